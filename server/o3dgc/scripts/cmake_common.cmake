@@ -7,3 +7,7 @@ source_group (Inl FILES ${PROJECT_INL_FILES})
 source_group (Src FILES ${PROJECT_CPP_FILES}  )
 source_group (SrcC FILES ${PROJECT_C_FILES}  )
 include_directories(BEFORE ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+option(O3DGC_64_BIT_INDICES "64-bit indices and counters in the connectivity coder" OFF)
+if(O3DGC_64_BIT_INDICES)
+    add_definitions(-DO3DGC_64_BIT_INDICES)
+endif()
@@ -26,62 +26,81 @@ THE SOFTWARE.
 #define O3DGC_ADJACENCY_INFO_H
 
 #include "o3dgcCommon.h"
+#include "o3dgcThreads.h"
 
 namespace o3dgc
 {
-    const long O3DGC_MIN_NEIGHBORS_SIZE     = 128;
-    const long O3DGC_MIN_NUM_NEIGHBORS_SIZE = 16;
+    const Index O3DGC_MIN_NEIGHBORS_SIZE     = 128;
+    const Index O3DGC_MIN_NUM_NEIGHBORS_SIZE = 16;
+    const Index O3DGC_MIN_NUM_TRIANGLES_PER_THREAD = 65536;
+
+    //! Shared state of the threads of AdjacencyInfo::ComputeVertexToTriangle().
+    template <class T>
+    struct VertexToTriangleTask
+    {
+        const T *               m_triangles;
+        Index                   m_numTriangles;
+        Index                   m_numVertices;
+        unsigned long           m_numThreads;
+        Index *                 m_cursors;          // per-thread counts, then per-thread write positions
+        Index *                 m_numNeighbors;
+        Index *                 m_neighbors;
+        Index                   m_rangeOffsets[O3DGC_MAX_NUM_THREADS];
+    };
     //! 
     class AdjacencyInfo
     {
     public:
         //! Constructor.
-                                AdjacencyInfo(long numNeighborsSize = O3DGC_MIN_NUM_NEIGHBORS_SIZE,
-                                              long neighborsSize    = O3DGC_MIN_NUM_NEIGHBORS_SIZE)
+                                AdjacencyInfo(Index numNeighborsSize = O3DGC_MIN_NUM_NEIGHBORS_SIZE,
+                                              Index neighborsSize    = O3DGC_MIN_NUM_NEIGHBORS_SIZE)
                                 {
                                     m_numElements      = 0;
                                     m_neighborsSize    = neighborsSize; 
                                     m_numNeighborsSize = numNeighborsSize;
-                                    m_numNeighbors     = new long [m_numNeighborsSize];
-                                    m_neighbors        = new long [m_neighborsSize   ];
+                                    m_numNeighbors     = new Index [m_numNeighborsSize];
+                                    m_neighbors        = new Index [m_neighborsSize   ];
+                                    m_cursors          = 0;
+                                    m_cursorsSize      = 0;
                                 };
         //! Destructor.
                                 ~AdjacencyInfo(void)
                                 {
                                     delete [] m_neighbors;
                                     delete [] m_numNeighbors;
+                                    delete [] m_cursors;
                                 };
-        O3DGCErrorCode          Allocate(long numNeighborsSize, long neighborsSize)
+        O3DGCErrorCode          Allocate(Index numNeighborsSize, Index neighborsSize)
                                 {
                                     m_numElements = numNeighborsSize;
                                     if (neighborsSize > m_neighborsSize)
                                     {
                                         delete [] m_numNeighbors;
                                         m_neighborsSize    = neighborsSize;
-                                        m_numNeighbors     = new long [m_numNeighborsSize];
+                                        m_numNeighbors     = new Index [m_numNeighborsSize];
                                     }
                                     if (numNeighborsSize > m_numNeighborsSize)
                                     {
                                         delete [] m_neighbors;
                                         m_numNeighborsSize = numNeighborsSize;
-                                        m_neighbors        = new long [m_neighborsSize];
+                                        m_neighbors        = new Index [m_neighborsSize];
                                     }
                                     return O3DGC_OK;
                                 }
-        O3DGCErrorCode          AllocateNumNeighborsArray(long numElements)
+        O3DGCErrorCode          AllocateNumNeighborsArray(Index numElements)
                                 {
                                     if (numElements > m_numNeighborsSize)
                                     {
                                         delete [] m_numNeighbors;
                                         m_numNeighborsSize = numElements;
-                                        m_numNeighbors = new long [m_numNeighborsSize];
+                                        m_numNeighbors = new Index [m_numNeighborsSize];
                                     }
                                     m_numElements = numElements;
                                     return O3DGC_OK;
                                 }
         O3DGCErrorCode          AllocateNeighborsArray()
                                 {
-                                    for(long i = 1; i < m_numElements; ++i)
+                                    for(Index i = 1; i < m_numElements; ++i)
                                     {
                                         m_numNeighbors[i] += m_numNeighbors[i-1];
                                     }
@@ -89,26 +108,26 @@ namespace o3dgc
                                     {
                                         delete [] m_neighbors;
                                         m_neighborsSize = m_numNeighbors[m_numElements-1];
-                                        m_neighbors = new long [m_neighborsSize];
+                                        m_neighbors = new Index [m_neighborsSize];
                                     }
                                     return O3DGC_OK;
                                 }
         O3DGCErrorCode          ClearNumNeighborsArray()
                                 {
-                                    memset(m_numNeighbors, 0x00, sizeof(long) * m_numElements);
+                                    memset(m_numNeighbors, 0x00, sizeof(Index) * m_numElements);
                                     return O3DGC_OK;
                                 }
         O3DGCErrorCode          ClearNeighborsArray()
                                 {
-                                    memset(m_neighbors, 0xFF, sizeof(long) * m_neighborsSize);
+                                    memset(m_neighbors, 0xFF, sizeof(Index) * m_neighborsSize);
                                     return O3DGC_OK;
                                 }
-        O3DGCErrorCode          AddNeighbor(long element, long neighbor)
+        O3DGCErrorCode          AddNeighbor(Index element, Index neighbor)
                                 {
                                     assert(m_numNeighbors[element] <= m_numNeighbors[m_numElements-1]);
-                                    long p0 = Begin(element);
-                                    long p1 = End(element);
-                                    for(long p = p0; p < p1; p++)
+                                    Index p0 = Begin(element);
+                                    Index p1 = End(element);
+                                    for(Index p = p0; p < p1; p++)
                                     {
                                         if (m_neighbors[p] == -1)
                                         {
@@ -118,38 +137,65 @@ namespace o3dgc
                                     }
                                     return O3DGC_ERROR_BUFFER_FULL;
                                 }
-        long                    Begin(long element) const 
+        Index                   Begin(Index element) const 
                                 {
                                     assert(element < m_numElements);
                                     assert(element >= 0);
                                     return (element>0)?m_numNeighbors[element-1]:0;
                                 }
-        long                    End(long element) const
+        Index                   End(Index element) const
                                 {
                                     assert(element < m_numElements);
                                     assert(element >= 0);
                                     return m_numNeighbors[element];
                                 }
-        long                    GetNeighbor(long element) const
+        Index                   GetNeighbor(Index element) const
                                 {
                                     assert(element < m_neighborsSize);
                                     assert(element >= 0);
                                     return m_neighbors[element];
                                 }    
-        long                    GetNumNeighbors(long element)  const 
+        Index                   GetNumNeighbors(Index element)  const 
                                 { 
                                     return End(element) - Begin(element);
                                 }
-        long * const            GetNumNeighborsBuffer() { return m_numNeighbors;}
-        long * const            GetNeighborsBuffer()    { return m_neighbors;}
+        Index * const           GetNumNeighborsBuffer() { return m_numNeighbors;}
+        Index * const           GetNeighborsBuffer()    { return m_neighbors;}
+        //! Builds the vertex-to-triangle adjacency of a triangle list with a counting sort, in O(numTriangles + numVertices).
+        //! The triangles of each vertex are listed in increasing order, as with AddNeighbor(). The counts and the scatter
+        //! are split over up to numThreads threads (0: one per processor), each one owning a range of triangles.
+        template <class T>
+        O3DGCErrorCode          ComputeVertexToTriangle(const T * const triangles,
+                                                        Index numTriangles,
+                                                        Index numVertices,
+                                                        unsigned long numThreads = 1);
 
     private:
-        long                    m_neighborsSize;    // actual allocated size for m_neighbors
-        long                    m_numNeighborsSize; // actual allocated size for m_numNeighbors
-        long                    m_numElements;      // number of elements 
-        long *                  m_neighbors;        // 
-        long *                  m_numNeighbors;     //         
+        template <class T>
+        static void             CountNeighbors(unsigned long threadID, void * data);
+        template <class T>
+        static void             SumNeighbors(unsigned long threadID, void * data);
+        template <class T>
+        static void             ComputeCursors(unsigned long threadID, void * data);
+        template <class T>
+        static void             ScatterNeighbors(unsigned long threadID, void * data);
+        static Index            GetRangeBegin(Index size, unsigned long numRanges, unsigned long range)
+                                {
+                                    const Index r = (Index) range;
+                                    const Index q = size / (Index) numRanges;
+                                    const Index m = size % (Index) numRanges;
+                                    return r * q + ((r < m) ? r : m);
+                                }
+
+        Index                   m_neighborsSize;    // actual allocated size for m_neighbors
+        Index                   m_numNeighborsSize; // actual allocated size for m_numNeighbors
+        Index                   m_numElements;      // number of elements 
+        Index *                 m_neighbors;        // 
+        Index *                 m_numNeighbors;     //         
+        Index *                 m_cursors;          // per-thread write positions of ComputeVertexToTriangle()
+        Index                   m_cursorsSize;      // actual allocated size for m_cursors
     };
 }
+#include "o3dgcAdjacencyInfo.inl"    // template implementation
 #endif // O3DGC_ADJACENCY_INFO_H
 
@@ -0,0 +1,176 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#ifndef O3DGC_ADJACENCY_INFO_INL
+#define O3DGC_ADJACENCY_INFO_INL
+namespace o3dgc
+{
+    template <class T>
+    O3DGCErrorCode AdjacencyInfo::ComputeVertexToTriangle(const T * const triangles,
+                                                          Index numTriangles,
+                                                          Index numVertices,
+                                                          unsigned long numThreads)
+    {
+        AllocateNumNeighborsArray(numVertices);
+        if (numVertices == 0)
+        {
+            return O3DGC_OK;
+        }
+        numThreads = GetNumThreads(numThreads);
+        const unsigned long maxNumThreads = (unsigned long) (numTriangles / O3DGC_MIN_NUM_TRIANGLES_PER_THREAD);
+        if (numThreads > maxNumThreads)
+        {
+            numThreads = maxNumThreads;
+        }
+        if (numThreads <= 1)
+        {
+            // count, turn the counts into start positions and scatter: each start position is
+            // advanced past its neighbors, which leaves m_numNeighbors holding the end positions
+            ClearNumNeighborsArray();
+            for(Index t = 0; t < 3 * numTriangles; ++t)
+            {
+                ++m_numNeighbors[ triangles[t] ];
+            }
+            Index size = 0;
+            for(Index v = 0; v < numVertices; ++v)
+            {
+                const Index n = m_numNeighbors[v];
+                m_numNeighbors[v] = size;
+                size += n;
+            }
+            if (size > m_neighborsSize)
+            {
+                delete [] m_neighbors;
+                m_neighborsSize = size;
+                m_neighbors     = new Index [m_neighborsSize];
+            }
+            for(Index i = 0, t = 0; i < numTriangles; ++i, t+=3)
+            {
+                m_neighbors[ m_numNeighbors[ triangles[t  ] ]++ ] = i;
+                m_neighbors[ m_numNeighbors[ triangles[t+1] ]++ ] = i;
+                m_neighbors[ m_numNeighbors[ triangles[t+2] ]++ ] = i;
+            }
+            return O3DGC_OK;
+        }
+        if (m_cursorsSize < (Index) numThreads * numVertices)
+        {
+            delete [] m_cursors;
+            m_cursorsSize = (Index) numThreads * numVertices;
+            m_cursors     = new Index [m_cursorsSize];
+        }
+        VertexToTriangleTask<T> task;
+        task.m_triangles    = triangles;
+        task.m_numTriangles = numTriangles;
+        task.m_numVertices  = numVertices;
+        task.m_numThreads   = numThreads;
+        task.m_cursors      = m_cursors;
+        task.m_numNeighbors = m_numNeighbors;
+        task.m_neighbors    = 0;
+        RunParallel(CountNeighbors<T>, &task, numThreads);
+        RunParallel(SumNeighbors<T>  , &task, numThreads);
+        Index size = 0;
+        for(unsigned long k = 0; k < numThreads; ++k)
+        {
+            const Index n = task.m_rangeOffsets[k];
+            task.m_rangeOffsets[k] = size;
+            size += n;
+        }
+        if (size > m_neighborsSize)
+        {
+            delete [] m_neighbors;
+            m_neighborsSize = size;
+            m_neighbors     = new Index [m_neighborsSize];
+        }
+        task.m_neighbors = m_neighbors;
+        RunParallel(ComputeCursors<T>  , &task, numThreads);
+        RunParallel(ScatterNeighbors<T>, &task, numThreads);
+        return O3DGC_OK;
+    }
+    template <class T>
+    void AdjacencyInfo::CountNeighbors(unsigned long threadID, void * data)
+    {
+        VertexToTriangleTask<T> & task = *((VertexToTriangleTask<T> *) data);
+        Index * const counts = task.m_cursors + threadID * task.m_numVertices;
+        const Index t0 = 3 * GetRangeBegin(task.m_numTriangles, task.m_numThreads, threadID);
+        const Index t1 = 3 * GetRangeBegin(task.m_numTriangles, task.m_numThreads, threadID + 1);
+        memset(counts, 0x00, sizeof(Index) * task.m_numVertices);
+        for(Index t = t0; t < t1; ++t)
+        {
+            ++counts[ task.m_triangles[t] ];
+        }
+    }
+    template <class T>
+    void AdjacencyInfo::SumNeighbors(unsigned long threadID, void * data)
+    {
+        // number of neighbors of the vertex range of the thread
+        VertexToTriangleTask<T> & task = *((VertexToTriangleTask<T> *) data);
+        const Index v0 = GetRangeBegin(task.m_numVertices, task.m_numThreads, threadID);
+        const Index v1 = GetRangeBegin(task.m_numVertices, task.m_numThreads, threadID + 1);
+        Index size = 0;
+        for(unsigned long k = 0; k < task.m_numThreads; ++k)
+        {
+            const Index * const counts = task.m_cursors + k * task.m_numVertices;
+            for(Index v = v0; v < v1; ++v)
+            {
+                size += counts[v];
+            }
+        }
+        task.m_rangeOffsets[threadID] = size;
+    }
+    template <class T>
+    void AdjacencyInfo::ComputeCursors(unsigned long threadID, void * data)
+    {
+        // the triangles of thread k are written after those of threads 0..k-1, which keeps them sorted
+        VertexToTriangleTask<T> & task = *((VertexToTriangleTask<T> *) data);
+        const Index v0 = GetRangeBegin(task.m_numVertices, task.m_numThreads, threadID);
+        const Index v1 = GetRangeBegin(task.m_numVertices, task.m_numThreads, threadID + 1);
+        Index position = task.m_rangeOffsets[threadID];
+        for(Index v = v0; v < v1; ++v)
+        {
+            for(unsigned long k = 0; k < task.m_numThreads; ++k)
+            {
+                Index & cursor = task.m_cursors[k * task.m_numVertices + v];
+                const Index n  = cursor;
+                cursor    = position;
+                position += n;
+            }
+            task.m_numNeighbors[v] = position;
+        }
+    }
+    template <class T>
+    void AdjacencyInfo::ScatterNeighbors(unsigned long threadID, void * data)
+    {
+        VertexToTriangleTask<T> & task = *((VertexToTriangleTask<T> *) data);
+        Index * const cursors = task.m_cursors + threadID * task.m_numVertices;
+        const Index i0 = GetRangeBegin(task.m_numTriangles, task.m_numThreads, threadID);
+        const Index i1 = GetRangeBegin(task.m_numTriangles, task.m_numThreads, threadID + 1);
+        const T * triangles = task.m_triangles + 3 * i0;
+        for(Index i = i0; i < i1; ++i, triangles += 3)
+        {
+            task.m_neighbors[ cursors[ triangles[0] ]++ ] = i;
+            task.m_neighbors[ cursors[ triangles[1] ]++ ] = i;
+            task.m_neighbors[ cursors[ triangles[2] ]++ ] = i;
+        }
+    }
+}
+#endif // O3DGC_ADJACENCY_INFO_INL
@@ -78,6 +78,8 @@ OF SUCH DAMAGE.
 
 namespace o3dgc
 {
+    const unsigned AC__MaxFrequencyTotal = 1U << 16;  // bound for set_frequencies()
+
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // - - Class definitions - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -88,10 +90,13 @@ namespace o3dgc
       Static_Bit_Model(void);
 
       void set_probability_0(double);             // set probability of symbol '0'
+      void set_frequencies(unsigned bit_0_count,   // exact integer probability
+                           unsigned bit_count);
 
     private:  //  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .
       unsigned bit_0_prob;
       friend class Arithmetic_Codec;
+      friend class RANS_Codec;
     };
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -107,11 +112,15 @@ namespace o3dgc
 
       void set_distribution(unsigned number_of_symbols,
                             const double probability[] = 0);    // 0 means uniform
+      void set_frequencies(unsigned number_of_symbols,    // symbol counts, zero
+                           const unsigned frequency[]);   // counts are never coded
 
     private:  //  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .
       unsigned * distribution, * decoder_table;
+      unsigned short * slot_table;        // rANS: symbol of each slot, on demand
       unsigned data_symbols, last_symbol, table_size, table_shift;
       friend class Arithmetic_Codec;
+      friend class RANS_Codec;
     };
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -123,12 +132,15 @@ namespace o3dgc
       Adaptive_Bit_Model(void);         
 
       void reset(void);                             // reset to equiprobable model
+      void set_counts(unsigned bit_0_count,           // reset to prior counts
+                      unsigned bit_count);
 
     private:  //  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .
       void     update(void);
       unsigned update_cycle, bits_until_update;
       unsigned bit_0_prob, bit_0_count, bit_count;
       friend class Arithmetic_Codec;
+      friend class RANS_Codec;
     };
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -145,6 +157,8 @@ namespace o3dgc
 
       void reset(void);                             // reset to equiprobable model
       void set_alphabet(unsigned number_of_symbols);
+      void set_counts(const unsigned short * counts,  // reset to prior counts
+                      unsigned number_of_counts);      // (missing symbols: 1)
 
     private:  //  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .
       void     update(bool);
@@ -152,6 +166,7 @@ namespace o3dgc
       unsigned total_count, update_cycle, symbols_until_update;
       unsigned data_symbols, last_symbol, table_size, table_shift;
       friend class Arithmetic_Codec;
+      friend class RANS_Codec;
     };
 
 
@@ -266,8 +281,9 @@ namespace o3dgc
       unsigned base, value, length;                     // arithmetic coding state
       unsigned buffer_size, mode;     // mode: 0 = undef, 1 = encoder, 2 = decoder
     };
-    inline long DecodeIntACEGC(Arithmetic_Codec & acd,
-                               Adaptive_Data_Model & mModelValues,
+    template <class Codec, class Model>
+    inline long DecodeIntACEGC(Codec & acd,
+                               Model & mModelValues,
                                Static_Bit_Model & bModel0,
                                Adaptive_Bit_Model & bModel1,
                                const unsigned long exp_k,
@@ -280,8 +296,9 @@ namespace o3dgc
         }
         return UIntToInt(uiValue);
     }
-    inline unsigned long DecodeUIntACEGC(Arithmetic_Codec & acd,
-                                         Adaptive_Data_Model & mModelValues,
+    template <class Codec, class Model>
+    inline unsigned long DecodeUIntACEGC(Codec & acd,
+                                         Model & mModelValues,
                                          Static_Bit_Model & bModel0,
                                          Adaptive_Bit_Model & bModel1,
                                          const unsigned long exp_k,
@@ -295,9 +312,10 @@ namespace o3dgc
         return uiValue;
     }
 
+    template <class Codec, class Model>
     inline void EncodeIntACEGC(long predResidual, 
-                               Arithmetic_Codec & ace,
-                               Adaptive_Data_Model & mModelValues,
+                               Codec & ace,
+                               Model & mModelValues,
                                Static_Bit_Model & bModel0,
                                Adaptive_Bit_Model & bModel1,
                                const unsigned long M)
@@ -313,9 +331,10 @@ namespace o3dgc
             ace.ExpGolombEncode(uiValue-M, 0, bModel0, bModel1);
         }
     }
+    template <class Codec, class Model>
     inline void EncodeUIntACEGC(long predResidual, 
-                                Arithmetic_Codec & ace,
-                                Adaptive_Data_Model & mModelValues,
+                                Codec & ace,
+                                Model & mModelValues,
                                 Static_Bit_Model & bModel0,
                                 Adaptive_Bit_Model & bModel1,
                                 const unsigned long M)
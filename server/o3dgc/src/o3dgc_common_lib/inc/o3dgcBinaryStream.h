@@ -37,7 +37,57 @@ namespace o3dgc
     const unsigned long O3DGC_BINARY_STREAM_MAX_SYMBOL1        = (1 << O3DGC_BINARY_STREAM_BITS_PER_SYMBOL1) - 1;
     const unsigned long O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32 = (32+O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0-1) / 
                                                                  O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0;
+    const unsigned long O3DGC_BINARY_STREAM_MAX_SIZE_UINT_ASCII = 1 + (8 * sizeof(unsigned long) + O3DGC_BINARY_STREAM_BITS_PER_SYMBOL1 - 1) /
+                                                                  O3DGC_BINARY_STREAM_BITS_PER_SYMBOL1;
 
+    //! Destination of the bytes released by BinaryStream::Flush(). Positions are offsets from the beginning of the
+    //! stream; Overwrite() patches bytes already appended (e.g. the stream size, which is known only at the end).
+    class BinaryStreamSink
+    {
+    public:
+        virtual                 ~BinaryStreamSink(void) {};
+        virtual O3DGCErrorCode  Append(const unsigned char * const buffer, unsigned long size) = 0;
+        virtual O3DGCErrorCode  Overwrite(unsigned long position, const unsigned char * const buffer, unsigned long size) = 0;
+    };
+    //! Sink writing to a seekable file opened in binary mode.
+    class FileStreamSink : public BinaryStreamSink
+    {
+    public:
+        //! Constructor.
+                                FileStreamSink(FILE * const file)
+                                {
+                                    m_file  = file;
+                                    m_start = ftell(file);
+                                    m_size  = 0;
+                                };
+        //! Destructor.
+        virtual                 ~FileStreamSink(void){};
+        virtual O3DGCErrorCode  Append(const unsigned char * const buffer, unsigned long size)
+                                {
+                                    if (fwrite(buffer, 1, size, m_file) != size)
+                                    {
+                                        return O3DGC_ERROR_WRITE_FILE;
+                                    }
+                                    m_size += size;
+                                    return O3DGC_OK;
+                                }
+        virtual O3DGCErrorCode  Overwrite(unsigned long position, const unsigned char * const buffer, unsigned long size)
+                                {
+                                    assert(position + size <= m_size);
+                                    if (fseek(m_file, m_start + position, SEEK_SET) != 0 ||
+                                        fwrite(buffer, 1, size, m_file) != size             ||
+                                        fseek(m_file, m_start + m_size, SEEK_SET) != 0)
+                                    {
+                                        return O3DGC_ERROR_WRITE_FILE;
+                                    }
+                                    return O3DGC_OK;
+                                }
+
+    private:
+        FILE *                  m_file;
+        long                    m_start;
+        unsigned long           m_size;
+    };
     //! 
     class BinaryStream
     {
@@ -47,6 +97,9 @@ namespace o3dgc
                                 {
                                     m_endianness = SystemEndianness();
                                     m_stream.Allocate(size);
+                                    m_sink       = 0;
+                                    m_flushed    = 0;
+                                    m_sinkError  = O3DGC_OK;
                                 };
         //! Destructor.
                                 ~BinaryStream(void){};
@@ -148,21 +201,21 @@ namespace o3dgc
 
         void                    WriteFloat32Bin(unsigned long position, float value) 
                                 {
-                                    assert(position < m_stream.GetSize() - 4);
+                                    assert(position < GetSize() - 4);
                                     unsigned char * ptr = (unsigned char *) (&value);
                                     if (m_endianness == O3DGC_BIG_ENDIAN)
                                     {
-                                        m_stream[position++] = ptr[3];
-                                        m_stream[position++] = ptr[2];
-                                        m_stream[position++] = ptr[1];
-                                        m_stream[position  ] = ptr[0];
+                                        SetByte(position++, ptr[3]);
+                                        SetByte(position++, ptr[2]);
+                                        SetByte(position++, ptr[1]);
+                                        SetByte(position, ptr[0]);
                                     }
                                     else
                                     {
-                                        m_stream[position++] = ptr[0];
-                                        m_stream[position++] = ptr[1];
-                                        m_stream[position++] = ptr[2];
-                                        m_stream[position  ] = ptr[3];
+                                        SetByte(position++, ptr[0]);
+                                        SetByte(position++, ptr[1]);
+                                        SetByte(position++, ptr[2]);
+                                        SetByte(position, ptr[3]);
                                     }
                                 }
         void                    WriteFloat32Bin(float value) 
@@ -177,29 +230,26 @@ namespace o3dgc
                                     }
                                     else
                                     {
-                                        m_stream.PushBack(ptr[0]);
-                                        m_stream.PushBack(ptr[1]);
-                                        m_stream.PushBack(ptr[2]);
-                                        m_stream.PushBack(ptr[3]);
+                                        WriteBytes(ptr, 4);
                                     }
                                 }
         void                    WriteUInt32Bin(unsigned long position, unsigned long value) 
                                 {
-                                    assert(position < m_stream.GetSize() - 4);
+                                    assert(position < GetSize() - 4);
                                     unsigned char * ptr = (unsigned char *) (&value);
                                     if (m_endianness == O3DGC_BIG_ENDIAN)
                                     {
-                                        m_stream[position++] = ptr[3];
-                                        m_stream[position++] = ptr[2];
-                                        m_stream[position++] = ptr[1];
-                                        m_stream[position  ] = ptr[0];
+                                        SetByte(position++, ptr[3]);
+                                        SetByte(position++, ptr[2]);
+                                        SetByte(position++, ptr[1]);
+                                        SetByte(position, ptr[0]);
                                     }
                                     else
                                     {
-                                        m_stream[position++] = ptr[0];
-                                        m_stream[position++] = ptr[1];
-                                        m_stream[position++] = ptr[2];
-                                        m_stream[position  ] = ptr[3];
+                                        SetByte(position++, ptr[0]);
+                                        SetByte(position++, ptr[1]);
+                                        SetByte(position++, ptr[2]);
+                                        SetByte(position, ptr[3]);
                                     }
                                 }
         void                    WriteUInt32Bin(unsigned long value) 
@@ -214,15 +264,13 @@ namespace o3dgc
                                     }
                                     else
                                     {
-                                        m_stream.PushBack(ptr[0]);
-                                        m_stream.PushBack(ptr[1]);
-                                        m_stream.PushBack(ptr[2]);
-                                        m_stream.PushBack(ptr[3]);
+                                        // little-endian host: the 4 low bytes are already in stream order
+                                        WriteBytes(ptr, 4);
                                     }
                                 }
         void                    WriteUChar8Bin(unsigned int position, unsigned char value) 
                                 {
-                                    m_stream[position] = value;
+                                    SetByte(position, value);
                                 }
         void                    WriteUChar8Bin(unsigned char value) 
                                 {
@@ -236,27 +284,27 @@ namespace o3dgc
                                 }
         unsigned long           ReadUInt32Bin(unsigned long & position)  const
                                 {
-                                    assert(position < m_stream.GetSize() - 4);
+                                    assert(position < GetSize() - 4);
                                     unsigned long value = 0;
                                     if (m_endianness == O3DGC_BIG_ENDIAN)
                                     {
-                                        value += (m_stream[position++]<<24);
-                                        value += (m_stream[position++]<<16);
-                                        value += (m_stream[position++]<<8);
-                                        value += (m_stream[position++]);
+                                        value += (m_stream[position++ - m_flushed]<<24);
+                                        value += (m_stream[position++ - m_flushed]<<16);
+                                        value += (m_stream[position++ - m_flushed]<<8);
+                                        value += (m_stream[position++ - m_flushed]);
                                     }
                                     else
                                     {
-                                        value += (m_stream[position++]);
-                                        value += (m_stream[position++]<<8);
-                                        value += (m_stream[position++]<<16);
-                                        value += (m_stream[position++]<<24);
+                                        value += (m_stream[position++ - m_flushed]);
+                                        value += (m_stream[position++ - m_flushed]<<8);
+                                        value += (m_stream[position++ - m_flushed]<<16);
+                                        value += (m_stream[position++ - m_flushed]<<24);
                                     }
                                     return value;
                                 }
         unsigned char           ReadUChar8Bin(unsigned long & position) const
                                 {
-                                    return m_stream[position++];
+                                    return m_stream[position++ - m_flushed];
                                 }
 
         void                    WriteFloat32ASCII(float value) 
@@ -266,21 +314,23 @@ namespace o3dgc
                                 }
         void                    WriteUInt32ASCII(unsigned long position, unsigned long value) 
                                 {
-                                    assert(position < m_stream.GetSize() - O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
+                                    assert(position < GetSize() - O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
                                     unsigned long value0 = value;
                                     for(unsigned long i = 0; i < O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32; ++i)
                                     {
-                                        m_stream[position++] = (value0 & O3DGC_BINARY_STREAM_MAX_SYMBOL0);
+                                        SetByte(position++, (value0 & O3DGC_BINARY_STREAM_MAX_SYMBOL0));
                                         value0 >>= O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0;
                                     }
                                 }
         void                    WriteUInt32ASCII(unsigned long value) 
                                 {
+                                    unsigned char * const ptr = ReserveTail(O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
                                     for(unsigned long i = 0; i < O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32; ++i)
                                     {
-                                        m_stream.PushBack(value & O3DGC_BINARY_STREAM_MAX_SYMBOL0);
+                                        ptr[i] = (unsigned char) (value & O3DGC_BINARY_STREAM_MAX_SYMBOL0);
                                         value >>= O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0;
                                     }
+                                    CommitTail(O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
                                 }
         void                    WriteIntASCII(long value) 
                                 {
@@ -290,7 +340,9 @@ namespace o3dgc
                                 {
                                     if (value >= O3DGC_BINARY_STREAM_MAX_SYMBOL0)
                                     {
-                                        m_stream.PushBack(O3DGC_BINARY_STREAM_MAX_SYMBOL0);
+                                        unsigned char * const ptr = ReserveTail(O3DGC_BINARY_STREAM_MAX_SIZE_UINT_ASCII);
+                                        unsigned long size = 0;
+                                        ptr[size++] = O3DGC_BINARY_STREAM_MAX_SYMBOL0;
                                         value -= O3DGC_BINARY_STREAM_MAX_SYMBOL0;
                                         unsigned char a, b;
                                         do
@@ -298,8 +350,9 @@ namespace o3dgc
                                             a  = ((value & O3DGC_BINARY_STREAM_MAX_SYMBOL1) << 1);
                                             b  = ( (value >>= O3DGC_BINARY_STREAM_BITS_PER_SYMBOL1) > 0);
                                             a += b;
-                                            m_stream.PushBack(a);
+                                            ptr[size++] = a;
                                         } while (b);
+                                        CommitTail(size);
                                     }
                                     else
                                     {
@@ -319,12 +372,12 @@ namespace o3dgc
                                 }
         unsigned long           ReadUInt32ASCII(unsigned long & position)  const
                                 {
-                                    assert(position < m_stream.GetSize() - O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
+                                    assert(position < GetSize() - O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32);
                                     unsigned long value = 0;
                                     unsigned long shift = 0;
                                     for(unsigned long i = 0; i < O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32; ++i)
                                     {
-                                        value  += (m_stream[position++] << shift);
+                                        value  += (m_stream[position++ - m_flushed] << shift);
                                         shift  += O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0;
                                     }
                                     return value;
@@ -335,14 +388,14 @@ namespace o3dgc
                                 }
         unsigned long           ReadUIntASCII(unsigned long & position) const
                                 {
-                                    unsigned long value = m_stream[position++];
+                                    unsigned long value = m_stream[position++ - m_flushed];
                                     if (value == O3DGC_BINARY_STREAM_MAX_SYMBOL0)
                                     {
                                         long x;
                                         unsigned long i = 0;
                                         do
                                         {
-                                            x = m_stream[position++];
+                                            x = m_stream[position++ - m_flushed];
                                             value += ( (x>>1) << i);
                                             i += O3DGC_BINARY_STREAM_BITS_PER_SYMBOL1;
                                         } while (x & 1);
@@ -351,7 +404,20 @@ namespace o3dgc
                                 }
         unsigned char           ReadUCharASCII(unsigned long & position) const
                                 {
-                                    return m_stream[position++];
+                                    return m_stream[position++ - m_flushed];
+                                }
+        //! Appends size raw bytes.
+        void                    WriteBytes(const unsigned char * const buffer, unsigned long size)
+                                {
+                                    memcpy(ReserveTail(size), buffer, size);
+                                    CommitTail(size);
+                                }
+        //! Copies size raw bytes starting at position.
+        void                    ReadBytes(unsigned long & position, unsigned char * const buffer, unsigned long size) const
+                                {
+                                    assert(position >= m_flushed && position + size <= GetSize());
+                                    memcpy(buffer, m_stream.GetBuffer() + position - m_flushed, size);
+                                    position += size;
                                 }
         O3DGCErrorCode          Save(const char * const fileName) 
                                 {
@@ -360,6 +426,11 @@ namespace o3dgc
                                     {
                                         return O3DGC_ERROR_CREATE_FILE;
                                     }
+                                    if (m_flushed > 0)
+                                    {
+                                        fclose(fout);
+                                        return O3DGC_ERROR_NON_SUPPORTED_FEATURE;
+                                    }
                                     fwrite(m_stream.GetBuffer(), 1, m_stream.GetSize(), fout);
                                     fclose(fout);
                                     return O3DGC_OK;
@@ -373,6 +444,8 @@ namespace o3dgc
                                     }
                                     fseek(fin, 0, SEEK_END);
                                     unsigned long size = ftell(fin);
+                                    m_stream.Clear();
+                                    m_flushed = 0;
                                     m_stream.Allocate(size);
                                     rewind(fin);
                                     unsigned int nread = (unsigned int) fread((void *) m_stream.GetBuffer(), 1, size, fin);
@@ -386,22 +459,55 @@ namespace o3dgc
                                 }
         O3DGCErrorCode          LoadFromBuffer(unsigned char * buffer, unsigned long bufferSize)
                                 {
+                                    m_stream.Clear();
+                                    m_flushed = 0;
                                     m_stream.Allocate(bufferSize);
                                     memcpy(m_stream.GetBuffer(), buffer, bufferSize);
                                     m_stream.SetSize(bufferSize);
                                     return O3DGC_OK;
                                 }
+        //! Read-only view over bufferSize bytes owned by the caller, which are decoded in place. The buffer must
+        //! outlive the stream; appending to a view first copies it, the positional Write*() functions must not be used.
+        void                    AttachBuffer(const unsigned char * const buffer, unsigned long bufferSize)
+                                {
+                                    m_stream.SetExternalBuffer((unsigned char *) buffer, bufferSize);
+                                    m_flushed = 0;
+                                }
+        bool                    IsView() const
+                                {
+                                    return m_stream.IsExternalBuffer();
+                                }
         unsigned long           GetSize() const
                                 {
-                                    return m_stream.GetSize();
+                                    return m_flushed + m_stream.GetSize();
+                                }
+        //! Sends the bytes written so far to the sink and releases them. Flushed bytes can no longer be read and only
+        //! the positional Write*() functions may still modify them. Returns the first error reported by the sink.
+        O3DGCErrorCode          Flush()
+                                {
+                                    if (m_sink && m_sinkError == O3DGC_OK && m_stream.GetSize() > 0)
+                                    {
+                                        m_sinkError = m_sink->Append(m_stream.GetBuffer(), m_stream.GetSize());
+                                        m_flushed  += m_stream.GetSize();
+                                        m_stream.SetSize(0);
+                                    }
+                                    return m_sinkError;
+                                }
+        void                    SetSink(BinaryStreamSink * const sink)
+                                {
+                                    m_sink = sink;
+                                }
+        BinaryStreamSink *      GetSink() const
+                                {
+                                    return m_sink;
                                 }
     const unsigned char * const GetBuffer(unsigned long position) const
                                 {
-                                    return m_stream.GetBuffer() + position;
+                                    return m_stream.GetBuffer() + position - m_flushed;
                                 }
     unsigned char * const       GetBuffer(unsigned long position)
                                 {
-                                    return (m_stream.GetBuffer() + position);
+                                    return (m_stream.GetBuffer() + position - m_flushed);
                                 }                                
     unsigned char * const       GetBuffer()
                                 {
@@ -409,20 +515,55 @@ namespace o3dgc
                                 }                                
     void                        GetBuffer(unsigned long position, unsigned char * & buffer) const
                                 {
-                                    buffer = (unsigned char *) (m_stream.GetBuffer() + position); // fix me: ugly!
+                                    buffer = (unsigned char *) (m_stream.GetBuffer() + position - m_flushed); // fix me: ugly!
                                 }
     void                        SetSize(unsigned long size)
                                 { 
-                                    m_stream.SetSize(size);
+                                    m_stream.SetSize(size - m_flushed);
                                 };
     void                        Allocate(unsigned long size)
                                 {
                                     m_stream.Allocate(size);
                                 }
+    //! Capacity planning: makes room for size more bytes, so that the writes that follow do not reallocate.
+    void                        Reserve(unsigned long size)
+                                {
+                                    ReserveTail(size);
+                                }
+    //! Returns size writable bytes past the end of the stream (the stream size is unchanged until CommitTail()).
+    unsigned char * const       ReserveTail(unsigned long size)
+                                {
+                                    const unsigned long required = m_stream.GetSize() + size;
+                                    if (required > m_stream.GetAllocatedSize())
+                                    {
+                                        const unsigned long allocated = 2 * m_stream.GetAllocatedSize();
+                                        m_stream.Allocate((allocated > required) ? allocated : required);
+                                    }
+                                    return m_stream.GetBuffer() + m_stream.GetSize();
+                                }
+    //! Appends the first size bytes of the reserved tail to the stream.
+    void                        CommitTail(unsigned long size)
+                                {
+                                    m_stream.SetSize(m_stream.GetSize() + size);
+                                }
 
     private:
+        void                    SetByte(unsigned long position, unsigned char value)
+                                {
+                                    if (position >= m_flushed)
+                                    {
+                                        m_stream[position - m_flushed] = value;
+                                    }
+                                    else if (m_sinkError == O3DGC_OK)
+                                    {
+                                        m_sinkError = m_sink->Overwrite(position, &value, 1);
+                                    }
+                                }
         Vector<unsigned char>   m_stream;
         O3DGCEndianness         m_endianness;
+        BinaryStreamSink *      m_sink;
+        unsigned long           m_flushed;
+        O3DGCErrorCode          m_sinkError;
     };
 
 }
@@ -35,6 +35,11 @@ THE SOFTWARE.
 namespace o3dgc
 {
     typedef float        Real;
+#ifdef O3DGC_64_BIT_INDICES
+    typedef long         Index;     //!< indices and counters of the connectivity coder
+#else
+    typedef int          Index;     //!< indices and counters of the connectivity coder, the streams limit them to 32 bits
+#endif
     const double O3DGC_MAX_DOUBLE       = 1.79769e+308;
     const long O3DGC_MIN_LONG           = -2147483647;
     const long O3DGC_MAX_LONG           =  2147483647;
@@ -47,9 +52,15 @@ namespace o3dgc
     const unsigned long O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES = 256;
     const unsigned long O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES   = 256;
     const unsigned long O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES = 32;
+    const unsigned long O3DGC_DV_MAX_M                        = 512;
 
     const unsigned long O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS = 2;
     const unsigned long O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS   = 257;
+    const unsigned long O3DGC_SC3DMC_MAX_NUM_LANES            = 8;
+    const unsigned long O3DGC_SC3DMC_MODEL_DICTIONARY_MAX_VERTICES = 2048;
+    //! range of the quantization bits chosen from error bounds or a stream size budget (floats have 24-bit mantissas)
+    const unsigned long O3DGC_SC3DMC_MIN_QUANT_BITS           = 2;
+    const unsigned long O3DGC_SC3DMC_MAX_QUANT_BITS           = 24;
 
     enum O3DGCEndianness
     {
@@ -64,7 +75,8 @@ namespace o3dgc
         O3DGC_ERROR_OPEN_FILE,
         O3DGC_ERROR_READ_FILE,
         O3DGC_ERROR_CORRUPTED_STREAM,
-        O3DGC_ERROR_NON_SUPPORTED_FEATURE
+        O3DGC_ERROR_NON_SUPPORTED_FEATURE,
+        O3DGC_ERROR_WRITE_FILE
     };
     enum O3DGCSC3DMCBinarization
     {
@@ -73,7 +85,24 @@ namespace o3dgc
         O3DGC_SC3DMC_BINARIZATION_FC     = 2,            // 4 bits Coding (not supported)
         O3DGC_SC3DMC_BINARIZATION_AC     = 3,            // Arithmetic Coding (not supported)
         O3DGC_SC3DMC_BINARIZATION_AC_EGC = 4,            // Arithmetic Coding & EGCk
-        O3DGC_SC3DMC_BINARIZATION_ASCII  = 5             // Arithmetic Coding & EGCk
+        O3DGC_SC3DMC_BINARIZATION_ASCII  = 5,            // Arithmetic Coding & EGCk
+        O3DGC_SC3DMC_BINARIZATION_RANS   = 6             // Interleaved rANS & EGCk
+    };
+    enum O3DGCModelDictionary
+    {
+        O3DGC_MODEL_DICTIONARY_NONE         = 0,            // models start equiprobable
+        O3DGC_MODEL_DICTIONARY_SMALL_MESHES = 1             // trained on small COLLADA meshes
+    };
+    enum O3DGCSC3DMCEntropyModel
+    {
+        O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE    = 0,         // models updated while coding
+        O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC = 1          // two passes, frequency tables stored in the stream
+    };
+    enum O3DGCVertexCacheOptimization
+    {
+        O3DGC_VERTEX_CACHE_OPTIMIZATION_NONE      = 0,  // triangles in traversal order
+        O3DGC_VERTEX_CACHE_OPTIMIZATION_TRIANGLES = 1,  // triangles reordered for the post-transform vertex cache
+        O3DGC_VERTEX_CACHE_OPTIMIZATION_VERTICES  = 2   // same, and vertices renumbered by order of first use
     };
     enum O3DGCStreamType
     {
@@ -95,7 +124,8 @@ namespace o3dgc
         O3DGC_SC3DMC_ADAPTIVE_DIFFERENTIAL_PREDICTION = 3, // not supported
         O3DGC_SC3DMC_CIRCULAR_DIFFERENTIAL_PREDICTION = 4, // not supported
         O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION         = 5,  // supported
-        O3DGC_SC3DMC_SURF_NORMALS_PREDICTION          = 6   // supported
+        O3DGC_SC3DMC_SURF_NORMALS_PREDICTION          = 6,  // supported
+        O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION    = 7   // supported
     };
     enum O3DGCSC3DMCEncodingMode
     {
@@ -165,6 +195,37 @@ namespace o3dgc
                                         memset(this, 0, sizeof(SC3DMCStats));
                                     };
                                     ~SC3DMCStats(void){};
+        //! Adds the times and sizes of stats, e.g. those of a segment.
+        void                        Accumulate(const SC3DMCStats & stats)
+                                    {
+                                        m_timeCoord            += stats.m_timeCoord;
+                                        m_timeNormal           += stats.m_timeNormal;
+                                        m_timeCoordIndex       += stats.m_timeCoordIndex;
+                                        m_timeReorder          += stats.m_timeReorder;
+                                        m_timeVertexCache      += stats.m_timeVertexCache;
+                                        m_timeEntropyDecoding  += stats.m_timeEntropyDecoding;
+                                        m_timeReconstruction   += stats.m_timeReconstruction;
+                                        if (stats.m_numCacheTriangles > 0)
+                                        {
+                                            const double n = (double) (m_numCacheTriangles + stats.m_numCacheTriangles);
+                                            m_acmrBefore = (m_acmrBefore * m_numCacheTriangles + stats.m_acmrBefore * stats.m_numCacheTriangles) / n;
+                                            m_acmrAfter  = (m_acmrAfter  * m_numCacheTriangles + stats.m_acmrAfter  * stats.m_numCacheTriangles) / n;
+                                            m_numCacheTriangles += stats.m_numCacheTriangles;
+                                        }
+                                        m_streamSizeCoord      += stats.m_streamSizeCoord;
+                                        m_streamSizeNormal     += stats.m_streamSizeNormal;
+                                        m_streamSizeCoordIndex += stats.m_streamSizeCoordIndex;
+                                        for(unsigned long a = 0; a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES; ++a)
+                                        {
+                                            m_timeFloatAttribute[a]       += stats.m_timeFloatAttribute[a];
+                                            m_streamSizeFloatAttribute[a] += stats.m_streamSizeFloatAttribute[a];
+                                        }
+                                        for(unsigned long a = 0; a < O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES; ++a)
+                                        {
+                                            m_timeIntAttribute[a]       += stats.m_timeIntAttribute[a];
+                                            m_streamSizeIntAttribute[a] += stats.m_streamSizeIntAttribute[a];
+                                        }
+                                    }
         
         double                      m_timeCoord;
         double                      m_timeNormal;
@@ -172,6 +233,15 @@ namespace o3dgc
         double                      m_timeFloatAttribute[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
         double                      m_timeIntAttribute  [O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES  ];
         double                      m_timeReorder;
+        double                      m_timeVertexCache;
+        //! time spent by the float attribute decoders in each of their two stages: entropy decoding of the predictors
+        //! and residuals, and reconstruction of the values from their predictions
+        double                      m_timeEntropyDecoding;
+        double                      m_timeReconstruction;
+        //! average cache miss ratios before and after the vertex cache optimization of m_numCacheTriangles triangles
+        double                      m_acmrBefore;
+        double                      m_acmrAfter;
+        unsigned long               m_numCacheTriangles;
 
         unsigned long               m_streamSizeCoord;
         unsigned long               m_streamSizeNormal;
@@ -179,6 +249,16 @@ namespace o3dgc
         unsigned long               m_streamSizeFloatAttribute[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
         unsigned long               m_streamSizeIntAttribute  [O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES  ];
 
+        //! quantization bits of the encoded attributes and bounds on their errors: position error relative to the
+        //! bounding box diagonal, normal angle in radians and float attribute error in the units of the attribute
+        unsigned long               m_quantBitsCoord;
+        unsigned long               m_quantBitsNormal;
+        unsigned long               m_quantBitsFloatAttribute [O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
+        double                      m_quantErrorCoord;
+        double                      m_quantErrorNormal;
+        double                      m_quantErrorFloatAttribute[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
+        //! the stream does not fit in the SC3DMCEncodeParams::SetMaxStreamSize() budget, even with the fewest bits
+        bool                        m_maxStreamSizeExceeded;
     };
     typedef struct 
     {
@@ -336,6 +416,96 @@ namespace o3dgc
             break;
         }
     }
+    //! True for the normal prediction modes predicting from the normals of the surface, which need the quantized 
+    //! coordinates.
+    inline bool IsSurfaceNormalsPrediction(O3DGCSC3DMCPredictionMode predMode)
+    {
+        return (predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION || 
+                predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION);
+    }
+    //! Maps the direction (x, y, z) to the square [-1, 1]^2: the unit octahedron is unfolded onto the square, the 
+    //! lower half folded over the corners. The null vector maps to (0, 0).
+    template <class T> 
+    inline void SphereToOctahedron(const T x, const T y, const T z, 
+                                   Real & u, Real & v)
+    {
+        const Real norm1 = (Real) absolute(x) + (Real) absolute(y) + (Real) absolute(z);
+        if (norm1 == (Real)(0.0))
+        {
+            u = v = (Real)(0.0);
+            return;
+        }
+        u = (Real) x / norm1;
+        v = (Real) y / norm1;
+        if (z < (T)(0))
+        {
+            const Real w = u;
+            u = ((Real)(1.0) - absolute(v)) * ((w >= (Real)(0.0)) ? (Real)(1.0) : (Real)(-1.0));
+            v = ((Real)(1.0) - absolute(w)) * ((v >= (Real)(0.0)) ? (Real)(1.0) : (Real)(-1.0));
+        }
+    }
+    //! Inverse of SphereToOctahedron, returning a unit vector, without branches.
+    inline void OctahedronToSphere(const Real u, const Real v,
+                                   Real & x, Real & y, Real & z)
+    {
+        z = (Real)(1.0) - absolute(u) - absolute(v);
+        const Real t = max(-z, (Real)(0.0)); // unfolds the lower half
+        x = u + ((u >= (Real)(0.0)) ? -t : t);
+        y = v + ((v >= (Real)(0.0)) ? -t : t);
+        const Real invNorm = (Real)(1.0) / (Real) sqrt(x * x + y * y + z * z);
+        x *= invNorm;
+        y *= invNorm;
+        z *= invNorm;
+    }
+    //! Completes the unit vector n into the orthonormal basis (t, s, n), without branches (Duff et al., "Building 
+    //! an Orthonormal Basis, Revisited").
+    inline void ComputeOrthonormalBasis(const Real * const n, Real * const t, Real * const s)
+    {
+        const Real sign = (n[2] >= (Real)(0.0)) ? (Real)(1.0) : (Real)(-1.0);
+        const Real a    = (Real)(-1.0) / (sign + n[2]);
+        const Real b    = n[0] * n[1] * a;
+        t[0] = (Real)(1.0) + sign * n[0] * n[0] * a;
+        t[1] = sign * b;
+        t[2] = -sign * n[0];
+        s[0] = b;
+        s[1] = sign + n[1] * n[1] * a;
+        s[2] = -n[1];
+    }
+    //! Bound on the Euclidean error of dim-dimensional vectors quantized with nQBits over [minTab, maxTab].
+    inline Real ComputeQuantizationError(const Real * const minTab,
+                                         const Real * const maxTab,
+                                         unsigned long dim,
+                                         unsigned long nQBits)
+    {
+        double r2 = 0.0;
+        for(unsigned long d = 0; d < dim; ++d)
+        {
+            const double r = maxTab[d] - minTab[d];
+            r2 += r * r;
+        }
+        return (Real) (0.5 * sqrt(r2) / ((double) (1UL << nQBits) - 1.0));
+    }
+    //! Bound, in radians, on the angle between a unit normal and its value decoded with the prediction mode predMode
+    //! and nQBits. The surface modes quantize the cube projection over [-2, 2] and the octahedral one over [-1, 1], 
+    //! both with nQBits+1; the first-order bounds sqrt(6)/2 and 3/sqrt(2) times the step are reached at the corners
+    //! of the projections. The other modes quantize the components over [minTab, maxTab].
+    inline Real ComputeNormalQuantizationError(O3DGCSC3DMCPredictionMode predMode,
+                                               const Real * const minTab,
+                                               const Real * const maxTab,
+                                               unsigned long nQBits)
+    {
+        const double numSteps = (double) (1UL << (nQBits + 1)) - 1.0;
+        if (predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
+        {
+            return (Real) (1.224744871391589 * 4.0 / numSteps);
+        }
+        if (predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
+        {
+            return (Real) (2.121320343559642 * 2.0 / numSteps);
+        }
+        const double chord = ComputeQuantizationError(minTab, maxTab, 3, nQBits);
+        return (Real) asin((chord < 1.0) ? chord : 1.0);
+    }
     inline unsigned long IntToUInt(long value)
     {
         return (value < 0)?(unsigned long) (-1 - (2 * value)):(unsigned long) (2 * value);
@@ -344,6 +514,20 @@ namespace o3dgc
     {
         return (uiValue & 1)?-((long) ((uiValue+1) >> 1)):((long) (uiValue >> 1));
     }
+    //! largest vertex index representable by the unsigned index type T
+    template <class T>
+    inline unsigned long GetMaxIndex()
+    {
+        return (sizeof(T) >= sizeof(unsigned long)) ? ~0UL : (1UL << (8 * sizeof(T))) - 1;
+    }
+    //! Per-component minimum and maximum of size vectors of dim floats spaced by stride (size > 0); defined with 
+    //! the SIMD kernels of o3dgcSIMD.cpp.
+    void ComputeVectorBounds(const Real * const tab, 
+                             unsigned long size, 
+                             unsigned long dim,
+                             unsigned long stride,
+                             Real * minTab,
+                             Real * maxTab);
     inline void ComputeVectorMinMax(const Real * const tab, 
                                     unsigned long size, 
                                     unsigned long dim,
@@ -356,21 +540,7 @@ namespace o3dgc
         {
             return;
         }
-        unsigned long p = 0;
-        for(unsigned long d = 0; d < dim; ++d)
-        {
-            maxTab[d] = minTab[d] = tab[p++];
-        }
-        p = stride;
-        for(unsigned long i = 1; i < size; ++i)
-        {
-            for(unsigned long d = 0; d < dim; ++d)
-            {
-                if (maxTab[d] < tab[p+d]) maxTab[d] = tab[p+d];
-                if (minTab[d] > tab[p+d]) minTab[d] = tab[p+d];
-            }
-            p += stride;
-        }
+        ComputeVectorBounds(tab, size, dim, stride, minTab, maxTab);
 
         if (quantMode == O3DGC_SC3DMC_DIAG_BB)
         {
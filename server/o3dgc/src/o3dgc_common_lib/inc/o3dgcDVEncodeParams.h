@@ -38,6 +38,7 @@ namespace o3dgc
                                         m_quantBits         = 10;
                                         m_streamTypeMode    = O3DGC_STREAM_TYPE_ASCII;
                                         m_encodeMode        = O3DGC_DYNAMIC_VECTOR_ENCODE_MODE_LIFT;
+                                        m_binarization      = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
                                     };
         //! Destructor.
                                     ~DVEncodeParams(void) {};
@@ -45,17 +46,20 @@ namespace o3dgc
         unsigned long               GetQuantBits()     const { return m_quantBits;}
         O3DGCStreamType             GetStreamType()    const { return m_streamTypeMode;}
         O3DGCDVEncodingMode         GetEncodeMode()    const { return m_encodeMode;}
+        O3DGCSC3DMCBinarization     GetBinarization()  const { return m_binarization;}
 
         void                        SetQuantBits   (unsigned long quantBits  ) { m_quantBits = quantBits;}
 
         void                        SetStreamType(O3DGCStreamType     streamTypeMode) { m_streamTypeMode = streamTypeMode;}
         void                        SetEncodeMode(O3DGCDVEncodingMode encodeMode    ) { m_encodeMode     = encodeMode    ;}
+        void                        SetBinarization(O3DGCSC3DMCBinarization binarization) { m_binarization = binarization;}
 
 
     private:
         unsigned long               m_quantBits;
         O3DGCStreamType             m_streamTypeMode;
         O3DGCDVEncodingMode         m_encodeMode;
+        O3DGCSC3DMCBinarization     m_binarization;
     };
 }
 #endif // O3DGC_DV_ENCODE_PARAMS_H
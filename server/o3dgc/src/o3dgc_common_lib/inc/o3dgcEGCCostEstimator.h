@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_EGC_COST_ESTIMATOR_H
+#define O3DGC_EGC_COST_ESTIMATOR_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcModelDictionary.h"
+
+namespace o3dgc
+{
+    const unsigned long O3DGC_EGC_COST_ESTIMATOR_MAX_M       = 1024;
+    const unsigned long O3DGC_EGC_COST_ESTIMATOR_NUM_BINS    = 2 * O3DGC_EGC_COST_ESTIMATOR_MAX_M;
+    const unsigned long O3DGC_EGC_COST_ESTIMATOR_NUM_CLASSES = 8 * sizeof(unsigned long);
+
+    //! Estimates the size of an EncodeIntACEGC()/EncodeUIntACEGC() stream as a function of the escape
+    //! threshold M from the histogram of the values, so that M can be chosen without trial encodings.
+    class EGCCostEstimator
+    {
+    public:    
+        //! Constructor.
+                                    EGCCostEstimator(void) { Clear(); };
+        //! Destructor.
+                                    ~EGCCostEstimator(void) {};
+        void                        Clear();
+        void                        AddUInt(unsigned long value)
+                                    {
+                                        if (value < O3DGC_EGC_COST_ESTIMATOR_NUM_BINS)
+                                        {
+                                            ++m_histogram[value];
+                                        }
+                                        else
+                                        {
+                                            ++m_classes[FloorLog2(value)];
+                                        }
+                                        ++m_numValues;
+                                    }
+        void                        AddInt(long value) { AddUInt(IntToUInt(value)); }
+        unsigned long               GetNumValues() const { return m_numValues; }
+        //! Estimated number of bits with a model of M+2 symbols (M <= O3DGC_EGC_COST_ESTIMATOR_MAX_M). Adaptive models
+        //! start from the prior counts of the entry of dictionary when SeedModel() would seed them.
+        double                      GetCost(unsigned long M, 
+                                            O3DGCSC3DMCEntropyModel entropyModel = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE,
+                                            O3DGCModelDictionary dictionary = O3DGC_MODEL_DICTIONARY_NONE,
+                                            O3DGCModelDictionaryEntry entry = O3DGC_MODEL_DICTIONARY_ENTRY_NONE) const;
+        //! Cheapest M among the powers of two not greater than maxM, and maxM itself.
+        unsigned long               GetBestM(unsigned long maxM, 
+                                             O3DGCSC3DMCEntropyModel entropyModel = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE,
+                                             O3DGCModelDictionary dictionary = O3DGC_MODEL_DICTIONARY_NONE,
+                                             O3DGCModelDictionaryEntry entry = O3DGC_MODEL_DICTIONARY_ENTRY_NONE) const;
+
+    private:
+        static unsigned long        FloorLog2(unsigned long value)
+                                    {
+                                        unsigned long n = 0;
+                                        while (value >>= 1)
+                                        {
+                                            ++n;
+                                        }
+                                        return n;
+                                    }
+        unsigned long               m_histogram[O3DGC_EGC_COST_ESTIMATOR_NUM_BINS];
+        unsigned long               m_classes  [O3DGC_EGC_COST_ESTIMATOR_NUM_CLASSES];  // values >= NUM_BINS by floor(log2)
+        unsigned long               m_numValues;
+    };
+}
+#endif // O3DGC_EGC_COST_ESTIMATOR_H
+
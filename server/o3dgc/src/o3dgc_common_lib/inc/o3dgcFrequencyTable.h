@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_FREQUENCY_TABLE_H
+#define O3DGC_FREQUENCY_TABLE_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcArithmeticCodec.h"
+
+namespace o3dgc
+{
+    //! Semi-static entropy coding: the symbol counts of a stream are gathered in a first pass and sent
+    //! ahead of the symbols, which are then coded with Static_Data_Model/Static_Bit_Model.
+
+    //! Scales a histogram down until its total fits in AC__MaxFrequencyTotal. Symbols that occur keep a count of one.
+    inline void ReduceFrequencies(const unsigned long * const histogram,
+                                  unsigned long numSymbols,
+                                  unsigned * const frequencies)
+    {
+        unsigned long total = 0;
+        unsigned long shift = 0;
+        for(unsigned long s = 0; s < numSymbols; ++s)
+        {
+            total += histogram[s];
+        }
+        while ((total >> shift) + numSymbols > AC__MaxFrequencyTotal)
+        {
+            ++shift;
+        }
+        for(unsigned long s = 0; s < numSymbols; ++s)
+        {
+            frequencies[s] = (unsigned) (histogram[s] >> shift);
+            if (frequencies[s] == 0 && histogram[s] > 0)
+            {
+                frequencies[s] = 1;
+            }
+        }
+    }
+    //! Writes the frequencies up to the last symbol that occurs.
+    template <class Codec>
+    inline void EncodeFrequencies(Codec & ace,
+                                  const unsigned * const frequencies,
+                                  unsigned long numSymbols,
+                                  Static_Bit_Model & bModel0,
+                                  Adaptive_Bit_Model & bModel1)
+    {
+        unsigned long numUsedSymbols = numSymbols;
+        while (numUsedSymbols > 0 && frequencies[numUsedSymbols-1] == 0)
+        {
+            --numUsedSymbols;
+        }
+        ace.ExpGolombEncode(numUsedSymbols, 0, bModel0, bModel1);
+        for(unsigned long s = 0; s < numUsedSymbols; ++s)
+        {
+            ace.ExpGolombEncode(frequencies[s], 0, bModel0, bModel1);
+        }
+    }
+    template <class Codec>
+    inline O3DGCErrorCode DecodeFrequencies(Codec & acd,
+                                            unsigned * const frequencies,
+                                            unsigned long numSymbols,
+                                            Static_Bit_Model & bModel0,
+                                            Adaptive_Bit_Model & bModel1)
+    {
+        unsigned long numUsedSymbols = acd.ExpGolombDecode(0, bModel0, bModel1);
+        unsigned long total = 0;
+        if (numUsedSymbols > numSymbols)
+        {
+            return O3DGC_ERROR_CORRUPTED_STREAM;
+        }
+        for(unsigned long s = 0; s < numSymbols; ++s)
+        {
+            frequencies[s] = (s < numUsedSymbols) ? acd.ExpGolombDecode(0, bModel0, bModel1) : 0;
+            if (frequencies[s] > AC__MaxFrequencyTotal)
+            {
+                return O3DGC_ERROR_CORRUPTED_STREAM;
+            }
+            total += frequencies[s];
+            if (total > AC__MaxFrequencyTotal)
+            {
+                return O3DGC_ERROR_CORRUPTED_STREAM;
+            }
+        }
+        return O3DGC_OK;
+    }
+    //! Builds the model of a two-symbol frequency table (an empty table gives p0 = 0.5).
+    inline void SetFrequencies(Static_Bit_Model & bModel, const unsigned * const frequencies)
+    {
+        if (frequencies[0] + frequencies[1] == 0)
+        {
+            bModel.set_frequencies(1, 2);
+        }
+        else
+        {
+            bModel.set_frequencies(frequencies[0], frequencies[0] + frequencies[1]);
+        }
+    }
+}
+#endif // O3DGC_FREQUENCY_TABLE_H
+
@@ -0,0 +1,62 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_MAPPED_FILE_H
+#define O3DGC_MAPPED_FILE_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcBinaryStream.h"
+
+namespace o3dgc
+{
+    //! Read-only memory mapping of a file, e.g. to decode a .s3d file with BinaryStream::AttachBuffer()
+    //! without reading it into memory first.
+    class MappedFile
+    {
+    public:    
+        //! Constructor.
+                                    MappedFile(void);
+        //! Destructor.
+                                    ~MappedFile(void);
+        O3DGCErrorCode              Open(const char * const fileName);
+        void                        Close();
+        const unsigned char * const GetBuffer() const { return m_buffer; }
+        unsigned long               GetSize() const { return m_size; }
+        //! Wraps the mapping in bstream. The file must stay open while bstream is used.
+        void                        Attach(BinaryStream & bstream) const { bstream.AttachBuffer(m_buffer, m_size); }
+
+    private:
+                                    MappedFile(const MappedFile &);
+        MappedFile &                operator=(const MappedFile &);
+
+        const unsigned char *       m_buffer;
+        unsigned long               m_size;
+#ifdef WIN32
+        void *                      m_file;
+        void *                      m_mapping;
+#endif
+    };
+}
+#endif // O3DGC_MAPPED_FILE_H
+
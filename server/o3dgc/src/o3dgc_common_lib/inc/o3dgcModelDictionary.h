@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_MODEL_DICTIONARY_H
+#define O3DGC_MODEL_DICTIONARY_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcArithmeticCodec.h"
+
+namespace o3dgc
+{
+    //! Adaptive models that can be seeded from a model dictionary.
+    enum O3DGCModelDictionaryEntry
+    {
+        O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_NUM_TFANS      = 0,
+        O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_DEGREES        = 1,
+        O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_CONFIGS        = 2,
+        O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_OPERATIONS     = 3,
+        O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_INDICES        = 4,
+        O3DGC_MODEL_DICTIONARY_ENTRY_NORMAL_ORIENTATIONS = 5,
+        O3DGC_MODEL_DICTIONARY_ENTRY_PREDICTORS          = 6,
+        O3DGC_MODEL_DICTIONARY_ENTRY_POSITION_VALUES     = 7,
+        O3DGC_MODEL_DICTIONARY_ENTRY_NORMAL_VALUES       = 8,
+        O3DGC_MODEL_DICTIONARY_ENTRY_COLOR_VALUES        = 9,
+        O3DGC_MODEL_DICTIONARY_ENTRY_TEXCOORD_VALUES     = 10,
+        O3DGC_MODEL_DICTIONARY_ENTRY_WEIGHT_VALUES       = 11,
+        O3DGC_MODEL_DICTIONARY_NUM_ENTRIES               = 12,
+        O3DGC_MODEL_DICTIONARY_ENTRY_NONE                = O3DGC_MODEL_DICTIONARY_NUM_ENTRIES   // not seeded
+    };
+    //! Returns the entry holding the prediction residuals of a float attribute type.
+    inline O3DGCModelDictionaryEntry GetModelDictionaryValuesEntry(O3DGCIFSFloatAttributeType type)
+    {
+        switch(type)
+        {
+        case O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_POSITION: return O3DGC_MODEL_DICTIONARY_ENTRY_POSITION_VALUES;
+        case O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_NORMAL:   return O3DGC_MODEL_DICTIONARY_ENTRY_NORMAL_VALUES;
+        case O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_COLOR:    return O3DGC_MODEL_DICTIONARY_ENTRY_COLOR_VALUES;
+        case O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_TEXCOORD: return O3DGC_MODEL_DICTIONARY_ENTRY_TEXCOORD_VALUES;
+        case O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_WEIGHT:   return O3DGC_MODEL_DICTIONARY_ENTRY_WEIGHT_VALUES;
+        default:                                      return O3DGC_MODEL_DICTIONARY_ENTRY_NONE;
+        }
+    }
+    //! Returns true if the library ships the dictionary (O3DGC_MODEL_DICTIONARY_NONE included).
+    bool IsValidModelDictionary(unsigned long dictionary);
+    //! Returns the prior counts stored for entry and sets numCounts to their number, or returns 0 if there are none.
+    const unsigned short * GetModelDictionaryCounts(O3DGCModelDictionary dictionary, 
+                                                    O3DGCModelDictionaryEntry entry, 
+                                                    unsigned long & numCounts);
+    //! Initializes model with the prior counts stored for entry; leaves it equiprobable if there are none.
+    //! Models with dictionary O3DGC_MODEL_DICTIONARY_NONE, or with fewer symbols than counts, are left untouched.
+    bool SeedModel(O3DGCModelDictionary dictionary, 
+                   O3DGCModelDictionaryEntry entry, 
+                   Adaptive_Data_Model & model);
+    bool SeedModel(O3DGCModelDictionary dictionary, 
+                   O3DGCModelDictionaryEntry entry, 
+                   Adaptive_Bit_Model & model);
+}
+#endif // O3DGC_MODEL_DICTIONARY_H
+
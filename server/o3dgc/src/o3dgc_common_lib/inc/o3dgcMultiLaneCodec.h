@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_MULTI_LANE_CODEC_H
+#define O3DGC_MULTI_LANE_CODEC_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcArithmeticCodec.h"
+
+namespace o3dgc
+{
+    //! Distributes prediction residuals round-robin over up to O3DGC_SC3DMC_MAX_NUM_LANES independent
+    //! codecs, each with its own models, so that consecutive symbols do not depend on each other.
+    //! Lane 0 uses the codec and models provided by the caller.
+    template <class Codec, class Model = Adaptive_Data_Model>
+    class MultiLaneCodec
+    {
+    public:    
+        //! Constructor.
+                                    MultiLaneCodec(Codec & codec0,
+                                                   Model & mModelValues0,
+                                                   Static_Bit_Model & bModel00,
+                                                   Adaptive_Bit_Model & bModel10)
+                                    {
+                                        m_numLanes        = 1;
+                                        m_lane            = 0;
+                                        m_codecs[0]       = &codec0;
+                                        m_mModelValues[0] = &mModelValues0;
+                                        m_bModel0[0]      = &bModel00;
+                                        m_bModel1[0]      = &bModel10;
+                                        for(unsigned long l = 1; l < O3DGC_SC3DMC_MAX_NUM_LANES; ++l)
+                                        {
+                                            m_codecs[l]       = &m_laneCodecs[l-1];
+                                            m_mModelValues[l] = &m_laneModelValues[l-1];
+                                            m_bModel0[l]      = &m_laneBModel0[l-1];
+                                            m_bModel1[l]      = &m_laneBModel1[l-1];
+                                        }
+                                    };
+        //! Destructor.
+                                    ~MultiLaneCodec(void) {};
+        O3DGCErrorCode              Init(unsigned long numLanes)
+                                    {
+                                        assert(numLanes > 0 && numLanes <= O3DGC_SC3DMC_MAX_NUM_LANES);
+                                        m_numLanes = numLanes;
+                                        m_lane     = 0;
+                                        return O3DGC_OK;
+                                    }
+        //! Static models carry no state: all the lanes can use the model of lane 0.
+        void                        ShareModelValues()
+                                    {
+                                        for(unsigned long l = 1; l < O3DGC_SC3DMC_MAX_NUM_LANES; ++l)
+                                        {
+                                            m_mModelValues[l] = m_mModelValues[0];
+                                        }
+                                    }
+        unsigned long               GetNumLanes() const { return m_numLanes; }
+        //! Lane of the next value.
+        unsigned long               GetLane() const { return m_lane; }
+        Codec &                     GetCodec(unsigned long l) { assert(l < m_numLanes); return *m_codecs[l]; }
+        Model &                     GetModelValues(unsigned long l) { assert(l < m_numLanes); return *m_mModelValues[l]; }
+        void                        EncodeInt(long predResidual, const unsigned long M)
+                                    {
+                                        EncodeIntACEGC(predResidual, *m_codecs[m_lane], *m_mModelValues[m_lane], 
+                                                       *m_bModel0[m_lane], *m_bModel1[m_lane], M);
+                                        NextLane();
+                                    }
+        void                        EncodeUInt(long predResidual, const unsigned long M)
+                                    {
+                                        EncodeUIntACEGC(predResidual, *m_codecs[m_lane], *m_mModelValues[m_lane], 
+                                                        *m_bModel0[m_lane], *m_bModel1[m_lane], M);
+                                        NextLane();
+                                    }
+        long                        DecodeInt(const unsigned long exp_k, const unsigned long M)
+                                    {
+                                        long value = DecodeIntACEGC(*m_codecs[m_lane], *m_mModelValues[m_lane], 
+                                                                    *m_bModel0[m_lane], *m_bModel1[m_lane], exp_k, M);
+                                        NextLane();
+                                        return value;
+                                    }
+        unsigned long               DecodeUInt(const unsigned long exp_k, const unsigned long M)
+                                    {
+                                        unsigned long value = DecodeUIntACEGC(*m_codecs[m_lane], *m_mModelValues[m_lane], 
+                                                                              *m_bModel0[m_lane], *m_bModel1[m_lane], exp_k, M);
+                                        NextLane();
+                                        return value;
+                                    }
+        //! Decodes count values, one from each of the lanes GetLane(), ..., GetLane() + count - 1: the lanes are 
+        //! independent, so that their decoding can overlap.
+        void                        DecodeInts(long * const values, unsigned long count, 
+                                               const unsigned long exp_k, const unsigned long M)
+                                    {
+                                        assert(m_lane + count <= m_numLanes);
+                                        for(unsigned long i = 0, l = m_lane; i < count; ++i, ++l)
+                                        {
+                                            values[i] = DecodeIntACEGC(*m_codecs[l], *m_mModelValues[l], 
+                                                                       *m_bModel0[l], *m_bModel1[l], exp_k, M);
+                                        }
+                                        SkipLanes(count);
+                                    }
+        //! Unsigned version of DecodeInts().
+        void                        DecodeUInts(long * const values, unsigned long count, 
+                                                const unsigned long exp_k, const unsigned long M)
+                                    {
+                                        assert(m_lane + count <= m_numLanes);
+                                        for(unsigned long i = 0, l = m_lane; i < count; ++i, ++l)
+                                        {
+                                            values[i] = (long) DecodeUIntACEGC(*m_codecs[l], *m_mModelValues[l], 
+                                                                               *m_bModel0[l], *m_bModel1[l], exp_k, M);
+                                        }
+                                        SkipLanes(count);
+                                    }
+
+    private:
+        void                        SkipLanes(unsigned long count)
+                                    {
+                                        m_lane += count;
+                                        if (m_lane == m_numLanes)
+                                        {
+                                            m_lane = 0;
+                                        }
+                                    }
+        void                        NextLane()
+                                    {
+                                        if (++m_lane == m_numLanes)
+                                        {
+                                            m_lane = 0;
+                                        }
+                                    }
+        unsigned long               m_numLanes;
+        unsigned long               m_lane;
+        Codec *                     m_codecs      [O3DGC_SC3DMC_MAX_NUM_LANES];
+        Model *                     m_mModelValues[O3DGC_SC3DMC_MAX_NUM_LANES];
+        Static_Bit_Model *          m_bModel0     [O3DGC_SC3DMC_MAX_NUM_LANES];
+        Adaptive_Bit_Model *        m_bModel1     [O3DGC_SC3DMC_MAX_NUM_LANES];
+        Codec                       m_laneCodecs     [O3DGC_SC3DMC_MAX_NUM_LANES-1];
+        Model                       m_laneModelValues[O3DGC_SC3DMC_MAX_NUM_LANES-1];
+        Static_Bit_Model            m_laneBModel0    [O3DGC_SC3DMC_MAX_NUM_LANES-1];
+        Adaptive_Bit_Model          m_laneBModel1    [O3DGC_SC3DMC_MAX_NUM_LANES-1];
+    };
+}
+#endif // O3DGC_MULTI_LANE_CODEC_H
+
@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_RANS_CODEC_H
+#define O3DGC_RANS_CODEC_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcArithmeticCodec.h"
+
+namespace o3dgc
+{
+    const unsigned RANS__NumStates = 4;            // interleaved rANS states
+
+    // Interleaved range ANS coder with byte-wise renormalization. It shares the
+    // probability models of Arithmetic_Codec (all distributions are scaled to
+    // 2^15) and exposes the same interface, so that the coding loops can target
+    // either backend. Symbols are coded round-robin over RANS__NumStates
+    // independent states. rANS is LIFO: the encoder records the (start, freq)
+    // pairs produced by the models and codes them backwards in stop_encoder().
+    // Static models are decoded with one table look-up per symbol; adaptive
+    // models search their distribution as Arithmetic_Codec does. Each stream
+    // ends with the RANS__NumStates final states (16 bytes), which makes small
+    // streams larger than with Arithmetic_Codec, the default.
+
+    class RANS_Codec
+    {
+    public:
+
+      RANS_Codec(void);
+     ~RANS_Codec(void);
+      RANS_Codec(unsigned max_code_bytes,
+                 unsigned char * user_buffer = 0);               // 0 = assign new
+
+      unsigned char * buffer(void) { return code_buffer; }
+
+      void set_buffer(unsigned max_code_bytes,
+                      unsigned char * user_buffer = 0);          // 0 = assign new
+
+      void     start_encoder(void);
+      void     start_decoder(void);
+
+      unsigned stop_encoder(void);                 // returns number of bytes used
+      void     stop_decoder(void);
+
+      void     encode(unsigned bit,
+                      Static_Bit_Model &);
+      unsigned decode(Static_Bit_Model &);
+
+      void     encode(unsigned data,
+                      Static_Data_Model &);
+      unsigned decode(Static_Data_Model &);
+
+      void     encode(unsigned bit,
+                      Adaptive_Bit_Model &);
+      unsigned decode(Adaptive_Bit_Model &);
+
+      void     encode(unsigned data,
+                      Adaptive_Data_Model &);
+      unsigned decode(Adaptive_Data_Model &);
+
+      void     ExpGolombEncode(unsigned int symbol,
+                               int k,
+                               Static_Bit_Model & bModel0,
+                               Adaptive_Bit_Model & bModel1)
+               {
+                   while(1)
+                   {
+                       if (symbol >= (unsigned int)(1<<k))
+                       {
+                           encode(1, bModel1);
+                           symbol = symbol - (1<<k);
+                           k++;
+                       }
+                       else
+                       {
+                           encode(0, bModel1); // now terminated zero of unary part
+                           while (k--) // next binary part
+                           {
+                               encode((signed short)((symbol>>k)&1), bModel0);
+                           }
+                           break;
+                       }
+                   }
+               }
+      unsigned ExpGolombDecode(int k,
+                               Static_Bit_Model & bModel0,
+                               Adaptive_Bit_Model & bModel1)
+               {
+                   unsigned int l;
+                   int symbol = 0;
+                   int binary_symbol = 0;
+                   do
+                   {
+                       l=decode(bModel1);
+                       if (l==1)
+                       {
+                           symbol += (1<<k);
+                           k++;
+                        }
+                   }
+                   while (l!=0);
+                   while (k--)                             //next binary part
+                   if (decode(bModel0)==1)
+                   {
+                       binary_symbol |= (1<<k);
+                   }
+                   return (unsigned int) (symbol+binary_symbol);
+                }
+
+    private:  //  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .  .
+      void     put_symbol(unsigned start, unsigned freq);
+      unsigned get_slot(void);
+      void     advance(unsigned slot, unsigned start, unsigned freq);
+      unsigned char * code_buffer, * new_buffer, * rans_pointer;
+      unsigned * symbol_buffer;                  // (start, freq) pairs to encode
+      unsigned symbol_count, symbol_buffer_size;
+      unsigned state[RANS__NumStates], lane;               // rANS coding state
+      unsigned buffer_size, mode;     // mode: 0 = undef, 1 = encoder, 2 = decoder
+    };
+}
+#endif // O3DGC_RANS_CODEC_H
+
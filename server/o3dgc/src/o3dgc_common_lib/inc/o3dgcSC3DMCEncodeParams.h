@@ -26,6 +26,7 @@ THE SOFTWARE.
 #define O3DGC_SC3DMC_ENCODE_PARAMS_H
 
 #include "o3dgcCommon.h"
+#include "o3dgcThreads.h"
 
 namespace o3dgc
 {
@@ -38,8 +39,16 @@ namespace o3dgc
                                         memset(this, 0, sizeof(SC3DMCEncodeParams));
                                         m_encodeMode        = O3DGC_SC3DMC_ENCODE_MODE_TFAN;
                                         m_streamTypeMode    = O3DGC_STREAM_TYPE_ASCII;
+                                        m_binarization      = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+                                        m_numLanes          = 1;
+                                        m_numThreads        = 1;
+                                        m_numSegments       = 1;
+                                        m_clusterSize       = 0;
+                                        m_modelDictionary   = O3DGC_MODEL_DICTIONARY_NONE;
+                                        m_entropyModel      = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE;
                                         m_coordQuantBits    = 14;
                                         m_normalQuantBits   = 8;
+                                        m_textureSize       = 1024;
                                         m_coordPredMode     = O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION;
                                         m_normalPredMode    = O3DGC_SC3DMC_SURF_NORMALS_PREDICTION;
                                         for(unsigned long a = 0; a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES; ++a)
@@ -56,6 +65,14 @@ namespace o3dgc
 
         O3DGCStreamType             GetStreamType()    const { return m_streamTypeMode;}
         O3DGCSC3DMCEncodingMode     GetEncodeMode()    const { return m_encodeMode;}
+        O3DGCSC3DMCBinarization     GetBinarization()  const { return m_binarization;}
+        unsigned long               GetNumLanes()      const { return m_numLanes;}
+        O3DGCModelDictionary        GetModelDictionary() const { return m_modelDictionary;}
+        O3DGCSC3DMCEntropyModel     GetEntropyModel()  const { return m_entropyModel;}
+        bool                        GetTableOfContents() const { return m_tableOfContents;}
+        unsigned long               GetNumThreads()    const { return m_numThreads;}
+        unsigned long               GetNumSegments()   const { return m_numSegments;}
+        unsigned long               GetClusterSize()   const { return m_clusterSize;}
 
         unsigned long               GetNumFloatAttributes() const { return m_numFloatAttributes;}
         unsigned long               GetNumIntAttributes()   const { return m_numIntAttributes;}
@@ -66,6 +83,11 @@ namespace o3dgc
                                        assert(a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES);
                                        return m_floatAttributeQuantBits[a];
                                     }
+        Real                        GetCoordMaxError()      const { return m_coordMaxError;}
+        Real                        GetNormalMaxError()     const { return m_normalMaxError;}
+        Real                        GetTexCoordMaxError()   const { return m_texCoordMaxError;}
+        unsigned long               GetTextureSize()        const { return m_textureSize;}
+        unsigned long               GetMaxStreamSize()      const { return m_maxStreamSize;}
         O3DGCSC3DMCPredictionMode   GetCoordPredMode()    const { return m_coordPredMode; }
         O3DGCSC3DMCPredictionMode   GetNormalPredMode()   const { return m_normalPredMode; }
         O3DGCSC3DMCPredictionMode   GetFloatAttributePredMode(unsigned long a) const
@@ -92,6 +114,37 @@ namespace o3dgc
                                     }
         void                        SetStreamType(O3DGCStreamType streamTypeMode)  { m_streamTypeMode = streamTypeMode;}
         void                        SetEncodeMode(O3DGCSC3DMCEncodingMode encodeMode)  { m_encodeMode = encodeMode;}
+        void                        SetBinarization(O3DGCSC3DMCBinarization binarization)  { m_binarization = binarization;}
+        //! Number of independent codecs the float attribute residuals are interleaved over (1 = single codec).
+        void                        SetNumLanes(unsigned long numLanes)
+                                    {
+                                        assert(numLanes > 0 && numLanes <= O3DGC_SC3DMC_MAX_NUM_LANES);
+                                        m_numLanes = numLanes;
+                                    }
+        //! Pre-trained models used to seed the adaptive models of meshes with at most O3DGC_SC3DMC_MODEL_DICTIONARY_MAX_VERTICES vertices.
+        void                        SetModelDictionary(O3DGCModelDictionary modelDictionary)  { m_modelDictionary = modelDictionary;}
+        //! Semi-static models trade a slower two-pass encoder for a decoder without model updates.
+        void                        SetEntropyModel(O3DGCSC3DMCEntropyModel entropyModel)  { m_entropyModel = entropyModel;}
+        //! Writes the offset and size of every section after the header, for random access and selective decoding.
+        void                        SetTableOfContents(bool tableOfContents)  { m_tableOfContents = tableOfContents;}
+        //! Number of worker threads (0: one per processor). The stream does not depend on it.
+        void                        SetNumThreads(unsigned long numThreads)
+                                    {
+                                        assert(numThreads <= O3DGC_MAX_NUM_THREADS);
+                                        m_numThreads = numThreads;
+                                    }
+        //! Splits the connected components into at most numSegments independently decodable segments of balanced
+        //! triangle counts, which are encoded and decoded concurrently. Meshes with a single component, index
+        //! buffers or attributes not defined per vertex are not segmented.
+        void                        SetNumSegments(unsigned long numSegments)
+                                    {
+                                        assert(numSegments > 0);
+                                        m_numSegments = numSegments;
+                                    }
+        //! Splits the triangles into spatial clusters of at most clusterSize triangles (0: disabled), with a k-d tree
+        //! over the triangle centroids. The clusters are segments whose bounding boxes allow a region of interest to be
+        //! decoded; the vertices shared by several clusters are duplicated. Overrides SetNumSegments().
+        void                        SetClusterSize(unsigned long clusterSize) { m_clusterSize = clusterSize;}
         void                        SetNumFloatAttributes(unsigned long numFloatAttributes) 
                                     { 
                                         assert(numFloatAttributes < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES);
@@ -109,6 +162,25 @@ namespace o3dgc
                                        assert(a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES);
                                        m_floatAttributeQuantBits[a] = q;
                                     }
+        //! The encoder chooses the fewest coord quantization bits keeping the position error below maxError times 
+        //! the bounding box diagonal (0: SetCoordQuantBits() is used).
+        void                        SetCoordMaxError(Real maxError) { m_coordMaxError = maxError;}
+        //! The encoder chooses the fewest normal quantization bits keeping the angle between the original and decoded
+        //! normals below maxError radians (0: SetNormalQuantBits() is used).
+        void                        SetNormalMaxError(Real maxError) { m_normalMaxError = maxError;}
+        //! The encoder chooses the fewest quantization bits of each O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_TEXCOORD attribute 
+        //! keeping the error below maxError texels of a texture of SetTextureSize() texels (0: 
+        //! SetFloatAttributeQuantBits() is used).
+        void                        SetTexCoordMaxError(Real maxError) { m_texCoordMaxError = maxError;}
+        void                        SetTextureSize(unsigned long textureSize)
+                                    {
+                                        assert(textureSize > 0);
+                                        m_textureSize = textureSize;
+                                    }
+        //! Lowers the quantization bits of all the float attributes by the fewest bits fitting the stream in 
+        //! maxStreamSize bytes (0: no budget). The encoder binary-searches the bits, encoding the mesh several times.
+        //! SC3DMCStats::m_maxStreamSizeExceeded reports a budget that could not be met.
+        void                        SetMaxStreamSize(unsigned long maxStreamSize) { m_maxStreamSize = maxStreamSize;}
         void                        SetCoordPredMode   (O3DGCSC3DMCPredictionMode coordPredMode   ) { m_coordPredMode    = coordPredMode   ; }
         void                        SetNormalPredMode  (O3DGCSC3DMCPredictionMode normalPredMode  ) { m_normalPredMode   = normalPredMode  ; }
         void                        SetFloatAttributePredMode(unsigned long a, O3DGCSC3DMCPredictionMode p) 
@@ -127,6 +199,11 @@ namespace o3dgc
         unsigned long               m_coordQuantBits;
         unsigned long               m_normalQuantBits;
         unsigned long               m_floatAttributeQuantBits[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
+        Real                        m_coordMaxError;
+        Real                        m_normalMaxError;
+        Real                        m_texCoordMaxError;
+        unsigned long               m_textureSize;
+        unsigned long               m_maxStreamSize;
         
         O3DGCSC3DMCPredictionMode   m_coordPredMode;
         O3DGCSC3DMCPredictionMode   m_normalPredMode; 
@@ -134,6 +211,14 @@ namespace o3dgc
         O3DGCSC3DMCPredictionMode   m_intAttributePredMode  [O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES];
         O3DGCStreamType             m_streamTypeMode;
         O3DGCSC3DMCEncodingMode     m_encodeMode;
+        O3DGCSC3DMCBinarization     m_binarization;
+        unsigned long               m_numLanes;
+        O3DGCModelDictionary        m_modelDictionary;
+        O3DGCSC3DMCEntropyModel     m_entropyModel;
+        bool                        m_tableOfContents;
+        unsigned long               m_numThreads;
+        unsigned long               m_numSegments;
+        unsigned long               m_clusterSize;
     };
 }
 #endif // O3DGC_SC3DMC_ENCODE_PARAMS_H
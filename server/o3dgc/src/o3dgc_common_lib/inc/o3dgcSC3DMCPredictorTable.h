@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_SC3DMC_PREDICTOR_TABLE_H
+#define O3DGC_SC3DMC_PREDICTOR_TABLE_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcVector.h"
+#include "o3dgcAdjacencyInfo.h"
+
+namespace o3dgc
+{
+    //! Prediction candidates of each vertex in traversal order, computed once from the connectivity and shared by
+    //! all the attributes predicted with the same mode. Candidate p of vertex vm is stored as the vertices (a, b, c)
+    //! of the parallelogram a + b - c, or (w, -1, -1) for the already visited neighbor w, in the order of Insert().
+    class SC3DMCPredictorTable
+    {
+    public:    
+        //! Constructor.
+                                    SC3DMCPredictorTable(void) { m_valid = false;};
+        //! Destructor.
+                                    ~SC3DMCPredictorTable(void) {};
+        //! vmap gives the traversal order of each vertex (0: the vertices are numbered in traversal order).
+        template <class T>
+        void                        Build(const AdjacencyInfo & v2T,
+                                          const T * const triangles,
+                                          const Index * const vmap,
+                                          const Index * const invVMap,
+                                          long numVertices,
+                                          bool parallelogram);
+        void                        Clear() { m_valid = false;}
+        bool                        IsValid() const { return m_valid;}
+        unsigned long               GetNumPredictors(long vm) const { return m_numPredictors[vm];}
+        const Index * const         GetPredictors(long vm) const 
+                                    { 
+                                        return m_predictors.GetBuffer() + 3 * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * vm;
+                                    }
+
+    private:
+        Vector<unsigned char>       m_numPredictors;
+        Vector<Index>               m_predictors;
+        bool                        m_valid;
+    };
+}
+#include "o3dgcSC3DMCPredictorTable.inl"    // template implementation
+#endif // O3DGC_SC3DMC_PREDICTOR_TABLE_H
@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#ifndef O3DGC_SC3DMC_PREDICTOR_TABLE_INL
+#define O3DGC_SC3DMC_PREDICTOR_TABLE_INL
+
+namespace o3dgc
+{
+    template <class T>
+    void SC3DMCPredictorTable::Build(const AdjacencyInfo & v2T,
+                                     const T * const triangles,
+                                     const Index * const vmap,
+                                     const Index * const invVMap,
+                                     long numVertices,
+                                     bool parallelogram)
+    {
+        const unsigned long maxNumPredictors = O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS;
+        m_numPredictors.Allocate(numVertices);
+        m_numPredictors.SetSize(numVertices);
+        m_predictors.Allocate(3 * maxNumPredictors * numVertices);
+        m_predictors.SetSize(3 * maxNumPredictors * numVertices);
+        // the candidates are sorted by Insert(), the vertices of each one travelling in m_pred[0..2]
+        SC3DMCPredictor neighbors[O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
+        unsigned long nPred;
+        for (long vm = 0; vm < numVertices; ++vm) 
+        {
+            nPred        = 0;
+            const long v = (invVMap) ? invVMap[vm] : vm;
+            const int u0 = v2T.Begin(v);
+            const int u1 = v2T.End(v);
+            for (long u = u0; u < u1; u++) 
+            {
+                const long ta = v2T.GetNeighbor(u);
+                if (ta < 0)
+                {
+                    break;
+                }
+                if (parallelogram)
+                {
+                    long a,b;
+                    if ((long) triangles[ta*3] == v)
+                    {
+                        a = (long) triangles[ta*3 + 1];
+                        b = (long) triangles[ta*3 + 2];
+                    }
+                    else if ((long) triangles[ta*3 + 1] == v)
+                    {
+                        a = (long) triangles[ta*3 + 0];
+                        b = (long) triangles[ta*3 + 2];
+                    }
+                    else
+                    {
+                        a = (long) triangles[ta*3 + 0];
+                        b = (long) triangles[ta*3 + 1];
+                    }
+                    const long ma = (vmap) ? vmap[a] : a;
+                    const long mb = (vmap) ? vmap[b] : b;
+                    if (ma < vm && mb < vm)
+                    {
+                        const int w0 = v2T.Begin(a);
+                        const int w1 = v2T.End(a);
+                        for (long w = w0; w < w1; w++) 
+                        {
+                            const long tb = v2T.GetNeighbor(w);
+                            if (tb < 0)
+                            {
+                                break;
+                            }
+                            long c = -1;
+                            bool foundB = false;
+                            for(long k = 0; k < 3; ++k)
+                            {
+                                const long x = (long) triangles[tb*3 + k];
+                                if (x == b)
+                                {
+                                    foundB = true;
+                                }
+                                if (((vmap) ? vmap[x] : x) < vm && x != a && x != b)
+                                {
+                                    c = x;
+                                }
+                            }
+                            if (c != -1 && foundB)
+                            {
+                                SC3DMCTriplet id = {min(ma, mb), max(ma, mb), -((vmap) ? vmap[c] : c)-1};
+                                unsigned long p = Insert(id, nPred, neighbors);
+                                if (p != 0xFFFFFFFF)
+                                {
+                                    neighbors[p].m_pred[0] = a;
+                                    neighbors[p].m_pred[1] = b;
+                                    neighbors[p].m_pred[2] = c;
+                                }
+                            }
+                        }
+                    }
+                }
+                for(long k = 0; k < 3; ++k)
+                {
+                    const long w  = (long) triangles[ta*3 + k];
+                    const long mw = (vmap) ? vmap[w] : w;
+                    if (mw < vm)
+                    {
+                        SC3DMCTriplet id = {-1, -1, mw};
+                        unsigned long p = Insert(id, nPred, neighbors);
+                        if (p != 0xFFFFFFFF)
+                        {
+                            neighbors[p].m_pred[0] = w;
+                            neighbors[p].m_pred[1] = -1;
+                            neighbors[p].m_pred[2] = -1;
+                        }
+                    }
+                }
+            }
+            m_numPredictors[vm] = (unsigned char) nPred;
+            Index * const predictors = m_predictors.GetBuffer() + 3 * maxNumPredictors * vm;
+            for (unsigned long p = 0; p < nPred; ++p)
+            {
+                predictors[3 * p    ] = (Index) neighbors[p].m_pred[0];
+                predictors[3 * p + 1] = (Index) neighbors[p].m_pred[1];
+                predictors[3 * p + 2] = (Index) neighbors[p].m_pred[2];
+            }
+        }
+        m_valid = true;
+    }
+}
+#endif // O3DGC_SC3DMC_PREDICTOR_TABLE_INL
@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_SC3DMC_SEGMENT_INDEX_H
+#define O3DGC_SC3DMC_SEGMENT_INDEX_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcVector.h"
+#include "o3dgcBinaryStream.h"
+
+namespace o3dgc
+{
+    //! Group of connected components, or spatial cluster of triangles, encoded as a complete SC3DMC stream of its own.
+    class SC3DMCSegment
+    {
+    public:
+        //! True if the bounding box of the segment intersects the box [min, max].
+        bool                        Intersects(const Real * const min, const Real * const max) const
+                                    {
+                                        for(int j = 0; j < 3; ++j)
+                                        {
+                                            if (m_min[j] > max[j] || m_max[j] < min[j])
+                                            {
+                                                return false;
+                                            }
+                                        }
+                                        return true;
+                                    }
+        Real                        m_min[3];           //!< bounding box of the positions of the segment
+        Real                        m_max[3];
+        unsigned long               m_numTriangles;
+        unsigned long               m_numVertices;
+        unsigned long               m_firstTriangle;    //!< position of the segment in the merged triangle list
+        unsigned long               m_firstVertex;      //!< position of the segment in the merged vertex arrays
+        unsigned long               m_offset;           //!< relative to the start code of the enclosing stream
+        unsigned long               m_size;
+    };
+
+    //! Optional index written after the SC3DMC header (markerBit2) of a segmented stream. It is followed by the
+    //! segment streams, which are decoded independently and merged in index order. The bounding box of each
+    //! segment lets a decoder select the segments of a region of interest.
+    class SC3DMCSegmentIndex
+    {
+    public:    
+        //! Constructor.
+                                    SC3DMCSegmentIndex(void) {};
+        //! Destructor.
+                                    ~SC3DMCSegmentIndex(void) {};
+        void                        Init(unsigned long numSegments)
+                                    {
+                                        m_segments.Allocate(numSegments);
+                                        m_segments.SetSize(numSegments);
+                                        memset(m_segments.GetBuffer(), 0, sizeof(SC3DMCSegment) * numSegments);
+                                    }
+        void                        Clear() { m_segments.Clear(); }
+        //! 0 when the stream is not segmented.
+        unsigned long               GetNumSegments() const { return m_segments.GetSize(); }
+        const SC3DMCSegment &       GetSegment(unsigned long s) const { return m_segments[s];}
+        SC3DMCSegment &             GetSegment(unsigned long s)       { return m_segments[s];}
+        //! Appends the index; the sizes of the segments must be known.
+        void                        Save(BinaryStream & bstream, O3DGCStreamType streamType) const
+                                    {
+                                        bstream.WriteUInt32(GetNumSegments(), streamType);
+                                        for(unsigned long s = 0; s < GetNumSegments(); ++s)
+                                        {
+                                            bstream.WriteUInt32(m_segments[s].m_numTriangles, streamType);
+                                            bstream.WriteUInt32(m_segments[s].m_numVertices , streamType);
+                                            bstream.WriteUInt32(m_segments[s].m_size        , streamType);
+                                            for(int j = 0; j < 3; ++j)
+                                            {
+                                                bstream.WriteFloat32((float) m_segments[s].m_min[j], streamType);
+                                                bstream.WriteFloat32((float) m_segments[s].m_max[j], streamType);
+                                            }
+                                        }
+                                    }
+        //! Reads the index of a stream of streamSize bytes starting at streamStart, whose segments must add up to
+        //! numTriangles triangles and numVertices vertices.
+        O3DGCErrorCode              Load(const BinaryStream & bstream, 
+                                         unsigned long & iterator,
+                                         O3DGCStreamType streamType,
+                                         unsigned long streamStart,
+                                         unsigned long streamSize,
+                                         unsigned long numTriangles, 
+                                         unsigned long numVertices)
+                                    {
+                                        const unsigned long numSegments = bstream.ReadUInt32(iterator, streamType);
+                                        if (numSegments > numVertices)
+                                        {
+                                            return O3DGC_ERROR_CORRUPTED_STREAM;
+                                        }
+                                        Init(numSegments);
+                                        unsigned long firstTriangle = 0;
+                                        unsigned long firstVertex   = 0;
+                                        for(unsigned long s = 0; s < numSegments; ++s)
+                                        {
+                                            m_segments[s].m_numTriangles  = bstream.ReadUInt32(iterator, streamType);
+                                            m_segments[s].m_numVertices   = bstream.ReadUInt32(iterator, streamType);
+                                            m_segments[s].m_size          = bstream.ReadUInt32(iterator, streamType);
+                                            for(int j = 0; j < 3; ++j)
+                                            {
+                                                m_segments[s].m_min[j] = (Real) bstream.ReadFloat32(iterator, streamType);
+                                                m_segments[s].m_max[j] = (Real) bstream.ReadFloat32(iterator, streamType);
+                                            }
+                                            m_segments[s].m_firstTriangle = firstTriangle;
+                                            m_segments[s].m_firstVertex   = firstVertex;
+                                            if (m_segments[s].m_numTriangles > numTriangles - firstTriangle ||
+                                                m_segments[s].m_numVertices  > numVertices  - firstVertex)
+                                            {
+                                                return O3DGC_ERROR_CORRUPTED_STREAM;
+                                            }
+                                            firstTriangle += m_segments[s].m_numTriangles;
+                                            firstVertex   += m_segments[s].m_numVertices;
+                                        }
+                                        unsigned long offset = iterator - streamStart;
+                                        for(unsigned long s = 0; s < numSegments; ++s)
+                                        {
+                                            m_segments[s].m_offset = offset;
+                                            if (offset > streamSize || m_segments[s].m_size > streamSize - offset)
+                                            {
+                                                return O3DGC_ERROR_CORRUPTED_STREAM;
+                                            }
+                                            offset += m_segments[s].m_size;
+                                        }
+                                        if (firstTriangle != numTriangles || firstVertex != numVertices)
+                                        {
+                                            return O3DGC_ERROR_CORRUPTED_STREAM;
+                                        }
+                                        return O3DGC_OK;
+                                    }
+        //! Keeps the segments intersecting the box [min, max] only, which are then merged in index order, and 
+        //! returns the number of triangles and vertices they hold.
+        void                        Select(const Real * const min, 
+                                           const Real * const max, 
+                                           unsigned long & numTriangles, 
+                                           unsigned long & numVertices)
+                                    {
+                                        unsigned long numSelected = 0;
+                                        numTriangles = 0;
+                                        numVertices  = 0;
+                                        for(unsigned long s = 0; s < GetNumSegments(); ++s)
+                                        {
+                                            if (m_segments[s].Intersects(min, max))
+                                            {
+                                                m_segments[numSelected]                 = m_segments[s];
+                                                m_segments[numSelected].m_firstTriangle = numTriangles;
+                                                m_segments[numSelected].m_firstVertex   = numVertices;
+                                                numTriangles += m_segments[s].m_numTriangles;
+                                                numVertices  += m_segments[s].m_numVertices;
+                                                ++numSelected;
+                                            }
+                                        }
+                                        m_segments.SetSize(numSelected);
+                                    }
+
+    private:
+        Vector<SC3DMCSegment>       m_segments;
+    };
+}
+#endif // O3DGC_SC3DMC_SEGMENT_INDEX_H
@@ -0,0 +1,244 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_SC3DMC_TABLE_OF_CONTENTS_H
+#define O3DGC_SC3DMC_TABLE_OF_CONTENTS_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcVector.h"
+#include "o3dgcBinaryStream.h"
+
+namespace o3dgc
+{
+    //! Sections of an SC3DMC stream, in stream order: the float attributes follow the normals and are
+    //! followed by the int attributes.
+    const unsigned long O3DGC_SC3DMC_SECTION_CONNECTIVITY      = 0;
+    const unsigned long O3DGC_SC3DMC_SECTION_COORD             = 1;
+    const unsigned long O3DGC_SC3DMC_SECTION_NORMAL            = 2;
+    const unsigned long O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0  = 3;
+
+    //! Size of the stream of section in stats.
+    inline unsigned long & GetSectionStreamSize(SC3DMCStats & stats, unsigned long section, unsigned long numFloatAttributes)
+    {
+        if (section == O3DGC_SC3DMC_SECTION_CONNECTIVITY)
+        {
+            return stats.m_streamSizeCoordIndex;
+        }
+        if (section == O3DGC_SC3DMC_SECTION_COORD)
+        {
+            return stats.m_streamSizeCoord;
+        }
+        if (section == O3DGC_SC3DMC_SECTION_NORMAL)
+        {
+            return stats.m_streamSizeNormal;
+        }
+        if (section < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes)
+        {
+            return stats.m_streamSizeFloatAttribute[section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0];
+        }
+        return stats.m_streamSizeIntAttribute[section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 - numFloatAttributes];
+    }
+    //! Time spent coding section in stats.
+    inline double & GetSectionTime(SC3DMCStats & stats, unsigned long section, unsigned long numFloatAttributes)
+    {
+        if (section == O3DGC_SC3DMC_SECTION_CONNECTIVITY)
+        {
+            return stats.m_timeCoordIndex;
+        }
+        if (section == O3DGC_SC3DMC_SECTION_COORD)
+        {
+            return stats.m_timeCoord;
+        }
+        if (section == O3DGC_SC3DMC_SECTION_NORMAL)
+        {
+            return stats.m_timeNormal;
+        }
+        if (section < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes)
+        {
+            return stats.m_timeFloatAttribute[section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0];
+        }
+        return stats.m_timeIntAttribute[section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 - numFloatAttributes];
+    }
+
+    //! Location of a section, relative to the start code of the stream.
+    class SC3DMCSection
+    {
+    public:
+        unsigned long               m_offset;
+        unsigned long               m_size;
+        unsigned char               m_codec;        //!< binarization in bits 0-2, bit 3 set for semi-static models
+    };
+
+    //! Optional table written after the SC3DMC header (markerBit1), which lets a decoder seek to any section.
+    class SC3DMCTableOfContents
+    {
+    public:    
+        //! Constructor.
+                                    SC3DMCTableOfContents(void) 
+                                    {
+                                        m_numFloatAttributes = 0;
+                                        m_numIntAttributes   = 0;
+                                    };
+        //! Destructor.
+                                    ~SC3DMCTableOfContents(void) {};
+        void                        Init(unsigned long numFloatAttributes, unsigned long numIntAttributes)
+                                    {
+                                        m_numFloatAttributes = numFloatAttributes;
+                                        m_numIntAttributes   = numIntAttributes;
+                                        const unsigned long numSections = O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 +
+                                                                          numFloatAttributes + numIntAttributes;
+                                        m_sections.Allocate(numSections);
+                                        m_sections.SetSize(numSections);
+                                        memset(m_sections.GetBuffer(), 0, sizeof(SC3DMCSection) * numSections);
+                                    }
+        void                        Clear() 
+                                    { 
+                                        m_numFloatAttributes = 0;
+                                        m_numIntAttributes   = 0;
+                                        m_sections.Clear();
+                                    }
+        //! 0 when the stream has no table of contents.
+        unsigned long               GetNumSections() const { return m_sections.GetSize(); }
+        unsigned long               GetFloatAttributeSection(unsigned long a) const
+                                    {
+                                        assert(a < m_numFloatAttributes);
+                                        return O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + a;
+                                    }
+        unsigned long               GetIntAttributeSection(unsigned long a) const
+                                    {
+                                        assert(a < m_numIntAttributes);
+                                        return O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + m_numFloatAttributes + a;
+                                    }
+        const SC3DMCSection &       GetSection(unsigned long s) const { return m_sections[s];}
+        SC3DMCSection &             GetSection(unsigned long s)       { return m_sections[s];}
+        //! Appends the table; the offsets and sizes are usually not known yet and are written later by Update().
+        void                        Save(BinaryStream & bstream, O3DGCStreamType streamType) const
+                                    {
+                                        for(unsigned long s = 0; s < GetNumSections(); ++s)
+                                        {
+                                            bstream.WriteUInt32(m_sections[s].m_offset, streamType);
+                                            bstream.WriteUInt32(m_sections[s].m_size  , streamType);
+                                            bstream.WriteUChar (m_sections[s].m_codec , streamType);
+                                        }
+                                    }
+        //! Overwrites the offsets and sizes of the table saved at position.
+        void                        Update(BinaryStream & bstream, unsigned long position, O3DGCStreamType streamType) const
+                                    {
+                                        const unsigned long sizeUInt32 = (streamType == O3DGC_STREAM_TYPE_ASCII) ? 
+                                                                          O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32 : 4;
+                                        for(unsigned long s = 0; s < GetNumSections(); ++s)
+                                        {
+                                            bstream.WriteUInt32(position, m_sections[s].m_offset, streamType);
+                                            position += sizeUInt32;
+                                            bstream.WriteUInt32(position, m_sections[s].m_size  , streamType);
+                                            position += sizeUInt32 + 1;
+                                        }
+                                    }
+        //! Reads the table of a stream of streamSize bytes.
+        O3DGCErrorCode              Load(const BinaryStream & bstream, 
+                                         unsigned long & iterator,
+                                         O3DGCStreamType streamType,
+                                         unsigned long streamSize,
+                                         unsigned long numFloatAttributes, 
+                                         unsigned long numIntAttributes)
+                                    {
+                                        Init(numFloatAttributes, numIntAttributes);
+                                        for(unsigned long s = 0; s < GetNumSections(); ++s)
+                                        {
+                                            m_sections[s].m_offset = bstream.ReadUInt32(iterator, streamType);
+                                            m_sections[s].m_size   = bstream.ReadUInt32(iterator, streamType);
+                                            m_sections[s].m_codec  = bstream.ReadUChar (iterator, streamType);
+                                            if (m_sections[s].m_offset > streamSize || 
+                                                m_sections[s].m_size   > streamSize - m_sections[s].m_offset)
+                                            {
+                                                return O3DGC_ERROR_CORRUPTED_STREAM;
+                                            }
+                                        }
+                                        return O3DGC_OK;
+                                    }
+
+    private:
+        Vector<SC3DMCSection>       m_sections;
+        unsigned long               m_numFloatAttributes;
+        unsigned long               m_numIntAttributes;
+    };
+
+    //! Sections requested from SC3DMCDecoder::DecodePlayload() (all of them by default).
+    class SC3DMCSectionSelection
+    {
+    public:
+        //! Constructor.
+                                    SC3DMCSectionSelection(bool selectAll = true)
+                                    {
+                                        m_connectivity = selectAll;
+                                        m_coord        = selectAll;
+                                        m_normal       = selectAll;
+                                        for(unsigned long a = 0; a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES; ++a)
+                                        {
+                                            m_floatAttributes[a] = selectAll;
+                                        }
+                                        for(unsigned long a = 0; a < O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES; ++a)
+                                        {
+                                            m_intAttributes[a] = selectAll;
+                                        }
+                                    };
+        //! Destructor.
+                                    ~SC3DMCSectionSelection(void) {};
+        bool                        GetConnectivity() const { return m_connectivity;}
+        bool                        GetCoord()        const { return m_coord;}
+        bool                        GetNormal()       const { return m_normal;}
+        bool                        GetFloatAttribute(unsigned long a) const
+                                    {
+                                        assert(a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES);
+                                        return m_floatAttributes[a];
+                                    }
+        bool                        GetIntAttribute(unsigned long a) const
+                                    {
+                                        assert(a < O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES);
+                                        return m_intAttributes[a];
+                                    }
+        void                        SetConnectivity(bool select) { m_connectivity = select;}
+        void                        SetCoord(bool select)        { m_coord        = select;}
+        void                        SetNormal(bool select)       { m_normal       = select;}
+        void                        SetFloatAttribute(unsigned long a, bool select)
+                                    {
+                                        assert(a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES);
+                                        m_floatAttributes[a] = select;
+                                    }
+        void                        SetIntAttribute(unsigned long a, bool select)
+                                    {
+                                        assert(a < O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES);
+                                        m_intAttributes[a] = select;
+                                    }
+
+    private:
+        bool                        m_connectivity;
+        bool                        m_coord;
+        bool                        m_normal;
+        bool                        m_floatAttributes[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
+        bool                        m_intAttributes  [O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES  ];
+    };
+}
+#endif // O3DGC_SC3DMC_TABLE_OF_CONTENTS_H
+
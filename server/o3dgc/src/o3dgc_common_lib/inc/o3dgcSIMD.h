@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_SIMD_H
+#define O3DGC_SIMD_H
+
+#include "o3dgcCommon.h"
+
+namespace o3dgc
+{
+    enum O3DGCSIMDLevel
+    {
+        O3DGC_SIMD_NONE = 0,    // scalar code
+        O3DGC_SIMD_SSE2 = 1,
+        O3DGC_SIMD_AVX2 = 2
+    };
+
+    //! Best instruction set supported by the processor and the operating system.
+    O3DGCSIMDLevel          GetSupportedSIMDLevel();
+    //! Instruction set of the kernels below: the supported one, unless lowered by SetSIMDLevel().
+    O3DGCSIMDLevel          GetSIMDLevel();
+    //! Selects the instruction set of the kernels, at most the supported one. Not thread safe: call it before 
+    //! encoding or decoding, e.g. to compare the kernels.
+    void                    SetSIMDLevel(O3DGCSIMDLevel level);
+
+    //! Quantizes the dim components of the num vectors of floatArray, spaced by stride, on nQBits bits:
+    //! quant[v * quantStride + d * quantDimStride] = (long)((floatArray[v * stride + d] - min[d]) * delta[d] + 0.5), 
+    //! with delta[d] = (2^nQBits - 1) / (max[d] - min[d]). The results are identical for every instruction set.
+    //! Vectorized for interleaved vectors of 1 to 4 components (stride = quantStride = dim, quantDimStride = 1) 
+    //! and for one array per component (quantStride = 1).
+    void                    QuantizeVectors(const Real * const floatArray,
+                                            unsigned long num,
+                                            unsigned long dim,
+                                            unsigned long stride,
+                                            const Real * const min,
+                                            const Real * const max,
+                                            unsigned long nQBits,
+                                            long * const quant,
+                                            unsigned long quantStride,
+                                            unsigned long quantDimStride);
+    //! Inverse of QuantizeVectors(): 
+    //! floatArray[v * stride + d] = quant[v * quantStride + d * quantDimStride] * idelta[d] + min[d],
+    //! with idelta[d] = (max[d] - min[d]) / (2^nQBits - 1).
+    void                    IQuantizeVectors(const long * const quant,
+                                             unsigned long quantStride,
+                                             unsigned long quantDimStride,
+                                             unsigned long num,
+                                             unsigned long dim,
+                                             const Real * const min,
+                                             const Real * const max,
+                                             unsigned long nQBits,
+                                             Real * const floatArray,
+                                             unsigned long stride);
+}
+#endif // O3DGC_SIMD_H
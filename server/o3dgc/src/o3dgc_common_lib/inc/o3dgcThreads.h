@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_THREADS_H
+#define O3DGC_THREADS_H
+
+#include "o3dgcCommon.h"
+
+namespace o3dgc
+{
+    const unsigned long O3DGC_MAX_NUM_THREADS = 64;
+
+    //! Task run by RunParallel(): called once per thread with threadID in [0, numThreads).
+    typedef void (* O3DGCThreadFunction)(unsigned long threadID, void * data);
+
+    //! Number of logical processors, at least 1.
+    unsigned long           GetNumProcessors();
+    //! Resolves a thread count request: 0 means one thread per logical processor.
+    inline unsigned long    GetNumThreads(unsigned long numThreads)
+                            {
+                                if (numThreads == 0)
+                                {
+                                    numThreads = GetNumProcessors();
+                                }
+                                return (numThreads > O3DGC_MAX_NUM_THREADS) ? O3DGC_MAX_NUM_THREADS : numThreads;
+                            }
+    //! Runs function(threadID, data) for every threadID in [0, numThreads) and waits for all of them.
+    //! Thread 0 is the calling thread. A task whose thread cannot be created runs on the calling thread.
+    void                    RunParallel(O3DGCThreadFunction function, void * data, unsigned long numThreads);
+
+    //! Thread running function(threadID, data) next to the calling thread, for tasks that need to run concurrently
+    //! with it, e.g. the stages of a pipeline.
+    class Thread
+    {
+    public:    
+        //! Constructor.
+                                Thread(void) { m_handle = 0;};
+        //! Destructor: waits for the thread.
+                                ~Thread(void) { Join();};
+        //! Starts the thread. Returns false if it cannot be created.
+        bool                    Start(O3DGCThreadFunction function, void * data, unsigned long threadID);
+        //! Waits for the thread to return, if it was started.
+        void                    Join();
+
+    private:
+                                Thread(const Thread &);
+        Thread &                operator=(const Thread &);
+        void *                  m_handle;
+        O3DGCThreadFunction     m_function;
+        void *                  m_data;
+        unsigned long           m_threadID;
+    };
+
+    //! Worker threads kept between runs, for the tasks run repeatedly, e.g. once per block of vertices. The
+    //! workers are started by the first run needing them and stopped by the destructor.
+    class ThreadPool
+    {
+    public:    
+        //! Constructor.
+                                ThreadPool(void);
+        //! Destructor: stops the workers.
+                                ~ThreadPool(void);
+        //! Starts the workers missing for numThreads threads, the calling thread included, and returns the number
+        //! of threads available (less than numThreads if a worker cannot be created).
+        unsigned long           Start(unsigned long numThreads);
+        //! Runs function(threadID, data) for every threadID in [0, numThreads) and waits for all of them, like
+        //! RunParallel(). Thread 0 is the calling thread; the tasks without a worker run on it after its own, so the
+        //! tasks waiting for each other need Start(numThreads) == numThreads. Runs of a pool must not overlap.
+        void                    Run(O3DGCThreadFunction function, void * data, unsigned long numThreads);
+
+    private:
+                                ThreadPool(const ThreadPool &);
+        ThreadPool &            operator=(const ThreadPool &);
+        void *                  m_handle;       //!< workers and their counters, created by the first Start()
+    };
+
+    //! Counter published by one thread and waited for by others, e.g. the number of items a pipeline stage has 
+    //! produced so far.
+    class ThreadCounter
+    {
+    public:    
+        //! Constructor.
+                                ThreadCounter(void);
+        //! Destructor.
+                                ~ThreadCounter(void);
+        //! Sets the counter and wakes up the waiting threads.
+        void                    Set(unsigned long value);
+        //! Blocks until the counter reaches value.
+        void                    Wait(unsigned long value);
+
+    private:
+                                ThreadCounter(const ThreadCounter &);
+        ThreadCounter &         operator=(const ThreadCounter &);
+        unsigned long           m_value;
+        void *                  m_handle;       //!< platform mutex and condition variable
+    };
+}
+#endif // O3DGC_THREADS_H
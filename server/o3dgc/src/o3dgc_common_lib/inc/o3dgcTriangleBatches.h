@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_TRIANGLE_BATCHES_H
+#define O3DGC_TRIANGLE_BATCHES_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcVector.h"
+
+namespace o3dgc
+{
+    const unsigned long O3DGC_MAX_BATCH_VERTICES = 65535;   //!< vertices addressable by 16-bit indices, 0xFFFF excluded
+
+    //! Consecutive triangles of a mesh drawn with a vertex buffer of their own.
+    class TriangleBatch
+    {
+    public:    
+        unsigned long               m_firstTriangle;        //!< first triangle of the batch in the mesh
+        unsigned long               m_numTriangles;
+        unsigned long               m_firstVertex;          //!< first entry of the batch in GetVertices()
+        unsigned long               m_numVertices;
+    };
+
+    //! Splits a triangle list into batches of at most maxBatchVertices vertices indexed with unsigned shorts 
+    //! (e.g., for WebGL 1 style targets without 32-bit index buffers). The triangles keep their order, a vertex 
+    //! shared by several batches is duplicated.
+    class TriangleBatches
+    {
+    public:    
+        //! Constructor.
+                                    TriangleBatches(void) {};
+        //! Destructor.
+                                    ~TriangleBatches(void) {};
+        template <class T>
+        O3DGCErrorCode              Build(const T * const triangles, 
+                                          unsigned long numTriangles, 
+                                          unsigned long numVertices,
+                                          unsigned long maxBatchVertices = O3DGC_MAX_BATCH_VERTICES);
+        //! Copies the dim components of the vertices of batch b, in the order of their local indices.
+        template <class A>
+        void                        GatherVertexAttribute(unsigned long b, 
+                                                          const A * const attribute, 
+                                                          unsigned long dim, 
+                                                          A * const batchAttribute) const;
+        void                        Clear() 
+                                    { 
+                                        m_batches.Clear();
+                                        m_indices.Clear();
+                                        m_vertices.Clear();
+                                    }
+        unsigned long               GetNumBatches() const { return m_batches.GetSize(); }
+        const TriangleBatch &       GetBatch(unsigned long b) const { return m_batches[b];}
+        //! Local indices of all the triangles, those of batch b start at 3 * GetBatch(b).m_firstTriangle.
+        const unsigned short * const GetIndices() const { return m_indices.GetBuffer();}
+        //! Mesh vertex of each local vertex, those of batch b start at GetBatch(b).m_firstVertex.
+        const unsigned long * const GetVertices() const { return m_vertices.GetBuffer();}
+        unsigned long               GetNumVertices() const { return m_vertices.GetSize();}
+
+    private:
+        Vector<TriangleBatch>       m_batches;
+        Vector<unsigned short>      m_indices;
+        Vector<unsigned long>       m_vertices;
+        Vector<long>                m_localIndices;         //!< local index of each mesh vertex in its last batch
+        Vector<long>                m_stamps;               //!< last batch referencing each mesh vertex
+    };
+}
+#include "o3dgcTriangleBatches.inl"    // template implementation
+#endif // O3DGC_TRIANGLE_BATCHES_H
@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#ifndef O3DGC_TRIANGLE_BATCHES_INL
+#define O3DGC_TRIANGLE_BATCHES_INL
+
+namespace o3dgc
+{
+    template <class T>
+    O3DGCErrorCode TriangleBatches::Build(const T * const triangles, 
+                                          unsigned long numTriangles, 
+                                          unsigned long numVertices,
+                                          unsigned long maxBatchVertices)
+    {
+        if (maxBatchVertices < 3 || maxBatchVertices > O3DGC_MAX_BATCH_VERTICES)
+        {
+            return O3DGC_ERROR_NON_SUPPORTED_FEATURE;
+        }
+        m_batches.Clear();
+        m_indices.Allocate(3 * numTriangles);
+        m_indices.SetSize(3 * numTriangles);
+        m_vertices.Allocate(numVertices);
+        m_vertices.Clear();
+        m_localIndices.Allocate(numVertices);
+        m_localIndices.SetSize(numVertices);
+        m_stamps.Allocate(numVertices);
+        m_stamps.SetSize(numVertices);
+        memset(m_stamps.GetBuffer(), 0xFF, sizeof(long) * numVertices);
+
+        TriangleBatch batch;
+        batch.m_firstTriangle = 0;
+        batch.m_numTriangles  = 0;
+        batch.m_firstVertex   = 0;
+        batch.m_numVertices   = 0;
+        long b = 0;
+        for(unsigned long t = 0; t < numTriangles; ++t)
+        {
+            unsigned long numNewVertices = 0;
+            for(unsigned long k = 0; k < 3; ++k)
+            {
+                const unsigned long v = (unsigned long) triangles[3 * t + k];
+                if (v >= numVertices)
+                {
+                    return O3DGC_ERROR_CORRUPTED_STREAM;
+                }
+                if (m_stamps[v] != b)
+                {
+                    ++numNewVertices;
+                }
+            }
+            if (batch.m_numVertices + numNewVertices > maxBatchVertices)
+            {
+                // close the current batch, the vertices it shares with the next one are duplicated
+                m_batches.PushBack(batch);
+                batch.m_firstTriangle = t;
+                batch.m_numTriangles  = 0;
+                batch.m_firstVertex   = m_vertices.GetSize();
+                batch.m_numVertices   = 0;
+                ++b;
+            }
+            for(unsigned long k = 0; k < 3; ++k)
+            {
+                const unsigned long v = (unsigned long) triangles[3 * t + k];
+                if (m_stamps[v] != b)
+                {
+                    m_stamps[v]       = b;
+                    m_localIndices[v] = (long) batch.m_numVertices++;
+                    m_vertices.PushBack(v);
+                }
+                m_indices[3 * t + k] = (unsigned short) m_localIndices[v];
+            }
+            ++batch.m_numTriangles;
+        }
+        if (batch.m_numTriangles > 0)
+        {
+            m_batches.PushBack(batch);
+        }
+        return O3DGC_OK;
+    }
+    template <class A>
+    void TriangleBatches::GatherVertexAttribute(unsigned long b, 
+                                                const A * const attribute, 
+                                                unsigned long dim, 
+                                                A * const batchAttribute) const
+    {
+        const TriangleBatch & batch = m_batches[b];
+        const unsigned long * const vertices = m_vertices.GetBuffer() + batch.m_firstVertex;
+        for(unsigned long i = 0; i < batch.m_numVertices; ++i)
+        {
+            memcpy(batchAttribute + i * dim, attribute + vertices[i] * dim, sizeof(A) * dim);
+        }
+    }
+}
+#endif // O3DGC_TRIANGLE_BATCHES_INL
@@ -28,12 +28,14 @@ THE SOFTWARE.
 #include "o3dgcCommon.h"
 #include "o3dgcVector.h"
 #include "o3dgcBinaryStream.h"
+#include "o3dgcModelDictionary.h"
 
 
 namespace o3dgc
 {
-    const long O3DGC_TFANS_MIN_SIZE_ALLOCATED_VERTICES_BUFFER = 128;
-    const long O3DGC_TFANS_MIN_SIZE_TFAN_SIZE_BUFFER          = 8;
+    const Index O3DGC_TFANS_MIN_SIZE_ALLOCATED_VERTICES_BUFFER = 128;
+    const Index O3DGC_TFANS_MIN_SIZE_TFAN_SIZE_BUFFER          = 8;
+    const unsigned long O3DGC_TFANS_MAX_NUM_SYMBOLS           = 32;
 
     class CompressedTriangleFans
     {
@@ -42,18 +44,22 @@ namespace o3dgc
                                     CompressedTriangleFans(void)
                                     {
                                         m_streamType   = O3DGC_STREAM_TYPE_UNKOWN;
-                                        m_bufferAC     = 0;
-                                        m_sizeBufferAC = 0;
+                                        m_binarization = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+                                        m_modelDictionary = O3DGC_MODEL_DICTIONARY_NONE;
+                                        m_entropyModel = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE;
                                     };
         //! Destructor.
-                                    ~CompressedTriangleFans(void) 
-                                    {
-                                        delete [] m_bufferAC;
-                                    };
+                                    ~CompressedTriangleFans(void) {};
         O3DGCStreamType       GetStreamType() const { return m_streamType; }
         void                        SetStreamType(O3DGCStreamType streamType) { m_streamType = streamType; }
+        O3DGCSC3DMCBinarization     GetBinarization() const { return m_binarization; }
+        void                        SetBinarization(O3DGCSC3DMCBinarization binarization) { m_binarization = binarization; }
+        O3DGCModelDictionary        GetModelDictionary() const { return m_modelDictionary; }
+        void                        SetModelDictionary(O3DGCModelDictionary modelDictionary) { m_modelDictionary = modelDictionary; }
+        O3DGCSC3DMCEntropyModel     GetEntropyModel() const { return m_entropyModel; }
+        void                        SetEntropyModel(O3DGCSC3DMCEntropyModel entropyModel) { m_entropyModel = entropyModel; }
 
-        O3DGCErrorCode              Allocate(long numVertices, long numTriangles)
+        O3DGCErrorCode              Allocate(Index numVertices, Index numTriangles)
                                     {
                                         assert(numVertices > 0);
                                         m_numTFANs.Allocate(numVertices);
@@ -65,62 +71,62 @@ namespace o3dgc
                                         Clear();
                                         return O3DGC_OK;
                                     }
-        O3DGCErrorCode              PushNumTFans(long numTFans)
+        O3DGCErrorCode              PushNumTFans(Index numTFans)
                                     {
                                          m_numTFANs.PushBack(numTFans);
                                         return O3DGC_OK;
                                     }
-        long                        ReadNumTFans(unsigned long & iterator) const
+        Index                       ReadNumTFans(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_numTFANs.GetSize());
                                         return m_numTFANs[iterator++];
                                     }
-        O3DGCErrorCode              PushDegree(long degree)
+        O3DGCErrorCode              PushDegree(Index degree)
                                     {
                                         m_degrees.PushBack(degree);
                                         return O3DGC_OK;
                                     }
-        long                        ReadDegree(unsigned long & iterator) const
+        Index                       ReadDegree(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_degrees.GetSize());
                                         return m_degrees[iterator++];
                                     }
-        O3DGCErrorCode              PushConfig(long config)
+        O3DGCErrorCode              PushConfig(Index config)
                                     {
                                         m_configs.PushBack(config);
                                         return O3DGC_OK;
                                     }
-        long                        ReadConfig(unsigned long & iterator) const
+        Index                       ReadConfig(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_configs.GetSize());
                                         return m_configs[iterator++];
                                     }
-        O3DGCErrorCode              PushOperation(long op)
+        O3DGCErrorCode              PushOperation(Index op)
                                     {
                                         m_operations.PushBack(op);
                                         return O3DGC_OK;
                                     }
-        long                        ReadOperation(unsigned long & iterator) const
+        Index                       ReadOperation(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_operations.GetSize());
                                         return m_operations[iterator++];
                                     }
-        O3DGCErrorCode              PushIndex(long index)
+        O3DGCErrorCode              PushIndex(Index index)
                                     {
                                         m_indices.PushBack(index);
                                         return O3DGC_OK;
                                     }
-        long                        ReadIndex(unsigned long & iterator) const
+        Index                       ReadIndex(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_indices.GetSize());
                                         return m_indices[iterator++];
                                     }
-        O3DGCErrorCode              PushTriangleIndex(long index)
+        O3DGCErrorCode              PushTriangleIndex(Index index)
                                     {
                                         m_trianglesOrder.PushBack(IntToUInt(index));
                                         return O3DGC_OK;
                                     }
-        long                        ReadTriangleIndex(unsigned long & iterator) const
+        Index                       ReadTriangleIndex(unsigned long & iterator) const
                                     {
                                         assert(iterator < m_trianglesOrder.GetSize());
                                         return UIntToInt(m_trianglesOrder[iterator++]);
@@ -143,24 +149,35 @@ namespace o3dgc
                                          O3DGCStreamType streamType);
 
     private:
-        O3DGCErrorCode              SaveBinAC(const Vector<long> & data,
-                                            BinaryStream & bstream);
-        O3DGCErrorCode              SaveUIntAC(const Vector<long> & data,
-                                             const unsigned long M,
+        template <class Codec>
+        O3DGCErrorCode              LoadAC(const BinaryStream & bstream, 
+                                           unsigned long & iterator, 
+                                           bool decodeTrianglesOrder);
+        template <class Codec>
+        O3DGCErrorCode              SaveBinAC(const Vector<Index> & data,
+                                              O3DGCModelDictionaryEntry entry,
+                                              BinaryStream & bstream);
+        template <class Codec>
+        O3DGCErrorCode              SaveUIntAC(const Vector<Index> & data,
+                                               const unsigned long M,
+                                               O3DGCModelDictionaryEntry entry,
                                                BinaryStream & bstream);
-        O3DGCErrorCode              SaveIntACEGC(const Vector<long> & data,
+        template <class Codec>
+        O3DGCErrorCode              SaveIntACEGC(const Vector<Index> & data,
                                                  const unsigned long M,
+                                                 O3DGCModelDictionaryEntry entry,
                                                  BinaryStream & bstream);
 
-        Vector<long>                m_numTFANs;
-        Vector<long>                m_degrees;
-        Vector<long>                m_configs;
-        Vector<long>                m_operations;
-        Vector<long>                m_indices;
-        Vector<long>                m_trianglesOrder;
-        unsigned char *             m_bufferAC;
-        unsigned long               m_sizeBufferAC;
+        Vector<Index>               m_numTFANs;
+        Vector<Index>               m_degrees;
+        Vector<Index>               m_configs;
+        Vector<Index>               m_operations;
+        Vector<Index>               m_indices;
+        Vector<Index>               m_trianglesOrder;
         O3DGCStreamType       m_streamType;
+        O3DGCSC3DMCBinarization     m_binarization;
+        O3DGCModelDictionary        m_modelDictionary;
+        O3DGCSC3DMCEntropyModel     m_entropyModel;
     };
 
     //! 
@@ -168,8 +185,8 @@ namespace o3dgc
     {
     public:    
         //! Constructor.
-                                    TriangleFans(long sizeTFAN     = O3DGC_TFANS_MIN_SIZE_TFAN_SIZE_BUFFER, 
-                                                 long verticesSize = O3DGC_TFANS_MIN_SIZE_ALLOCATED_VERTICES_BUFFER)
+                                    TriangleFans(Index sizeTFAN     = O3DGC_TFANS_MIN_SIZE_TFAN_SIZE_BUFFER, 
+                                                 Index verticesSize = O3DGC_TFANS_MIN_SIZE_ALLOCATED_VERTICES_BUFFER)
                                     {
                                         assert(sizeTFAN     > 0);
                                         assert(verticesSize > 0);
@@ -177,8 +194,8 @@ namespace o3dgc
                                         m_numVertices           = 0;
                                         m_verticesAllocatedSize = verticesSize;
                                         m_sizeTFANAllocatedSize = sizeTFAN;
-                                        m_sizeTFAN              = new long [m_sizeTFANAllocatedSize];
-                                        m_vertices              = new long [m_verticesAllocatedSize];
+                                        m_sizeTFAN              = new Index [m_sizeTFANAllocatedSize];
+                                        m_vertices              = new Index [m_verticesAllocatedSize];
                                     };
         //! Destructor.
                                     ~TriangleFans(void)
@@ -187,7 +204,7 @@ namespace o3dgc
                                         delete [] m_sizeTFAN;
                                     };
 
-        O3DGCErrorCode                Allocate(long sizeTFAN, long verticesSize)
+        O3DGCErrorCode                Allocate(Index sizeTFAN, Index verticesSize)
                                     {
                                         assert(sizeTFAN     > 0);
                                         assert(verticesSize > 0);
@@ -197,13 +214,13 @@ namespace o3dgc
                                         {
                                             delete [] m_vertices;
                                             m_verticesAllocatedSize = verticesSize;
-                                            m_vertices              = new long [m_verticesAllocatedSize];
+                                            m_vertices              = new Index [m_verticesAllocatedSize];
                                         }
                                         if (m_sizeTFANAllocatedSize < sizeTFAN)
                                         {
                                             delete [] m_sizeTFAN;
                                             m_sizeTFANAllocatedSize = sizeTFAN;
-                                            m_sizeTFAN              = new long [m_sizeTFANAllocatedSize];
+                                            m_sizeTFAN              = new Index [m_sizeTFANAllocatedSize];
                                         }
                                         return O3DGC_OK;
                                     };
@@ -213,7 +230,7 @@ namespace o3dgc
                                         m_numVertices = 0;
                                         return O3DGC_OK;
                                     }
-        O3DGCErrorCode                AddVertex(long vertex) 
+        O3DGCErrorCode                AddVertex(Index vertex) 
                                     {
                                         assert(m_numTFANs    >= 0);
                                         assert(m_numTFANs    <  m_sizeTFANAllocatedSize);
@@ -222,9 +239,9 @@ namespace o3dgc
                                         if (m_numVertices == m_verticesAllocatedSize)
                                         {
                                             m_verticesAllocatedSize *= 2;
-                                            long * tmp = m_vertices;
-                                            m_vertices = new long [m_verticesAllocatedSize];
-                                            memcpy(m_vertices, tmp, sizeof(long) * m_numVertices);
+                                            Index * tmp = m_vertices;
+                                            m_vertices = new Index [m_verticesAllocatedSize];
+                                            memcpy(m_vertices, tmp, sizeof(Index) * m_numVertices);
                                             delete [] tmp;
                                         }
                                         m_vertices[m_numVertices-1] = vertex;
@@ -238,52 +255,52 @@ namespace o3dgc
                                         if (m_numTFANs == m_sizeTFANAllocatedSize)
                                         {
                                             m_sizeTFANAllocatedSize *= 2;
-                                            long * tmp = m_sizeTFAN;
-                                            m_sizeTFAN = new long [m_sizeTFANAllocatedSize];
-                                            memcpy(m_sizeTFAN, tmp, sizeof(long) * m_numTFANs);
+                                            Index * tmp = m_sizeTFAN;
+                                            m_sizeTFAN = new Index [m_sizeTFANAllocatedSize];
+                                            memcpy(m_sizeTFAN, tmp, sizeof(Index) * m_numTFANs);
                                             delete [] tmp;
                                         }
                                         m_sizeTFAN[m_numTFANs-1] = (m_numTFANs > 1) ? m_sizeTFAN[m_numTFANs-2] : 0;
                                         return O3DGC_OK;
                                     }
-        long                        Begin(long tfan) const 
+        Index                       Begin(Index tfan) const 
                                     {
                                         assert(tfan < m_numTFANs);
                                         assert(tfan >= 0);
                                         return (tfan>0)?m_sizeTFAN[tfan-1]:0;
                                     }
-        long                        End(long tfan) const
+        Index                       End(Index tfan) const
                                     {
                                         assert(tfan < m_numTFANs);
                                         assert(tfan >= 0);
                                         return m_sizeTFAN[tfan];
                                     }
-        long                        GetVertex(long vertex) const
+        Index                       GetVertex(Index vertex) const
                                     {
                                         assert(vertex < m_numVertices);
                                         assert(vertex >= 0);
                                         return m_vertices[vertex];
                                     }
-        long                        GetTFANSize(long tfan)  const 
+        Index                       GetTFANSize(Index tfan)  const 
                                     { 
                                         return End(tfan) - Begin(tfan);
                                     }
-        long                        GetNumTFANs()  const 
+        Index                       GetNumTFANs()  const 
                                     { 
                                         return m_numTFANs;
                                     }
-        long                        GetNumVertices()  const 
+        Index                       GetNumVertices()  const 
                                     { 
                                         return m_numVertices;
                                     }
 
     private:
-        long                        m_verticesAllocatedSize;
-        long                        m_sizeTFANAllocatedSize;
-        long                        m_numTFANs;
-        long                        m_numVertices;
-        long *                      m_vertices;
-        long *                      m_sizeTFAN;
+        Index                       m_verticesAllocatedSize;
+        Index                       m_sizeTFANAllocatedSize;
+        Index                       m_numTFANs;
+        Index                       m_numVertices;
+        Index *                     m_vertices;
+        Index *                     m_sizeTFAN;
     
     };
 }
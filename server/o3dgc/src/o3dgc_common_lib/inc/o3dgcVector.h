@@ -40,11 +40,15 @@ namespace o3dgc
                                     m_allocated = 0;
                                     m_size      = 0;
                                     m_buffer    = 0;
+                                    m_owner     = true;
                                 };
         //! Destructor.
                                 ~Vector(void)
                                 {
-                                    delete [] m_buffer;
+                                    if (m_owner)
+                                    {
+                                        delete [] m_buffer;
+                                    }
                                 };
         T &                     operator[](unsigned long i)
                                 { 
@@ -56,23 +60,41 @@ namespace o3dgc
                                 }
         void                    Allocate(unsigned long size)
                                 {
-                                    if (size > m_allocated)
+                                    if (size > m_allocated || !m_owner)
                                     {
-                                        m_allocated = size;
+                                        m_allocated = (size > m_size) ? size : m_size;
                                         T * tmp     = new T [m_allocated];
                                         if (m_size > 0)
                                         {
                                             memcpy(tmp, m_buffer, m_size * sizeof(T) );
+                                        }
+                                        if (m_owner)
+                                        {
                                             delete [] m_buffer;
                                         }
                                         m_buffer = tmp;
+                                        m_owner  = true;
+                                    }
+                                };
+        //! Wraps size elements owned by the caller without copying them. The first call to Allocate() or
+        //! PushBack() moves the elements to a private buffer, the external memory is never written to by the Vector.
+        void                    SetExternalBuffer(T * const buffer, unsigned long size)
+                                {
+                                    if (m_owner)
+                                    {
+                                        delete [] m_buffer;
                                     }
+                                    m_buffer    = buffer;
+                                    m_allocated = size;
+                                    m_size      = size;
+                                    m_owner     = false;
                                 };
+        bool                    IsExternalBuffer() const { return !m_owner;};
         void                    PushBack(const T & value)
                                 {
-                                    if (m_size == m_allocated)
+                                    if (m_size == m_allocated || !m_owner)
                                     {
-                                        m_allocated *= 2;
+                                        m_allocated = 2 * m_size;
                                         if (m_allocated < O3DGC_DEFAULT_VECTOR_SIZE)
                                         {
                                             m_allocated = O3DGC_DEFAULT_VECTOR_SIZE;
@@ -81,9 +103,13 @@ namespace o3dgc
                                         if (m_size > 0)
                                         {
                                             memcpy(tmp, m_buffer, m_size * sizeof(T) );
+                                        }
+                                        if (m_owner)
+                                        {
                                             delete [] m_buffer;
                                         }
                                         m_buffer = tmp;
+                                        m_owner  = true;
                                     }
                                     assert(m_size < m_allocated);
                                     m_buffer[m_size++] = value;
@@ -103,6 +129,7 @@ namespace o3dgc
         T *                     m_buffer;
         unsigned long                  m_allocated;
         unsigned long                  m_size;
+        bool                    m_owner;
     };
 
 
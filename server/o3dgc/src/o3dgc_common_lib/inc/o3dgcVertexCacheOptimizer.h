@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#ifndef O3DGC_VERTEX_CACHE_OPTIMIZER_H
+#define O3DGC_VERTEX_CACHE_OPTIMIZER_H
+
+#include "o3dgcCommon.h"
+#include "o3dgcVector.h"
+
+namespace o3dgc
+{
+    const long O3DGC_VERTEX_CACHE_SIZE      = 32;   //!< LRU cache modeled by the optimizer
+    const long O3DGC_VERTEX_CACHE_FIFO_SIZE = 16;   //!< FIFO cache simulated to measure the ACMR
+    const long O3DGC_VERTEX_CACHE_MAX_VALENCE_SCORE = 64;
+
+    //! Reorders triangles for the post-transform vertex cache (T. Forsyth, "Linear-speed vertex cache 
+    //! optimisation", 2006): the next triangle is the one whose vertices score best, the score of a vertex 
+    //! growing with its position in an LRU cache and decreasing with its number of triangles not yet emitted.
+    class VertexCacheOptimizer
+    {
+    public:    
+        //! Constructor.
+                                    VertexCacheOptimizer(void)
+                                    {
+                                        double s;
+                                        for(long p = 0; p < O3DGC_VERTEX_CACHE_SIZE; ++p)
+                                        {
+                                            // the vertices of the last triangle get a fixed score, so that
+                                            // strips are not favored over fans
+                                            s = 1.0 - (double) (p - 3) / (O3DGC_VERTEX_CACHE_SIZE - 3);
+                                            m_cacheScores[p] = (float) ((p < 3) ? 0.75 : pow(s, 1.5));
+                                        }
+                                        for(long n = 1; n < O3DGC_VERTEX_CACHE_MAX_VALENCE_SCORE; ++n)
+                                        {
+                                            m_valenceScores[n] = (float) (2.0 / sqrt((double) n));
+                                        }
+                                        m_valenceScores[0] = 0.0f;
+                                    };
+        //! Destructor.
+                                    ~VertexCacheOptimizer(void) {};
+        //! Reorders the triangles in place. The vertices of each triangle keep their order.
+        template <class T>
+        O3DGCErrorCode              OptimizeTriangles(T * const triangles, long numTriangles, long numVertices);
+        //! Renumbers the vertices by order of first use, the unused vertices coming last. The new index of 
+        //! each vertex is kept for PermuteVertexAttribute().
+        template <class T>
+        O3DGCErrorCode              RenumberVertices(T * const triangles, long numTriangles, long numVertices);
+        //! Moves the dim components of each vertex to the index given by the last RenumberVertices().
+        template <class A>
+        void                        PermuteVertexAttribute(A * const attribute, unsigned long dim);
+        //! Average number of cache misses per triangle, for a FIFO cache of cacheSize vertices.
+        template <class T>
+        double                      ComputeACMR(const T * const triangles, 
+                                                long numTriangles,
+                                                long numVertices,
+                                                long cacheSize = O3DGC_VERTEX_CACHE_FIFO_SIZE);
+
+    private:
+        float                       VertexScore(long v) const
+                                    {
+                                        const long n = m_numActiveTriangles[v];
+                                        if (n == 0)
+                                        {
+                                            return -1.0f;
+                                        }
+                                        const long p = m_cachePositions[v];
+                                        return ((p >= 0) ? m_cacheScores[p] : 0.0f) + 
+                                               m_valenceScores[(n < O3DGC_VERTEX_CACHE_MAX_VALENCE_SCORE) ? n : 
+                                                                O3DGC_VERTEX_CACHE_MAX_VALENCE_SCORE - 1];
+                                    }
+
+        float                       m_cacheScores  [O3DGC_VERTEX_CACHE_SIZE];
+        float                       m_valenceScores[O3DGC_VERTEX_CACHE_MAX_VALENCE_SCORE];
+        Vector<long>                m_numActiveTriangles;
+        Vector<long>                m_cachePositions;
+        Vector<long>                m_firstTriangles;       //!< vertex-to-triangle adjacency
+        Vector<long>                m_vertexTriangles;
+        Vector<float>               m_vertexScores;
+        Vector<float>               m_triangleScores;
+        Vector<char>                m_emitted;
+        Vector<long>                m_newIndices;
+        Vector<unsigned char>       m_buffer;
+    };
+}
+#include "o3dgcVertexCacheOptimizer.inl"    // template implementation
+#endif // O3DGC_VERTEX_CACHE_OPTIMIZER_H
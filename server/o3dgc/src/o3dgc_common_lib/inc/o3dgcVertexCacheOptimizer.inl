@@ -0,0 +1,231 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#ifndef O3DGC_VERTEX_CACHE_OPTIMIZER_INL
+#define O3DGC_VERTEX_CACHE_OPTIMIZER_INL
+
+namespace o3dgc
+{
+    template <class T>
+    O3DGCErrorCode VertexCacheOptimizer::OptimizeTriangles(T * const triangles, long numTriangles, long numVertices)
+    {
+        if (numTriangles == 0)
+        {
+            return O3DGC_OK;
+        }
+        // vertex-to-triangle adjacency: the active triangles of a vertex come first in its list
+        m_numActiveTriangles.Allocate(numVertices);
+        m_numActiveTriangles.SetSize(numVertices);
+        m_firstTriangles.Allocate(numVertices + 1);
+        m_firstTriangles.SetSize(numVertices + 1);
+        m_vertexTriangles.Allocate(3 * numTriangles);
+        m_vertexTriangles.SetSize(3 * numTriangles);
+        memset(m_numActiveTriangles.GetBuffer(), 0, sizeof(long) * numVertices);
+        for(long i = 0; i < 3 * numTriangles; ++i)
+        {
+            ++m_numActiveTriangles[(long) triangles[i]];
+        }
+        m_firstTriangles[0] = 0;
+        for(long v = 0; v < numVertices; ++v)
+        {
+            m_firstTriangles[v + 1] = m_firstTriangles[v] + m_numActiveTriangles[v];
+            m_numActiveTriangles[v] = 0;
+        }
+        for(long i = 0; i < 3 * numTriangles; ++i)
+        {
+            const long v = (long) triangles[i];
+            m_vertexTriangles[m_firstTriangles[v] + m_numActiveTriangles[v]++] = i / 3;
+        }
+        m_cachePositions.Allocate(numVertices);
+        m_cachePositions.SetSize(numVertices);
+        m_vertexScores.Allocate(numVertices);
+        m_vertexScores.SetSize(numVertices);
+        for(long v = 0; v < numVertices; ++v)
+        {
+            m_cachePositions[v] = -1;
+            m_vertexScores[v]   = VertexScore(v);
+        }
+        m_triangleScores.Allocate(numTriangles);
+        m_triangleScores.SetSize(numTriangles);
+        m_emitted.Allocate(numTriangles);
+        m_emitted.SetSize(numTriangles);
+        for(long t = 0; t < numTriangles; ++t)
+        {
+            m_triangleScores[t] = m_vertexScores[(long) triangles[3 * t    ]] + 
+                                  m_vertexScores[(long) triangles[3 * t + 1]] + 
+                                  m_vertexScores[(long) triangles[3 * t + 2]];
+            m_emitted[t]        = 0;
+        }
+        m_buffer.Allocate(sizeof(T) * 3 * numTriangles);
+        T * const output = (T *) m_buffer.GetBuffer();
+
+        long cache   [O3DGC_VERTEX_CACHE_SIZE + 3];
+        long newCache[O3DGC_VERTEX_CACHE_SIZE + 3];
+        long cacheSize = 0;
+        long cursor    = 0;
+        long best      = -1;
+        for(long i = 0; i < numTriangles; ++i)
+        {
+            if (best < 0)
+            {
+                // nothing left around the cached vertices: restart from the first triangle not emitted
+                while (m_emitted[cursor])
+                {
+                    ++cursor;
+                }
+                best = cursor;
+            }
+            m_emitted[best] = 1;
+            memcpy(output + 3 * i, triangles + 3 * best, sizeof(T) * 3);
+            // the vertices of the triangle move to the front of the cache
+            long newCacheSize = 0;
+            for(long k = 0; k < 3; ++k)
+            {
+                const long v      = (long) triangles[3 * best + k];
+                const long first  = m_firstTriangles[v];
+                const long last   = first + --m_numActiveTriangles[v];
+                for(long j = first; j <= last; ++j)
+                {
+                    if (m_vertexTriangles[j] == best)
+                    {
+                        m_vertexTriangles[j]    = m_vertexTriangles[last];
+                        m_vertexTriangles[last] = best;
+                        break;
+                    }
+                }
+                if (m_cachePositions[v] != -2)
+                {
+                    m_cachePositions[v]      = -2; // marks the vertices already moved
+                    newCache[newCacheSize++] = v;
+                }
+            }
+            for(long j = 0; j < cacheSize; ++j)
+            {
+                if (m_cachePositions[cache[j]] != -2)
+                {
+                    newCache[newCacheSize++] = cache[j];
+                }
+            }
+            // update the scores of the vertices in the cache or evicted from it, and of their triangles
+            best = -1;
+            float bestScore = -1.0f;
+            for(long j = 0; j < newCacheSize; ++j)
+            {
+                const long v        = newCache[j];
+                m_cachePositions[v] = (j < O3DGC_VERTEX_CACHE_SIZE) ? j : -1;
+                m_vertexScores[v]   = VertexScore(v);
+            }
+            for(long j = 0; j < newCacheSize; ++j)
+            {
+                const long v     = newCache[j];
+                const long first = m_firstTriangles[v];
+                const long last  = first + m_numActiveTriangles[v];
+                for(long n = first; n < last; ++n)
+                {
+                    const long t = m_vertexTriangles[n];
+                    m_triangleScores[t] = m_vertexScores[(long) triangles[3 * t    ]] + 
+                                          m_vertexScores[(long) triangles[3 * t + 1]] + 
+                                          m_vertexScores[(long) triangles[3 * t + 2]];
+                    if (m_triangleScores[t] > bestScore)
+                    {
+                        bestScore = m_triangleScores[t];
+                        best      = t;
+                    }
+                }
+            }
+            cacheSize = (newCacheSize < O3DGC_VERTEX_CACHE_SIZE) ? newCacheSize : O3DGC_VERTEX_CACHE_SIZE;
+            memcpy(cache, newCache, sizeof(long) * cacheSize);
+        }
+        memcpy(triangles, output, sizeof(T) * 3 * numTriangles);
+        return O3DGC_OK;
+    }
+    template <class T>
+    O3DGCErrorCode VertexCacheOptimizer::RenumberVertices(T * const triangles, long numTriangles, long numVertices)
+    {
+        m_newIndices.Allocate(numVertices);
+        m_newIndices.SetSize(numVertices);
+        for(long v = 0; v < numVertices; ++v)
+        {
+            m_newIndices[v] = -1;
+        }
+        long numIndices = 0;
+        for(long i = 0; i < 3 * numTriangles; ++i)
+        {
+            const long v = (long) triangles[i];
+            if (m_newIndices[v] < 0)
+            {
+                m_newIndices[v] = numIndices++;
+            }
+            triangles[i] = (T) m_newIndices[v];
+        }
+        for(long v = 0; v < numVertices; ++v)
+        {
+            if (m_newIndices[v] < 0)
+            {
+                m_newIndices[v] = numIndices++;
+            }
+        }
+        return O3DGC_OK;
+    }
+    template <class A>
+    void VertexCacheOptimizer::PermuteVertexAttribute(A * const attribute, unsigned long dim)
+    {
+        const long numVertices = (long) m_newIndices.GetSize();
+        m_buffer.Allocate(sizeof(A) * dim * numVertices);
+        A * const buffer = (A *) m_buffer.GetBuffer();
+        memcpy(buffer, attribute, sizeof(A) * dim * numVertices);
+        for(long v = 0; v < numVertices; ++v)
+        {
+            memcpy(attribute + m_newIndices[v] * dim, buffer + v * dim, sizeof(A) * dim);
+        }
+    }
+    template <class T>
+    double VertexCacheOptimizer::ComputeACMR(const T * const triangles, 
+                                             long numTriangles,
+                                             long numVertices,
+                                             long cacheSize)
+    {
+        if (numTriangles == 0)
+        {
+            return 0.0;
+        }
+        // a vertex loaded by the k-th miss stays in the FIFO until the (k + cacheSize)-th miss
+        m_cachePositions.Allocate(numVertices);
+        m_cachePositions.SetSize(numVertices);
+        for(long v = 0; v < numVertices; ++v)
+        {
+            m_cachePositions[v] = -1;
+        }
+        long numMisses = 0;
+        for(long i = 0; i < 3 * numTriangles; ++i)
+        {
+            const long v = (long) triangles[i];
+            if (m_cachePositions[v] < 0 || numMisses - m_cachePositions[v] > cacheSize)
+            {
+                m_cachePositions[v] = numMisses++;
+            }
+        }
+        return (double) numMisses / numTriangles;
+    }
+}
+#endif // O3DGC_VERTEX_CACHE_OPTIMIZER_INL
@@ -650,6 +650,19 @@ namespace o3dgc
       bit_0_prob = unsigned(p0 * (1 << BM__LengthShift));
     }
 
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void Static_Bit_Model::set_frequencies(unsigned bit_0_count,
+                                           unsigned bit_count)
+    {
+      if ((bit_count == 0) || (bit_0_count > bit_count) || (bit_count > AC__MaxFrequencyTotal))
+        AC_Error("invalid bit frequencies");
+                                   // integer arithmetic: identical on both sides
+      bit_0_prob = (bit_0_count << BM__LengthShift) / bit_count;
+      if (bit_0_prob == 0) bit_0_prob = 1;
+      if (bit_0_prob >= (1U << BM__LengthShift)) bit_0_prob = (1U << BM__LengthShift) - 1;
+    }
+
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // - Adaptive bit model implementation - - - - - - - - - - - - - - - - - - - -
@@ -672,6 +685,22 @@ namespace o3dgc
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+    void Adaptive_Bit_Model::set_counts(unsigned bit_0_count_,
+                                        unsigned bit_count_)
+    {
+                                        // start from prior counts, e.g. offline trained
+      if ((bit_0_count_ == 0) || (bit_0_count_ >= bit_count_) || (bit_count_ > BM__MaxCount))
+        AC_Error("invalid bit model counts");
+
+      bit_0_count = bit_0_count_;
+      bit_count   = bit_count_;
+      unsigned scale = 0x80000000U / bit_count;
+      bit_0_prob = (bit_0_count * scale) >> (31 - BM__LengthShift);
+      update_cycle = bits_until_update = 4;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
     void Adaptive_Bit_Model::update(void)
     {
                                        // halve counts when a threshold is reached
@@ -698,12 +727,15 @@ namespace o3dgc
     Static_Data_Model::Static_Data_Model(void)
     {
       data_symbols = 0;
-      distribution = 0;
+      distribution = decoder_table = 0;
+      slot_table = 0;
+      table_size = table_shift = 0;
     }
 
     Static_Data_Model::~Static_Data_Model(void)
     {
       delete [] distribution;
+      delete [] slot_table;
     }
 
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -714,6 +746,9 @@ namespace o3dgc
       if ((number_of_symbols < 2) || (number_of_symbols > (1 << 11)))
         AC_Error("invalid number of data symbols");
 
+      delete [] slot_table;                          // rebuilt by the rANS decoder
+      slot_table = 0;
+
       if (data_symbols != number_of_symbols) {     // assign memory for data model
         data_symbols = number_of_symbols;
         last_symbol = data_symbols - 1;
@@ -756,6 +791,88 @@ namespace o3dgc
       if ((sum < 0.9999) || (sum > 1.0001)) AC_Error("invalid probabilities");
     }
 
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void Static_Data_Model::set_frequencies(unsigned number_of_symbols,
+                                            const unsigned frequency[])
+    {
+      if ((number_of_symbols < 2) || (number_of_symbols > (1 << 11)))
+        AC_Error("invalid number of data symbols");
+
+      delete [] slot_table;                          // rebuilt by the rANS decoder
+      slot_table = 0;
+
+      unsigned k, total = 0;
+      for (k = 0; k < number_of_symbols; k++) total += frequency[k];
+      if (total > AC__MaxFrequencyTotal) AC_Error("invalid symbol frequencies");
+
+                   // the model never changes: afford a finer table for decoding
+      unsigned table_bits = 0;
+      if (number_of_symbols > 16) {
+        table_bits = 3;
+        while ((number_of_symbols << 2) > (1U << table_bits)) ++table_bits;
+      }
+      if ((data_symbols != number_of_symbols) || (table_size != ((table_bits) ? (1U << table_bits) : 0))) {
+        data_symbols = number_of_symbols;
+        last_symbol = data_symbols - 1;
+        delete [] distribution;
+        if (table_bits) {
+          table_size  = 1 << table_bits;
+          table_shift = DM__LengthShift - table_bits;
+          distribution = new unsigned[data_symbols+table_size+2];
+          decoder_table = distribution + data_symbols;
+        }
+        else {
+          decoder_table = 0;
+          table_size = table_shift = 0;
+          distribution = new unsigned[data_symbols];
+        }
+        if (distribution == 0) AC_Error("cannot assign model memory");
+      }
+                      // scale to 2^15, every symbol that occurs keeps one slot
+      unsigned f, sum = 0, max_symbol = 0;
+      for (k = 0; k < data_symbols; k++) {
+        f = (total == 0) ? 1 : frequency[k];
+        if (f) {
+          f = (total == 0) ? (DM__MaxCount / data_symbols) : ((f << DM__LengthShift) / total);
+          if (f == 0) f = 1;
+        }
+        distribution[k] = f;
+        sum += f;
+        if (f > distribution[max_symbol]) max_symbol = k;
+      }
+                          // rounding error goes to the most probable symbol
+      if (sum < DM__MaxCount) {
+        distribution[max_symbol] += DM__MaxCount - sum;
+      }
+      else if (sum - DM__MaxCount < distribution[max_symbol]) {
+        distribution[max_symbol] -= sum - DM__MaxCount;
+      }
+      else {
+        while (sum > DM__MaxCount) {
+          for (k = max_symbol = 0; k < data_symbols; k++)
+            if (distribution[k] > distribution[max_symbol]) max_symbol = k;
+          --distribution[max_symbol];
+          --sum;
+        }
+      }
+                                 // compute cumulative distribution, decoder table
+      unsigned s = 0, cumulative = 0;
+      for (k = 0; k < data_symbols; k++) {
+        f = distribution[k];
+        distribution[k] = cumulative;
+        cumulative += f;
+        if (table_size == 0) continue;
+        unsigned w = distribution[k] >> table_shift;
+        while (s < w) decoder_table[++s] = k - 1;
+      }
+
+      if (table_size != 0) {
+        decoder_table[0] = 0;
+        while (s <= table_size) decoder_table[++s] = data_symbols - 1;
+      }
+    }
+
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // - - Adaptive data model implementation  - - - - - - - - - - - - - - - - - -
 
@@ -859,5 +976,24 @@ namespace o3dgc
       update(false);
       symbols_until_update = update_cycle = (data_symbols + 6) >> 1;
     }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void Adaptive_Data_Model::set_counts(const unsigned short * counts,
+                                         unsigned number_of_counts)
+    {
+      if (data_symbols == 0) return;
+      if (number_of_counts > data_symbols) AC_Error("invalid number of counts");
+
+                                        // start from prior counts, e.g. offline trained
+      total_count = 0;
+      update_cycle = 0;
+      for (unsigned k = 0; k < data_symbols; k++) {
+        symbol_count[k] = ((k < number_of_counts) && (counts[k] > 0)) ? counts[k] : 1;
+        update_cycle += symbol_count[k];
+      }
+      update(false);
+      symbols_until_update = update_cycle = (data_symbols + 6) >> 1;
+    }
 }
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
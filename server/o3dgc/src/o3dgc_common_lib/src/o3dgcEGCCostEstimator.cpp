@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "o3dgcEGCCostEstimator.h"
+#include "o3dgcArithmeticCodec.h"
+
+namespace o3dgc
+{
+    void EGCCostEstimator::Clear()
+    {
+        memset(m_histogram, 0, sizeof(unsigned long) * O3DGC_EGC_COST_ESTIMATOR_NUM_BINS);
+        memset(m_classes  , 0, sizeof(unsigned long) * O3DGC_EGC_COST_ESTIMATOR_NUM_CLASSES);
+        m_numValues = 0;
+    }
+    inline double ExpGolombLength(unsigned long value)
+    {
+        unsigned long n = 0;
+        ++value;
+        while (value >>= 1)
+        {
+            ++n;
+        }
+        return 2.0 * n + 1.0;
+    }
+    double EGCCostEstimator::GetCost(unsigned long M, 
+                                     O3DGCSC3DMCEntropyModel entropyModel,
+                                     O3DGCModelDictionary dictionary,
+                                     O3DGCModelDictionaryEntry entry) const
+    {
+        assert(M > 0 && M <= O3DGC_EGC_COST_ESTIMATOR_MAX_M);
+        const double  ln2        = log(2.0);
+        unsigned long numEscapes = m_numValues;
+        unsigned long numUsed    = 0;
+        double        cost       = 0.0;
+        for(unsigned long s = 0; s < M; ++s)
+        {
+            numEscapes -= m_histogram[s];
+            if (m_histogram[s] > 0)
+            {
+                numUsed = s + 1;
+            }
+        }
+        if (entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
+        {
+            // empirical entropy of the symbols plus the frequency table sent by EncodeFrequencies()
+            unsigned long shift = 0;
+            while ((m_numValues >> shift) + M + 2 > AC__MaxFrequencyTotal)
+            {
+                ++shift;
+            }
+            if (numEscapes > 0)
+            {
+                numUsed = M + 1;
+            }
+            cost += ExpGolombLength(numUsed);
+            for(unsigned long s = 0; s < numUsed; ++s)
+            {
+                const unsigned long h = (s < M) ? m_histogram[s] : numEscapes;
+                cost += ExpGolombLength((h > 0 && (h >> shift) == 0) ? 1 : (h >> shift));
+                if (h > 0)
+                {
+                    cost += h * log((double) m_numValues / h) / ln2;
+                }
+            }
+        }
+        else
+        {
+            // the adaptive models not seeded by SeedModel() start from uniform counts: the code length of the symbols 
+            // is that of a Laplace estimator over K = M+2 symbols, log((N+K-1)! / ((K-1)! prod(h!)))
+            unsigned long          numPriors = 0;
+            const unsigned short * priors    = GetModelDictionaryCounts(dictionary, entry, numPriors);
+            if (!priors || numPriors > M + 2)
+            {
+                const double K = (double) (M + 2);
+                cost = lgamma(m_numValues + K) - lgamma(K) - lgamma(numEscapes + 1.0);
+                for(unsigned long s = 0; s < M; ++s)
+                {
+                    if (m_histogram[s] > 0)
+                    {
+                        cost -= lgamma(m_histogram[s] + 1.0);
+                    }
+                }
+            }
+            else
+            {
+                // seeded models start from the prior counts a(s) instead, with a total A: 
+                // log(Gamma(N+A) / Gamma(A)) - sum log(Gamma(h+a) / Gamma(a))
+                double A = 0.0;
+                for(unsigned long s = 0; s < M + 2; ++s)
+                {
+                    const double a = (double) ((s < numPriors && priors[s] > 0) ? priors[s] : 1);
+                    const double h = (double) ((s < M) ? m_histogram[s] : ((s == M) ? numEscapes : 0));
+                    A += a;
+                    if (h > 0.0)
+                    {
+                        cost -= lgamma(h + a) - lgamma(a);
+                    }
+                }
+                cost += lgamma(m_numValues + A) - lgamma(A);
+            }
+            cost /= ln2;
+        }
+        // escaped values: Exp-Golomb code of order 0 of (value - M), i.e. L ones and a zero coded with an
+        // adaptive bit model followed by L raw bits, where L = floor(log2(value - M + 1))
+        double numOnes = 0.0;
+        for(unsigned long s = M; s < O3DGC_EGC_COST_ESTIMATOR_NUM_BINS; ++s)
+        {
+            if (m_histogram[s] > 0)
+            {
+                numOnes += (double) m_histogram[s] * FloorLog2(s - M + 1);
+            }
+        }
+        for(unsigned long c = 0; c < O3DGC_EGC_COST_ESTIMATOR_NUM_CLASSES; ++c)
+        {
+            if (m_classes[c] > 0)
+            {
+                const unsigned long value = (1UL << c) + ((1UL << c) >> 1); // middle of [2^c, 2^(c+1))
+                numOnes += (double) m_classes[c] * FloorLog2(value - M + 1);
+            }
+        }
+        if (numOnes > 0.0)
+        {
+            const double numBits = numOnes + numEscapes;
+            cost += (numOnes * log(numBits / numOnes) + numEscapes * log(numBits / numEscapes)) / ln2 + numOnes;
+        }
+        return cost;
+    }
+    unsigned long EGCCostEstimator::GetBestM(unsigned long maxM, 
+                                             O3DGCSC3DMCEntropyModel entropyModel,
+                                             O3DGCModelDictionary dictionary,
+                                             O3DGCModelDictionaryEntry entry) const
+    {
+        assert(maxM > 0 && maxM <= O3DGC_EGC_COST_ESTIMATOR_MAX_M);
+        unsigned long bestM    = maxM;
+        double        bestCost = GetCost(maxM, entropyModel, dictionary, entry);
+        double        cost;
+        for(unsigned long M = 1; M < maxM; M <<= 1)
+        {
+            cost = GetCost(M, entropyModel, dictionary, entry);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestM    = M;
+            }
+        }
+        return bestM;
+    }
+}
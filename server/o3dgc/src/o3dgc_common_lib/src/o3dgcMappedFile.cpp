@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "o3dgcMappedFile.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace o3dgc
+{
+    MappedFile::MappedFile(void)
+    {
+        m_buffer  = 0;
+        m_size    = 0;
+#ifdef WIN32
+        m_file    = INVALID_HANDLE_VALUE;
+        m_mapping = 0;
+#endif
+    }
+    MappedFile::~MappedFile(void)
+    {
+        Close();
+    }
+#ifdef WIN32
+    O3DGCErrorCode MappedFile::Open(const char * const fileName)
+    {
+        Close();
+        m_file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return O3DGC_ERROR_OPEN_FILE;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0 || size.HighPart != 0)
+        {
+            Close();
+            return O3DGC_ERROR_READ_FILE;
+        }
+        m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!m_mapping)
+        {
+            Close();
+            return O3DGC_ERROR_READ_FILE;
+        }
+        m_buffer = (const unsigned char *) MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_buffer)
+        {
+            Close();
+            return O3DGC_ERROR_READ_FILE;
+        }
+        m_size = (unsigned long) size.LowPart;
+        return O3DGC_OK;
+    }
+    void MappedFile::Close()
+    {
+        if (m_buffer)
+        {
+            UnmapViewOfFile(m_buffer);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+        m_buffer  = 0;
+        m_size    = 0;
+        m_file    = INVALID_HANDLE_VALUE;
+        m_mapping = 0;
+    }
+#else
+    O3DGCErrorCode MappedFile::Open(const char * const fileName)
+    {
+        Close();
+        int fd = open(fileName, O_RDONLY);
+        if (fd < 0)
+        {
+            return O3DGC_ERROR_OPEN_FILE;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0 || (unsigned long) st.st_size != (unsigned long long) st.st_size)
+        {
+            close(fd);
+            return O3DGC_ERROR_READ_FILE;
+        }
+        void * buffer = mmap(0, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps its own reference to the file
+        if (buffer == MAP_FAILED)
+        {
+            return O3DGC_ERROR_READ_FILE;
+        }
+        m_buffer = (const unsigned char *) buffer;
+        m_size   = (unsigned long) st.st_size;
+        return O3DGC_OK;
+    }
+    void MappedFile::Close()
+    {
+        if (m_buffer)
+        {
+            munmap((void *) m_buffer, m_size);
+        }
+        m_buffer = 0;
+        m_size   = 0;
+    }
+#endif
+}
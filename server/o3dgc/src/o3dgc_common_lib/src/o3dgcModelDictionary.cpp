@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "o3dgcModelDictionary.h"
+
+namespace o3dgc
+{
+    struct ModelDictionaryEntry
+    {
+        const unsigned short *      m_counts;                       // prior symbol counts (bit models: {#0, #1})
+        unsigned long               m_numCounts;
+    };
+
+    // O3DGC_MODEL_DICTIONARY_SMALL_MESHES: symbol statistics gathered by encoding the COLLADA models of 
+    // static/models split into one mesh per geometry (meshes with at most 4096 vertices, default quantization), 
+    // normalized to a total of 512 so that the models keep adapting quickly to the mesh being coded.
+    static const unsigned short g_smallMeshesTFANNumTFANs[3] = 
+    {
+        193, 313, 6
+    };
+    static const unsigned short g_smallMeshesTFANDegrees[10] = 
+    {
+        42, 67, 95, 31, 53, 168, 31, 13, 4, 3
+    };
+    static const unsigned short g_smallMeshesTFANConfigs[10] = 
+    {
+        121, 1, 37, 7, 70, 151, 12, 82, 17, 12
+    };
+    static const unsigned short g_smallMeshesTFANOperations[2] = 
+    {
+        195, 317
+    };
+    static const unsigned short g_smallMeshesTFANIndices[9] = 
+    {
+        34, 12, 16, 32, 25, 14, 21, 13, 345
+    };
+    static const unsigned short g_smallMeshesNormalOrientations[11] = 
+    {
+        353, 57, 59, 8, 10, 5, 8, 2, 6, 1, 2
+    };
+    static const unsigned short g_smallMeshesPredictors[2] = 
+    {
+        403, 109
+    };
+    static const unsigned short g_smallMeshesPositionValues[257] = 
+    {
+        182, 14, 13, 9, 9, 7, 6, 5, 7, 4, 6, 4, 4, 3, 4, 3,
+        3, 3, 3, 3, 3, 3, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 2, 2, 1, 1, 2,
+        2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        68
+    };
+    static const unsigned short g_smallMeshesNormalValues[257] = 
+    {
+        156, 30, 33, 17, 17, 10, 13, 8, 7, 7, 7, 6, 6, 4, 4, 4,
+        3, 4, 3, 2, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        1, 2, 2, 2, 1, 2, 1, 2, 1, 2, 2, 1, 1, 2, 2, 2,
+        2, 3, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 2, 2, 3,
+        2, 3, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        2
+    };
+    static const unsigned short g_smallMeshesTexCoordValues[257] = 
+    {
+        163, 28, 28, 17, 18, 10, 9, 6, 7, 7, 6, 8, 6, 4, 4, 3,
+        3, 4, 3, 3, 3, 2, 2, 3, 3, 2, 2, 2, 2, 1, 1, 2,
+        2, 2, 1, 3, 2, 1, 1, 3, 3, 1, 1, 2, 3, 3, 3, 3,
+        3, 2, 2, 1, 1, 1, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        21
+    };
+    static const ModelDictionaryEntry g_smallMeshes[O3DGC_MODEL_DICTIONARY_NUM_ENTRIES] = 
+    {
+        { g_smallMeshesTFANNumTFANs, 3 },
+        { g_smallMeshesTFANDegrees, 10 },
+        { g_smallMeshesTFANConfigs, 10 },
+        { g_smallMeshesTFANOperations, 2 },
+        { g_smallMeshesTFANIndices, 9 },
+        { g_smallMeshesNormalOrientations, 11 },
+        { g_smallMeshesPredictors, 2 },
+        { g_smallMeshesPositionValues, 257 },
+        { g_smallMeshesNormalValues, 257 },
+        { 0, 0 },
+        { g_smallMeshesTexCoordValues, 257 },
+        { 0, 0 }
+    };
+
+    static const ModelDictionaryEntry * GetModelDictionaryEntry(O3DGCModelDictionary dictionary, 
+                                                                O3DGCModelDictionaryEntry entry)
+    {
+        if (entry >= O3DGC_MODEL_DICTIONARY_NUM_ENTRIES)
+        {
+            return 0;
+        }
+        const ModelDictionaryEntry * dictionaryEntry = 0;
+        switch(dictionary)
+        {
+        case O3DGC_MODEL_DICTIONARY_SMALL_MESHES: dictionaryEntry = g_smallMeshes + entry; break;
+        default:                                  return 0;
+        }
+        return (dictionaryEntry->m_numCounts > 0) ? dictionaryEntry : 0;
+    }
+    bool IsValidModelDictionary(unsigned long dictionary)
+    {
+        return dictionary == O3DGC_MODEL_DICTIONARY_NONE || 
+               dictionary == O3DGC_MODEL_DICTIONARY_SMALL_MESHES;
+    }
+    const unsigned short * GetModelDictionaryCounts(O3DGCModelDictionary dictionary, 
+                                                    O3DGCModelDictionaryEntry entry, 
+                                                    unsigned long & numCounts)
+    {
+        const ModelDictionaryEntry * dictionaryEntry = GetModelDictionaryEntry(dictionary, entry);
+        numCounts = (dictionaryEntry) ? dictionaryEntry->m_numCounts : 0;
+        return (dictionaryEntry) ? dictionaryEntry->m_counts : 0;
+    }
+    bool SeedModel(O3DGCModelDictionary dictionary, 
+                   O3DGCModelDictionaryEntry entry, 
+                   Adaptive_Data_Model & model)
+    {
+        const ModelDictionaryEntry * dictionaryEntry = GetModelDictionaryEntry(dictionary, entry);
+        if (!dictionaryEntry || dictionaryEntry->m_numCounts > model.model_symbols())
+        {
+            return false;
+        }
+        model.set_counts(dictionaryEntry->m_counts, dictionaryEntry->m_numCounts);
+        return true;
+    }
+    bool SeedModel(O3DGCModelDictionary dictionary, 
+                   O3DGCModelDictionaryEntry entry, 
+                   Adaptive_Bit_Model & model)
+    {
+        const ModelDictionaryEntry * dictionaryEntry = GetModelDictionaryEntry(dictionary, entry);
+        if (!dictionaryEntry || dictionaryEntry->m_numCounts != 2)
+        {
+            return false;
+        }
+        model.set_counts(dictionaryEntry->m_counts[0], dictionaryEntry->m_counts[0] + dictionaryEntry->m_counts[1]);
+        return true;
+    }
+}
@@ -0,0 +1,340 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include "o3dgcRANSCodec.h"
+
+namespace o3dgc
+{
+    // - - Constants - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    const unsigned RANS__ScaleBits   = 15;           // models are scaled to 2^15
+    const unsigned RANS__ScaleMask   = (1U << RANS__ScaleBits) - 1;
+    const unsigned RANS__LowerBound  = 1U << 23;   // lower bound of the state
+    const unsigned RANS__BitShift    = RANS__ScaleBits - 13; // bit models: 2^13
+    const unsigned RANS__MinSymbols  = 1024;  // initial size of the symbol buffer
+
+    // - - Static functions  - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    static void RANS_Error(const char * msg)
+    {
+      fprintf(stderr, "\n\n -> rANS coding error: ");
+      fputs(msg, stderr);
+      fputs("\n Execution terminated!\n", stderr);
+      exit(1);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // - - Coding implementations  - - - - - - - - - - - - - - - - - - - - - - - -
+
+    inline void RANS_Codec::put_symbol(unsigned start, unsigned freq)
+    {
+      if (symbol_count == symbol_buffer_size) {            // grow symbol buffer
+        unsigned * tmp = symbol_buffer;
+        symbol_buffer_size = (symbol_buffer_size < RANS__MinSymbols) ? RANS__MinSymbols : 2 * symbol_buffer_size;
+        symbol_buffer = new unsigned[symbol_buffer_size];
+        if (symbol_count) memcpy(symbol_buffer, tmp, sizeof(unsigned) * symbol_count);
+        delete [] tmp;
+      }
+      symbol_buffer[symbol_count++] = start | (freq << 16);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    inline unsigned RANS_Codec::get_slot(void)
+    {
+      return state[lane] & RANS__ScaleMask;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    inline void RANS_Codec::advance(unsigned slot, unsigned start, unsigned freq)
+    {
+      unsigned x = freq * (state[lane] >> RANS__ScaleBits) + slot - start;
+      while (x < RANS__LowerBound) x = (x << 8) | unsigned(*rans_pointer++);
+      state[lane] = x;
+      lane = (lane + 1) & (RANS__NumStates - 1);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::encode(unsigned bit,
+                            Static_Bit_Model & M)
+    {
+      unsigned p0 = M.bit_0_prob << RANS__BitShift;
+      if (bit == 0)
+        put_symbol(0, p0);
+      else
+        put_symbol(p0, (1U << RANS__ScaleBits) - p0);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    unsigned RANS_Codec::decode(Static_Bit_Model & M)
+    {
+      unsigned p0   = M.bit_0_prob << RANS__BitShift;
+      unsigned slot = get_slot();
+      unsigned bit  = (slot >= p0);
+      if (bit == 0)
+        advance(slot, 0, p0);
+      else
+        advance(slot, p0, (1U << RANS__ScaleBits) - p0);
+      return bit;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::encode(unsigned bit,
+                            Adaptive_Bit_Model & M)
+    {
+      unsigned p0 = M.bit_0_prob << RANS__BitShift;
+      if (bit == 0) {
+        put_symbol(0, p0);
+        ++M.bit_0_count;
+      }
+      else
+        put_symbol(p0, (1U << RANS__ScaleBits) - p0);
+
+      if (--M.bits_until_update == 0) M.update();         // periodic model update
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    unsigned RANS_Codec::decode(Adaptive_Bit_Model & M)
+    {
+      unsigned p0   = M.bit_0_prob << RANS__BitShift;
+      unsigned slot = get_slot();
+      unsigned bit  = (slot >= p0);
+      if (bit == 0) {
+        advance(slot, 0, p0);
+        ++M.bit_0_count;
+      }
+      else
+        advance(slot, p0, (1U << RANS__ScaleBits) - p0);
+
+      if (--M.bits_until_update == 0) M.update();         // periodic model update
+
+      return bit;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::encode(unsigned data,
+                            Static_Data_Model & M)
+    {
+    #ifdef _DEBUG
+      if (data >= M.data_symbols) RANS_Error("invalid data symbol");
+    #endif
+      unsigned start = M.distribution[data];
+      unsigned end   = (data == M.last_symbol) ? (1U << RANS__ScaleBits) : M.distribution[data+1];
+      put_symbol(start, end - start);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    unsigned RANS_Codec::decode(Static_Data_Model & M)
+    {
+      if (M.slot_table == 0) {       // the model never changes: map every slot to
+        M.slot_table = new unsigned short[1U << RANS__ScaleBits];  // its symbol
+        for (unsigned s = 0; s < M.data_symbols; ++s) {
+          unsigned end = (s == M.last_symbol) ? (1U << RANS__ScaleBits) : M.distribution[s+1];
+          for (unsigned k = M.distribution[s]; k < end; ++k)
+            M.slot_table[k] = (unsigned short) s;
+        }
+      }
+      unsigned slot  = get_slot();
+      unsigned s     = M.slot_table[slot];         // a single look-up per symbol
+      unsigned start = M.distribution[s];
+      unsigned end   = (s == M.last_symbol) ? (1U << RANS__ScaleBits) : M.distribution[s+1];
+      advance(slot, start, end - start);
+      return s;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::encode(unsigned data,
+                            Adaptive_Data_Model & M)
+    {
+    #ifdef _DEBUG
+      if (data >= M.data_symbols) RANS_Error("invalid data symbol");
+    #endif
+      unsigned start = M.distribution[data];
+      unsigned end   = (data == M.last_symbol) ? (1U << RANS__ScaleBits) : M.distribution[data+1];
+      put_symbol(start, end - start);
+
+      ++M.symbol_count[data];
+      if (--M.symbols_until_update == 0) M.update(true);  // periodic model update
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    unsigned RANS_Codec::decode(Adaptive_Data_Model & M)
+    {
+      unsigned slot = get_slot();
+      unsigned s, n;
+      if (M.decoder_table) {              // use table look-up for faster decoding
+        unsigned t = slot >> M.table_shift;
+        s = M.decoder_table[t];         // initial decision based on table look-up
+        n = M.decoder_table[t+1] + 1;
+      }
+      else {
+        s = 0;
+        n = M.data_symbols;
+      }
+      while (n > s + 1) {                          // finish with bisection search
+        unsigned m = (s + n) >> 1;
+        if (M.distribution[m] > slot) n = m; else s = m;
+      }
+      unsigned start = M.distribution[s];
+      unsigned end   = (s == M.last_symbol) ? (1U << RANS__ScaleBits) : M.distribution[s+1];
+      advance(slot, start, end - start);
+
+      ++M.symbol_count[s];
+      if (--M.symbols_until_update == 0) M.update(false);  // periodic model update
+
+      return s;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // - - Other RANS_Codec implementations  - - - - - - - - - - - - - - - - - - -
+
+    RANS_Codec::RANS_Codec(void)
+    {
+      mode = buffer_size = 0;
+      new_buffer = code_buffer = 0;
+      symbol_count = symbol_buffer_size = 0;       // allocated on first symbol
+      symbol_buffer = 0;
+    }
+
+    RANS_Codec::RANS_Codec(unsigned max_code_bytes,
+                           unsigned char * user_buffer)
+    {
+      mode = buffer_size = 0;
+      new_buffer = code_buffer = 0;
+      symbol_count = symbol_buffer_size = 0;       // allocated on first symbol
+      symbol_buffer = 0;
+      set_buffer(max_code_bytes, user_buffer);
+    }
+
+    RANS_Codec::~RANS_Codec(void)
+    {
+      delete [] new_buffer;
+      delete [] symbol_buffer;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::set_buffer(unsigned max_code_bytes,
+                                unsigned char * user_buffer)
+    {
+      if (!max_code_bytes) RANS_Error("invalid codec buffer size");
+      if (mode != 0) RANS_Error("cannot set buffer while encoding or decoding");
+
+      if (user_buffer != 0) {                       // user provides memory buffer
+        buffer_size = max_code_bytes;
+        code_buffer = user_buffer;               // set buffer for compressed data
+        delete [] new_buffer;                 // free anything previously assigned
+        new_buffer = 0;
+        return;
+      }
+
+      if (max_code_bytes <= buffer_size) return;               // enough available
+
+      buffer_size = max_code_bytes;                           // assign new memory
+      delete [] new_buffer;                   // free anything previously assigned
+      new_buffer = new unsigned char[buffer_size+16];
+      code_buffer = new_buffer;                  // set buffer for compressed data
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::start_encoder(void)
+    {
+      if (mode != 0) RANS_Error("cannot start encoder");
+      if (buffer_size == 0) RANS_Error("no code buffer set");
+
+      mode = 1;
+      symbol_count = 0;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::start_decoder(void)
+    {
+      if (mode != 0) RANS_Error("cannot start decoder");
+      if (buffer_size < 4 * RANS__NumStates) RANS_Error("no code buffer set");
+
+      mode = 2;
+      lane = 0;
+      rans_pointer = code_buffer;         // initial states, least significant first
+      for (unsigned k = 0; k < RANS__NumStates; ++k) {
+        state[k] =  unsigned(rans_pointer[0])        | (unsigned(rans_pointer[1]) <<  8) |
+                   (unsigned(rans_pointer[2]) << 16) | (unsigned(rans_pointer[3]) << 24);
+        rans_pointer += 4;
+      }
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    unsigned RANS_Codec::stop_encoder(void)
+    {
+      if (mode != 1) RANS_Error("invalid to stop encoder");
+      mode = 0;
+
+      for (unsigned k = 0; k < RANS__NumStates; ++k) state[k] = RANS__LowerBound;
+
+      unsigned char * end = code_buffer + buffer_size;
+      unsigned char * ptr = end;                // code symbols backwards (LIFO)
+      for (unsigned i = symbol_count; i-- > 0; ) {
+        unsigned start = symbol_buffer[i] & 0xFFFFU;
+        unsigned freq  = symbol_buffer[i] >> 16;
+        unsigned & x   = state[i & (RANS__NumStates - 1)];
+        unsigned x_max = ((RANS__LowerBound >> RANS__ScaleBits) << 8) * freq;
+        while (x >= x_max) {                                      // renormalize
+          if (ptr == code_buffer) RANS_Error("code buffer overflow");
+          *--ptr = (unsigned char) (x & 0xFF);
+          x >>= 8;
+        }
+        x = ((x / freq) << RANS__ScaleBits) + (x % freq) + start;
+      }
+      for (unsigned k = RANS__NumStates; k-- > 0; ) {        // flush final states
+        if (ptr < code_buffer + 4) RANS_Error("code buffer overflow");
+        ptr -= 4;
+        ptr[0] = (unsigned char) (state[k]      );
+        ptr[1] = (unsigned char) (state[k] >>  8);
+        ptr[2] = (unsigned char) (state[k] >> 16);
+        ptr[3] = (unsigned char) (state[k] >> 24);
+      }
+      unsigned code_bytes = unsigned(end - ptr);
+      memmove(code_buffer, ptr, code_bytes);        // move code to buffer start
+      symbol_count = 0;
+      return code_bytes;                                   // number of bytes used
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void RANS_Codec::stop_decoder(void)
+    {
+      if (mode != 2) RANS_Error("invalid to stop decoder");
+      mode = 0;
+    }
+}
@@ -0,0 +1,507 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "o3dgcSIMD.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define O3DGC_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(O3DGC_SIMD_X86) && defined(__GNUC__)
+#define O3DGC_TARGET_SSE2 __attribute__((target("sse2")))
+#define O3DGC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define O3DGC_TARGET_SSE2
+#define O3DGC_TARGET_AVX2
+#endif
+
+namespace o3dgc
+{
+    //! Number of floats processed at once by the kernels of interleaved vectors: a multiple of the SSE2 and AVX2 
+    //! widths and of every dim in [1, 4], so that the component of each float of a block is fixed.
+    const unsigned long O3DGC_SIMD_BLOCK_SIZE = 24;
+
+    static O3DGCSIMDLevel DetectSIMDLevel()
+    {
+#if defined(O3DGC_SIMD_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        if ((info[3] & (1 << 26)) == 0)
+        {
+            return O3DGC_SIMD_NONE;
+        }
+        // AVX2 also needs the operating system to save the AVX registers
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx     = (info[2] & (1 << 28)) != 0;
+        if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5))
+            {
+                return O3DGC_SIMD_AVX2;
+            }
+        }
+        return O3DGC_SIMD_SSE2;
+#elif defined(O3DGC_SIMD_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return O3DGC_SIMD_AVX2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return O3DGC_SIMD_SSE2;
+        }
+        return O3DGC_SIMD_NONE;
+#else
+        return O3DGC_SIMD_NONE;
+#endif
+    }
+    static const O3DGCSIMDLevel s_supportedSIMDLevel = DetectSIMDLevel();
+    static O3DGCSIMDLevel       s_SIMDLevel          = s_supportedSIMDLevel;
+
+    O3DGCSIMDLevel GetSupportedSIMDLevel()
+    {
+        return s_supportedSIMDLevel;
+    }
+    O3DGCSIMDLevel GetSIMDLevel()
+    {
+        return s_SIMDLevel;
+    }
+    void SetSIMDLevel(O3DGCSIMDLevel level)
+    {
+        s_SIMDLevel = (level < s_supportedSIMDLevel) ? level : s_supportedSIMDLevel;
+    }
+    inline Real QuantizationStep(Real min, Real max, unsigned long nQBits)
+    {
+        const Real r = max - min;
+        return (r > 0.0f) ? (float)((1 << nQBits) - 1) / r : 1.0f;
+    }
+    inline Real IQuantizationStep(Real min, Real max, unsigned long nQBits)
+    {
+        const Real r = max - min;
+        return (r > 0.0f) ? r / (float)((1 << nQBits) - 1) : 1.0f;
+    }
+#ifdef O3DGC_SIMD_X86
+    // The kernels truncate the quantized values to 32 bits, which holds any value of at most 30 bits.
+    O3DGC_TARGET_SSE2 inline void StoreLongsSSE2(long * const dest, __m128i q)
+    {
+        if (sizeof(long) == 8)
+        {
+            const __m128i sign = _mm_srai_epi32(q, 31);
+            _mm_storeu_si128((__m128i *) dest      , _mm_unpacklo_epi32(q, sign));
+            _mm_storeu_si128((__m128i *) (dest + 2), _mm_unpackhi_epi32(q, sign));
+        }
+        else
+        {
+            _mm_storeu_si128((__m128i *) dest, q);
+        }
+    }
+    O3DGC_TARGET_SSE2 inline __m128i LoadLongsSSE2(const long * const src)
+    {
+        if (sizeof(long) == 8)
+        {
+            const __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) src));
+            const __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + 2)));
+            return _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+        return _mm_loadu_si128((const __m128i *) src);
+    }
+    O3DGC_TARGET_AVX2 inline void StoreLongsAVX2(long * const dest, __m256i q)
+    {
+        if (sizeof(long) == 8)
+        {
+            _mm256_storeu_si256((__m256i *) dest      , _mm256_cvtepi32_epi64(_mm256_castsi256_si128(q)));
+            _mm256_storeu_si256((__m256i *) (dest + 4), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(q, 1)));
+        }
+        else
+        {
+            _mm256_storeu_si256((__m256i *) dest, q);
+        }
+    }
+    O3DGC_TARGET_AVX2 inline __m256i LoadLongsAVX2(const long * const src)
+    {
+        if (sizeof(long) == 8)
+        {
+            const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            const __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) src)      , lowHalves);
+            const __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) (src + 4)), lowHalves);
+            return _mm256_inserti128_si256(a, _mm256_castsi256_si128(b), 1);
+        }
+        return _mm256_loadu_si256((const __m256i *) src);
+    }
+    //! Quantizes the first floats of src, by whole blocks, and returns their number.
+    O3DGC_TARGET_SSE2 static unsigned long QuantizeInterleavedSSE2(const Real * const src, 
+                                                                   unsigned long size,
+                                                                   const Real * const minBlock,
+                                                                   const Real * const deltaBlock,
+                                                                   long * const quant)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; k += 4)
+            {
+                const __m128 x = _mm_sub_ps(_mm_loadu_ps(src + e + k), _mm_loadu_ps(minBlock + k));
+                const __m128 y = _mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(deltaBlock + k)), half);
+                StoreLongsSSE2(quant + e + k, _mm_cvttps_epi32(y));
+            }
+        }
+        return e;
+    }
+    O3DGC_TARGET_AVX2 static unsigned long QuantizeInterleavedAVX2(const Real * const src, 
+                                                                   unsigned long size,
+                                                                   const Real * const minBlock,
+                                                                   const Real * const deltaBlock,
+                                                                   long * const quant)
+    {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; k += 8)
+            {
+                const __m256 x = _mm256_sub_ps(_mm256_loadu_ps(src + e + k), _mm256_loadu_ps(minBlock + k));
+                const __m256 y = _mm256_add_ps(_mm256_mul_ps(x, _mm256_loadu_ps(deltaBlock + k)), half);
+                StoreLongsAVX2(quant + e + k, _mm256_cvttps_epi32(y));
+            }
+        }
+        return e;
+    }
+    //! Quantizes the component d of the first vectors, by groups of 4, into consecutive longs and returns their number.
+    O3DGC_TARGET_SSE2 static unsigned long QuantizePlanarSSE2(const Real * const src, 
+                                                              unsigned long num,
+                                                              unsigned long stride,
+                                                              Real min,
+                                                              Real delta,
+                                                              long * const quant)
+    {
+        const __m128 half   = _mm_set1_ps(0.5f);
+        const __m128 vMin   = _mm_set1_ps(min);
+        const __m128 vDelta = _mm_set1_ps(delta);
+        unsigned long v = 0;
+        for(; v + 4 <= num; v += 4)
+        {
+            const Real * const s = src + v * stride;
+            const __m128 x = _mm_sub_ps(_mm_setr_ps(s[0], s[stride], s[2 * stride], s[3 * stride]), vMin);
+            StoreLongsSSE2(quant + v, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, vDelta), half)));
+        }
+        return v;
+    }
+    O3DGC_TARGET_SSE2 static unsigned long IQuantizeInterleavedSSE2(const long * const quant, 
+                                                                    unsigned long size,
+                                                                    const Real * const minBlock,
+                                                                    const Real * const ideltaBlock,
+                                                                    Real * const dest)
+    {
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; k += 4)
+            {
+                const __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(LoadLongsSSE2(quant + e + k)), _mm_loadu_ps(ideltaBlock + k));
+                _mm_storeu_ps(dest + e + k, _mm_add_ps(x, _mm_loadu_ps(minBlock + k)));
+            }
+        }
+        return e;
+    }
+    O3DGC_TARGET_AVX2 static unsigned long IQuantizeInterleavedAVX2(const long * const quant, 
+                                                                    unsigned long size,
+                                                                    const Real * const minBlock,
+                                                                    const Real * const ideltaBlock,
+                                                                    Real * const dest)
+    {
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; k += 8)
+            {
+                const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(LoadLongsAVX2(quant + e + k)), _mm256_loadu_ps(ideltaBlock + k));
+                _mm256_storeu_ps(dest + e + k, _mm256_add_ps(x, _mm256_loadu_ps(minBlock + k)));
+            }
+        }
+        return e;
+    }
+    O3DGC_TARGET_SSE2 static unsigned long IQuantizePlanarSSE2(const long * const quant, 
+                                                               unsigned long num,
+                                                               Real min,
+                                                               Real idelta,
+                                                               Real * const dest,
+                                                               unsigned long stride)
+    {
+        const __m128 vMin    = _mm_set1_ps(min);
+        const __m128 vIDelta = _mm_set1_ps(idelta);
+        Real values[4];
+        unsigned long v = 0;
+        for(; v + 4 <= num; v += 4)
+        {
+            _mm_storeu_ps(values, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(LoadLongsSSE2(quant + v)), vIDelta), vMin));
+            Real * const d = dest + v * stride;
+            d[0]          = values[0];
+            d[stride]     = values[1];
+            d[2 * stride] = values[2];
+            d[3 * stride] = values[3];
+        }
+        return v;
+    }
+    //! Updates the per-float minima and maxima of the blocks with the first floats of tab, by whole blocks, and 
+    //! returns their number. The updates follow the scalar comparisons: a NaN or an equal value is never taken.
+    O3DGC_TARGET_SSE2 static unsigned long ComputeBoundsInterleavedSSE2(const Real * const tab, 
+                                                                        unsigned long size,
+                                                                        Real * const minBlock,
+                                                                        Real * const maxBlock)
+    {
+        __m128 vMin[O3DGC_SIMD_BLOCK_SIZE / 4];
+        __m128 vMax[O3DGC_SIMD_BLOCK_SIZE / 4];
+        for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 4; ++k)
+        {
+            vMin[k] = _mm_loadu_ps(minBlock + 4 * k);
+            vMax[k] = _mm_loadu_ps(maxBlock + 4 * k);
+        }
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 4; ++k)
+            {
+                const __m128 x = _mm_loadu_ps(tab + e + 4 * k);
+                vMin[k] = _mm_min_ps(x, vMin[k]);   // x < min ? x : min
+                vMax[k] = _mm_max_ps(x, vMax[k]);   // x > max ? x : max
+            }
+        }
+        for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 4; ++k)
+        {
+            _mm_storeu_ps(minBlock + 4 * k, vMin[k]);
+            _mm_storeu_ps(maxBlock + 4 * k, vMax[k]);
+        }
+        return e;
+    }
+    O3DGC_TARGET_AVX2 static unsigned long ComputeBoundsInterleavedAVX2(const Real * const tab, 
+                                                                        unsigned long size,
+                                                                        Real * const minBlock,
+                                                                        Real * const maxBlock)
+    {
+        __m256 vMin[O3DGC_SIMD_BLOCK_SIZE / 8];
+        __m256 vMax[O3DGC_SIMD_BLOCK_SIZE / 8];
+        for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 8; ++k)
+        {
+            vMin[k] = _mm256_loadu_ps(minBlock + 8 * k);
+            vMax[k] = _mm256_loadu_ps(maxBlock + 8 * k);
+        }
+        unsigned long e = 0;
+        for(; e + O3DGC_SIMD_BLOCK_SIZE <= size; e += O3DGC_SIMD_BLOCK_SIZE)
+        {
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 8; ++k)
+            {
+                const __m256 x = _mm256_loadu_ps(tab + e + 8 * k);
+                vMin[k] = _mm256_min_ps(x, vMin[k]);
+                vMax[k] = _mm256_max_ps(x, vMax[k]);
+            }
+        }
+        for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE / 8; ++k)
+        {
+            _mm256_storeu_ps(minBlock + 8 * k, vMin[k]);
+            _mm256_storeu_ps(maxBlock + 8 * k, vMax[k]);
+        }
+        return e;
+    }
+#endif // O3DGC_SIMD_X86
+    //! True if the kernels of interleaved vectors apply to vectors of dim floats spaced by stride.
+    inline bool IsInterleavedLayout(unsigned long dim, unsigned long stride)
+    {
+        return (s_SIMDLevel >= O3DGC_SIMD_SSE2 && sizeof(Real) == sizeof(float) && 
+                dim >= 1 && dim <= 4 && stride == dim);
+    }
+    void QuantizeVectors(const Real * const floatArray,
+                         unsigned long num,
+                         unsigned long dim,
+                         unsigned long stride,
+                         const Real * const min,
+                         const Real * const max,
+                         unsigned long nQBits,
+                         long * const quant,
+                         unsigned long quantStride,
+                         unsigned long quantDimStride)
+    {
+#ifdef O3DGC_SIMD_X86
+        if (IsInterleavedLayout(dim, stride) && quantStride == dim && quantDimStride == 1)
+        {
+            Real minBlock  [O3DGC_SIMD_BLOCK_SIZE];
+            Real deltaBlock[O3DGC_SIMD_BLOCK_SIZE];
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; ++k)
+            {
+                minBlock[k]   = min[k % dim];
+                deltaBlock[k] = QuantizationStep(min[k % dim], max[k % dim], nQBits);
+            }
+            const unsigned long size = num * dim;
+            unsigned long e = (s_SIMDLevel >= O3DGC_SIMD_AVX2) ? 
+                              QuantizeInterleavedAVX2(floatArray, size, minBlock, deltaBlock, quant) :
+                              QuantizeInterleavedSSE2(floatArray, size, minBlock, deltaBlock, quant);
+            for(; e < size; ++e)
+            {
+                const unsigned long k = e % dim;
+                quant[e] = (long)((floatArray[e] - minBlock[k]) * deltaBlock[k] + 0.5f);
+            }
+            return;
+        }
+#endif // O3DGC_SIMD_X86
+        for(unsigned long d = 0; d < dim; ++d)
+        {
+            const Real delta = QuantizationStep(min[d], max[d], nQBits);
+            unsigned long v = 0;
+#ifdef O3DGC_SIMD_X86
+            if (s_SIMDLevel >= O3DGC_SIMD_SSE2 && sizeof(Real) == sizeof(float) && quantStride == 1)
+            {
+                v = QuantizePlanarSSE2(floatArray + d, num, stride, min[d], delta, quant + d * quantDimStride);
+            }
+#endif // O3DGC_SIMD_X86
+            for(; v < num; ++v)
+            {
+                quant[v * quantStride + d * quantDimStride] = (long)((floatArray[v * stride + d] - min[d]) * delta + 0.5f);
+            }
+        }
+    }
+    void IQuantizeVectors(const long * const quant,
+                          unsigned long quantStride,
+                          unsigned long quantDimStride,
+                          unsigned long num,
+                          unsigned long dim,
+                          const Real * const min,
+                          const Real * const max,
+                          unsigned long nQBits,
+                          Real * const floatArray,
+                          unsigned long stride)
+    {
+#ifdef O3DGC_SIMD_X86
+        if (IsInterleavedLayout(dim, stride) && quantStride == dim && quantDimStride == 1)
+        {
+            Real minBlock   [O3DGC_SIMD_BLOCK_SIZE];
+            Real ideltaBlock[O3DGC_SIMD_BLOCK_SIZE];
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; ++k)
+            {
+                minBlock[k]    = min[k % dim];
+                ideltaBlock[k] = IQuantizationStep(min[k % dim], max[k % dim], nQBits);
+            }
+            const unsigned long size = num * dim;
+            unsigned long e = (s_SIMDLevel >= O3DGC_SIMD_AVX2) ? 
+                              IQuantizeInterleavedAVX2(quant, size, minBlock, ideltaBlock, floatArray) :
+                              IQuantizeInterleavedSSE2(quant, size, minBlock, ideltaBlock, floatArray);
+            for(; e < size; ++e)
+            {
+                const unsigned long k = e % dim;
+                floatArray[e] = quant[e] * ideltaBlock[k] + minBlock[k];
+            }
+            return;
+        }
+#endif // O3DGC_SIMD_X86
+        for(unsigned long d = 0; d < dim; ++d)
+        {
+            const Real idelta = IQuantizationStep(min[d], max[d], nQBits);
+            unsigned long v = 0;
+#ifdef O3DGC_SIMD_X86
+            if (s_SIMDLevel >= O3DGC_SIMD_SSE2 && sizeof(Real) == sizeof(float) && quantStride == 1)
+            {
+                v = IQuantizePlanarSSE2(quant + d * quantDimStride, num, min[d], idelta, floatArray + d, stride);
+            }
+#endif // O3DGC_SIMD_X86
+            for(; v < num; ++v)
+            {
+                floatArray[v * stride + d] = quant[v * quantStride + d * quantDimStride] * idelta + min[d];
+            }
+        }
+    }
+    void ComputeVectorBounds(const Real * const tab, 
+                             unsigned long size, 
+                             unsigned long dim,
+                             unsigned long stride,
+                             Real * minTab,
+                             Real * maxTab)
+    {
+        for(unsigned long d = 0; d < dim; ++d)
+        {
+            maxTab[d] = minTab[d] = tab[d];
+        }
+        unsigned long first = 1;
+#ifdef O3DGC_SIMD_X86
+        const bool vectorized = IsInterleavedLayout(dim, stride);
+        if (vectorized)
+        {
+            Real minBlock[O3DGC_SIMD_BLOCK_SIZE];
+            Real maxBlock[O3DGC_SIMD_BLOCK_SIZE];
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; ++k)
+            {
+                maxBlock[k] = minBlock[k] = tab[k % dim];
+            }
+            const unsigned long e = (s_SIMDLevel >= O3DGC_SIMD_AVX2) ? 
+                                    ComputeBoundsInterleavedAVX2(tab, size * dim, minBlock, maxBlock) :
+                                    ComputeBoundsInterleavedSSE2(tab, size * dim, minBlock, maxBlock);
+            for(unsigned long k = 0; k < O3DGC_SIMD_BLOCK_SIZE; ++k)
+            {
+                const unsigned long d = k % dim;
+                if (maxTab[d] < maxBlock[k]) maxTab[d] = maxBlock[k];
+                if (minTab[d] > minBlock[k]) minTab[d] = minBlock[k];
+            }
+            first = (e > 0) ? e / dim : 1;
+        }
+#endif // O3DGC_SIMD_X86
+        for(unsigned long i = first; i < size; ++i)
+        {
+            const Real * const p = tab + i * stride;
+            for(unsigned long d = 0; d < dim; ++d)
+            {
+                if (maxTab[d] < p[d]) maxTab[d] = p[d];
+                if (minTab[d] > p[d]) minTab[d] = p[d];
+            }
+        }
+#ifdef O3DGC_SIMD_X86
+        if (vectorized)
+        {
+            // -0 and +0 are equal: the scalar scan keeps the first zero, while the blocks may have kept any of them
+            for(unsigned long d = 0; d < dim; ++d)
+            {
+                for(unsigned long i = 0; minTab[d] == 0.0f && i < size; ++i)
+                {
+                    if (tab[i * stride + d] == 0.0f)
+                    {
+                        minTab[d] = tab[i * stride + d];
+                        break;
+                    }
+                }
+                for(unsigned long i = 0; maxTab[d] == 0.0f && i < size; ++i)
+                {
+                    if (tab[i * stride + d] == 0.0f)
+                    {
+                        maxTab[d] = tab[i * stride + d];
+                        break;
+                    }
+                }
+            }
+        }
+#endif // O3DGC_SIMD_X86
+    }
+}
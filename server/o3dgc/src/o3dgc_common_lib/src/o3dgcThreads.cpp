@@ -0,0 +1,363 @@
+/*
+Copyright (c) 2013 Khaled Mammou - Advanced Micro Devices, Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "o3dgcThreads.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace o3dgc
+{
+    struct ThreadTask
+    {
+        O3DGCThreadFunction     m_function;
+        void *                  m_data;
+        unsigned long           m_threadID;
+    };
+#ifdef WIN32
+    static DWORD WINAPI RunThreadTask(LPVOID task)
+    {
+        const ThreadTask * const t = (const ThreadTask *) task;
+        t->m_function(t->m_threadID, t->m_data);
+        return 0;
+    }
+    unsigned long GetNumProcessors()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (info.dwNumberOfProcessors > 0) ? (unsigned long) info.dwNumberOfProcessors : 1;
+    }
+    void RunParallel(O3DGCThreadFunction function, void * data, unsigned long numThreads)
+    {
+        assert(numThreads <= O3DGC_MAX_NUM_THREADS);
+        ThreadTask tasks  [O3DGC_MAX_NUM_THREADS];
+        HANDLE     threads[O3DGC_MAX_NUM_THREADS];
+        for(unsigned long i = 1; i < numThreads; ++i)
+        {
+            tasks[i].m_function = function;
+            tasks[i].m_data     = data;
+            tasks[i].m_threadID = i;
+            threads[i] = CreateThread(NULL, 0, RunThreadTask, &tasks[i], 0, NULL);
+            if (threads[i] == NULL)
+            {
+                function(i, data);
+            }
+        }
+        if (numThreads > 0)
+        {
+            function(0, data);
+        }
+        for(unsigned long i = 1; i < numThreads; ++i)
+        {
+            if (threads[i] != NULL)
+            {
+                WaitForSingleObject(threads[i], INFINITE);
+                CloseHandle(threads[i]);
+            }
+        }
+    }
+    bool Thread::Start(O3DGCThreadFunction function, void * data, unsigned long threadID)
+    {
+        assert(m_handle == 0);
+        ThreadTask * const task = new ThreadTask;
+        task->m_function = function;
+        task->m_data     = data;
+        task->m_threadID = threadID;
+        m_data           = task;
+        m_handle         = CreateThread(NULL, 0, RunThreadTask, task, 0, NULL);
+        if (m_handle == NULL)
+        {
+            delete task;
+            m_handle = 0;
+            return false;
+        }
+        return true;
+    }
+    void Thread::Join()
+    {
+        if (m_handle != 0)
+        {
+            WaitForSingleObject((HANDLE) m_handle, INFINITE);
+            CloseHandle((HANDLE) m_handle);
+            delete (ThreadTask *) m_data;
+            m_handle = 0;
+        }
+    }
+    struct ThreadCounterHandle
+    {
+        CRITICAL_SECTION        m_mutex;
+        CONDITION_VARIABLE      m_condition;
+    };
+    ThreadCounter::ThreadCounter(void)
+    {
+        ThreadCounterHandle * const handle = new ThreadCounterHandle;
+        InitializeCriticalSection(&handle->m_mutex);
+        InitializeConditionVariable(&handle->m_condition);
+        m_value  = 0;
+        m_handle = handle;
+    }
+    ThreadCounter::~ThreadCounter(void)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        DeleteCriticalSection(&handle->m_mutex);
+        delete handle;
+    }
+    void ThreadCounter::Set(unsigned long value)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        EnterCriticalSection(&handle->m_mutex);
+        m_value = value;
+        LeaveCriticalSection(&handle->m_mutex);
+        WakeAllConditionVariable(&handle->m_condition);
+    }
+    void ThreadCounter::Wait(unsigned long value)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        EnterCriticalSection(&handle->m_mutex);
+        while (m_value < value)
+        {
+            SleepConditionVariableCS(&handle->m_condition, &handle->m_mutex, INFINITE);
+        }
+        LeaveCriticalSection(&handle->m_mutex);
+    }
+#else
+    static void * RunThreadTask(void * task)
+    {
+        const ThreadTask * const t = (const ThreadTask *) task;
+        t->m_function(t->m_threadID, t->m_data);
+        return 0;
+    }
+    unsigned long GetNumProcessors()
+    {
+        const long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+        return (numProcessors > 0) ? (unsigned long) numProcessors : 1;
+    }
+    void RunParallel(O3DGCThreadFunction function, void * data, unsigned long numThreads)
+    {
+        assert(numThreads <= O3DGC_MAX_NUM_THREADS);
+        ThreadTask tasks  [O3DGC_MAX_NUM_THREADS];
+        pthread_t  threads[O3DGC_MAX_NUM_THREADS];
+        bool       started[O3DGC_MAX_NUM_THREADS];
+        for(unsigned long i = 1; i < numThreads; ++i)
+        {
+            tasks[i].m_function = function;
+            tasks[i].m_data     = data;
+            tasks[i].m_threadID = i;
+            started[i] = (pthread_create(&threads[i], NULL, RunThreadTask, &tasks[i]) == 0);
+            if (!started[i])
+            {
+                function(i, data);
+            }
+        }
+        if (numThreads > 0)
+        {
+            function(0, data);
+        }
+        for(unsigned long i = 1; i < numThreads; ++i)
+        {
+            if (started[i])
+            {
+                pthread_join(threads[i], NULL);
+            }
+        }
+    }
+    bool Thread::Start(O3DGCThreadFunction function, void * data, unsigned long threadID)
+    {
+        assert(m_handle == 0);
+        ThreadTask * const task = new ThreadTask;
+        pthread_t * const thread = new pthread_t;
+        task->m_function = function;
+        task->m_data     = data;
+        task->m_threadID = threadID;
+        if (pthread_create(thread, NULL, RunThreadTask, task) != 0)
+        {
+            delete task;
+            delete thread;
+            return false;
+        }
+        m_data   = task;
+        m_handle = thread;
+        return true;
+    }
+    void Thread::Join()
+    {
+        if (m_handle != 0)
+        {
+            pthread_join(*((pthread_t *) m_handle), NULL);
+            delete (pthread_t *) m_handle;
+            delete (ThreadTask *) m_data;
+            m_handle = 0;
+        }
+    }
+    struct ThreadCounterHandle
+    {
+        pthread_mutex_t         m_mutex;
+        pthread_cond_t          m_condition;
+    };
+    ThreadCounter::ThreadCounter(void)
+    {
+        ThreadCounterHandle * const handle = new ThreadCounterHandle;
+        pthread_mutex_init(&handle->m_mutex, NULL);
+        pthread_cond_init(&handle->m_condition, NULL);
+        m_value  = 0;
+        m_handle = handle;
+    }
+    ThreadCounter::~ThreadCounter(void)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        pthread_cond_destroy(&handle->m_condition);
+        pthread_mutex_destroy(&handle->m_mutex);
+        delete handle;
+    }
+    void ThreadCounter::Set(unsigned long value)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        pthread_mutex_lock(&handle->m_mutex);
+        m_value = value;
+        pthread_cond_broadcast(&handle->m_condition);
+        pthread_mutex_unlock(&handle->m_mutex);
+    }
+    void ThreadCounter::Wait(unsigned long value)
+    {
+        ThreadCounterHandle * const handle = (ThreadCounterHandle *) m_handle;
+        pthread_mutex_lock(&handle->m_mutex);
+        while (m_value < value)
+        {
+            pthread_cond_wait(&handle->m_condition, &handle->m_mutex);
+        }
+        pthread_mutex_unlock(&handle->m_mutex);
+    }
+#endif
+    //! State of the workers of a ThreadPool: worker i runs the task i of the runs from m_firstRun[i] on, each one
+    //! started by m_start reaching its number and completed by m_done[i] reaching it.
+    struct ThreadPoolState
+    {
+        Thread                  m_threads [O3DGC_MAX_NUM_THREADS];
+        ThreadCounter           m_done    [O3DGC_MAX_NUM_THREADS];
+        unsigned long           m_firstRun[O3DGC_MAX_NUM_THREADS];
+        ThreadCounter           m_start;
+        unsigned long           m_numWorkers;   //!< workers 1, ..., m_numWorkers are started
+        unsigned long           m_run;          //!< number of the last run
+        O3DGCThreadFunction     m_function;
+        void *                  m_data;
+        unsigned long           m_numThreads;
+        bool                    m_exit;
+    };
+    static void RunPoolWorker(unsigned long threadID, void * data)
+    {
+        ThreadPoolState & pool = *((ThreadPoolState *) data);
+        for(unsigned long run = pool.m_firstRun[threadID]; ; ++run)
+        {
+            pool.m_start.Wait(run);
+            if (pool.m_exit)
+            {
+                return;
+            }
+            if (threadID < pool.m_numThreads)
+            {
+                pool.m_function(threadID, pool.m_data);
+            }
+            pool.m_done[threadID].Set(run);
+        }
+    }
+    ThreadPool::ThreadPool(void)
+    {
+        m_handle = 0;
+    }
+    ThreadPool::~ThreadPool(void)
+    {
+        ThreadPoolState * const pool = (ThreadPoolState *) m_handle;
+        if (pool)
+        {
+            pool->m_exit = true;
+            pool->m_start.Set(pool->m_run + 1);
+            for(unsigned long i = 1; i <= pool->m_numWorkers; ++i)
+            {
+                pool->m_threads[i].Join();
+            }
+            delete pool;
+        }
+    }
+    unsigned long ThreadPool::Start(unsigned long numThreads)
+    {
+        numThreads = min(numThreads, O3DGC_MAX_NUM_THREADS);
+        if (numThreads <= 1)
+        {
+            return numThreads;
+        }
+        if (!m_handle)
+        {
+            ThreadPoolState * const pool = new ThreadPoolState;
+            pool->m_numWorkers = 0;
+            pool->m_run        = 0;
+            pool->m_function   = 0;
+            pool->m_data       = 0;
+            pool->m_numThreads = 0;
+            pool->m_exit       = false;
+            m_handle = pool;
+        }
+        ThreadPoolState & pool = *((ThreadPoolState *) m_handle);
+        while (pool.m_numWorkers + 1 < numThreads)
+        {
+            const unsigned long threadID = pool.m_numWorkers + 1;
+            pool.m_firstRun[threadID] = pool.m_run + 1;
+            if (!pool.m_threads[threadID].Start(RunPoolWorker, &pool, threadID))
+            {
+                break;
+            }
+            pool.m_numWorkers = threadID;
+        }
+        return min(numThreads, pool.m_numWorkers + 1);
+    }
+    void ThreadPool::Run(O3DGCThreadFunction function, void * data, unsigned long numThreads)
+    {
+        assert(numThreads <= O3DGC_MAX_NUM_THREADS);
+        if (numThreads <= 1)
+        {
+            if (numThreads == 1)
+            {
+                function(0, data);
+            }
+            return;
+        }
+        const unsigned long numStarted = Start(numThreads);
+        ThreadPoolState & pool = *((ThreadPoolState *) m_handle);
+        pool.m_function   = function;
+        pool.m_data       = data;
+        pool.m_numThreads = numStarted;
+        const unsigned long run = ++pool.m_run;
+        pool.m_start.Set(run);
+        function(0, data);
+        for(unsigned long i = numStarted; i < numThreads; ++i)
+        {
+            function(i, data);
+        }
+        // the idle workers are waited for too, so that none of them sees the parameters of the next run
+        for(unsigned long i = 1; i <= pool.m_numWorkers; ++i)
+        {
+            pool.m_done[i].Wait(run);
+        }
+    }
+}
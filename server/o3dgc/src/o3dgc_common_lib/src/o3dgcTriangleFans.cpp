@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #include "o3dgcTriangleFans.h"
 #include "o3dgcArithmeticCodec.h"
+#include "o3dgcRANSCodec.h"
+#include "o3dgcFrequencyTable.h"
 
 //#define DEBUG_VERBOSE
 
@@ -31,13 +33,14 @@ namespace o3dgc
         FILE* g_fileDebugTF = NULL;
 #endif //DEBUG_VERBOSE
 
-    O3DGCErrorCode    SaveUIntData(const Vector<long> & data,
+    O3DGCErrorCode    SaveUIntData(const Vector<Index> & data,
                                    BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();
         bstream.WriteUInt32ASCII(0);
         const unsigned long size       = data.GetSize();
         bstream.WriteUInt32ASCII(size);
+        bstream.Reserve(size); // at least one symbol per value
         for(unsigned long i = 0; i < size; ++i)
         {
             bstream.WriteUIntASCII(data[i]);
@@ -45,13 +48,14 @@ namespace o3dgc
         bstream.WriteUInt32ASCII(start, bstream.GetSize() - start);
         return O3DGC_OK;
     }
-    O3DGCErrorCode    SaveIntData(const Vector<long> & data,
+    O3DGCErrorCode    SaveIntData(const Vector<Index> & data,
                                   BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();
         bstream.WriteUInt32ASCII(0);
         const unsigned long size       = data.GetSize();
         bstream.WriteUInt32ASCII(size);
+        bstream.Reserve(size);
         for(unsigned long i = 0; i < size; ++i)
         {
             bstream.WriteIntASCII(data[i]);
@@ -59,14 +63,15 @@ namespace o3dgc
         bstream.WriteUInt32ASCII(start, bstream.GetSize() - start);
         return O3DGC_OK;
     }
-    O3DGCErrorCode    SaveBinData(const Vector<long> & data,
+    O3DGCErrorCode    SaveBinData(const Vector<Index> & data,
                                   BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();
         bstream.WriteUInt32ASCII(0);
         const unsigned long size = data.GetSize();
-        long symbol;
+        Index symbol;
         bstream.WriteUInt32ASCII(size);
+        bstream.Reserve((size + O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0 - 1) / O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0);
         for(unsigned long i = 0; i < size; )
         {
             symbol = 0;
@@ -80,14 +85,58 @@ namespace o3dgc
         bstream.WriteUInt32ASCII(start, bstream.GetSize() - start);
         return O3DGC_OK;
     }
-    O3DGCErrorCode    CompressedTriangleFans::SaveUIntAC(const Vector<long> & data,
+    template <class Codec>
+    void              SaveStaticModel(Codec & ace,
+                                      const Vector<Index> & data,
+                                      const Index minValue,
+                                      const unsigned long M,
+                                      const unsigned long numSymbols,
+                                      Static_Data_Model & mModelValues,
+                                      Static_Bit_Model & bModel0,
+                                      Adaptive_Bit_Model & bModel1)
+    {
+        assert(numSymbols <= O3DGC_TFANS_MAX_NUM_SYMBOLS);
+        unsigned long histogram  [O3DGC_TFANS_MAX_NUM_SYMBOLS];
+        unsigned      frequencies[O3DGC_TFANS_MAX_NUM_SYMBOLS];
+        unsigned long value;
+        memset(histogram, 0, sizeof(unsigned long) * numSymbols);
+        const unsigned long size = data.GetSize();
+        for(unsigned long i = 0; i < size; ++i)
+        {
+            value = data[i]-minValue;
+            ++histogram[(value < M)? value : M];
+        }
+        ReduceFrequencies(histogram, numSymbols, frequencies);
+        EncodeFrequencies(ace, frequencies, numSymbols, bModel0, bModel1);
+        mModelValues.set_frequencies(numSymbols, frequencies);
+    }
+    template <class Codec>
+    O3DGCErrorCode    LoadStaticModel(Codec & acd,
+                                      const unsigned long numSymbols,
+                                      Static_Data_Model & mModelValues,
+                                      Static_Bit_Model & bModel0,
+                                      Adaptive_Bit_Model & bModel1)
+    {
+        assert(numSymbols <= O3DGC_TFANS_MAX_NUM_SYMBOLS);
+        unsigned frequencies[O3DGC_TFANS_MAX_NUM_SYMBOLS];
+        O3DGCErrorCode ret = DecodeFrequencies(acd, frequencies, numSymbols, bModel0, bModel1);
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        mModelValues.set_frequencies(numSymbols, frequencies);
+        return O3DGC_OK;
+    }
+    template <class Codec>
+    O3DGCErrorCode    CompressedTriangleFans::SaveUIntAC(const Vector<Index> & data,
                                                          const unsigned long M,
+                                                         O3DGCModelDictionaryEntry entry,
                                                          BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();     
         const unsigned int NMAX = data.GetSize() * 8 + 100;
         const unsigned long size       = data.GetSize();
-        long minValue = O3DGC_MAX_LONG;
+        Index minValue = O3DGC_MAX_LONG;
         bstream.WriteUInt32Bin(0);
         bstream.WriteUInt32Bin(size);
         if (size > 0)
@@ -109,31 +158,38 @@ namespace o3dgc
     #endif //DEBUG_VERBOSE
             }
             bstream.WriteUInt32Bin(minValue);
-            if ( m_sizeBufferAC < NMAX )
-            {
-                delete [] m_bufferAC;
-                m_sizeBufferAC = NMAX;
-                m_bufferAC     = new unsigned char [m_sizeBufferAC];
-            }
-            Arithmetic_Codec ace;
-            ace.set_buffer(NMAX, m_bufferAC);
+            Codec ace;
+            ace.set_buffer(NMAX, bstream.ReserveTail(NMAX));
             ace.start_encoder();
-            Adaptive_Data_Model mModelValues(M+1);
-            for(unsigned long i = 0; i < size; ++i)
+            if (m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
             {
-                ace.encode(data[i]-minValue, mModelValues);
+                Static_Data_Model mModelValues;
+                Static_Bit_Model bModel0;
+                Adaptive_Bit_Model bModel1;
+                SaveStaticModel(ace, data, minValue, M, M+1, mModelValues, bModel0, bModel1);
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    ace.encode(data[i]-minValue, mModelValues);
+                }
             }
-            unsigned long encodedBytes = ace.stop_encoder();
-            for(unsigned long i = 0; i < encodedBytes; ++i)
+            else
             {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
+                Adaptive_Data_Model mModelValues(M+1);
+                SeedModel(m_modelDictionary, entry, mModelValues);
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    ace.encode(data[i]-minValue, mModelValues);
+                }
             }
+            bstream.CommitTail(ace.stop_encoder());
         }
         bstream.WriteUInt32Bin(start, bstream.GetSize() - start);
         return O3DGC_OK;
     }
-    O3DGCErrorCode    CompressedTriangleFans::SaveBinAC(const Vector<long> & data,
-                                                         BinaryStream & bstream) 
+    template <class Codec>
+    O3DGCErrorCode    CompressedTriangleFans::SaveBinAC(const Vector<Index> & data,
+                                                        O3DGCModelDictionaryEntry entry,
+                                                        BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();     
         const unsigned int NMAX = data.GetSize() * 8 + 100;
@@ -142,46 +198,61 @@ namespace o3dgc
         bstream.WriteUInt32Bin(size);
         if (size > 0)
         {
-            if ( m_sizeBufferAC < NMAX )
-            {
-                delete [] m_bufferAC;
-                m_sizeBufferAC = NMAX;
-                m_bufferAC     = new unsigned char [m_sizeBufferAC];
-            }
-            Arithmetic_Codec ace;
-            ace.set_buffer(NMAX, m_bufferAC);
+            Codec ace;
+            ace.set_buffer(NMAX, bstream.ReserveTail(NMAX));
             ace.start_encoder();
-            Adaptive_Bit_Model bModel;
     #ifdef DEBUG_VERBOSE
             printf("-----------\nsize %i, start %i\n", size, start);
             fprintf(g_fileDebugTF, "-----------\nsize %i, start %i\n", size, start);
     #endif //DEBUG_VERBOSE
-            for(unsigned long i = 0; i < size; ++i)
+            if (m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
             {
-                ace.encode(data[i], bModel);
-    #ifdef DEBUG_VERBOSE
-                printf("%i\t%i\n", i, data[i]);
-                fprintf(g_fileDebugTF, "%i\t%i\n", i, data[i]);
-    #endif //DEBUG_VERBOSE
+                Static_Bit_Model bModel;
+                Static_Bit_Model bModel0;
+                Adaptive_Bit_Model bModel1;
+                unsigned long histogram[2] = {0, 0};
+                unsigned frequencies[2];
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    ++histogram[data[i] & 1];
+                }
+                ReduceFrequencies(histogram, 2, frequencies);
+                EncodeFrequencies(ace, frequencies, 2, bModel0, bModel1);
+                SetFrequencies(bModel, frequencies);
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    ace.encode(data[i], bModel);
+                }
             }
-            unsigned long encodedBytes = ace.stop_encoder();
-            for(unsigned long i = 0; i < encodedBytes; ++i)
+            else
             {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
+                Adaptive_Bit_Model bModel;
+                SeedModel(m_modelDictionary, entry, bModel);
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    ace.encode(data[i], bModel);
+    #ifdef DEBUG_VERBOSE
+                    printf("%i\t%i\n", i, data[i]);
+                    fprintf(g_fileDebugTF, "%i\t%i\n", i, data[i]);
+    #endif //DEBUG_VERBOSE
+                }
             }
+            bstream.CommitTail(ace.stop_encoder());
         }
         bstream.WriteUInt32Bin(start, bstream.GetSize() - start);
         return O3DGC_OK;
     }
 
-    O3DGCErrorCode    CompressedTriangleFans::SaveIntACEGC(const Vector<long> & data,
+    template <class Codec>
+    O3DGCErrorCode    CompressedTriangleFans::SaveIntACEGC(const Vector<Index> & data,
                                                             const unsigned long M,
+                                                            O3DGCModelDictionaryEntry entry,
                                                             BinaryStream & bstream) 
     {
         unsigned long start = bstream.GetSize();
         const unsigned int NMAX = data.GetSize() * 8 + 100;
         const unsigned long size       = data.GetSize();
-        long minValue = 0;
+        Index minValue = 0;
         bstream.WriteUInt32Bin(0);
         bstream.WriteUInt32Bin(size);
         if (size > 0)
@@ -202,37 +273,30 @@ namespace o3dgc
 #endif //DEBUG_VERBOSE
             }
             bstream.WriteUInt32Bin(minValue + O3DGC_MAX_LONG);
-            if ( m_sizeBufferAC < NMAX )
-            {
-                delete [] m_bufferAC;
-                m_sizeBufferAC = NMAX;
-                m_bufferAC     = new unsigned char [m_sizeBufferAC];
-            }
-            Arithmetic_Codec ace;
-            ace.set_buffer(NMAX, m_bufferAC);
+            Codec ace;
+            ace.set_buffer(NMAX, bstream.ReserveTail(NMAX));
             ace.start_encoder();
-            Adaptive_Data_Model mModelValues(M+2);
             Static_Bit_Model bModel0;
             Adaptive_Bit_Model bModel1;
-            unsigned long value;
-            for(unsigned long i = 0; i < size; ++i)
+            if (m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
             {
-                value = data[i]-minValue;
-                if (value < M) 
-                {
-                    ace.encode(value, mModelValues);
-                }
-                else 
+                Static_Data_Model mModelValues;
+                SaveStaticModel(ace, data, minValue, M, M+2, mModelValues, bModel0, bModel1);
+                for(unsigned long i = 0; i < size; ++i)
                 {
-                    ace.encode(M, mModelValues);
-                    ace.ExpGolombEncode(value-M, 0, bModel0, bModel1);
+                    EncodeUIntACEGC(data[i]-minValue, ace, mModelValues, bModel0, bModel1, M);
                 }
             }
-            unsigned long encodedBytes = ace.stop_encoder();
-            for(unsigned long i = 0; i < encodedBytes; ++i)
+            else
             {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
+                Adaptive_Data_Model mModelValues(M+2);
+                SeedModel(m_modelDictionary, entry, mModelValues);
+                for(unsigned long i = 0; i < size; ++i)
+                {
+                    EncodeUIntACEGC(data[i]-minValue, ace, mModelValues, bModel0, bModel1, M);
+                }
             }
+            bstream.CommitTail(ace.stop_encoder());
         }
         bstream.WriteUInt32Bin(start, bstream.GetSize() - start);
         return O3DGC_OK;
@@ -255,16 +319,28 @@ namespace o3dgc
                 SaveUIntData(m_trianglesOrder, bstream);
             }
         }
+        else if (m_binarization == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            SaveIntACEGC<RANS_Codec>(m_numTFANs  , 4 , O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_NUM_TFANS, bstream);
+            SaveIntACEGC<RANS_Codec>(m_degrees   , 16, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_DEGREES, bstream);
+            SaveUIntAC  <RANS_Codec>(m_configs   , 10, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_CONFIGS, bstream);
+            SaveBinAC   <RANS_Codec>(m_operations,     O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_OPERATIONS, bstream);
+            SaveIntACEGC<RANS_Codec>(m_indices   , 8 , O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_INDICES, bstream);
+            if (encodeTrianglesOrder)
+            {
+                SaveIntACEGC<RANS_Codec>(m_trianglesOrder , 16, O3DGC_MODEL_DICTIONARY_ENTRY_NONE, bstream);
+            }
+        }
         else
         {
-            SaveIntACEGC(m_numTFANs  , 4 , bstream);
-            SaveIntACEGC(m_degrees   , 16, bstream);
-            SaveUIntAC  (m_configs   , 10, bstream);
-            SaveBinAC   (m_operations,     bstream);
-            SaveIntACEGC(m_indices   , 8 , bstream);
+            SaveIntACEGC<Arithmetic_Codec>(m_numTFANs  , 4 , O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_NUM_TFANS, bstream);
+            SaveIntACEGC<Arithmetic_Codec>(m_degrees   , 16, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_DEGREES, bstream);
+            SaveUIntAC  <Arithmetic_Codec>(m_configs   , 10, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_CONFIGS, bstream);
+            SaveBinAC   <Arithmetic_Codec>(m_operations,     O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_OPERATIONS, bstream);
+            SaveIntACEGC<Arithmetic_Codec>(m_indices   , 8 , O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_INDICES, bstream);
             if (encodeTrianglesOrder)
             {
-                SaveIntACEGC(m_trianglesOrder , 16, bstream);
+                SaveIntACEGC<Arithmetic_Codec>(m_trianglesOrder , 16, O3DGC_MODEL_DICTIONARY_ENTRY_NONE, bstream);
             }
         }
 #ifdef DEBUG_VERBOSE
@@ -272,7 +348,7 @@ namespace o3dgc
 #endif //DEBUG_VERBOSE
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadUIntData(Vector<long> & data,
+    O3DGCErrorCode    LoadUIntData(Vector<Index> & data,
                                   const BinaryStream & bstream,
                                   unsigned long & iterator) 
     {
@@ -286,7 +362,7 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadIntData(Vector<long> & data,
+    O3DGCErrorCode    LoadIntData(Vector<Index> & data,
                                   const BinaryStream & bstream,
                                   unsigned long & iterator) 
     {
@@ -300,13 +376,13 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadBinData(Vector<long> & data,
+    O3DGCErrorCode    LoadBinData(Vector<Index> & data,
                                   const BinaryStream & bstream,
                                   unsigned long & iterator) 
     {
         bstream.ReadUInt32ASCII(iterator);
         const unsigned long size = bstream.ReadUInt32ASCII(iterator);
-        long symbol;
+        Index symbol;
         data.Allocate(size * O3DGC_BINARY_STREAM_BITS_PER_SYMBOL0);
         data.Clear();
         for(unsigned long i = 0; i < size;)
@@ -321,8 +397,12 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadUIntAC(Vector<long> & data,
+    template <class Codec>
+    O3DGCErrorCode    LoadUIntAC(Vector<Index> & data,
                                  const unsigned long M,
+                                 O3DGCSC3DMCEntropyModel entropyModel,
+                                 O3DGCModelDictionary dictionary,
+                                 O3DGCModelDictionaryEntry entry,
                                  const BinaryStream & bstream,
                                  unsigned long & iterator) 
     {
@@ -332,19 +412,36 @@ namespace o3dgc
         {
             return O3DGC_OK;
         }
-        long minValue   = bstream.ReadUInt32Bin(iterator);
+        Index minValue   = bstream.ReadUInt32Bin(iterator);
         unsigned char * buffer = 0;
         bstream.GetBuffer(iterator, buffer);
         iterator += sizeSize;
         data.Allocate(size);
-        Arithmetic_Codec acd;
+        Codec acd;
         acd.set_buffer(sizeSize, buffer);
         acd.start_decoder();
-        Adaptive_Data_Model mModelValues(M+1);
 #ifdef DEBUG_VERBOSE
         printf("-----------\nsize %i\n", size);
         fprintf(g_fileDebugTF, "size %i\n", size);
 #endif //DEBUG_VERBOSE
+        if (entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
+        {
+            Static_Data_Model mModelValues;
+            Static_Bit_Model bModel0;
+            Adaptive_Bit_Model bModel1;
+            O3DGCErrorCode ret = LoadStaticModel(acd, M+1, mModelValues, bModel0, bModel1);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+            for(unsigned long i = 0; i < size; ++i)
+            {
+                data.PushBack(acd.decode(mModelValues)+minValue);
+            }
+            return O3DGC_OK;
+        }
+        Adaptive_Data_Model mModelValues(M+1);
+        SeedModel(dictionary, entry, mModelValues);
         for(unsigned long i = 0; i < size; ++i)
         {
             data.PushBack(acd.decode(mModelValues)+minValue);
@@ -355,8 +452,12 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadIntACEGC(Vector<long> & data,
+    template <class Codec>
+    O3DGCErrorCode    LoadIntACEGC(Vector<Index> & data,
                                    const unsigned long M,
+                                   O3DGCSC3DMCEntropyModel entropyModel,
+                                   O3DGCModelDictionary dictionary,
+                                   O3DGCModelDictionaryEntry entry,
                                    const BinaryStream & bstream,
                                    unsigned long & iterator) 
     {
@@ -366,18 +467,33 @@ namespace o3dgc
         {
             return O3DGC_OK;
         }
-        long minValue   = bstream.ReadUInt32Bin(iterator) - O3DGC_MAX_LONG;
+        Index minValue   = bstream.ReadUInt32Bin(iterator) - O3DGC_MAX_LONG;
         unsigned char * buffer = 0;
         bstream.GetBuffer(iterator, buffer);
         iterator += sizeSize;
         data.Allocate(size);
-        Arithmetic_Codec acd;
+        Codec acd;
         acd.set_buffer(sizeSize, buffer);
         acd.start_decoder();
-        Adaptive_Data_Model mModelValues(M+2);
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
+        if (entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
+        {
+            Static_Data_Model mModelValues;
+            O3DGCErrorCode ret = LoadStaticModel(acd, M+2, mModelValues, bModel0, bModel1);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+            for(unsigned long i = 0; i < size; ++i)
+            {
+                data.PushBack(DecodeUIntACEGC(acd, mModelValues, bModel0, bModel1, 0, M) + minValue);
+            }
+            return O3DGC_OK;
+        }
+        Adaptive_Data_Model mModelValues(M+2);
         unsigned long value;
+        SeedModel(dictionary, entry, mModelValues);
 
 #ifdef DEBUG_VERBOSE
         printf("-----------\nsize %i\n", size);
@@ -401,7 +517,11 @@ namespace o3dgc
 #endif //DEBUG_VERBOSE
         return O3DGC_OK;
     }
-    O3DGCErrorCode    LoadBinAC(Vector<long> & data,
+    template <class Codec>
+    O3DGCErrorCode    LoadBinAC(Vector<Index> & data,
+                                O3DGCSC3DMCEntropyModel entropyModel,
+                                O3DGCModelDictionary dictionary,
+                                O3DGCModelDictionaryEntry entry,
                                 const BinaryStream & bstream,
                                 unsigned long & iterator) 
     {
@@ -415,14 +535,33 @@ namespace o3dgc
         bstream.GetBuffer(iterator, buffer);
         iterator += sizeSize;
         data.Allocate(size);
-        Arithmetic_Codec acd;
+        Codec acd;
         acd.set_buffer(sizeSize, buffer);
         acd.start_decoder();
-        Adaptive_Bit_Model bModel;
 #ifdef DEBUG_VERBOSE
         printf("-----------\nsize %i\n", size);
         fprintf(g_fileDebugTF, "size %i\n", size);
 #endif //DEBUG_VERBOSE
+        if (entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
+        {
+            Static_Bit_Model bModel;
+            Static_Bit_Model bModel0;
+            Adaptive_Bit_Model bModel1;
+            unsigned frequencies[2];
+            O3DGCErrorCode ret = DecodeFrequencies(acd, frequencies, 2, bModel0, bModel1);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+            SetFrequencies(bModel, frequencies);
+            for(unsigned long i = 0; i < size; ++i)
+            {
+                data.PushBack(acd.decode(bModel));
+            }
+            return O3DGC_OK;
+        }
+        Adaptive_Bit_Model bModel;
+        SeedModel(dictionary, entry, bModel);
         for(unsigned long i = 0; i < size; ++i)
         {
             data.PushBack(acd.decode(bModel));
@@ -441,6 +580,7 @@ namespace o3dgc
 #ifdef DEBUG_VERBOSE
         g_fileDebugTF = fopen("Load_new.txt", "w");
 #endif //DEBUG_VERBOSE
+        O3DGCErrorCode ret = O3DGC_OK;
         if (streamType == O3DGC_STREAM_TYPE_ASCII)
         {
             LoadUIntData(m_numTFANs  , bstream, iterator);
@@ -453,23 +593,38 @@ namespace o3dgc
                 LoadUIntData(m_trianglesOrder , bstream, iterator);
             }
         }
+        else if (m_binarization == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            ret = LoadAC<RANS_Codec>(bstream, iterator, decodeTrianglesOrder);
+        }
         else
         {
-            LoadIntACEGC(m_numTFANs  , 4 , bstream, iterator);
-            LoadIntACEGC(m_degrees   , 16, bstream, iterator);
-            LoadUIntAC  (m_configs   , 10, bstream, iterator);
-            LoadBinAC   (m_operations,     bstream, iterator);
-            LoadIntACEGC(m_indices   , 8 , bstream, iterator);
-            if (decodeTrianglesOrder)
-            {
-                LoadIntACEGC(m_trianglesOrder , 16, bstream, iterator);
-            }
+            ret = LoadAC<Arithmetic_Codec>(bstream, iterator, decodeTrianglesOrder);
         }
 
 #ifdef DEBUG_VERBOSE
         fclose(g_fileDebugTF);
 #endif //DEBUG_VERBOSE
+        return ret;
+    }
+    template <class Codec>
+    O3DGCErrorCode    CompressedTriangleFans::LoadAC(const BinaryStream & bstream,
+                                                     unsigned long & iterator, 
+                                                     bool decodeTrianglesOrder) 
+    {
+        O3DGCErrorCode ret;
+        if ((ret = LoadIntACEGC<Codec>(m_numTFANs  , 4 , m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_NUM_TFANS, bstream, iterator)) != O3DGC_OK ||
+            (ret = LoadIntACEGC<Codec>(m_degrees   , 16, m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_DEGREES, bstream, iterator)) != O3DGC_OK ||
+            (ret = LoadUIntAC  <Codec>(m_configs   , 10, m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_CONFIGS, bstream, iterator)) != O3DGC_OK ||
+            (ret = LoadBinAC   <Codec>(m_operations,     m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_OPERATIONS, bstream, iterator)) != O3DGC_OK ||
+            (ret = LoadIntACEGC<Codec>(m_indices   , 8 , m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_TFAN_INDICES, bstream, iterator)) != O3DGC_OK)
+        {
+            return ret;
+        }
+        if (decodeTrianglesOrder)
+        {
+            return LoadIntACEGC<Codec>(m_trianglesOrder , 16, m_entropyModel, m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_NONE, bstream, iterator);
+        }
         return O3DGC_OK;
     }
 }
-
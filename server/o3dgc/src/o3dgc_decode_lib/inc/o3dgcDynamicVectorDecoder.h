@@ -61,6 +61,12 @@ namespace o3dgc
                                               const Real * const minFloatArray,
                                               const Real * const maxFloatArray,
                                               unsigned long nQBits);
+        template <class Codec>
+        O3DGCErrorCode              DecodeAC(Codec & acd,
+                                             unsigned long num, 
+                                             unsigned long dim, 
+                                             unsigned long streamSize, 
+                                             const BinaryStream & bstream);
 
         unsigned long               m_streamSize;
         unsigned long               m_maxNumVectors;
@@ -30,40 +30,195 @@ THE SOFTWARE.
 #include "o3dgcIndexedFaceSet.h"
 #include "o3dgcSC3DMCEncodeParams.h"
 #include "o3dgcTriangleListDecoder.h"
+#include "o3dgcMultiLaneCodec.h"
+#include "o3dgcModelDictionary.h"
+#include "o3dgcSC3DMCTableOfContents.h"
+#include "o3dgcSC3DMCSegmentIndex.h"
+#include "o3dgcSC3DMCPredictorTable.h"
+#include "o3dgcThreads.h"
+#include "o3dgcVertexCacheOptimizer.h"
+#include "o3dgcTriangleBatches.h"
+#include "o3dgcSIMD.h"
 
 namespace o3dgc
 {    
-    //! 
+    //! Number of vertices per chunk of the float attribute decoding pipeline, and number of chunks in flight.
+    const long          O3DGC_SC3DMC_DECODE_CHUNK_SIZE = 4096;
+    const long          O3DGC_SC3DMC_DECODE_NUM_CHUNKS = 8;
+
     template <class T>
-    class SC3DMCDecoder
+    class SC3DMCDecoder;
+
+    //! Shared state of the threads decoding the segments: thread i decodes the segments i, i + m_numThreads, ...
+    template <class T>
+    struct SC3DMCSegmentDecodeTask
+    {
+        const SC3DMCDecoder<T> *        m_decoder;
+        IndexedFaceSet<T> *             m_ifs;
+        const BinaryStream *            m_bstream;
+        const SC3DMCSectionSelection *  m_selection;
+        SC3DMCStats *                   m_stats;
+        O3DGCErrorCode *                m_errors;
+        unsigned long                   m_numThreads;
+    };
+
+    //! Working buffers of the attribute decoding. The threads decoding the attributes concurrently have one each.
+    struct SC3DMCDecodeScratch
     {
-    public:    
         //! Constructor.
-                                    SC3DMCDecoder(void)
+                                    SC3DMCDecodeScratch(void)
                                     {
-                                        m_iterator            = 0;
-                                        m_streamSize          = 0;
                                         m_quantFloatArray     = 0;
                                         m_quantFloatArraySize = 0;
                                         m_normals             = 0;
                                         m_normalsSize         = 0;
-                                        m_streamType          = O3DGC_STREAM_TYPE_UNKOWN;
+                                        m_numThreads          = 1;
+                                        m_timeEntropyDecoding = 0.0;
+                                        m_timeReconstruction  = 0.0;
                                     };
         //! Destructor.
-                                    ~SC3DMCDecoder(void)
+                                    ~SC3DMCDecodeScratch(void)
                                     {
                                         delete [] m_normals;
                                         delete [] m_quantFloatArray;
                                     }
+        long *                      m_quantFloatArray;
+        unsigned long               m_quantFloatArraySize;
+        Vector<char>                m_orientation;
+        Real *                      m_normals;
+        unsigned long               m_normalsSize;
+        //! Ring of O3DGC_SC3DMC_DECODE_NUM_CHUNKS chunks of decoded residuals and predictor indices.
+        Vector<long>                m_residuals;
+        Vector<unsigned char>       m_bestPreds;
+        //! Number of threads decoding with this scratch: with two or more, the stages of the float attribute 
+        //! decoding run concurrently.
+        unsigned long               m_numThreads;
+        //! Worker running the entropy decoding stage, kept for all the float attributes decoded with this scratch.
+        ThreadPool                  m_threadPool;
+        double                      m_timeEntropyDecoding;
+        double                      m_timeReconstruction;
+    };
+
+    //! State of the two stages of the float attribute decoding. The entropy decoding stage decodes the predictor 
+    //! indices and the residuals of the vertices, chunk by chunk, into the ring of the scratch; the reconstruction 
+    //! stage adds them to their predictions. When they run concurrently, m_decodedChunks and m_reconstructedChunks 
+    //! count the chunks each stage has completed.
+    template <class Model, class Codec>
+    struct SC3DMCFloatArrayDecodeTask
+    {
+        Codec *                         m_acd;
+        MultiLaneCodec<Codec, Model> *  m_lanes;
+        Model *                         m_modelPreds;
+        unsigned long                   m_exp_k;
+        unsigned long                   m_M;
+        O3DGCStreamType                 m_streamType;
+        const BinaryStream *            m_bstream;
+        unsigned long                   m_iterator;
+        unsigned long                   m_iteratorPred;
+        const SC3DMCPredictorTable *    m_predictors;
+        O3DGCSC3DMCPredictionMode       m_predMode;
+        unsigned long                   m_dimFloatArray;
+        unsigned long                   m_stride;
+        long                            m_numVertices;
+        SC3DMCDecodeScratch *           m_scratch;
+        ThreadCounter                   m_decodedChunks;
+        ThreadCounter                   m_reconstructedChunks;
+    };
+
+    //! Shared state of the threads decoding the attribute sections: thread i decodes the sections i, i + m_numThreads, 
+    //! ... of m_sections, each one from m_iterators[section], with m_scratch[i].
+    template <class T>
+    struct SC3DMCAttributeDecodeTask
+    {
+        SC3DMCDecoder<T> *              m_decoder;
+        IndexedFaceSet<T> *             m_ifs;
+        const BinaryStream *            m_bstream;
+        const unsigned long *           m_sections;
+        unsigned long                   m_numSections;
+        unsigned long *                 m_iterators;
+        bool                            m_surfNormals;      //!< the normals are decoded right after the coordinates
+        SC3DMCDecodeScratch *           m_scratch;
+        O3DGCErrorCode *                m_errors;
+        unsigned long                   m_numThreads;
+    };
+
+    //! 
+    template <class T>
+    class SC3DMCDecoder
+    {
+    public:    
+        //! Constructor.
+                                    SC3DMCDecoder(void)
+                                    {
+                                        m_iterator            = 0;
+                                        m_streamStart         = 0;
+                                        m_streamSize          = 0;
+                                        m_numThreads          = 1;
+                                        m_regionOfInterest    = false;
+                                        m_segmented           = false;
+                                        m_vertexCacheOptimization = O3DGC_VERTEX_CACHE_OPTIMIZATION_NONE;
+                                        m_maxBatchVertices    = 0;
+                                        m_streamType          = O3DGC_STREAM_TYPE_UNKOWN;
+                                    };
+        //! Destructor.
+                                    ~SC3DMCDecoder(void) {};
         //!
         O3DGCErrorCode              DecodeHeader(IndexedFaceSet<T> & ifs,
                                                  const BinaryStream & bstream);
         //!                         
         O3DGCErrorCode              DecodePlayload(IndexedFaceSet<T> & ifs,
                                                   const BinaryStream & bstream);
+        //! Decodes the selected sections only. The connectivity is decoded whenever an attribute is selected and the
+        //! coordinates whenever the normals are, so their buffers must be set. With a table of contents, the other
+        //! sections are not read at all; otherwise they are skipped using their size field.
+        O3DGCErrorCode              DecodePlayload(IndexedFaceSet<T> & ifs,
+                                                  const BinaryStream & bstream,
+                                                  const SC3DMCSectionSelection & selection);
+        //! Empty when the stream has no table of contents.
+        const SC3DMCTableOfContents & GetTableOfContents() const { return m_toc;}
+        //! Empty when the stream is not segmented.
+        const SC3DMCSegmentIndex &  GetSegmentIndex() const { return m_segments;}
+        //! Restricts the decoding of segmented streams to the segments whose bounding box intersects [min, max]. 
+        //! Must be set before DecodeHeader(), which then gives the size of the selected segments. The region is
+        //! ignored by streams without segments, which are decoded entirely.
+        void                        SetRegionOfInterest(const Real * const min, const Real * const max)
+                                    {
+                                        for(int j = 0; j < 3; ++j)
+                                        {
+                                            m_regionMin[j] = min[j];
+                                            m_regionMax[j] = max[j];
+                                        }
+                                        m_regionOfInterest = true;
+                                    }
+        void                        ClearRegionOfInterest() { m_regionOfInterest = false;}
+        //! Reorders the decoded triangles for the post-transform vertex cache, and optionally renumbers the vertices
+        //! to match; the ACMR before and after is reported in the stats. Streams that carry the original triangle 
+        //! order (e.g. several index buffers) keep it.
+        O3DGCVertexCacheOptimization GetVertexCacheOptimization() const { return m_vertexCacheOptimization;}
+        void                        SetVertexCacheOptimization(O3DGCVertexCacheOptimization vertexCacheOptimization) 
+                                    { 
+                                        m_vertexCacheOptimization = vertexCacheOptimization;
+                                    }
+        //! Splits the decoded triangles into batches of at most maxBatchVertices vertices with 16-bit indices, 
+        //! returned by GetBatches() when the connectivity is selected (0: no batches).
+        unsigned long               GetMaxBatchVertices() const { return m_maxBatchVertices;}
+        void                        SetMaxBatchVertices(unsigned long maxBatchVertices) 
+                                    { 
+                                        assert(maxBatchVertices <= O3DGC_MAX_BATCH_VERTICES);
+                                        m_maxBatchVertices = maxBatchVertices;
+                                    }
+        //! Empty unless SetMaxBatchVertices() was called.
+        const TriangleBatches &     GetBatches() const { return m_batches;}
+        //! Number of threads decoding the segments and the attributes (0: one per processor).
+        unsigned long               GetNumThreads() const { return m_numThreads;}
+        void                        SetNumThreads(unsigned long numThreads)
+                                    {
+                                        assert(numThreads <= O3DGC_MAX_NUM_THREADS);
+                                        m_numThreads = numThreads;
+                                    }
         const SC3DMCStats &         GetStats()    const { return m_stats;}
         unsigned long               GetIterator() const { return m_iterator;}
-        O3DGCErrorCode              SetIterator(unsigned long iterator) { m_iterator = iterator;}
+        O3DGCErrorCode              SetIterator(unsigned long iterator) { m_iterator = iterator; return O3DGC_OK;}
         
 
     private:                        
@@ -76,32 +231,138 @@ namespace o3dgc
                                                      unsigned long nQBits,
                                                      const IndexedFaceSet<T> & ifs,
                                                      O3DGCSC3DMCPredictionMode & predMode,
-                                                     const BinaryStream & bstream);
+                                                     O3DGCIFSFloatAttributeType attributeType,
+                                                     SC3DMCDecodeScratch & scratch,
+                                                     const BinaryStream & bstream,
+                                                     unsigned long & iterator);
+        template <class Model, class Codec>
+        O3DGCErrorCode              DecodeFloatArray(Codec & acd,
+                                                     Real * const floatArray,
+                                                     unsigned long numfloatArraySize,
+                                                     unsigned long dimfloatArraySize,
+                                                     unsigned long stride,
+                                                     const Real * const minfloatArray,
+                                                     const Real * const maxfloatArray,
+                                                     unsigned long nQBits,
+                                                     const IndexedFaceSet<T> & ifs,
+                                                     O3DGCSC3DMCPredictionMode & predMode,
+                                                     O3DGCIFSFloatAttributeType attributeType,
+                                                     SC3DMCDecodeScratch & scratch,
+                                                     const BinaryStream & bstream,
+                                                     unsigned long & iterator);
+        //! Entropy decoding stage of DecodeFloatArray(): decodes the chunk-th chunk of vertices into the ring.
+        template <class Model, class Codec>
+        static void                 DecodeResiduals(SC3DMCFloatArrayDecodeTask<Model, Codec> & task, long chunk);
+        //! Reconstruction stage of DecodeFloatArray(): computes the quantized values of the chunk-th chunk of vertices.
+        template <class Model, class Codec>
+        static void                 ReconstructFloatArray(SC3DMCFloatArrayDecodeTask<Model, Codec> & task, long chunk);
+        //! Thread function of DecodeFloatArray(): thread 1 runs the entropy decoding stage over all the chunks and 
+        //! thread 0 the reconstruction stage.
+        template <class Model, class Codec>
+        static void                 DecodeFloatArrayThread(unsigned long threadID, void * data);
         O3DGCErrorCode              IQuantizeFloatArray(Real * const floatArray,
                                                        unsigned long numfloatArraySize,
                                                        unsigned long dimfloatArraySize,
                                                        unsigned long stride,
                                                        const Real * const minfloatArray,
                                                        const Real * const maxfloatArray,
-                                                       unsigned long nQBits);
+                                                       unsigned long nQBits,
+                                                       const SC3DMCDecodeScratch & scratch);
         O3DGCErrorCode              DecodeIntArray(long * const intArray, 
                                                    unsigned long numIntArraySize,
                                                    unsigned long dimIntArraySize,
                                                    unsigned long stride,
                                                    const IndexedFaceSet<T> & ifs,
                                                    O3DGCSC3DMCPredictionMode & predMode,
-                                                   const BinaryStream & bstream);
-        O3DGCErrorCode              ProcessNormals(const IndexedFaceSet<T> & ifs);
+                                                   const BinaryStream & bstream,
+                                                   unsigned long & iterator);
+        template <class Codec>
+        O3DGCErrorCode              DecodeIntArray(Codec & acd,
+                                                   long * const intArray, 
+                                                   unsigned long numIntArraySize,
+                                                   unsigned long dimIntArraySize,
+                                                   unsigned long stride,
+                                                   const IndexedFaceSet<T> & ifs,
+                                                   O3DGCSC3DMCPredictionMode & predMode,
+                                                   const BinaryStream & bstream,
+                                                   unsigned long & iterator);
+        template <class Codec>
+        O3DGCErrorCode              LoadModels(Codec & acd,
+                                               MultiLaneCodec<Codec, Adaptive_Data_Model> & lanes,
+                                               Adaptive_Data_Model & mModelPreds,
+                                               unsigned long & M,
+                                               O3DGCModelDictionaryEntry valuesEntry,
+                                               Static_Bit_Model & bModel0,
+                                               Adaptive_Bit_Model & bModel1);
+        template <class Codec>
+        O3DGCErrorCode              LoadModels(Codec & acd,
+                                               MultiLaneCodec<Codec, Static_Data_Model> & lanes,
+                                               Static_Data_Model & mModelPreds,
+                                               unsigned long & M,
+                                               O3DGCModelDictionaryEntry valuesEntry,
+                                               Static_Bit_Model & bModel0,
+                                               Adaptive_Bit_Model & bModel1);
+        //! Reads the mask of the attribute section at iterator without consuming it.
+        unsigned char               PeekMask(const BinaryStream & bstream, unsigned long iterator) const;
+        O3DGCErrorCode              ProcessNormals(const IndexedFaceSet<T> & ifs, SC3DMCDecodeScratch & scratch);
+        //! Stores in scratch.m_normals the unit normals of the surface, computed from the quantized coordinates held 
+        //! by scratch, or their opposites if inverted.
+        O3DGCErrorCode              ProcessOctahedralNormals(const IndexedFaceSet<T> & ifs, 
+                                                             bool inverted, 
+                                                             SC3DMCDecodeScratch & scratch);
+        //! Prediction candidates of the vertices for the given mode, built on first use after the connectivity is coded.
+        const SC3DMCPredictorTable & GetPredictorTable(bool parallelogram, const IndexedFaceSet<T> & ifs);
+        O3DGCErrorCode              DecodeMesh(IndexedFaceSet<T> & ifs,
+                                               const BinaryStream & bstream,
+                                               const SC3DMCSectionSelection & selection);
+        O3DGCErrorCode              OptimizeVertexCache(IndexedFaceSet<T> & ifs, const SC3DMCSectionSelection & selection);
+        void                        SeekSection(unsigned long section);
+        //! Decodes the segments concurrently, each one into the caller's buffers at the offsets of the segment index.
+        O3DGCErrorCode              DecodeSegments(IndexedFaceSet<T> & ifs,
+                                                   const BinaryStream & bstream,
+                                                   const SC3DMCSectionSelection & selection);
+        O3DGCErrorCode              DecodeSegment(unsigned long s,
+                                                  IndexedFaceSet<T> & ifs,
+                                                  const BinaryStream & bstream,
+                                                  const SC3DMCSectionSelection & selection,
+                                                  SC3DMCStats & stats) const;
+        //! Thread function of DecodeSegments().
+        static void                 DecodeSegmentsThread(unsigned long threadID, void * data);
+        //! Decodes the selected attribute sections, concurrently if more than one thread is allowed. 
+        O3DGCErrorCode              DecodeAttributes(IndexedFaceSet<T> & ifs,
+                                                     const BinaryStream & bstream,
+                                                     const SC3DMCSectionSelection & selection);
+        //! Decodes the attribute section (O3DGC_SC3DMC_SECTION_COORD or a later one) starting at iterator and times 
+        //! it in m_stats.
+        O3DGCErrorCode              DecodeAttribute(unsigned long section,
+                                                    IndexedFaceSet<T> & ifs,
+                                                    SC3DMCDecodeScratch & scratch,
+                                                    const BinaryStream & bstream,
+                                                    unsigned long & iterator);
+        //! Thread function of DecodeAttributes().
+        static void                 DecodeAttributesThread(unsigned long threadID, void * data);
+        void                        SkipSection(const BinaryStream & bstream);
 
         unsigned long               m_iterator;
+        unsigned long               m_streamStart;
         unsigned long               m_streamSize;
+        SC3DMCTableOfContents       m_toc;
+        SC3DMCSegmentIndex          m_segments;
+        unsigned long               m_numThreads;
+        bool                        m_segmented;            //!< set even when the region of interest selects no segment
+        bool                        m_regionOfInterest;
+        Real                        m_regionMin[3];
+        Real                        m_regionMax[3];
+        O3DGCVertexCacheOptimization m_vertexCacheOptimization;
+        VertexCacheOptimizer        m_vertexCacheOptimizer;
+        unsigned long               m_maxBatchVertices;
+        TriangleBatches             m_batches;
         SC3DMCEncodeParams          m_params;
         TriangleListDecoder<T>      m_triangleListDecoder;
-        long *                      m_quantFloatArray;
-        unsigned long               m_quantFloatArraySize;
-        Vector<char>                m_orientation;
-        Real *                      m_normals;
-        unsigned long               m_normalsSize;
+        SC3DMCPredictorTable        m_parallelogramPredictors;
+        SC3DMCPredictorTable        m_differentialPredictors;
+        SC3DMCDecodeScratch         m_scratch;              //!< used when the attributes are decoded by a single thread
+        ThreadPool                  m_threadPool;           //!< decodes the attribute sections and the segments
         SC3DMCStats                 m_stats;
         O3DGCStreamType             m_streamType;
     };
@@ -25,6 +25,10 @@ THE SOFTWARE.
 #define O3DGC_SC3DMC_DECODER_INL
 
 #include "o3dgcArithmeticCodec.h"
+#include "o3dgcRANSCodec.h"
+#include "o3dgcMultiLaneCodec.h"
+#include "o3dgcModelDictionary.h"
+#include "o3dgcFrequencyTable.h"
 #include "o3dgcTimer.h"
 
 //#define DEBUG_VERBOSE
@@ -40,6 +44,7 @@ namespace o3dgc
                                                   const BinaryStream & bstream)
     {
         unsigned long iterator0 = m_iterator;
+        m_streamStart           = m_iterator;
         unsigned long start_code = bstream.ReadUInt32(m_iterator, O3DGC_STREAM_TYPE_BINARY);
         if (start_code != O3DGC_SC3DMC_START_CODE)
         {
@@ -70,8 +75,19 @@ namespace o3dgc
         ifs.SetSolid           ((mask & 2) == 1);
         ifs.SetConvex          ((mask & 4) == 1);
         ifs.SetIsTriangularMesh((mask & 8) == 1);
-        //bool markerBit0 = (mask & 16 ) == 1;
-        //bool markerBit1 = (mask & 32 ) == 1;
+        if (mask & 16) // markerBit0: models seeded from a model dictionary
+        {
+            unsigned char modelDictionary = bstream.ReadUChar(m_iterator, m_streamType);
+            if (!IsValidModelDictionary(modelDictionary))
+            {
+                return O3DGC_ERROR_NON_SUPPORTED_FEATURE;
+            }
+            m_params.SetModelDictionary((O3DGCModelDictionary) modelDictionary);
+        }
+        else
+        {
+            m_params.SetModelDictionary(O3DGC_MODEL_DICTIONARY_NONE);
+        }
         //bool markerBit2 = (mask & 64 ) == 1;
         //bool markerBit3 = (mask & 128) == 1;
        
@@ -133,100 +149,524 @@ namespace o3dgc
                 ifs.SetIntAttributeType(a, (O3DGCIFSIntAttributeType) bstream.ReadUChar(m_iterator, m_streamType));
             }
         }    
+        if (mask & 32) // markerBit1: table of contents
+        {
+            O3DGCErrorCode ret = m_toc.Load(bstream, m_iterator, m_streamType, m_streamSize, 
+                                            ifs.GetNumFloatAttributes(), ifs.GetNumIntAttributes());
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+        }
+        else
+        {
+            m_toc.Clear();
+        }
+        m_segmented = (mask & 64) != 0;
+        if (m_segmented) // markerBit2: segmented stream
+        {
+            O3DGCErrorCode ret = m_segments.Load(bstream, m_iterator, m_streamType, m_streamStart, m_streamSize, 
+                                                 ifs.GetNCoordIndex(), ifs.GetNCoord());
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+            if (m_regionOfInterest)
+            {
+                unsigned long numTriangles = 0;
+                unsigned long numVertices  = 0;
+                m_segments.Select(m_regionMin, m_regionMax, numTriangles, numVertices);
+                ifs.SetNCoordIndex(numTriangles);
+                ifs.SetNCoord(numVertices);
+                ifs.SetNNormal((ifs.GetNNormal() > 0) ? numVertices : 0);
+                for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+                {
+                    ifs.SetNFloatAttribute(a, (ifs.GetNFloatAttribute(a) > 0) ? numVertices : 0);
+                }
+                for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+                {
+                    ifs.SetNIntAttribute(a, (ifs.GetNIntAttribute(a) > 0) ? numVertices : 0);
+                }
+            }
+        }
+        else
+        {
+            m_segments.Clear();
+        }
+        // the decoded vertex indices have to fit in T (e.g., at most 65536 vertices for unsigned short)
+        if (ifs.GetNCoord() > 0 && ifs.GetNCoord() - 1 > GetMaxIndex<T>())
+        {
+            return O3DGC_ERROR_NON_SUPPORTED_FEATURE;
+        }
         return O3DGC_OK;
     }
     template<class T>
     O3DGCErrorCode SC3DMCDecoder<T>::DecodePlayload(IndexedFaceSet<T> & ifs,
                                                     const BinaryStream & bstream)
+    {
+        return DecodePlayload(ifs, bstream, SC3DMCSectionSelection());
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodePlayload(IndexedFaceSet<T> & ifs,
+                                                    const BinaryStream & bstream,
+                                                    const SC3DMCSectionSelection & selection)
+    {
+        m_batches.Clear();
+        O3DGCErrorCode ret = DecodeMesh(ifs, bstream, selection);
+        if (ret == O3DGC_OK && m_maxBatchVertices > 0 && selection.GetConnectivity())
+        {
+            ret = m_batches.Build(ifs.GetCoordIndex(), ifs.GetNCoordIndex(), ifs.GetNCoord(), m_maxBatchVertices);
+        }
+        return ret;
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeMesh(IndexedFaceSet<T> & ifs,
+                                                const BinaryStream & bstream,
+                                                const SC3DMCSectionSelection & selection)
     {
         O3DGCErrorCode ret = O3DGC_OK;
+        // the attributes are predicted from the connectivity, and the normals from the coordinates
+        const bool decodeNormal = selection.GetNormal() && ifs.GetNNormal() > 0;
+        const bool decodeCoord  = (selection.GetCoord() || decodeNormal) && ifs.GetNCoord() > 0;
+        bool decodeConnectivity = selection.GetConnectivity() || decodeCoord || decodeNormal;
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            decodeConnectivity = decodeConnectivity || selection.GetFloatAttribute(a);
+        }
+        for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            decodeConnectivity = decodeConnectivity || selection.GetIntAttribute(a);
+        }
+        m_stats = SC3DMCStats();
+        if (!decodeConnectivity)
+        {
+            m_iterator = m_streamStart + m_streamSize;
+            return O3DGC_OK;
+        }
+        if (m_segmented)
+        {
+            ret        = DecodeSegments(ifs, bstream, selection);
+            m_iterator = m_streamStart + m_streamSize;
+            return ret;
+        }
 #ifdef DEBUG_VERBOSE
         g_fileDebugSC3DMCDec = fopen("tfans_dec_main.txt", "w");
 #endif //DEBUG_VERBOSE
 
         m_triangleListDecoder.SetStreamType(m_streamType);
+        m_triangleListDecoder.SetModelDictionary(m_params.GetModelDictionary());
+        SeekSection(O3DGC_SC3DMC_SECTION_CONNECTIVITY);
         m_stats.m_streamSizeCoordIndex = m_iterator;
         Timer timer;
         timer.Tic();
         m_triangleListDecoder.Decode(ifs.GetCoordIndex(), ifs.GetNCoordIndex(), ifs.GetNCoord(), bstream, m_iterator);
+        m_parallelogramPredictors.Clear();
+        m_differentialPredictors.Clear();
         timer.Toc();
         m_stats.m_timeCoordIndex       = timer.GetElapsedTime();
         m_stats.m_streamSizeCoordIndex = m_iterator - m_stats.m_streamSizeCoordIndex;
 
-        // decode coord
-        m_stats.m_streamSizeCoord = m_iterator;
-        timer.Tic();
-        if (ifs.GetNCoord() > 0)
-        {
-            ret = DecodeFloatArray(ifs.GetCoord(), ifs.GetNCoord(), 3, 3, ifs.GetCoordMin(), ifs.GetCoordMax(),
-                                   m_params.GetCoordQuantBits(), ifs, m_params.GetCoordPredMode(), bstream);
-        }
+        ret = DecodeAttributes(ifs, bstream, selection);
         if (ret != O3DGC_OK)
         {
             return ret;
         }
+
+        timer.Tic();
+        m_triangleListDecoder.Reorder();
         timer.Toc();
-        m_stats.m_timeCoord       = timer.GetElapsedTime();
-        m_stats.m_streamSizeCoord = m_iterator - m_stats.m_streamSizeCoord;
+        m_stats.m_timeReorder       = timer.GetElapsedTime();
+        m_iterator                  = m_streamStart + m_streamSize;
+        if (ret == O3DGC_OK)
+        {
+            ret = OptimizeVertexCache(ifs, selection);
+        }
 
-        // decode Normal
-        m_stats.m_streamSizeNormal = m_iterator;
+#ifdef DEBUG_VERBOSE
+        fclose(g_fileDebugSC3DMCDec);
+#endif //DEBUG_VERBOSE
+        return ret;
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeAttribute(unsigned long section,
+                                                     IndexedFaceSet<T> & ifs,
+                                                     SC3DMCDecodeScratch & scratch,
+                                                     const BinaryStream & bstream,
+                                                     unsigned long & iterator)
+    {
+        const unsigned long numFloatAttributes = ifs.GetNumFloatAttributes();
+        const unsigned long start = iterator;
+        O3DGCErrorCode ret;
+        Timer timer;
         timer.Tic();
-        if (ifs.GetNNormal() > 0)
+        if (section == O3DGC_SC3DMC_SECTION_COORD)
         {
-            DecodeFloatArray(ifs.GetNormal(), ifs.GetNNormal(), 3, 3, ifs.GetNormalMin(), ifs.GetNormalMax(),
-                                m_params.GetNormalQuantBits(), ifs, m_params.GetNormalPredMode(), bstream);
+            ret = DecodeFloatArray(ifs.GetCoord(), ifs.GetNCoord(), 3, 3, ifs.GetCoordMin(), ifs.GetCoordMax(),
+                                   m_params.GetCoordQuantBits(), ifs, m_params.GetCoordPredMode(), 
+                                   O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_POSITION, scratch, bstream, iterator);
         }
-        if (ret != O3DGC_OK)
+        else if (section == O3DGC_SC3DMC_SECTION_NORMAL)
         {
-            return ret;
+            // with O3DGC_SC3DMC_SURF_NORMALS_PREDICTION, scratch holds the quantized coordinates
+            ret = DecodeFloatArray(ifs.GetNormal(), ifs.GetNNormal(), 3, 3, ifs.GetNormalMin(), ifs.GetNormalMax(),
+                                   m_params.GetNormalQuantBits(), ifs, m_params.GetNormalPredMode(), 
+                                   O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_NORMAL, scratch, bstream, iterator);
+        }
+        else if (section < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes)
+        {
+            const unsigned long a = section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0;
+            ret = DecodeFloatArray(ifs.GetFloatAttribute(a), ifs.GetNFloatAttribute(a), ifs.GetFloatAttributeDim(a), ifs.GetFloatAttributeDim(a), 
+                                   ifs.GetFloatAttributeMin(a), ifs.GetFloatAttributeMax(a), 
+                                   m_params.GetFloatAttributeQuantBits(a), ifs, m_params.GetFloatAttributePredMode(a), 
+                                   ifs.GetFloatAttributeType(a), scratch, bstream, iterator);
+        }
+        else
+        {
+            const unsigned long a = section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 - numFloatAttributes;
+            ret = DecodeIntArray(ifs.GetIntAttribute(a), ifs.GetNIntAttribute(a), ifs.GetIntAttributeDim(a), ifs.GetIntAttributeDim(a), 
+                                 ifs, m_params.GetIntAttributePredMode(a), bstream, iterator);
         }
         timer.Toc();
-        m_stats.m_timeNormal       = timer.GetElapsedTime();
-        m_stats.m_streamSizeNormal = m_iterator - m_stats.m_streamSizeNormal;
+        if (ret == O3DGC_OK)
+        {
+            GetSectionTime      (m_stats, section, numFloatAttributes) = timer.GetElapsedTime();
+            GetSectionStreamSize(m_stats, section, numFloatAttributes) = iterator - start;
+        }
+        return ret;
+    }
+    template<class T>
+    void SC3DMCDecoder<T>::DecodeAttributesThread(unsigned long threadID, void * data)
+    {
+        SC3DMCAttributeDecodeTask<T> & task = *((SC3DMCAttributeDecodeTask<T> *) data);
+        for(unsigned long i = threadID; i < task.m_numSections; i += task.m_numThreads)
+        {
+            const unsigned long section = task.m_sections[i];
+            task.m_errors[section] = task.m_decoder->DecodeAttribute(section, *task.m_ifs, task.m_scratch[threadID], 
+                                                                     *task.m_bstream, task.m_iterators[section]);
+            if (section == O3DGC_SC3DMC_SECTION_COORD && task.m_surfNormals && task.m_errors[section] == O3DGC_OK)
+            {
+                task.m_errors[O3DGC_SC3DMC_SECTION_NORMAL] = 
+                    task.m_decoder->DecodeAttribute(O3DGC_SC3DMC_SECTION_NORMAL, *task.m_ifs, task.m_scratch[threadID], 
+                                                    *task.m_bstream, task.m_iterators[O3DGC_SC3DMC_SECTION_NORMAL]);
+            }
+        }
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeAttributes(IndexedFaceSet<T> & ifs,
+                                                      const BinaryStream & bstream,
+                                                      const SC3DMCSectionSelection & selection)
+    {
+        const unsigned long numFloatAttributes = ifs.GetNumFloatAttributes();
+        const unsigned long numSections        = O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes + 
+                                                 ifs.GetNumIntAttributes();
+        const unsigned long maxNumSections     = O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES + 
+                                                 O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES;
+        const bool          decodeNormal       = selection.GetNormal() && ifs.GetNNormal() > 0;
+        const bool          decodeCoord        = (selection.GetCoord() || decodeNormal) && ifs.GetNCoord() > 0;
+        unsigned long       iterators[maxNumSections];
+        bool                decode   [maxNumSections];
 
-        // decode FloatAttributes
-        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        // locates the sections, through the table of contents if any or else through their size fields
+        for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+        {
+            if (s == O3DGC_SC3DMC_SECTION_COORD)
+            {
+                decode[s] = decodeCoord;
+            }
+            else if (s == O3DGC_SC3DMC_SECTION_NORMAL)
+            {
+                decode[s] = decodeNormal;
+            }
+            else if (s < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes)
+            {
+                decode[s] = selection.GetFloatAttribute(s - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0);
+            }
+            else
+            {
+                decode[s] = selection.GetIntAttribute(s - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 - numFloatAttributes);
+            }
+            if ((s == O3DGC_SC3DMC_SECTION_COORD  && ifs.GetNCoord()  == 0) ||
+                (s == O3DGC_SC3DMC_SECTION_NORMAL && ifs.GetNNormal() == 0))
+            {
+                continue; // not encoded
+            }
+            SeekSection(s);
+            iterators[s] = m_iterator;
+            SkipSection(bstream);
+        }
+
+        // the normals predicted from the coordinates are decoded right after them, by the same thread
+        const bool surfNormals = decodeNormal && decodeCoord &&
+                                 IsSurfaceNormalsPrediction((O3DGCSC3DMCPredictionMode)
+                                                            (PeekMask(bstream, iterators[O3DGC_SC3DMC_SECTION_NORMAL]) & 7));
+        unsigned long sections[maxNumSections];
+        unsigned long numTasks = 0;
+        for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
         {
-            m_stats.m_streamSizeFloatAttribute[a] = m_iterator;
-            timer.Tic();
-            DecodeFloatArray(ifs.GetFloatAttribute(a), ifs.GetNFloatAttribute(a), ifs.GetFloatAttributeDim(a), ifs.GetFloatAttributeDim(a), 
-                                ifs.GetFloatAttributeMin(a), ifs.GetFloatAttributeMax(a), 
-                                m_params.GetFloatAttributeQuantBits(a), ifs, m_params.GetFloatAttributePredMode(a), bstream);
-            timer.Toc();
-            m_stats.m_timeFloatAttribute[a]       = timer.GetElapsedTime();
-            m_stats.m_streamSizeFloatAttribute[a] = m_iterator - m_stats.m_streamSizeFloatAttribute[a];
+            if (decode[s] && (s != O3DGC_SC3DMC_SECTION_NORMAL || !surfNormals))
+            {
+                sections[numTasks++] = s;
+            }
         }
-        if (ret != O3DGC_OK)
+        const unsigned long maxNumThreads = o3dgc::GetNumThreads(m_numThreads);
+        const unsigned long numThreads    = min(maxNumThreads, numTasks);
+        if (numThreads <= 1)
         {
-            return ret;
+            m_scratch.m_numThreads          = maxNumThreads;
+            m_scratch.m_timeEntropyDecoding = 0.0;
+            m_scratch.m_timeReconstruction  = 0.0;
+            for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+            {
+                if (decode[s])
+                {
+                    const O3DGCErrorCode ret = DecodeAttribute(s, ifs, m_scratch, bstream, iterators[s]);
+                    if (ret != O3DGC_OK)
+                    {
+                        return ret;
+                    }
+                }
+            }
+            m_stats.m_timeEntropyDecoding = m_scratch.m_timeEntropyDecoding;
+            m_stats.m_timeReconstruction  = m_scratch.m_timeReconstruction;
+            return O3DGC_OK;
         }
 
-        // decode IntAttributes
-        for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        // the prediction candidates are built on first use: build the ones the threads share beforehand
+        for(unsigned long i = 0; i < numTasks; ++i)
+        {
+            const unsigned long s = sections[i];
+            const bool parallelogram = (s < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes &&
+                                        (PeekMask(bstream, iterators[s]) & 7) == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION);
+            GetPredictorTable(parallelogram, ifs);
+        }
+        if (surfNormals)
+        {
+            GetPredictorTable(false, ifs);
+        }
+        O3DGCErrorCode errors[maxNumSections];
+        SC3DMCAttributeDecodeTask<T> task;
+        task.m_decoder     = this;
+        task.m_ifs         = &ifs;
+        task.m_bstream     = &bstream;
+        task.m_sections    = sections;
+        task.m_numSections = numTasks;
+        task.m_iterators   = iterators;
+        task.m_surfNormals = surfNormals;
+        task.m_scratch     = new SC3DMCDecodeScratch[numThreads];
+        task.m_errors      = errors;
+        task.m_numThreads  = numThreads;
+        for(unsigned long s = 0; s < numSections; ++s)
+        {
+            errors[s] = O3DGC_OK;
+        }
+        for(unsigned long i = 0; i < numThreads; ++i)
+        {
+            // the remaining threads are shared by the stages of the float attribute decoding
+            task.m_scratch[i].m_numThreads = maxNumThreads / numThreads;
+        }
+        m_threadPool.Run(DecodeAttributesThread, &task, numThreads);
+        m_stats.m_timeEntropyDecoding = 0.0;
+        m_stats.m_timeReconstruction  = 0.0;
+        for(unsigned long i = 0; i < numThreads; ++i)
+        {
+            m_stats.m_timeEntropyDecoding += task.m_scratch[i].m_timeEntropyDecoding;
+            m_stats.m_timeReconstruction  += task.m_scratch[i].m_timeReconstruction;
+        }
+        delete [] task.m_scratch;
+        for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+        {
+            if (errors[s] != O3DGC_OK)
+            {
+                return errors[s];
+            }
+        }
+        return O3DGC_OK;
+    }
+    template<class T>
+    void SC3DMCDecoder<T>::DecodeSegmentsThread(unsigned long threadID, void * data)
+    {
+        SC3DMCSegmentDecodeTask<T> & task = *((SC3DMCSegmentDecodeTask<T> *) data);
+        const unsigned long numSegments = task.m_decoder->m_segments.GetNumSegments();
+        for(unsigned long s = threadID; s < numSegments; s += task.m_numThreads)
+        {
+            task.m_errors[s] = task.m_decoder->DecodeSegment(s, *task.m_ifs, *task.m_bstream, *task.m_selection, task.m_stats[s]);
+        }
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeSegments(IndexedFaceSet<T> & ifs,
+                                                    const BinaryStream & bstream,
+                                                    const SC3DMCSectionSelection & selection)
+    {
+        const unsigned long numSegments = m_segments.GetNumSegments();
+        if (numSegments == 0)
+        {
+            return O3DGC_OK; // no segment intersects the region of interest
+        }
+        SC3DMCSegmentDecodeTask<T> task;
+        task.m_decoder    = this;
+        task.m_ifs        = &ifs;
+        task.m_bstream    = &bstream;
+        task.m_selection  = &selection;
+        task.m_stats      = new SC3DMCStats   [numSegments];
+        task.m_errors     = new O3DGCErrorCode[numSegments];
+        task.m_numThreads = min(o3dgc::GetNumThreads(m_numThreads), numSegments);
+        m_threadPool.Run(DecodeSegmentsThread, &task, task.m_numThreads);
+
+        O3DGCErrorCode ret = O3DGC_OK;
+        for(unsigned long s = 0; s < numSegments; ++s)
         {
-            m_stats.m_streamSizeIntAttribute[a] = m_iterator;
-            timer.Tic();
-            DecodeIntArray(ifs.GetIntAttribute(a), ifs.GetNIntAttribute(a), ifs.GetIntAttributeDim(a), ifs.GetIntAttributeDim(a), 
-                           ifs, m_params.GetIntAttributePredMode(a), bstream);
-            timer.Toc();
-            m_stats.m_timeIntAttribute[a]       = timer.GetElapsedTime();
-            m_stats.m_streamSizeIntAttribute[a] = m_iterator - m_stats.m_streamSizeIntAttribute[a];
+            if (ret == O3DGC_OK)
+            {
+                ret = task.m_errors[s];
+            }
+            m_stats.Accumulate(task.m_stats[s]);
         }
+        delete [] task.m_stats;
+        delete [] task.m_errors;
+        return ret;
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeSegment(unsigned long s,
+                                                   IndexedFaceSet<T> & ifs,
+                                                   const BinaryStream & bstream,
+                                                   const SC3DMCSectionSelection & selection,
+                                                   SC3DMCStats & stats) const
+    {
+        const SC3DMCSegment & segment = m_segments.GetSegment(s);
+        SC3DMCDecoder<T> decoder;
+        IndexedFaceSet<T> segmentIFS;
+        decoder.SetIterator(m_streamStart + segment.m_offset);
+        O3DGCErrorCode ret = decoder.DecodeHeader(segmentIFS, bstream);
         if (ret != O3DGC_OK)
         {
             return ret;
         }
-
+        // the segment must fit in the buffers sized from the header of the mesh
+        bool valid = (decoder.m_segments.GetNumSegments() == 0                       &&
+                      segmentIFS.GetNCoord()                == segment.m_numVertices  &&
+                      segmentIFS.GetNCoordIndex()           == segment.m_numTriangles &&
+                      (segmentIFS.GetNNormal() > 0)         == (ifs.GetNNormal() > 0) &&
+                      segmentIFS.GetNumFloatAttributes()    == ifs.GetNumFloatAttributes() &&
+                      segmentIFS.GetNumIntAttributes()      == ifs.GetNumIntAttributes());
+        for(unsigned long a = 0; valid && a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            valid = (segmentIFS.GetNFloatAttribute(a) > 0) == (ifs.GetNFloatAttribute(a) > 0) &&
+                    (ifs.GetNFloatAttribute(a) == 0 || segmentIFS.GetFloatAttributeDim(a) == ifs.GetFloatAttributeDim(a));
+        }
+        for(unsigned long a = 0; valid && a < ifs.GetNumIntAttributes(); ++a)
+        {
+            valid = (segmentIFS.GetNIntAttribute(a) > 0) == (ifs.GetNIntAttribute(a) > 0) &&
+                    (ifs.GetNIntAttribute(a) == 0 || segmentIFS.GetIntAttributeDim(a) == ifs.GetIntAttributeDim(a));
+        }
+        if (!valid)
+        {
+            return O3DGC_ERROR_CORRUPTED_STREAM;
+        }
+        const unsigned long firstVertex = segment.m_firstVertex;
+        T * const coordIndex = ifs.GetCoordIndex() ? ifs.GetCoordIndex() + 3 * segment.m_firstTriangle : 0;
+        segmentIFS.SetCoordIndex(coordIndex);
+        segmentIFS.SetCoord (ifs.GetCoord()  ? ifs.GetCoord()  + 3 * firstVertex : 0);
+        segmentIFS.SetNormal(ifs.GetNormal() ? ifs.GetNormal() + 3 * firstVertex : 0);
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            Real * const floatAttribute = ifs.GetFloatAttribute(a);
+            segmentIFS.SetFloatAttribute(a, floatAttribute ? floatAttribute + ifs.GetFloatAttributeDim(a) * firstVertex : 0);
+        }
+        for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            long * const intAttribute = ifs.GetIntAttribute(a);
+            segmentIFS.SetIntAttribute(a, intAttribute ? intAttribute + ifs.GetIntAttributeDim(a) * firstVertex : 0);
+        }
+        decoder.SetVertexCacheOptimization(m_vertexCacheOptimization);
+        ret   = decoder.DecodePlayload(segmentIFS, bstream, selection);
+        stats = decoder.GetStats();
+        if (ret == O3DGC_OK && coordIndex)
+        {
+            for(unsigned long i = 0; i < 3 * segment.m_numTriangles; ++i)
+            {
+                coordIndex[i] = (T) (coordIndex[i] + firstVertex);
+            }
+        }
+        return ret;
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::OptimizeVertexCache(IndexedFaceSet<T> & ifs, const SC3DMCSectionSelection & selection)
+    {
+        if (m_vertexCacheOptimization == O3DGC_VERTEX_CACHE_OPTIMIZATION_NONE || m_triangleListDecoder.GetReorderTriangles())
+        {
+            return O3DGC_OK;
+        }
+        T * const triangles      = ifs.GetCoordIndex();
+        const long numTriangles  = (long) ifs.GetNCoordIndex();
+        const long numVertices   = (long) ifs.GetNCoord();
+        Timer timer;
         timer.Tic();
-        m_triangleListDecoder.Reorder();
+        m_stats.m_acmrBefore = m_vertexCacheOptimizer.ComputeACMR(triangles, numTriangles, numVertices);
+        m_vertexCacheOptimizer.OptimizeTriangles(triangles, numTriangles, numVertices);
+        if (m_vertexCacheOptimization == O3DGC_VERTEX_CACHE_OPTIMIZATION_VERTICES)
+        {
+            // only the decoded attributes are renumbered
+            const bool decodeNormal = selection.GetNormal() && ifs.GetNNormal() > 0;
+            const bool decodeCoord  = (selection.GetCoord() || decodeNormal) && ifs.GetNCoord() > 0;
+            m_vertexCacheOptimizer.RenumberVertices(triangles, numTriangles, numVertices);
+            if (decodeCoord)
+            {
+                m_vertexCacheOptimizer.PermuteVertexAttribute(ifs.GetCoord(), 3);
+            }
+            if (decodeNormal)
+            {
+                m_vertexCacheOptimizer.PermuteVertexAttribute(ifs.GetNormal(), 3);
+            }
+            for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+            {
+                if (selection.GetFloatAttribute(a) && ifs.GetNFloatAttribute(a) > 0)
+                {
+                    m_vertexCacheOptimizer.PermuteVertexAttribute(ifs.GetFloatAttribute(a), ifs.GetFloatAttributeDim(a));
+                }
+            }
+            for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+            {
+                if (selection.GetIntAttribute(a) && ifs.GetNIntAttribute(a) > 0)
+                {
+                    m_vertexCacheOptimizer.PermuteVertexAttribute(ifs.GetIntAttribute(a), ifs.GetIntAttributeDim(a));
+                }
+            }
+        }
+        m_stats.m_acmrAfter         = m_vertexCacheOptimizer.ComputeACMR(triangles, numTriangles, numVertices);
+        m_stats.m_numCacheTriangles = (unsigned long) numTriangles;
         timer.Toc();
-        m_stats.m_timeReorder       = timer.GetElapsedTime();
-
-#ifdef DEBUG_VERBOSE
-        fclose(g_fileDebugSC3DMCDec);
-#endif //DEBUG_VERBOSE
-        return ret;
+        m_stats.m_timeVertexCache   = timer.GetElapsedTime();
+        return O3DGC_OK;
+    }
+    template<class T>
+    void SC3DMCDecoder<T>::SeekSection(unsigned long section)
+    {
+        if (m_toc.GetNumSections() > 0)
+        {
+            m_iterator = m_streamStart + m_toc.GetSection(section).m_offset;
+        }
+    }
+    template<class T>
+    void SC3DMCDecoder<T>::SkipSection(const BinaryStream & bstream)
+    {
+        if (m_toc.GetNumSections() > 0)
+        {
+            return; // the next decoded section is reached through SeekSection()
+        }
+        unsigned long start = m_iterator;
+        m_iterator = start + bstream.ReadUInt32(m_iterator, m_streamType);
+        if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
+        {
+            // predictors
+            start      = m_iterator;
+            m_iterator = start + bstream.ReadUInt32(m_iterator, m_streamType);
+        }
+    }
+    template<class T>
+    unsigned char SC3DMCDecoder<T>::PeekMask(const BinaryStream & bstream, unsigned long iterator) const
+    {
+        bstream.ReadUInt32(iterator, m_streamType);        // bitsream size
+        return bstream.ReadUChar(iterator, m_streamType);
     }
     template<class T>
     O3DGCErrorCode SC3DMCDecoder<T>::DecodeIntArray(long * const intArray, 
@@ -235,39 +675,58 @@ namespace o3dgc
                                                     unsigned long stride,
                                                     const IndexedFaceSet<T> & ifs,
                                                     O3DGCSC3DMCPredictionMode & predMode,
-                                                    const BinaryStream & bstream)
+                                                    const BinaryStream & bstream,
+                                                    unsigned long & iterator)
+    {
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && ((PeekMask(bstream, iterator) >> 4) & 7) == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec acd;
+            return DecodeIntArray(acd, intArray, numIntArray, dimIntArray, stride, ifs, predMode, bstream, iterator);
+        }
+        Arithmetic_Codec acd;
+        return DecodeIntArray(acd, intArray, numIntArray, dimIntArray, stride, ifs, predMode, bstream, iterator);
+    }
+    template<class T>
+    template<class Codec>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeIntArray(Codec & acd,
+                                                    long * const intArray, 
+                                                    unsigned long numIntArray,
+                                                    unsigned long dimIntArray,
+                                                    unsigned long stride,
+                                                    const IndexedFaceSet<T> & ifs,
+                                                    O3DGCSC3DMCPredictionMode & predMode,
+                                                    const BinaryStream & bstream,
+                                                    unsigned long & iterator)
     {
         assert(dimIntArray <  O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES);
         long predResidual;
         SC3DMCPredictor m_neighbors  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
-        Arithmetic_Codec acd;
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
         Adaptive_Data_Model mModelPreds(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS+1);
         unsigned long nPred;
 
-        const AdjacencyInfo & v2T            = m_triangleListDecoder.GetVertexToTriangle();
-        const T * const     triangles        = ifs.GetCoordIndex();
         const long          nvert            = (long) numIntArray;
         const unsigned long size             = numIntArray * dimIntArray;
         unsigned char *     buffer           = 0;
-        unsigned long       start            = m_iterator;
-        unsigned long       streamSize       = bstream.ReadUInt32(m_iterator, m_streamType);        // bitsream size
-        unsigned char mask                   = bstream.ReadUChar(m_iterator, m_streamType);
+        unsigned long       start            = iterator;
+        unsigned long       streamSize       = bstream.ReadUInt32(iterator, m_streamType);        // bitsream size
+        unsigned char mask                   = bstream.ReadUChar(iterator, m_streamType);
         O3DGCSC3DMCBinarization binarization = (O3DGCSC3DMCBinarization)((mask >> 4) & 7);
         predMode                             = (O3DGCSC3DMCPredictionMode)(mask & 7);
-        streamSize                          -= (m_iterator - start);
-        unsigned long       iteratorPred     = m_iterator + streamSize;
+        streamSize                          -= (iterator - start);
+        unsigned long       iteratorPred     = iterator + streamSize;
         unsigned int        exp_k            = 0;
         unsigned int        M                = 0;
         if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
         {
-            if (binarization != O3DGC_SC3DMC_BINARIZATION_AC_EGC)
+            if (binarization != O3DGC_SC3DMC_BINARIZATION_AC_EGC &&
+                binarization != O3DGC_SC3DMC_BINARIZATION_RANS)
             {
                 return O3DGC_ERROR_CORRUPTED_STREAM;
             }
-            bstream.GetBuffer(m_iterator, buffer);
-            m_iterator += streamSize;
+            bstream.GetBuffer(iterator, buffer);
+            iterator += streamSize;
             acd.set_buffer(streamSize, buffer);
             acd.start_decoder();
             exp_k = acd.ExpGolombDecode(0, bModel0, bModel1);
@@ -288,36 +747,20 @@ namespace o3dgc
         fprintf(g_fileDebugSC3DMCDec, "IntArray (%i, %i)\n", numIntArray, dimIntArray);
 #endif //DEBUG_VERBOSE
 
+        const SC3DMCPredictorTable & predictors = GetPredictorTable(false, ifs);
         for (long v=0; v < nvert; ++v) 
         {
             nPred = 0;
-            if ( v2T.GetNumNeighbors(v) > 0 && 
-                 predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            const Index * const candidates = predictors.GetPredictors(v);
+            if (predMode != O3DGC_SC3DMC_NO_PREDICTION)
             {
-                int u0 = v2T.Begin(v);
-                int u1 = v2T.End(v);
-                for (long u = u0; u < u1; u++) 
+                nPred = predictors.GetNumPredictors(v);
+                for (unsigned long p = 0; p < nPred; ++p)
                 {
-                    long ta = v2T.GetNeighbor(u);
-                    if (ta < 0)
-                    {
-                        break;
-                    }
-                    for(long k = 0; k < 3; ++k)
+                    const long w = candidates[3*p];
+                    for (unsigned long i = 0; i < dimIntArray; i++) 
                     {
-                        long w = triangles[ta*3 + k];
-                        if ( w < v )
-                        {
-                            SC3DMCTriplet id = {-1, -1, w};
-                            unsigned long p = Insert(id, nPred, m_neighbors);
-                            if (p != 0xFFFFFFFF)
-                            {
-                                for (unsigned long i = 0; i < dimIntArray; i++) 
-                                {
-                                    m_neighbors[p].m_pred[i] = intArray[w*stride+i];
-                                } 
-                            }
-                        }
+                        m_neighbors[p].m_pred[i] = intArray[w*stride+i];
                     }
                 }
             }
@@ -328,8 +771,8 @@ namespace o3dgc
                 fprintf(g_fileDebugSC3DMCDec, "\t\t vm %i\n", v);
                 for (unsigned long p = 0; p < nPred; ++p)
                 {
-                    printf("\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
-                    fprintf(g_fileDebugSC3DMCDec, "\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
+                    printf("\t\t pred a = %i b = %i c = %i \n", candidates[3*p], candidates[3*p+1], candidates[3*p+2]);
+                    fprintf(g_fileDebugSC3DMCDec, "\t\t pred a = %i b = %i c = %i \n", candidates[3*p], candidates[3*p+1], candidates[3*p+2]);
                     for (unsigned long i = 0; i < dimIntArray; ++i) 
                     {
                         printf("\t\t\t %i\n", m_neighbors[p].m_pred[i]);
@@ -347,14 +790,14 @@ namespace o3dgc
                     bestPred = acd.decode(mModelPreds);
                 }
 #ifdef DEBUG_VERBOSE1
-                    printf("best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
-                    fprintf(g_fileDebugSC3DMCDec, "best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
+                    printf("best (%i, %i, %i) \t pos %i\n", candidates[3*bestPred], candidates[3*bestPred+1], candidates[3*bestPred+2], bestPred);
+                    fprintf(g_fileDebugSC3DMCDec, "best (%i, %i, %i) \t pos %i\n", candidates[3*bestPred], candidates[3*bestPred+1], candidates[3*bestPred+2], bestPred);
 #endif //DEBUG_VERBOSE
                 for (unsigned long i = 0; i < dimIntArray; i++) 
                 {
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
-                        predResidual = bstream.ReadIntASCII(m_iterator);
+                        predResidual = bstream.ReadIntASCII(iterator);
                     }
                     else
                     {
@@ -373,7 +816,7 @@ namespace o3dgc
                 {
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
-                        predResidual = bstream.ReadIntASCII(m_iterator);
+                        predResidual = bstream.ReadIntASCII(iterator);
                     }
                     else
                     {
@@ -392,7 +835,7 @@ namespace o3dgc
                 {
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
-                        predResidual = bstream.ReadUIntASCII(m_iterator);
+                        predResidual = bstream.ReadUIntASCII(iterator);
                     }
                     else
                     {
@@ -406,22 +849,33 @@ namespace o3dgc
                 }
             }
         }
-        m_iterator  = iteratorPred;
+        iterator  = iteratorPred;
 #ifdef DEBUG_VERBOSE
         fflush(g_fileDebugSC3DMCDec);
 #endif //DEBUG_VERBOSE
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode SC3DMCDecoder<T>::ProcessNormals(const IndexedFaceSet<T> & ifs)
+    const SC3DMCPredictorTable & SC3DMCDecoder<T>::GetPredictorTable(bool parallelogram, const IndexedFaceSet<T> & ifs)
+    {
+        SC3DMCPredictorTable & table = (parallelogram) ? m_parallelogramPredictors : m_differentialPredictors;
+        if (!table.IsValid())
+        {
+            table.Build(m_triangleListDecoder.GetVertexToTriangle(), ifs.GetCoordIndex(), 0, 0,
+                        (long) ifs.GetNCoord(), parallelogram);
+        }
+        return table;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::ProcessNormals(const IndexedFaceSet<T> & ifs, SC3DMCDecodeScratch & scratch)
     {
         const long nvert               = (long) ifs.GetNNormal();
         const unsigned long normalSize = ifs.GetNNormal() * 2;
-        if (m_normalsSize < normalSize)
+        if (scratch.m_normalsSize < normalSize)
         {
-            delete [] m_normals;
-            m_normalsSize = normalSize;
-            m_normals     = new Real [normalSize];
+            delete [] scratch.m_normals;
+            scratch.m_normalsSize = normalSize;
+            scratch.m_normals     = new Real [normalSize];
         }                                  
         const AdjacencyInfo & v2T          = m_triangleListDecoder.GetVertexToTriangle();
         const T * const       triangles    = ifs.GetCoordIndex();        
@@ -447,15 +901,15 @@ namespace o3dgc
                 a = triangles[ta*3 + 0];
                 b = triangles[ta*3 + 1];
                 c = triangles[ta*3 + 2];
-                p1.X() = m_quantFloatArray[3*a];
-                p1.Y() = m_quantFloatArray[3*a+1];
-                p1.Z() = m_quantFloatArray[3*a+2];
-                p2.X() = m_quantFloatArray[3*b];
-                p2.Y() = m_quantFloatArray[3*b+1];
-                p2.Z() = m_quantFloatArray[3*b+2];
-                p3.X() = m_quantFloatArray[3*c];
-                p3.Y() = m_quantFloatArray[3*c+1];
-                p3.Z() = m_quantFloatArray[3*c+2];
+                p1.X() = scratch.m_quantFloatArray[3*a];
+                p1.Y() = scratch.m_quantFloatArray[3*a+1];
+                p1.Z() = scratch.m_quantFloatArray[3*a+2];
+                p2.X() = scratch.m_quantFloatArray[3*b];
+                p2.Y() = scratch.m_quantFloatArray[3*b+1];
+                p2.Z() = scratch.m_quantFloatArray[3*b+2];
+                p3.X() = scratch.m_quantFloatArray[3*c];
+                p3.Y() = scratch.m_quantFloatArray[3*c+1];
+                p3.Z() = scratch.m_quantFloatArray[3*c+2];
                 nt  = (p2-p1)^(p3-p1);
                 n0 += nt;
             }
@@ -469,15 +923,15 @@ namespace o3dgc
 
             rna0 = na0 / norm0;
             rnb0 = nb0 / norm0;
-            ni1  = ni0 + m_orientation[v];
-            m_orientation[v] = ni1;
+            ni1  = ni0 + scratch.m_orientation[v];
+            scratch.m_orientation[v] = ni1;
             if ( (ni1 >> 1) != (ni0 >> 1) )
             {
                 rna0 = Real(0.0);
                 rnb0 = Real(0.0);
             }
-            m_normals[2*v]   = rna0;
-            m_normals[2*v+1] = rnb0;
+            scratch.m_normals[2*v]   = rna0;
+            scratch.m_normals[2*v+1] = rnb0;
 
 #ifdef DEBUG_VERBOSE1
             printf("n0 \t %i \t %i \t %i \t %i (%f, %f)\n", v, n0.X(), n0.Y(), n0.Z(), rna0, rnb0);
@@ -487,6 +941,65 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
+    template <class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::ProcessOctahedralNormals(const IndexedFaceSet<T> & ifs, 
+                                                              bool inverted, 
+                                                              SC3DMCDecodeScratch & scratch)
+    {
+        const long nvert               = (long) ifs.GetNNormal();
+        const unsigned long normalSize = ifs.GetNNormal() * 3;
+        if (scratch.m_normalsSize < normalSize)
+        {
+            delete [] scratch.m_normals;
+            scratch.m_normalsSize = normalSize;
+            scratch.m_normals     = new Real [normalSize];
+        }                                  
+        const AdjacencyInfo & v2T         = m_triangleListDecoder.GetVertexToTriangle();
+        const T * const       triangles   = ifs.GetCoordIndex();        
+        const Real            sign        = (inverted) ? (Real)(-1.0) : (Real)(1.0);
+        Vec3<long> p1, p2, p3, n0;
+        Real norm0;
+        long a, b, c;
+        for (long v=0; v < nvert; ++v) 
+        {
+            n0.X() = 0;
+            n0.Y() = 0;
+            n0.Z() = 0;
+            int u0 = v2T.Begin(v);
+            int u1 = v2T.End(v);
+            for (long u = u0; u < u1; u++) 
+            {
+                long ta = v2T.GetNeighbor(u);
+                if (ta == -1)
+                {
+                    break;
+                }
+                a = triangles[ta*3 + 0];
+                b = triangles[ta*3 + 1];
+                c = triangles[ta*3 + 2];
+                p1.X() = scratch.m_quantFloatArray[3*a];
+                p1.Y() = scratch.m_quantFloatArray[3*a+1];
+                p1.Z() = scratch.m_quantFloatArray[3*a+2];
+                p2.X() = scratch.m_quantFloatArray[3*b];
+                p2.Y() = scratch.m_quantFloatArray[3*b+1];
+                p2.Z() = scratch.m_quantFloatArray[3*b+2];
+                p3.X() = scratch.m_quantFloatArray[3*c];
+                p3.Y() = scratch.m_quantFloatArray[3*c+1];
+                p3.Z() = scratch.m_quantFloatArray[3*c+2];
+                n0 += (p2-p1)^(p3-p1);
+            }
+            norm0 = (Real) n0.GetNorm();
+            if (norm0 == 0.0)
+            {
+                n0.Z() = 1;
+                norm0  = 1.0;
+            }
+            scratch.m_normals[3*v]   = sign * (n0.X() / norm0);
+            scratch.m_normals[3*v+1] = sign * (n0.Y() / norm0);
+            scratch.m_normals[3*v+2] = sign * (n0.Z() / norm0);
+        }
+        return O3DGC_OK;
+    }
     template<class T>
     O3DGCErrorCode SC3DMCDecoder<T>::DecodeFloatArray(Real * const floatArray, 
                                                    unsigned long numFloatArray,
@@ -497,43 +1010,166 @@ namespace o3dgc
                                                    unsigned long nQBits,
                                                    const IndexedFaceSet<T> & ifs,
                                                    O3DGCSC3DMCPredictionMode & predMode,
-                                                   const BinaryStream & bstream)
+                                                   O3DGCIFSFloatAttributeType attributeType,
+                                                   SC3DMCDecodeScratch & scratch,
+                                                   const BinaryStream & bstream,
+                                                   unsigned long & iterator)
     {
-        assert(dimFloatArray <  O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES);
-        long predResidual;
-        SC3DMCPredictor m_neighbors  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
+        const unsigned char mask = (m_streamType != O3DGC_STREAM_TYPE_ASCII) ? PeekMask(bstream, iterator) : 0;
+        if (((mask >> 4) & 7) == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec acd;
+            if (mask & 0x08)
+            {
+                return DecodeFloatArray<Static_Data_Model>(acd, floatArray, numFloatArray, dimFloatArray, stride, 
+                                                           minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream, iterator);
+            }
+            return DecodeFloatArray<Adaptive_Data_Model>(acd, floatArray, numFloatArray, dimFloatArray, stride, 
+                                                         minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream, iterator);
+        }
         Arithmetic_Codec acd;
+        if (mask & 0x08)
+        {
+            return DecodeFloatArray<Static_Data_Model>(acd, floatArray, numFloatArray, dimFloatArray, stride, 
+                                                       minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream, iterator);
+        }
+        return DecodeFloatArray<Adaptive_Data_Model>(acd, floatArray, numFloatArray, dimFloatArray, stride, 
+                                                     minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream, iterator);
+    }
+    template<class T>
+    template<class Codec>
+    O3DGCErrorCode SC3DMCDecoder<T>::LoadModels(Codec & acd,
+                                                MultiLaneCodec<Codec, Adaptive_Data_Model> & lanes,
+                                                Adaptive_Data_Model & mModelPreds,
+                                                unsigned long & M,
+                                                O3DGCModelDictionaryEntry valuesEntry,
+                                                Static_Bit_Model & bModel0,
+                                                Adaptive_Bit_Model & bModel1)
+    {
+        const O3DGCModelDictionary modelDictionary = m_params.GetModelDictionary();
+        for(unsigned long l = 0; l < lanes.GetNumLanes(); ++l)
+        {
+            lanes.GetModelValues(l).set_alphabet(M+2);
+            SeedModel(modelDictionary, valuesEntry, lanes.GetModelValues(l));
+        }
+        mModelPreds.set_alphabet(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS+1);
+        SeedModel(modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_PREDICTORS, mModelPreds);
+        return O3DGC_OK;
+    }
+    template<class T>
+    template<class Codec>
+    O3DGCErrorCode SC3DMCDecoder<T>::LoadModels(Codec & acd,
+                                                MultiLaneCodec<Codec, Static_Data_Model> & lanes,
+                                                Static_Data_Model & mModelPreds,
+                                                unsigned long & M,
+                                                O3DGCModelDictionaryEntry valuesEntry,
+                                                Static_Bit_Model & bModel0,
+                                                Adaptive_Bit_Model & bModel1)
+    {
+        unsigned frequencies[O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + 1];
+        const unsigned long staticM = acd.ExpGolombDecode(0, bModel0, bModel1);
+        if (M + 2 > O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + 1 || staticM == 0 || staticM > M)
+        {
+            return O3DGC_ERROR_CORRUPTED_STREAM;
+        }
+        M = staticM;
+        O3DGCErrorCode ret = DecodeFrequencies(acd, frequencies, M + 2, bModel0, bModel1);
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        lanes.GetModelValues(0).set_frequencies(M + 2, frequencies);
+        lanes.ShareModelValues();
+        ret = DecodeFrequencies(acd, frequencies, O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1, bModel0, bModel1);
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        mModelPreds.set_frequencies(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1, frequencies);
+        return O3DGC_OK;
+    }
+    template<class T>
+    template<class Model, class Codec>
+    O3DGCErrorCode SC3DMCDecoder<T>::DecodeFloatArray(Codec & acd,
+                                                   Real * const floatArray, 
+                                                   unsigned long numFloatArray,
+                                                   unsigned long dimFloatArray,
+                                                   unsigned long stride,
+                                                   const Real * const minFloatArray,
+                                                   const Real * const maxFloatArray,
+                                                   unsigned long nQBits,
+                                                   const IndexedFaceSet<T> & ifs,
+                                                   O3DGCSC3DMCPredictionMode & predMode,
+                                                   O3DGCIFSFloatAttributeType attributeType,
+                                                   SC3DMCDecodeScratch & scratch,
+                                                   const BinaryStream & bstream,
+                                                   unsigned long & iterator)
+    {
+        assert(dimFloatArray <  O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES);
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
-        Adaptive_Data_Model mModelPreds(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS+1);
-        unsigned long nPred;
+        Model mModelPreds;
+        Model mModelValues;
+        MultiLaneCodec<Codec, Model> lanes(acd, mModelValues, bModel0, bModel1);
+        const O3DGCModelDictionary      modelDictionary = m_params.GetModelDictionary();
+        const O3DGCModelDictionaryEntry valuesEntry     = GetModelDictionaryValuesEntry(attributeType);
 
-        const AdjacencyInfo & v2T            = m_triangleListDecoder.GetVertexToTriangle();
-        const T * const     triangles        = ifs.GetCoordIndex();       
         const long          nvert            = (long) numFloatArray;
         const unsigned long size             = numFloatArray * dimFloatArray;
         unsigned char *     buffer           = 0;
-        unsigned long       start            = m_iterator;
-        unsigned long       streamSize       = bstream.ReadUInt32(m_iterator, m_streamType);        // bitsream size
-        unsigned char mask                   = bstream.ReadUChar(m_iterator, m_streamType);
+        unsigned long       start            = iterator;
+        unsigned long       streamSize       = bstream.ReadUInt32(iterator, m_streamType);        // bitsream size
+        unsigned char mask                   = bstream.ReadUChar(iterator, m_streamType);
         O3DGCSC3DMCBinarization binarization = (O3DGCSC3DMCBinarization)((mask >> 4) & 7);
         predMode                             = (O3DGCSC3DMCPredictionMode)(mask & 7);
-        streamSize                          -= (m_iterator - start);
-        unsigned long       iteratorPred     = m_iterator + streamSize;
+        streamSize                          -= (iterator - start);
+        unsigned long       iteratorPred     = iterator + streamSize;
         unsigned int        exp_k            = 0;
-        unsigned int        M                = 0;
+        unsigned long       M                = 0;
         if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
         {
-            if (binarization != O3DGC_SC3DMC_BINARIZATION_AC_EGC)
+            if (binarization != O3DGC_SC3DMC_BINARIZATION_AC_EGC &&
+                binarization != O3DGC_SC3DMC_BINARIZATION_RANS)
             {
                 return O3DGC_ERROR_CORRUPTED_STREAM;
             }
-            bstream.GetBuffer(m_iterator, buffer);
-            m_iterator += streamSize;
-            acd.set_buffer(streamSize, buffer);
+            unsigned long numLanes = 1;
+            unsigned long laneSize[O3DGC_SC3DMC_MAX_NUM_LANES];
+            laneSize[0] = streamSize;
+            if (mask & 0x80)
+            {
+                const unsigned long end = iterator + streamSize;
+                numLanes = bstream.ReadUChar8Bin(iterator);
+                if (numLanes < 2 || numLanes > O3DGC_SC3DMC_MAX_NUM_LANES)
+                {
+                    return O3DGC_ERROR_CORRUPTED_STREAM;
+                }
+                unsigned long sizeLanes = 0;
+                for(unsigned long l = 0; l < numLanes - 1; ++l)
+                {
+                    laneSize[l] = bstream.ReadUInt32Bin(iterator);
+                    sizeLanes  += laneSize[l];
+                }
+                if (iterator + sizeLanes > end)
+                {
+                    return O3DGC_ERROR_CORRUPTED_STREAM;
+                }
+                laneSize[numLanes - 1] = end - iterator - sizeLanes;
+                streamSize = end - iterator;
+            }
+            bstream.GetBuffer(iterator, buffer);
+            iterator += streamSize;
+            acd.set_buffer(laneSize[0], buffer);
             acd.start_decoder();
             exp_k = acd.ExpGolombDecode(0, bModel0, bModel1);
             M     = acd.ExpGolombDecode(0, bModel0, bModel1);
+            lanes.Init(numLanes);
+            for(unsigned long l = 1; l < numLanes; ++l)
+            {
+                buffer += laneSize[l-1];
+                lanes.GetCodec(l).set_buffer(laneSize[l], buffer);
+                lanes.GetCodec(l).start_decoder();
+            }
         }
         else
         {
@@ -543,226 +1179,93 @@ namespace o3dgc
             }
             bstream.ReadUInt32(iteratorPred, m_streamType);        // predictors bitsream size
         }
-        Adaptive_Data_Model mModelValues(M+2);
-
 
         if (predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
         {
-            m_orientation.Allocate(size);
-            m_orientation.Clear();
+            scratch.m_orientation.Allocate(size);
+            scratch.m_orientation.Clear();
             if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
             {
                 for(unsigned long i = 0; i < numFloatArray; ++i)
                 {
-                    m_orientation.PushBack((unsigned char) bstream.ReadIntASCII(m_iterator));
+                    scratch.m_orientation.PushBack((unsigned char) bstream.ReadIntASCII(iterator));
                 }
             }
             else
             {
                 Adaptive_Data_Model dModel(12);
+                SeedModel(modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_NORMAL_ORIENTATIONS, dModel);
                 for(unsigned long i = 0; i < numFloatArray; ++i)
                 {
-                    m_orientation.PushBack((unsigned char) UIntToInt(acd.decode(dModel)));
+                    scratch.m_orientation.PushBack((unsigned char) UIntToInt(acd.decode(dModel)));
                 }
             }
-            ProcessNormals(ifs);
+            ProcessNormals(ifs, scratch);
+            dimFloatArray = 2;
+        }
+        else if (predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
+        {
+            const unsigned long inverted = (m_streamType == O3DGC_STREAM_TYPE_ASCII) ? 
+                                           (unsigned long) bstream.ReadIntASCII(iterator) :
+                                           acd.ExpGolombDecode(0, bModel0, bModel1);
+            ProcessOctahedralNormals(ifs, inverted != 0, scratch);
             dimFloatArray = 2;
         }
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
+        {
+            // semi-static frequency tables follow the orientations
+            O3DGCErrorCode ret = LoadModels(acd, lanes, mModelPreds, M, valuesEntry, bModel0, bModel1);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+        }
 #ifdef DEBUG_VERBOSE
         printf("FloatArray (%i, %i)\n", numFloatArray, dimFloatArray);
         fprintf(g_fileDebugSC3DMCDec, "FloatArray (%i, %i)\n", numFloatArray, dimFloatArray);
 #endif //DEBUG_VERBOSE
 
-        if (m_quantFloatArraySize < size)
+        if (scratch.m_quantFloatArraySize < size)
         {
-            delete [] m_quantFloatArray;
-            m_quantFloatArraySize = size;
-            m_quantFloatArray     = new long [size];
+            delete [] scratch.m_quantFloatArray;
+            scratch.m_quantFloatArraySize = size;
+            scratch.m_quantFloatArray     = new long [size];
         }
-        for (long v=0; v < nvert; ++v) 
+        const long numChunks = (nvert + O3DGC_SC3DMC_DECODE_CHUNK_SIZE - 1) / O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        const long ringSize  = min(numChunks, O3DGC_SC3DMC_DECODE_NUM_CHUNKS) * O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        scratch.m_residuals.Allocate(ringSize * dimFloatArray);
+        scratch.m_bestPreds.Allocate(ringSize);
+        SC3DMCFloatArrayDecodeTask<Model, Codec> task;
+        task.m_acd           = &acd;
+        task.m_lanes         = &lanes;
+        task.m_modelPreds    = &mModelPreds;
+        task.m_exp_k         = exp_k;
+        task.m_M             = M;
+        task.m_streamType    = m_streamType;
+        task.m_bstream       = &bstream;
+        task.m_iterator      = iterator;
+        task.m_iteratorPred  = iteratorPred;
+        task.m_predictors    = &GetPredictorTable(predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION, ifs);
+        task.m_predMode      = predMode;
+        task.m_dimFloatArray = dimFloatArray;
+        task.m_stride        = stride;
+        task.m_numVertices   = nvert;
+        task.m_scratch       = &scratch;
+        if (scratch.m_numThreads > 1 && numChunks > 1 && scratch.m_threadPool.Start(2) == 2)
         {
-            nPred = 0;
-            if ( v2T.GetNumNeighbors(v) > 0 && 
-                 predMode != O3DGC_SC3DMC_NO_PREDICTION)
-            {
-                int u0 = v2T.Begin(v);
-                int u1 = v2T.End(v);
-                for (long u = u0; u < u1; u++) 
-                {
-                    long ta = v2T.GetNeighbor(u);
-                    if (ta < 0)
-                    {
-                        break;
-                    }
-                    if (predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION)
-                    {
-                        long a,b;
-                        if ((long) triangles[ta*3] == v)
-                        {
-                            a = triangles[ta*3 + 1];
-                            b = triangles[ta*3 + 2];
-                        }
-                        else if ((long)triangles[ta*3 + 1] == v)
-                        {
-                            a = triangles[ta*3 + 0];
-                            b = triangles[ta*3 + 2];
-                        }
-                        else
-                        {
-                            a = triangles[ta*3 + 0];
-                            b = triangles[ta*3 + 1];
-                        }
-                        if ( a < v && b < v)
-                        {
-                            int u0 = v2T.Begin(a);
-                            int u1 = v2T.End(a);
-                            for (long u = u0; u < u1; u++) 
-                            {
-                                long tb = v2T.GetNeighbor(u);
-                                if (tb < 0)
-                                {
-                                    break;
-                                }
-                                long c = -1;
-                                bool foundB = false;
-                                for(long k = 0; k < 3; ++k)
-                                {
-                                    long x = triangles[tb*3 + k];
-                                    if (x == b)
-                                    {
-                                        foundB = true;
-                                    }
-                                    if (x < v && x != a && x != b)
-                                    {
-                                        c = x;
-                                    }
-                                }
-                                if (c != -1 && foundB)
-                                {
-                                    SC3DMCTriplet id = {min(a, b), max(a, b), -c-1};
-                                    unsigned long p = Insert(id, nPred, m_neighbors);
-                                    if (p != 0xFFFFFFFF)
-                                    {
-                                        for (unsigned long i = 0; i < dimFloatArray; i++) 
-                                        {
-                                            m_neighbors[p].m_pred[i] = m_quantFloatArray[a*stride+i] + 
-                                                                       m_quantFloatArray[b*stride+i] - 
-                                                                       m_quantFloatArray[c*stride+i];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    if ( predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION  ||
-                         predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION ||
-                         predMode == O3DGC_SC3DMC_DIFFERENTIAL_PREDICTION )
-                    {                
-                        for(long k = 0; k < 3; ++k)
-                        {
-                            long w = triangles[ta*3 + k];
-                            if ( w < v )
-                            {
-                                SC3DMCTriplet id = {-1, -1, w};
-                                unsigned long p = Insert(id, nPred, m_neighbors);
-                                if (p != 0xFFFFFFFF)
-                                {
-                                    for (unsigned long i = 0; i < dimFloatArray; i++) 
-                                    {
-                                        m_neighbors[p].m_pred[i] = m_quantFloatArray[w*stride+i];
-                                    } 
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            if (nPred > 1)
-            {
-#ifdef DEBUG_VERBOSE1
-                printf("\t\t vm %i\n", v);
-                fprintf(g_fileDebugSC3DMCDec, "\t\t vm %i\n", v);
-                for (unsigned long p = 0; p < nPred; ++p)
-                {
-                    printf("\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
-                    fprintf(g_fileDebugSC3DMCDec, "\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
-                    for (unsigned long i = 0; i < dimFloatArray; ++i) 
-                    {
-                        printf("\t\t\t %i\n", m_neighbors[p].m_pred[i]);
-                        fprintf(g_fileDebugSC3DMCDec, "\t\t\t %i\n", m_neighbors[p].m_pred[i]);
-                    }
-                }
-#endif //DEBUG_VERBOSE
-                unsigned long bestPred;
-                if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
-                {
-                    bestPred = bstream.ReadUCharASCII(iteratorPred);
-                }
-                else
-                {
-                    bestPred = acd.decode(mModelPreds);
-                }
-#ifdef DEBUG_VERBOSE1
-                    printf("best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
-                    fprintf(g_fileDebugSC3DMCDec, "best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
-#endif //DEBUG_VERBOSE
-                for (unsigned long i = 0; i < dimFloatArray; i++) 
-                {
-                    if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
-                    {
-                        predResidual = bstream.ReadIntASCII(m_iterator);
-                    }
-                    else
-                    {
-                        predResidual = DecodeIntACEGC(acd, mModelValues, bModel0, bModel1, exp_k, M);
-                    }
-                    m_quantFloatArray[v*stride+i] = predResidual + m_neighbors[bestPred].m_pred[i];
-#ifdef DEBUG_VERBOSE
-                    printf("%i \t %i \t [%i]\n", v*dimFloatArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
-                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i \t [%i]\n", v*dimFloatArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
-#endif //DEBUG_VERBOSE
-                }
-            }
-            else if (v > 0 && predMode != O3DGC_SC3DMC_NO_PREDICTION)
-            {
-                for (unsigned long i = 0; i < dimFloatArray; i++) 
-                {
-                    if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
-                    {
-                        predResidual = bstream.ReadIntASCII(m_iterator);
-                    }
-                    else
-                    {
-                        predResidual = DecodeIntACEGC(acd, mModelValues, bModel0, bModel1, exp_k, M);
-                    }
-                    m_quantFloatArray[v*stride+i] = predResidual + m_quantFloatArray[(v-1)*stride+i];
-#ifdef DEBUG_VERBOSE
-                    printf("%i \t %i\n", v*dimFloatArray+i, predResidual);
-                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i\n", v*dimFloatArray+i, predResidual);
-#endif //DEBUG_VERBOSE
-                }
-            }
-            else
+            // the entropy decoding runs ahead on a worker of the scratch
+            scratch.m_threadPool.Run(DecodeFloatArrayThread<Model, Codec>, &task, 2);
+        }
+        else
+        {
+            for (long chunk = 0; chunk < numChunks; ++chunk)
             {
-                for (unsigned long i = 0; i < dimFloatArray; i++) 
-                {
-                    if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
-                    {
-                        predResidual = bstream.ReadUIntASCII(m_iterator);
-                    }
-                    else
-                    {
-                        predResidual = DecodeUIntACEGC(acd, mModelValues, bModel0, bModel1, exp_k, M);
-                    }
-                    m_quantFloatArray[v*stride+i] = predResidual;
-#ifdef DEBUG_VERBOSE
-                    printf("%i \t %i\n", v*dimFloatArray+i, predResidual);
-                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i\n", v*dimFloatArray+i, predResidual);
-#endif //DEBUG_VERBOSE
-                }
+                DecodeResiduals(task, chunk);
+                ReconstructFloatArray(task, chunk);
             }
         }
-        m_iterator  = iteratorPred;
+        iteratorPred = task.m_iteratorPred;
+        iterator  = iteratorPred;
         if (predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
         {
             const Real minNormal[2] = {(Real)(-2),(Real)(-2)};
@@ -770,14 +1273,14 @@ namespace o3dgc
             Real na1, nb1;
             Real na0, nb0;
             char ni1;
-            IQuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minNormal, maxNormal, nQBits+1);
+            IQuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minNormal, maxNormal, nQBits+1, scratch);
             for (long v=0; v < nvert; ++v) 
             {
-                na0 = m_normals[2*v];
-                nb0 = m_normals[2*v+1];
+                na0 = scratch.m_normals[2*v];
+                nb0 = scratch.m_normals[2*v+1];
                 na1 = floatArray[stride*v]   + na0;
                 nb1 = floatArray[stride*v+1] + nb0;
-                ni1 = m_orientation[v];
+                ni1 = scratch.m_orientation[v];
 
                 CubeToSphere(na1, nb1, ni1,
                              floatArray[stride*v], 
@@ -802,9 +1305,27 @@ namespace o3dgc
 #endif //DEBUG_VERBOSE
             }
         }
+        else if (predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
+        {
+            const Real minOctahedron[2] = {(Real)(-1.0),(Real)(-1.0)};
+            const Real maxOctahedron[2] = {(Real)(1.0),(Real)(1.0)};
+            Real x, y, z, t[3], s[3];
+            IQuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minOctahedron, maxOctahedron, nQBits+1, scratch);
+            for (long v=0; v < nvert; ++v) 
+            {
+                // back from the frame of the normal of the surface
+                const Real * const n = scratch.m_normals + 3*v;
+                Real * const       n1 = floatArray + stride*v;
+                OctahedronToSphere(n1[0], n1[1], x, y, z);
+                ComputeOrthonormalBasis(n, t, s);
+                n1[0] = x * t[0] + y * s[0] + z * n[0];
+                n1[1] = x * t[1] + y * s[1] + z * n[1];
+                n1[2] = x * t[2] + y * s[2] + z * n[2];
+            }
+        }
         else
         {
-            IQuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits);
+            IQuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits, scratch);
         }
 #ifdef DEBUG_VERBOSE
         fflush(g_fileDebugSC3DMCDec);
@@ -812,37 +1333,209 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template<class T>
-    O3DGCErrorCode SC3DMCDecoder<T>::IQuantizeFloatArray(Real * const floatArray, 
-                                                      unsigned long numFloatArray,
-                                                      unsigned long dimFloatArray,
-                                                      unsigned long stride,
-                                                      const Real * const minFloatArray,
-                                                      const Real * const maxFloatArray,
-                                                      unsigned long nQBits)
+    template<class Model, class Codec>
+    void SC3DMCDecoder<T>::DecodeResiduals(SC3DMCFloatArrayDecodeTask<Model, Codec> & task, long chunk)
+    {
+        const long            start        = chunk * O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        const long            end          = min(start + O3DGC_SC3DMC_DECODE_CHUNK_SIZE, task.m_numVertices);
+        const long            offset       = (chunk % O3DGC_SC3DMC_DECODE_NUM_CHUNKS) * O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        const unsigned long   dim          = task.m_dimFloatArray;
+        const bool            ascii        = (task.m_streamType == O3DGC_STREAM_TYPE_ASCII);
+        const BinaryStream &  bstream      = *task.m_bstream;
+        long * const          residuals    = task.m_scratch->m_residuals.GetBuffer() + offset * dim;
+        unsigned char * const bestPreds    = task.m_scratch->m_bestPreds.GetBuffer() + offset;
+        Timer timer;
+        timer.Tic();
+        if (ascii)
+        {
+            for (long v = start; v < end; ++v) 
+            {
+                long * const residual = residuals + (v - start) * dim;
+                unsigned long nPred = 0;
+                if (task.m_predMode != O3DGC_SC3DMC_NO_PREDICTION)
+                {
+                    nPred = task.m_predictors->GetNumPredictors(v);
+                }
+                if (nPred > 1)
+                {
+                    bestPreds[v - start] = bstream.ReadUCharASCII(task.m_iteratorPred);
+                }
+                if (nPred > 1 || (v > 0 && task.m_predMode != O3DGC_SC3DMC_NO_PREDICTION))
+                {
+                    for (unsigned long i = 0; i < dim; i++) 
+                    {
+                        residual[i] = bstream.ReadIntASCII(task.m_iterator);
+                    }
+                }
+                else
+                {
+                    for (unsigned long i = 0; i < dim; i++) 
+                    {
+                        residual[i] = bstream.ReadUIntASCII(task.m_iterator);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // the values are decoded one from each lane at a time. The predictor index of a vertex precedes its 
+            // values in lane 0, and the values of the vertices without prediction are unsigned.
+            MultiLaneCodec<Codec, Model> & lanes = *task.m_lanes;
+            const unsigned long numLanes   = lanes.GetNumLanes();
+            const bool          prediction = (task.m_predMode != O3DGC_SC3DMC_NO_PREDICTION);
+            const unsigned long end0       = (prediction && start == 0 && task.m_predictors->GetNumPredictors(0) <= 1) ? dim : 0;
+            const unsigned long numValues  = (end - start) * dim;
+            long                vPred      = start;     // next vertex whose predictor index is to be decoded
+            unsigned long       k          = 0;
+            while (k < numValues)
+            {
+                const unsigned long lane = lanes.GetLane();
+                if (lane == 0 && prediction)
+                {
+                    for (const long v = start + (long) (k / dim); vPred <= v; ++vPred)
+                    {
+                        if (task.m_predictors->GetNumPredictors(vPred) > 1)
+                        {
+                            bestPreds[vPred - start] = (unsigned char) task.m_acd->decode(*task.m_modelPreds);
+                        }
+                    }
+                }
+                unsigned long count = min(numLanes - lane, numValues - k);
+                if (k < end0)
+                {
+                    count = min(count, end0 - k);
+                    lanes.DecodeUInts(residuals + k, count, task.m_exp_k, task.m_M);
+                }
+                else if (prediction)
+                {
+                    lanes.DecodeInts(residuals + k, count, task.m_exp_k, task.m_M);
+                }
+                else
+                {
+                    lanes.DecodeUInts(residuals + k, count, task.m_exp_k, task.m_M);
+                }
+                k += count;
+            }
+            for (; prediction && vPred < end; ++vPred)
+            {
+                if (task.m_predictors->GetNumPredictors(vPred) > 1)
+                {
+                    bestPreds[vPred - start] = (unsigned char) task.m_acd->decode(*task.m_modelPreds);
+                }
+            }
+        }
+        timer.Toc();
+        task.m_scratch->m_timeEntropyDecoding += timer.GetElapsedTime();
+    }
+    template<class T>
+    template<class Model, class Codec>
+    void SC3DMCDecoder<T>::ReconstructFloatArray(SC3DMCFloatArrayDecodeTask<Model, Codec> & task, long chunk)
     {
-        
-        Real idelta[O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES];
-        Real r;
-        for(unsigned long d = 0; d < dimFloatArray; d++)
+        const long                  start           = chunk * O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        const long                  end             = min(start + O3DGC_SC3DMC_DECODE_CHUNK_SIZE, task.m_numVertices);
+        const long                  offset          = (chunk % O3DGC_SC3DMC_DECODE_NUM_CHUNKS) * O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        const unsigned long         dim             = task.m_dimFloatArray;
+        const unsigned long         stride          = task.m_stride;
+        const long * const          residuals       = task.m_scratch->m_residuals.GetBuffer() + offset * dim;
+        const unsigned char * const bestPreds       = task.m_scratch->m_bestPreds.GetBuffer() + offset;
+        long * const                quantFloatArray = task.m_scratch->m_quantFloatArray;
+        Timer timer;
+        timer.Tic();
+        for (long v = start; v < end; ++v) 
         {
-            r = maxFloatArray[d] - minFloatArray[d];
-            if (r > 0.0f)
+            const long * const residual = residuals + (v - start) * dim;
+            unsigned long nPred = 0;
+            if (task.m_predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            {
+                nPred = task.m_predictors->GetNumPredictors(v);
+            }
+            if (nPred > 1)
+            {
+                const Index * const candidates = task.m_predictors->GetPredictors(v);
+                const unsigned long bestPred   = bestPreds[v - start];
+                const long a = candidates[3*bestPred];
+                const long b = candidates[3*bestPred+1];
+                const long c = candidates[3*bestPred+2];
+#ifdef DEBUG_VERBOSE1
+                printf("best (%i, %i, %i) \t pos %i\n", a, b, c, bestPred);
+                fprintf(g_fileDebugSC3DMCDec, "best (%i, %i, %i) \t pos %i\n", a, b, c, bestPred);
+#endif //DEBUG_VERBOSE
+                for (unsigned long i = 0; i < dim; i++) 
+                {
+                    const long pred = (c < 0) ? quantFloatArray[a*stride+i] : 
+                                      quantFloatArray[a*stride+i] + quantFloatArray[b*stride+i] - quantFloatArray[c*stride+i];
+                    quantFloatArray[v*stride+i] = residual[i] + pred;
+#ifdef DEBUG_VERBOSE
+                    printf("%i \t %i \t [%i]\n", v*dim+i, residual[i], pred);
+                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i \t [%i]\n", v*dim+i, residual[i], pred);
+#endif //DEBUG_VERBOSE
+                }
+            }
+            else if (v > 0 && task.m_predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            {
+                for (unsigned long i = 0; i < dim; i++) 
+                {
+                    quantFloatArray[v*stride+i] = residual[i] + quantFloatArray[(v-1)*stride+i];
+#ifdef DEBUG_VERBOSE
+                    printf("%i \t %i\n", v*dim+i, residual[i]);
+                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i\n", v*dim+i, residual[i]);
+#endif //DEBUG_VERBOSE
+                }
+            }
+            else
             {
-                idelta[d] = r/(float)((1 << nQBits) - 1);
+                for (unsigned long i = 0; i < dim; i++) 
+                {
+                    quantFloatArray[v*stride+i] = residual[i];
+#ifdef DEBUG_VERBOSE
+                    printf("%i \t %i\n", v*dim+i, residual[i]);
+                    fprintf(g_fileDebugSC3DMCDec, "%i \t %i\n", v*dim+i, residual[i]);
+#endif //DEBUG_VERBOSE
+                }
             }
-            else 
+        }
+        timer.Toc();
+        task.m_scratch->m_timeReconstruction += timer.GetElapsedTime();
+    }
+    template<class T>
+    template<class Model, class Codec>
+    void SC3DMCDecoder<T>::DecodeFloatArrayThread(unsigned long threadID, void * data)
+    {
+        SC3DMCFloatArrayDecodeTask<Model, Codec> & task = *((SC3DMCFloatArrayDecodeTask<Model, Codec> *) data);
+        const long numChunks = (task.m_numVertices + O3DGC_SC3DMC_DECODE_CHUNK_SIZE - 1) / O3DGC_SC3DMC_DECODE_CHUNK_SIZE;
+        if (threadID == 0)
+        {
+            for (long chunk = 0; chunk < numChunks; ++chunk)
             {
-                idelta[d] = 1.0f;
+                task.m_decodedChunks.Wait(chunk + 1);
+                ReconstructFloatArray(task, chunk);
+                task.m_reconstructedChunks.Set(chunk + 1);
             }
-        }        
-        for(unsigned long v = 0; v < numFloatArray; ++v)
+            return;
+        }
+        for (long chunk = 0; chunk < numChunks; ++chunk)
         {
-            for(unsigned long d = 0; d < dimFloatArray; ++d)
+            if (chunk >= O3DGC_SC3DMC_DECODE_NUM_CHUNKS)
             {
-//                floatArray[v * stride + d] = m_quantFloatArray[v * stride + d];
-                floatArray[v * stride + d] = m_quantFloatArray[v * stride + d] * idelta[d] + minFloatArray[d];
+                // the chunk reuses the slot of the ring of chunk - O3DGC_SC3DMC_DECODE_NUM_CHUNKS
+                task.m_reconstructedChunks.Wait(chunk - O3DGC_SC3DMC_DECODE_NUM_CHUNKS + 1);
             }
+            DecodeResiduals(task, chunk);
+            task.m_decodedChunks.Set(chunk + 1);
         }
+    }
+    template<class T>
+    O3DGCErrorCode SC3DMCDecoder<T>::IQuantizeFloatArray(Real * const floatArray, 
+                                                      unsigned long numFloatArray,
+                                                      unsigned long dimFloatArray,
+                                                      unsigned long stride,
+                                                      const Real * const minFloatArray,
+                                                      const Real * const maxFloatArray,
+                                                      unsigned long nQBits,
+                                                      const SC3DMCDecodeScratch & scratch)
+    {
+        IQuantizeVectors(scratch.m_quantFloatArray, stride, 1, numFloatArray, dimFloatArray, 
+                         minFloatArray, maxFloatArray, nQBits, floatArray, stride);
         return O3DGC_OK;
     }
 }
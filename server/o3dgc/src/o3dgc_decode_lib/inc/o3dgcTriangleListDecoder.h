@@ -49,6 +49,8 @@ namespace o3dgc
                                         m_numVisitedVertices     = 0;
                                         m_visitedVertices        = 0;
                                         m_visitedVerticesValence = 0;
+                                        m_vertexToCorner         = 0;
+                                        m_nextCorner             = 0;
                                         m_maxNumVertices         = 0;
                                         m_maxNumTriangles        = 0;
                                         m_itNumTFans             = 0;
@@ -65,16 +67,19 @@ namespace o3dgc
                                     ~TriangleListDecoder(void)
                                     {
                                         delete [] m_tempTriangles;
+                                        delete [] m_vertexToCorner;
+                                        delete [] m_nextCorner;
                                     };
 
         O3DGCStreamType       GetStreamType()       const { return m_streamType; }
         bool                        GetReorderTriangles() const { return m_decodeTrianglesOrder; }        
         bool                        GetReorderVertices()  const { return m_decodeVerticesOrder; }        
         void                        SetStreamType(O3DGCStreamType streamType) { m_streamType = streamType; }
+        void                        SetModelDictionary(O3DGCModelDictionary modelDictionary) { m_ctfans.SetModelDictionary(modelDictionary); }
         const AdjacencyInfo &       GetVertexToTriangle() const { return m_vertexToTriangle;}
         O3DGCErrorCode              Decode(T * const triangles,
-                                           const long numTriangles,
-                                           const long numVertices,
+                                           const Index numTriangles,
+                                           const Index numVertices,
                                            const BinaryStream & bstream,
                                            unsigned long & iterator)
                                     {
@@ -85,9 +90,23 @@ namespace o3dgc
                                         {
                                             return O3DGC_ERROR_NON_SUPPORTED_FEATURE;
                                         }
-                                        unsigned long maxSizeV2T = bstream.ReadUInt32(iterator, m_streamType);
-                                        Init(triangles, numTriangles, numVertices, maxSizeV2T);
-                                        m_ctfans.Load(bstream, iterator, m_decodeTrianglesOrder, m_streamType);
+                                        bstream.ReadUInt32(iterator, m_streamType); // maximum valence, not needed by the corner lists
+                                        Init(triangles, numTriangles, numVertices);
+                                        if (((compressionMask >> 4) & 7) == O3DGC_SC3DMC_BINARIZATION_RANS)
+                                        {
+                                            m_ctfans.SetBinarization(O3DGC_SC3DMC_BINARIZATION_RANS);
+                                        }
+                                        else
+                                        {
+                                            m_ctfans.SetBinarization(O3DGC_SC3DMC_BINARIZATION_AC_EGC);
+                                        }
+                                        m_ctfans.SetEntropyModel(((compressionMask & 8) != 0) ? O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC :
+                                                                                                 O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE);
+                                        O3DGCErrorCode ret = m_ctfans.Load(bstream, iterator, m_decodeTrianglesOrder, m_streamType);
+                                        if (ret != O3DGC_OK)
+                                        {
+                                            return ret;
+                                        }
                                         Decompress();
                                         return O3DGC_OK;
                                     }
@@ -95,31 +114,37 @@ namespace o3dgc
 
         private:
         O3DGCErrorCode              Init(T * const triangles, 
-                                         const long numTriangles,
-                                         const long numVertices,
-                                         const long maxSizeV2T);
+                                         const Index numTriangles,
+                                         const Index numVertices);
         O3DGCErrorCode              Decompress();
-        O3DGCErrorCode              CompueLocalConnectivityInfo(const long focusVertex);
-        O3DGCErrorCode              DecompressTFAN(const long focusVertex);
+        O3DGCErrorCode              CompueLocalConnectivityInfo(const Index focusVertex);
+        O3DGCErrorCode              DecompressTFAN(const Index focusVertex);
+        void                        AddCorner(const Index vertex, const Index corner)
+                                    {
+                                        m_nextCorner[corner]     = m_vertexToCorner[vertex];
+                                        m_vertexToCorner[vertex] = corner;
+                                    }
 
         unsigned long               m_itNumTFans;
         unsigned long               m_itDegree;
         unsigned long               m_itConfig;
         unsigned long               m_itOperation;
         unsigned long               m_itIndex;
-        long                        m_maxNumVertices;
-        long                        m_maxNumTriangles;
-        long                        m_numTriangles;
-        long                        m_numVertices;
-        long                        m_tempTrianglesSize;
+        Index                       m_maxNumVertices;
+        Index                       m_maxNumTriangles;
+        Index                       m_numTriangles;
+        Index                       m_numVertices;
+        Index                       m_tempTrianglesSize;
         T *                         m_triangles;
         T *                         m_tempTriangles;
-        long                        m_vertexCount;
-        long                        m_triangleCount;
-        long                        m_numConqueredTriangles;
-        long                        m_numVisitedVertices;
-        long *                      m_visitedVertices;
-        long *                      m_visitedVerticesValence;
+        Index                       m_vertexCount;
+        Index                       m_triangleCount;
+        Index                       m_numConqueredTriangles;
+        Index                       m_numVisitedVertices;
+        Index *                     m_visitedVertices;
+        Index *                     m_visitedVerticesValence;
+        Index *                     m_vertexToCorner;   // last decoded corner of each vertex, -1 if none
+        Index *                     m_nextCorner;       // previous corner of the same vertex, -1 if none
         AdjacencyInfo               m_vertexToTriangle;
         CompressedTriangleFans      m_ctfans;
         TriangleFans                m_tfans;
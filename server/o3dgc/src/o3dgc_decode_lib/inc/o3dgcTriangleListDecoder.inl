@@ -28,9 +28,8 @@ namespace o3dgc
 {
     template<class T>
     O3DGCErrorCode TriangleListDecoder<T>::Init(T * const  triangles,
-                                                const long numTriangles,
-                                                const long numVertices,
-                                                const long maxSizeV2T)
+                                                const Index numTriangles,
+                                                const Index numVertices)
     {
         assert(numVertices  > 0);
         assert(numTriangles > 0);
@@ -49,8 +48,16 @@ namespace o3dgc
             m_maxNumVertices         = m_numVertices;
             delete [] m_visitedVerticesValence;
             delete [] m_visitedVertices;
-            m_visitedVerticesValence = new long [m_numVertices];
-            m_visitedVertices        = new long [m_numVertices];
+            delete [] m_vertexToCorner;
+            m_visitedVerticesValence = new Index [m_numVertices];
+            m_visitedVertices        = new Index [m_numVertices];
+            m_vertexToCorner         = new Index [m_numVertices];
+        }
+        if  (m_numTriangles > m_maxNumTriangles)
+        {
+            m_maxNumTriangles        = m_numTriangles;
+            delete [] m_nextCorner;
+            m_nextCorner             = new Index [3*m_numTriangles];
         }
         
         if (m_decodeTrianglesOrder && m_tempTrianglesSize < m_numTriangles)
@@ -64,21 +71,15 @@ namespace o3dgc
         m_ctfans.Allocate(m_numVertices, m_numTriangles);
         m_tfans.Allocate(2 * m_numVertices, 8 * m_numVertices);
 
-         // compute vertex-to-triangle adjacency information
-        m_vertexToTriangle.AllocateNumNeighborsArray(numVertices);
-        long * numNeighbors = m_vertexToTriangle.GetNumNeighborsBuffer();
-        for(long i = 0; i < numVertices; ++i)
-        {
-            numNeighbors[i] = maxSizeV2T;
-        }
-        m_vertexToTriangle.AllocateNeighborsArray();
-        m_vertexToTriangle.ClearNeighborsArray();
+        // the corners of each vertex are linked as they are decoded, which takes 3 * numTriangles + numVertices
+        // entries whatever the valences, and the vertex-to-triangle adjacency is built once all triangles are known
+        memset(m_vertexToCorner, 0xFF, sizeof(Index) * m_numVertices);
         return O3DGC_OK;
     }
     template<class T>
     O3DGCErrorCode TriangleListDecoder<T>::Decompress()
     {
-        for(long focusVertex = 0; focusVertex < m_numVertices; ++focusVertex)
+        for(Index focusVertex = 0; focusVertex < m_numVertices; ++focusVertex)
         {
             if (focusVertex == m_vertexCount)
             {
@@ -87,7 +88,8 @@ namespace o3dgc
             CompueLocalConnectivityInfo(focusVertex);
             DecompressTFAN(focusVertex);
         }
-        return O3DGC_OK;
+        // compute vertex-to-triangle adjacency information
+        return m_vertexToTriangle.ComputeVertexToTriangle(m_triangles, m_triangleCount, m_numVertices);
     }
     template<class T>
     O3DGCErrorCode TriangleListDecoder<T>::Reorder()
@@ -95,10 +97,10 @@ namespace o3dgc
         if (m_decodeTrianglesOrder)
         {
             unsigned long itTriangleIndex = 0;
-            long prevTriangleIndex = 0;
-            long t;
+            Index prevTriangleIndex = 0;
+            Index t;
             memcpy(m_tempTriangles, m_triangles, m_numTriangles * 3 * sizeof(T));
-            for(long i = 0; i < m_numTriangles; ++i)
+            for(Index i = 0; i < m_numTriangles; ++i)
             {
                 t  = m_ctfans.ReadTriangleIndex(itTriangleIndex) + prevTriangleIndex;
                 assert( t >= 0 && t < m_numTriangles);
@@ -109,55 +111,50 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template<class T>
-    O3DGCErrorCode TriangleListDecoder<T>::CompueLocalConnectivityInfo(const long focusVertex)
+    O3DGCErrorCode TriangleListDecoder<T>::CompueLocalConnectivityInfo(const Index focusVertex)
     {
-        long t = 0;
-        long p, v;
+        Index p, v;
         m_numConqueredTriangles    = 0;
         m_numVisitedVertices       = 0;
-        for(long i = m_vertexToTriangle.Begin(focusVertex); (t >= 0) && (i < m_vertexToTriangle.End(focusVertex)); ++i)
+        for(Index corner = m_vertexToCorner[focusVertex]; corner >= 0; corner = m_nextCorner[corner])
         {
-            t = m_vertexToTriangle.GetNeighbor(i);
-            if ( t >= 0)
+            ++m_numConqueredTriangles;
+            p = corner - corner % 3;
+            // extract visited vertices
+            for(Index k = 0; k < 3; ++k)
             {
-                ++m_numConqueredTriangles;
-                p = 3*t;
-                // extract visited vertices
-                for(long k = 0; k < 3; ++k)
+                v = m_triangles[p+k];
+                if (v > focusVertex) // vertices are insertices by increasing traversal order
                 {
-                    v = m_triangles[p+k];
-                    if (v > focusVertex) // vertices are insertices by increasing traversal order
+                    bool foundOrInserted = false;
+                    for (Index j = 0; j < m_numVisitedVertices; ++j)
                     {
-                        bool foundOrInserted = false;
-                        for (long j = 0; j < m_numVisitedVertices; ++j)
+                        if (v == m_visitedVertices[j])
                         {
-                            if (v == m_visitedVertices[j])
-                            {
-                                m_visitedVerticesValence[j]++;
-                                foundOrInserted = true;
-                                break;
-                            }
-                            else if (v < m_visitedVertices[j])
-                            {
-                                ++m_numVisitedVertices;
-                                for (long h = m_numVisitedVertices-1; h > j; --h)
-                                {
-                                    m_visitedVertices[h]        = m_visitedVertices[h-1];
-                                    m_visitedVerticesValence[h] = m_visitedVerticesValence[h-1];
-                                }
-                                m_visitedVertices[j]        = v;
-                                m_visitedVerticesValence[j] = 1;
-                                foundOrInserted = true;
-                                break;
-                            }
+                            m_visitedVerticesValence[j]++;
+                            foundOrInserted = true;
+                            break;
                         }
-                        if (!foundOrInserted)
+                        else if (v < m_visitedVertices[j])
                         {
-                            m_visitedVertices[m_numVisitedVertices]        = v;
-                            m_visitedVerticesValence[m_numVisitedVertices] = 1;
-                            m_numVisitedVertices++;
+                            ++m_numVisitedVertices;
+                            for (Index h = m_numVisitedVertices-1; h > j; --h)
+                            {
+                                m_visitedVertices[h]        = m_visitedVertices[h-1];
+                                m_visitedVerticesValence[h] = m_visitedVerticesValence[h-1];
+                            }
+                            m_visitedVertices[j]        = v;
+                            m_visitedVerticesValence[j] = 1;
+                            foundOrInserted = true;
+                            break;
                         }
                     }
+                    if (!foundOrInserted)
+                    {
+                        m_visitedVertices[m_numVisitedVertices]        = v;
+                        m_visitedVerticesValence[m_numVisitedVertices] = 1;
+                        m_numVisitedVertices++;
+                    }
                 }
             }
         }
@@ -165,8 +162,8 @@ namespace o3dgc
         // in order to avoid config. 9
         if (m_numVisitedVertices > 2)
         {
-            long y;
-            for(long x = 1; x < m_numVisitedVertices; ++x)
+            Index y;
+            for(Index x = 1; x < m_numVisitedVertices; ++x)
             {
 
                 if (m_visitedVerticesValence[x] == 1)
@@ -184,19 +181,19 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template<class T>
-    O3DGCErrorCode TriangleListDecoder<T>::DecompressTFAN(const long focusVertex)
+    O3DGCErrorCode TriangleListDecoder<T>::DecompressTFAN(const Index focusVertex)
     {
-        long ntfans; 
-        long degree, config;
-        long op;
-        long index;
-        long k0, k1;
-        long b, c, t;
+        Index ntfans; 
+        Index degree, config;
+        Index op;
+        Index index;
+        Index k0, k1;
+        Index b, c, t;
 
         ntfans = m_ctfans.ReadNumTFans(m_itNumTFans);
         if (ntfans > 0) 
         {
-            for(long f = 0; f != ntfans; f++) 
+            for(Index f = 0; f != ntfans; f++) 
             {
                 m_tfans.AddTFAN();
                 degree     = m_ctfans.ReadDegree(m_itDegree) +2 - m_numConqueredTriangles;
@@ -207,7 +204,7 @@ namespace o3dgc
                 {
                     case 0:// ops: 1000001 vertices: -1 -2
                         m_tfans.AddVertex(m_visitedVertices[0]);
-                        for(long u = 1; u < degree-1; u++)
+                        for(Index u = 1; u < degree-1; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -216,7 +213,7 @@ namespace o3dgc
                         break;
                     case 1: // ops: 1xxxxxx1 vertices: -1 x x x x x -2
                         m_tfans.AddVertex(m_visitedVertices[0]);
-                        for(long u = 1; u < degree-1; u++)
+                        for(Index u = 1; u < degree-1; u++)
                         {
                             op = m_ctfans.ReadOperation(m_itOperation);
                             if (op == 1) 
@@ -240,7 +237,7 @@ namespace o3dgc
                         m_tfans.AddVertex(m_visitedVertices[1]);
                         break;
                     case 2: // ops: 00000001 vertices: -1
-                        for(long u = 0; u < degree-1; u++)
+                        for(Index u = 0; u < degree-1; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -248,7 +245,7 @@ namespace o3dgc
                         m_tfans.AddVertex(m_visitedVertices[0]);
                         break;
                     case 3: // ops: 00000001 vertices: -2
-                        for(long u=0; u < degree-1; u++)
+                        for(Index u=0; u < degree-1; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -257,7 +254,7 @@ namespace o3dgc
                         break;
                     case 4: // ops: 10000000 vertices: -1
                         m_tfans.AddVertex(m_visitedVertices[0]);
-                        for(long u = 1; u < degree; u++)
+                        for(Index u = 1; u < degree; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -265,14 +262,14 @@ namespace o3dgc
                         break;
                     case 5: // ops: 10000000 vertices: -2
                         m_tfans.AddVertex(m_visitedVertices[1]);
-                        for(long u = 1; u < degree; u++)
+                        for(Index u = 1; u < degree; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
                         }
                         break;
                     case 6:// ops: 00000000 vertices:
-                        for(long u = 0; u < degree; u++)
+                        for(Index u = 0; u < degree; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -280,7 +277,7 @@ namespace o3dgc
                         break;
                     case 7: // ops: 1000001 vertices: -2 -1
                         m_tfans.AddVertex(m_visitedVertices[1]);
-                        for(long u = 1; u < degree-1; u++)
+                        for(Index u = 1; u < degree-1; u++)
                         {
                             m_visitedVertices[m_numVisitedVertices++] = m_vertexCount;
                             m_tfans.AddVertex(m_vertexCount++);
@@ -289,7 +286,7 @@ namespace o3dgc
                         break;
                     case 8: // ops: 1xxxxxx1 vertices: -2 x x x x x -1
                         m_tfans.AddVertex(m_visitedVertices[1]);
-                        for(long u = 1; u < degree-1; u++)
+                        for(Index u = 1; u < degree-1; u++)
                         {
                             op = m_ctfans.ReadOperation(m_itOperation);
                             if (op == 1) 
@@ -313,7 +310,7 @@ namespace o3dgc
                         m_tfans.AddVertex(m_visitedVertices[0]);
                         break;
                     case 9: // general case
-                        for(long u = 0; u < degree; u++)
+                        for(Index u = 0; u < degree; u++)
                         {
                             op = m_ctfans.ReadOperation(m_itOperation);
                             if (op == 1) 
@@ -340,7 +337,7 @@ namespace o3dgc
                 //logger.write_2_log("\t degree=%i \t cas = %i\n", degree, cas);
                 k1 = m_tfans.GetNumVertices();
                 b  = m_tfans.GetVertex(k0+1);
-                for (long k = k0+2; k < k1; k++)
+                for (Index k = k0+2; k < k1; k++)
                 {
                     c = m_tfans.GetVertex(k);
                     t = m_triangleCount*3;
@@ -349,9 +346,9 @@ namespace o3dgc
                     m_triangles[t++] = (T) b;
                     m_triangles[t  ] = (T) c;
 
-                    m_vertexToTriangle.AddNeighbor(focusVertex, m_triangleCount);
-                    m_vertexToTriangle.AddNeighbor(b          , m_triangleCount);
-                    m_vertexToTriangle.AddNeighbor(c          , m_triangleCount);
+                    AddCorner(focusVertex, t-2);
+                    AddCorner(b          , t-1);
+                    AddCorner(c          , t  );
                     b=c;
                     m_triangleCount++;
                 }
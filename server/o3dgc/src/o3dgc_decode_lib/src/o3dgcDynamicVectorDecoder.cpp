@@ -21,6 +21,8 @@ THE SOFTWARE.
 */
 #include "o3dgcDynamicVectorDecoder.h"
 #include "o3dgcArithmeticCodec.h"
+#include "o3dgcRANSCodec.h"
+#include "o3dgcSIMD.h"
 
 
 //#define DEBUG_VERBOSE
@@ -138,7 +140,10 @@ namespace o3dgc
             m_streamType = O3DGC_STREAM_TYPE_BINARY;
         }
         m_streamSize = bstream.ReadUInt32(m_iterator, m_streamType);
-        m_params.SetEncodeMode( (O3DGCDVEncodingMode) bstream.ReadUChar(m_iterator, m_streamType));
+        unsigned char mode = bstream.ReadUChar(m_iterator, m_streamType);
+        m_params.SetEncodeMode( (O3DGCDVEncodingMode) (mode & 15));
+        m_params.SetBinarization(((mode >> 4) & 7) == O3DGC_SC3DMC_BINARIZATION_RANS ? O3DGC_SC3DMC_BINARIZATION_RANS :
+                                                                                      O3DGC_SC3DMC_BINARIZATION_AC_EGC);
         dynamicVector.SetNVector   ( bstream.ReadUInt32(m_iterator, m_streamType) );
           
         if (dynamicVector.GetNVector() > 0)
@@ -148,6 +153,32 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
+    template <class Codec>
+    O3DGCErrorCode DynamicVectorDecoder::DecodeAC(Codec & acd,
+                                                  unsigned long num, 
+                                                  unsigned long dim, 
+                                                  unsigned long streamSize, 
+                                                  const BinaryStream & bstream)
+    {
+        Static_Bit_Model bModel0;
+        Adaptive_Bit_Model bModel1;
+        unsigned char * buffer = 0;
+        bstream.GetBuffer(m_iterator, buffer);
+        m_iterator += streamSize;
+        acd.set_buffer(streamSize, buffer);
+        acd.start_decoder();
+        const unsigned int exp_k = acd.ExpGolombDecode(0, bModel0, bModel1);
+        const unsigned int M     = acd.ExpGolombDecode(0, bModel0, bModel1);
+        Adaptive_Data_Model mModelValues(M+2);
+        for(unsigned long v = 0; v < num; ++v)
+        {
+            for(unsigned long d = 0; d < dim; ++d)
+            {
+                m_quantVectors[d * num + v] = DecodeIntACEGC(acd, mModelValues, bModel0, bModel1, exp_k, M);
+            }
+        }
+        return O3DGC_OK;
+    }
     O3DGCErrorCode DynamicVectorDecoder::DecodePlayload(DynamicVector & dynamicVector,
                                                         const BinaryStream & bstream)
     {
@@ -166,23 +197,7 @@ namespace o3dgc
             dynamicVector.SetMin(j, (Real) bstream.ReadFloat32(m_iterator, m_streamType));
             dynamicVector.SetMax(j, (Real) bstream.ReadFloat32(m_iterator, m_streamType));
         }
-        Arithmetic_Codec acd;
-        Static_Bit_Model bModel0;
-        Adaptive_Bit_Model bModel1;
-        unsigned char *     buffer           = 0;
         streamSize                          -= (m_iterator - start);
-        unsigned int        exp_k            = 0;
-        unsigned int        M                = 0;        
-        if (m_streamType == O3DGC_STREAM_TYPE_BINARY)
-        {
-            bstream.GetBuffer(m_iterator, buffer);
-            m_iterator += streamSize;
-            acd.set_buffer(streamSize, buffer);
-            acd.start_decoder();
-            exp_k = acd.ExpGolombDecode(0, bModel0, bModel1);
-            M     = acd.ExpGolombDecode(0, bModel0, bModel1);
-        }
-        Adaptive_Data_Model mModelValues(M+2);
 
         if (m_maxNumVectors < size)
         {
@@ -200,15 +215,15 @@ namespace o3dgc
                 }
             }
         }
+        else if (m_params.GetBinarization() == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec acd;
+            DecodeAC(acd, num, dim, streamSize, bstream);
+        }
         else
         {
-            for(unsigned long v = 0; v < num; ++v)
-            {
-                for(unsigned long d = 0; d < dim; ++d)
-                {
-                    m_quantVectors[d * num + v] = DecodeIntACEGC(acd, mModelValues, bModel0, bModel1, exp_k, M);
-                }
-            }
+            Arithmetic_Codec acd;
+            DecodeAC(acd, num, dim, streamSize, bstream);
         }
         #ifdef DEBUG_VERBOSE
         printf("IntArray (%i, %i)\n", num, dim);
@@ -249,30 +264,14 @@ namespace o3dgc
                                                    unsigned long nQBits)
     {
         const unsigned long size = numFloatArray * dimFloatArray;
-        Real r;
         if (m_maxNumVectors < size)
         {
             delete [] m_quantVectors;
             m_maxNumVectors = size;
             m_quantVectors = new long [m_maxNumVectors];
         }
-        Real idelta;
-        for(unsigned long d = 0; d < dimFloatArray; ++d)
-        {
-            r = maxFloatArray[d] - minFloatArray[d];
-            if (r > 0.0f)
-            {
-                idelta = (float)(r) / ((1 << nQBits) - 1);
-            }
-            else
-            {
-                idelta = 1.0f;
-            }
-            for(unsigned long v = 0; v < numFloatArray; ++v)
-            {
-                floatArray[v * stride + d] = m_quantVectors[v + d * numFloatArray] * idelta + minFloatArray[d];
-            }
-        }
+        IQuantizeVectors(m_quantVectors, 1, numFloatArray, numFloatArray, dimFloatArray, 
+                         minFloatArray, maxFloatArray, nQBits, floatArray, stride);
         return O3DGC_OK;
     }
 }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "o3dgcCommon.h"
 #include "o3dgcBinaryStream.h"
 #include "o3dgcDynamicVector.h"
+#include "o3dgcEGCCostEstimator.h"
 
 namespace o3dgc
 {
@@ -60,18 +61,25 @@ namespace o3dgc
                                              const Real * const minFloatArray,
                                              const Real * const maxFloatArray,
                                              unsigned long nQBits);
-        O3DGCErrorCode              EncodeAC(unsigned long num, 
+        template <class Codec>
+        O3DGCErrorCode              EncodeAC(Codec & ace,
+                                             unsigned long num, 
                                              unsigned long dim, 
                                              unsigned long M, 
-                                             unsigned long & encodedBytes);
+                                             unsigned long & encodedBytes,
+                                             BinaryStream & bstream);
+        template <class Codec>
+        O3DGCErrorCode              EncodeBestM(Codec & ace,
+                                                unsigned long num, 
+                                                unsigned long dim, 
+                                                BinaryStream & bstream);
 
         unsigned long               m_posSize;
-        unsigned long               m_sizeBufferAC;
         unsigned long               m_maxNumVectors;
         unsigned long               m_numVectors;
         unsigned long               m_dimVectors;
-        unsigned char *             m_bufferAC;
         long *                      m_quantVectors;
+        EGCCostEstimator            m_estimator;
         O3DGCStreamType             m_streamType;
     };
 }
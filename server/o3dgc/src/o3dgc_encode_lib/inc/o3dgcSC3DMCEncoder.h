@@ -30,46 +30,223 @@ THE SOFTWARE.
 #include "o3dgcIndexedFaceSet.h"
 #include "o3dgcSC3DMCEncodeParams.h"
 #include "o3dgcTriangleListEncoder.h"
+#include "o3dgcMultiLaneCodec.h"
+#include "o3dgcEGCCostEstimator.h"
+#include "o3dgcSC3DMCTableOfContents.h"
+#include "o3dgcSC3DMCSegmentIndex.h"
+#include "o3dgcSC3DMCPredictorTable.h"
+#include "o3dgcSIMD.h"
 
 namespace o3dgc
 {    
-    //! 
+    //! Number of vertices whose candidate residuals are computed at once by EncodeFloatArray().
+    const long O3DGC_SC3DMC_RESIDUAL_BLOCK_SIZE = 65536;
+
     template<class T>
-    class SC3DMCEncoder
+    class SC3DMCEncoder;
+
+    //! Shared state of the threads encoding the segments: thread i encodes the segments i, i + m_numThreads, ...
+    template<class T>
+    struct SC3DMCSegmentEncodeTask
+    {
+        const SC3DMCEncoder<T> *    m_encoder;
+        const SC3DMCEncodeParams *  m_params;
+        const IndexedFaceSet<T> *   m_ifs;
+        BinaryStream *              m_streams;
+        SC3DMCStats *               m_stats;
+        O3DGCErrorCode *            m_errors;
+        unsigned long               m_numThreads;
+    };
+
+    //! Working buffers of the attribute encoding. The threads encoding the attributes concurrently have one each.
+    struct SC3DMCEncodeScratch
     {
-    public:    
         //! Constructor.
-                                    SC3DMCEncoder(void)
+                                    SC3DMCEncodeScratch(void)
                                     {
-                                        m_posSize             = 0;
                                         m_quantFloatArray     = 0;
                                         m_quantFloatArraySize = 0;
-                                        m_sizeBufferAC        = 0;
-                                        m_bufferAC            = 0;
                                         m_normals             = 0;
                                         m_normalsSize         = 0;
-                                        m_streamType          = O3DGC_STREAM_TYPE_UNKOWN;
+                                        m_invertedNormals     = false;
+                                        m_numThreads          = 1;
                                     };
         //! Destructor.
-                                    ~SC3DMCEncoder(void)
+                                    ~SC3DMCEncodeScratch(void)
                                     {
                                         delete [] m_normals;
                                         delete [] m_quantFloatArray;
-                                        delete [] m_bufferAC;
                                     }
-        //! 
+        long *                      m_quantFloatArray;
+        unsigned long               m_quantFloatArraySize;
+        SC3DMCPredictor             m_neighbors  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
+        unsigned long               m_freqSymbols[O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS];
+        unsigned long               m_freqPreds  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
+        Vector<long>                m_predictors;
+        Vector<long>                m_residuals;
+        EGCCostEstimator            m_estimator;
+        Real *                      m_normals;
+        unsigned long               m_normalsSize;
+        //! True if the normals point against those of the surface (O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION).
+        bool                        m_invertedNormals;
+        //! Residuals of the vertices of the current block for each of their candidate predictors, when m_numThreads > 1.
+        Vector<long>                m_candidateResiduals;
+        //! Number of threads computing m_candidateResiduals.
+        unsigned long               m_numThreads;
+        //! Workers computing m_candidateResiduals, kept for all the blocks encoded with this scratch.
+        ThreadPool                  m_threadPool;
+    };
+
+    //! Shared state of the threads computing the residuals of the vertices [m_start, m_end) for each of their 
+    //! prediction candidates: thread i handles the i-th of m_numThreads consecutive vertex ranges. EstimateM() also 
+    //! reads the integer arrays through it.
+    struct SC3DMCResidualTask
+    {
+        const SC3DMCPredictorTable *  m_predictors;
+        const Index *                 m_invVMap;
+        const long *                  m_quantFloatArray;
+        unsigned long                 m_dimFloatArray;
+        unsigned long                 m_stride;
+        long                          m_start;
+        long                          m_end;
+        long *                        m_residuals;
+        unsigned long                 m_numThreads;
+    };
+
+    //! Shared state of the threads encoding the attribute sections: thread i encodes the sections i, i + m_numThreads, 
+    //! ... of m_sections to m_streams, with m_scratch[i].
+    template<class T>
+    struct SC3DMCAttributeEncodeTask
+    {
+        SC3DMCEncoder<T> *          m_encoder;
+        const SC3DMCEncodeParams *  m_params;
+        const IndexedFaceSet<T> *   m_ifs;
+        const unsigned long *       m_sections;
+        unsigned long               m_numSections;
+        BinaryStream *              m_streams;
+        SC3DMCEncodeScratch *       m_scratch;
+        O3DGCErrorCode *            m_errors;
+        unsigned long               m_numThreads;
+    };
+
+    //! 
+    template<class T>
+    class SC3DMCEncoder
+    {
+    public:    
+        //! Constructor.
+                                    SC3DMCEncoder(void)
+                                    {
+                                        m_posStart            = 0;
+                                        m_posSize             = 0;
+                                        m_posTOC              = 0;
+                                        m_streamType          = O3DGC_STREAM_TYPE_UNKOWN;
+                                        m_binarization        = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+                                        m_numLanes            = 1;
+                                        m_modelDictionary     = O3DGC_MODEL_DICTIONARY_NONE;
+                                        m_entropyModel        = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE;
+                                    };
+        //! Destructor.
+                                    ~SC3DMCEncoder(void) {};
+        //! Encodes ifs, whose ComputeMinMax() gives the quantization ranges, with the quantization bits of params or
+        //! those chosen from its error bounds and stream size budget.
         O3DGCErrorCode              Encode(const SC3DMCEncodeParams & params, 
                                            const IndexedFaceSet<T> & ifs, 
                                            BinaryStream & bstream);
         const SC3DMCStats &         GetStats() const { return m_stats;}
 
         private:
+        //! Encodes the header and the payload with the quantization bits of params.
+        O3DGCErrorCode              EncodeStream(const SC3DMCEncodeParams & params, 
+                                                 const IndexedFaceSet<T> & ifs, 
+                                                 BinaryStream & bstream);
+        //! Sets the quantization bits of quantParams to the fewest meeting the error bounds of params.
+        static void                 ComputeQuantBits(const SC3DMCEncodeParams & params, 
+                                                     const IndexedFaceSet<T> & ifs,
+                                                     SC3DMCEncodeParams & quantParams);
+        //! Lowers the quantization bits of quantParams by the fewest bits fitting the stream in 
+        //! quantParams.GetMaxStreamSize() bytes. If none was found to, fits is false and the bits giving the smallest
+        //! measured stream are kept.
+        static O3DGCErrorCode       FitStreamSize(const IndexedFaceSet<T> & ifs, 
+                                                  SC3DMCEncodeParams & quantParams,
+                                                  bool & fits);
+        //! Drops the model dictionary of quantParams unless it gives a smaller stream: its priors may fit the mesh 
+        //! worse than the adaptive models learn it.
+        static O3DGCErrorCode       ChooseModelDictionary(const IndexedFaceSet<T> & ifs, 
+                                                          SC3DMCEncodeParams & quantParams);
+        static O3DGCErrorCode       ComputeStreamSize(const SC3DMCEncodeParams & params, 
+                                                      const IndexedFaceSet<T> & ifs,
+                                                      unsigned long & size);
+        //! Records the quantization bits of params and the bounds on the errors in m_stats.
+        void                        ComputeQuantErrors(const SC3DMCEncodeParams & params, 
+                                                       const IndexedFaceSet<T> & ifs);
         O3DGCErrorCode              EncodeHeader(const SC3DMCEncodeParams & params, 
                                                  const IndexedFaceSet<T> & ifs, 
                                                  BinaryStream & bstream);
         O3DGCErrorCode              EncodePayload(const SC3DMCEncodeParams & params, 
                                                   const IndexedFaceSet<T> & ifs, 
                                                   BinaryStream & bstream);
+        //! Groups the connected components, or the triangles of spatial clusters, into segments. Clears m_segments if 
+        //! the mesh is not segmented.
+        void                        ComputeSegments(const SC3DMCEncodeParams & params, 
+                                                    const IndexedFaceSet<T> & ifs);
+        //! Assigns the triangles to the leaves of a k-d tree with at most clusterSize triangles per leaf and returns
+        //! the number of leaves.
+        unsigned long               ComputeClusters(unsigned long clusterSize,
+                                                    const IndexedFaceSet<T> & ifs,
+                                                    Vector<unsigned long> & triangleSegments);
+        //! Lists the triangles and vertices of each segment and computes the segment index, given the segment of 
+        //! each triangle and, if any, of each vertex.
+        void                        BuildSegments(unsigned long numSegments,
+                                                  const Vector<unsigned long> & triangleSegments,
+                                                  const unsigned long * const vertexSegments,
+                                                  const IndexedFaceSet<T> & ifs);
+        //! Encodes the segments concurrently and appends the segment index followed by the segment streams.
+        O3DGCErrorCode              EncodeSegments(const SC3DMCEncodeParams & params, 
+                                                   const IndexedFaceSet<T> & ifs, 
+                                                   BinaryStream & bstream);
+        O3DGCErrorCode              EncodeSegment(unsigned long s,
+                                                  const SC3DMCEncodeParams & params, 
+                                                  const IndexedFaceSet<T> & ifs, 
+                                                  BinaryStream & bstream,
+                                                  SC3DMCStats & stats) const;
+        //! Thread function of EncodeSegments().
+        static void                 EncodeSegmentsThread(unsigned long threadID, void * data);
+        //! Encodes the attribute sections, concurrently if params allows more than one thread, and appends them.
+        O3DGCErrorCode              EncodeAttributes(const SC3DMCEncodeParams & params, 
+                                                     const IndexedFaceSet<T> & ifs, 
+                                                     BinaryStream & bstream);
+        //! Encodes the attribute section (O3DGC_SC3DMC_SECTION_COORD or a later one) and times it in m_stats.
+        O3DGCErrorCode              EncodeAttribute(unsigned long section,
+                                                    const SC3DMCEncodeParams & params, 
+                                                    const IndexedFaceSet<T> & ifs, 
+                                                    SC3DMCEncodeScratch & scratch,
+                                                    BinaryStream & bstream);
+        //! Thread function of EncodeAttributes().
+        static void                 EncodeAttributesThread(unsigned long threadID, void * data);
+        //! Thread function of EncodeFloatArray(): computes the residuals of a block of vertices for each of their 
+        //! prediction candidates.
+        static void                 ComputeResidualsThread(unsigned long threadID, void * data);
+        //! Computes the residuals of the vertex vm for each of its prediction candidates.
+        static void                 ComputeCandidateResiduals(const SC3DMCResidualTask & task, long vm, long * const residuals);
+        //! Escape threshold M of the adaptive models that the estimator prefers for the residuals of the first block 
+        //! of vertices, each vertex using its candidate with the smallest residuals. Serves the integer arrays too, 
+        //! whose predictor tables only hold (w, -1, -1) candidates. The models seeded from the entry valuesEntry of 
+        //! dictionary are priced from its prior counts.
+        static unsigned long        EstimateM(const SC3DMCResidualTask & task, 
+                                              long numVertices,
+                                              O3DGCSC3DMCPredictionMode predMode,
+                                              O3DGCModelDictionary dictionary,
+                                              O3DGCModelDictionaryEntry valuesEntry,
+                                              SC3DMCEncodeScratch & scratch);
+        //! Integer counterpart of EstimateFloatArrayM().
+        unsigned long               EstimateIntArrayM(const long * const intArray, 
+                                                      unsigned long numIntArray,
+                                                      unsigned long dimIntArray,
+                                                      unsigned long stride,
+                                                      const SC3DMCPredictorTable & predictors,
+                                                      O3DGCSC3DMCPredictionMode predMode,
+                                                      SC3DMCEncodeScratch & scratch);
         O3DGCErrorCode              EncodeFloatArray(const Real * const floatArray, 
                                                      unsigned long numfloatArray,
                                                      unsigned long dimfloatArray,
@@ -79,36 +256,86 @@ namespace o3dgc
                                                      unsigned long nQBits,
                                                      const IndexedFaceSet<T> & ifs,
                                                      O3DGCSC3DMCPredictionMode predMode,
+                                                     O3DGCIFSFloatAttributeType attributeType,
+                                                     SC3DMCEncodeScratch & scratch,
                                                      BinaryStream & bstream);
+        template <class Codec>
+        O3DGCErrorCode              EncodeFloatArray(Codec & ace,
+                                                     const Real * const floatArray, 
+                                                     unsigned long numfloatArray,
+                                                     unsigned long dimfloatArray,
+                                                     unsigned long stride,
+                                                     const Real * const minfloatArray,
+                                                     const Real * const maxfloatArray,
+                                                     unsigned long nQBits,
+                                                     const IndexedFaceSet<T> & ifs,
+                                                     O3DGCSC3DMCPredictionMode predMode,
+                                                     O3DGCIFSFloatAttributeType attributeType,
+                                                     SC3DMCEncodeScratch & scratch,
+                                                     BinaryStream & bstream);
+        template <class Codec>
+        O3DGCErrorCode              EncodeSemiStatic(Codec & ace,
+                                                     MultiLaneCodec<Codec, Static_Data_Model> & lanes,
+                                                     unsigned long M,
+                                                     Static_Bit_Model & bModel0,
+                                                     Adaptive_Bit_Model & bModel1,
+                                                     SC3DMCEncodeScratch & scratch);
         O3DGCErrorCode              QuantizeFloatArray(const Real * const floatArray, 
                                                        unsigned long numFloatArray,
                                                        unsigned long dimFloatArray,
                                                        unsigned long stride,
                                                        const Real * const minfloatArray,
                                                        const Real * const maxfloatArray,
-                                                       unsigned long nQBits);
+                                                       unsigned long nQBits,
+                                                       SC3DMCEncodeScratch & scratch);
         O3DGCErrorCode              EncodeIntArray(const long * const intArray, 
                                                    unsigned long numIntArray,
                                                    unsigned long dimIntArray,
                                                    unsigned long stride,
                                                    const IndexedFaceSet<T> & ifs,
                                                    O3DGCSC3DMCPredictionMode predMode,
+                                                   SC3DMCEncodeScratch & scratch,
+                                                   BinaryStream & bstream);
+        template <class Codec>
+        O3DGCErrorCode              EncodeIntArray(Codec & ace,
+                                                   const long * const intArray, 
+                                                   unsigned long numIntArray,
+                                                   unsigned long dimIntArray,
+                                                   unsigned long stride,
+                                                   const IndexedFaceSet<T> & ifs,
+                                                   O3DGCSC3DMCPredictionMode predMode,
+                                                   SC3DMCEncodeScratch & scratch,
                                                    BinaryStream & bstream);
-        O3DGCErrorCode              ProcessNormals(const IndexedFaceSet<T> & ifs);
+        O3DGCErrorCode              ProcessNormals(const IndexedFaceSet<T> & ifs, SC3DMCEncodeScratch & scratch);
+        //! Stores in scratch.m_normals the octahedral coordinates of the normals in the frames of the normals of the 
+        //! surface, computed from the quantized coordinates held by scratch and inverted if the normals mostly point 
+        //! against them.
+        O3DGCErrorCode              ProcessOctahedralNormals(const IndexedFaceSet<T> & ifs, SC3DMCEncodeScratch & scratch);
+        //! Prediction candidates of the vertices for the given mode, built on first use after the connectivity is coded.
+        const SC3DMCPredictorTable & GetPredictorTable(bool parallelogram, const IndexedFaceSet<T> & ifs);
+        //! Records the location of the section of size bytes that was just encoded.
+        void                        UpdateTableOfContents(unsigned long section, 
+                                                          unsigned long size,
+                                                          const BinaryStream & bstream);
         TriangleListEncoder<T>      m_triangleListEncoder;
-        long *                      m_quantFloatArray;
+        SC3DMCPredictorTable        m_parallelogramPredictors;
+        SC3DMCPredictorTable        m_differentialPredictors;
+        unsigned long               m_posStart;
         unsigned long               m_posSize;
-        unsigned long               m_quantFloatArraySize;
-        unsigned char *             m_bufferAC;
-        unsigned long               m_sizeBufferAC;
-        SC3DMCPredictor             m_neighbors  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
-        unsigned long               m_freqSymbols[O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS];
-        unsigned long               m_freqPreds  [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS];
-        Vector<long>                m_predictors;
-        Real *                      m_normals;
-        unsigned long               m_normalsSize;
+        unsigned long               m_posTOC;
+        SC3DMCTableOfContents       m_toc;
+        SC3DMCSegmentIndex          m_segments;
+        Vector<long>                m_segmentVertices;  //!< vertices of each segment, in segment order
+        Vector<long>                m_segmentCoordIndex;//!< triangles of each segment, indexed within their segment
+        Vector<long>                m_localVertices;
+        SC3DMCEncodeScratch         m_scratch;          //!< used when the attributes are encoded by a single thread
+        ThreadPool                  m_threadPool;       //!< encodes the attribute sections and the segments
         SC3DMCStats                 m_stats;
         O3DGCStreamType       m_streamType;
+        O3DGCSC3DMCBinarization     m_binarization;
+        unsigned long               m_numLanes;
+        O3DGCModelDictionary        m_modelDictionary;
+        O3DGCSC3DMCEntropyModel     m_entropyModel;
     };
 }
 #include "o3dgcSC3DMCEncoder.inl"    // template implementation
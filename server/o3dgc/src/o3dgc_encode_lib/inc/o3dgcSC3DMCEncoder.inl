@@ -26,6 +26,10 @@ THE SOFTWARE.
 
 
 #include "o3dgcArithmeticCodec.h"
+#include "o3dgcRANSCodec.h"
+#include "o3dgcMultiLaneCodec.h"
+#include "o3dgcModelDictionary.h"
+#include "o3dgcFrequencyTable.h"
 #include "o3dgcTimer.h"
 #include "o3dgcVector.h"
 #include "o3dgcBinaryStream.h"
@@ -44,20 +48,100 @@ namespace o3dgc
                                             const IndexedFaceSet<T> & ifs, 
                                             BinaryStream & bstream)
     {
+        SC3DMCEncodeParams quantParams(params);
+        ComputeQuantBits(params, ifs, quantParams);
+        bool fits = true;
+        if (params.GetMaxStreamSize() > 0)
+        {
+            const O3DGCErrorCode ret = FitStreamSize(ifs, quantParams, fits);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+        }
+        if (quantParams.GetModelDictionary() != O3DGC_MODEL_DICTIONARY_NONE)
+        {
+            const O3DGCErrorCode ret = ChooseModelDictionary(ifs, quantParams);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+        }
+        const O3DGCErrorCode ret = EncodeStream(quantParams, ifs, bstream);
+        ComputeQuantErrors(quantParams, ifs);
+        m_stats.m_maxStreamSizeExceeded = !fits;
+        return ret;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeStream(const SC3DMCEncodeParams & params, 
+                                                  const IndexedFaceSet<T> & ifs, 
+                                                  BinaryStream & bstream)
+    {
+        O3DGCErrorCode ret = O3DGC_OK;
+        ComputeSegments(params, ifs);
         // Encode header
         unsigned long start = bstream.GetSize();
-        EncodeHeader(params, ifs, bstream);
+        if (m_segments.GetNumSegments() > 0)
+        {
+            // the header of a segmented stream gives the size of the merged segments, whose vertices may be duplicated
+            IndexedFaceSet<T> mergedIFS(ifs);
+            const unsigned long numVertices = m_segmentVertices.GetSize();
+            mergedIFS.SetNCoord(numVertices);
+            mergedIFS.SetNNormal((ifs.GetNNormal() > 0) ? numVertices : 0);
+            for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+            {
+                mergedIFS.SetNFloatAttribute(a, (ifs.GetNFloatAttribute(a) > 0) ? numVertices : 0);
+            }
+            for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+            {
+                mergedIFS.SetNIntAttribute(a, (ifs.GetNIntAttribute(a) > 0) ? numVertices : 0);
+            }
+            ret = EncodeHeader(params, mergedIFS, bstream);
+        }
+        else
+        {
+            ret = EncodeHeader(params, ifs, bstream);
+        }
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
         // Encode payload
-        EncodePayload(params, ifs, bstream);
+        if (m_segments.GetNumSegments() > 0)
+        {
+            ret = EncodeSegments(params, ifs, bstream);
+        }
+        else
+        {
+            ret = EncodePayload(params, ifs, bstream);
+        }
+        if (m_toc.GetNumSections() > 0)
+        {
+            m_toc.Update(bstream, m_posTOC, m_streamType);
+        }
         bstream.WriteUInt32(m_posSize, bstream.GetSize() - start, m_streamType);
-        return O3DGC_OK;
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        // sink errors are sticky: the last flush reports any failure of the per-section flushes
+        return bstream.Flush();
     }
     template <class T>
     O3DGCErrorCode SC3DMCEncoder<T>::EncodeHeader(const SC3DMCEncodeParams & params, 
                                                const IndexedFaceSet<T> & ifs, 
                                                BinaryStream & bstream)
     {
-        m_streamType = params.GetStreamType();
+        m_streamType   = params.GetStreamType();
+        m_binarization = (params.GetBinarization() == O3DGC_SC3DMC_BINARIZATION_RANS) ? O3DGC_SC3DMC_BINARIZATION_RANS :
+                                                                                        O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+        m_numLanes     = (m_streamType == O3DGC_STREAM_TYPE_ASCII) ? 1 : 
+                         max(1UL, min(params.GetNumLanes(), O3DGC_SC3DMC_MAX_NUM_LANES));
+        m_modelDictionary = (m_streamType == O3DGC_STREAM_TYPE_ASCII || 
+                             ifs.GetNCoord() > O3DGC_SC3DMC_MODEL_DICTIONARY_MAX_VERTICES) ? O3DGC_MODEL_DICTIONARY_NONE : 
+                                                                                             params.GetModelDictionary();
+        m_entropyModel = (m_streamType == O3DGC_STREAM_TYPE_ASCII) ? O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE : params.GetEntropyModel();
+        m_posStart     = bstream.GetSize();
         bstream.WriteUInt32(O3DGC_SC3DMC_START_CODE, m_streamType);
         m_posSize = bstream.GetSize();
         bstream.WriteUInt32(0, m_streamType); // to be filled later
@@ -66,9 +150,9 @@ namespace o3dgc
         bstream.WriteFloat32((float)ifs.GetCreaseAngle(), m_streamType);
           
         unsigned char mask = 0;
-        bool markerBit0 = false;
-        bool markerBit1 = false;
-        bool markerBit2 = false;
+        bool markerBit0 = (m_modelDictionary != O3DGC_MODEL_DICTIONARY_NONE);
+        bool markerBit1 = params.GetTableOfContents() && m_segments.GetNumSegments() == 0; // segments have their own
+        bool markerBit2 = m_segments.GetNumSegments() > 0;
         bool markerBit3 = false;
 
         mask += (ifs.GetCCW()                  );
@@ -81,6 +165,10 @@ namespace o3dgc
         mask += (markerBit3                << 7);
 
         bstream.WriteUChar(mask, m_streamType);
+        if (markerBit0)
+        {
+            bstream.WriteUChar((unsigned char) m_modelDictionary, m_streamType);
+        }
 
         bstream.WriteUInt32(ifs.GetNCoord(), m_streamType);
         bstream.WriteUInt32(ifs.GetNNormal(), m_streamType);
@@ -139,46 +227,159 @@ namespace o3dgc
                 bstream.WriteUChar((unsigned char) ifs.GetIntAttributeType(a), m_streamType);
             }
         }    
+        if (markerBit1)
+        {
+            const unsigned char binarization = (unsigned char) ((m_streamType == O3DGC_STREAM_TYPE_ASCII) ? 
+                                                                 O3DGC_SC3DMC_BINARIZATION_ASCII : m_binarization);
+            const unsigned char semiStatic   = (m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC) ? 8 : 0;
+            m_toc.Init(ifs.GetNumFloatAttributes(), ifs.GetNumIntAttributes());
+            for(unsigned long s = 0; s < m_toc.GetNumSections(); ++s)
+            {
+                m_toc.GetSection(s).m_codec = binarization + semiStatic;
+            }
+            for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+            {
+                m_toc.GetSection(m_toc.GetIntAttributeSection(a)).m_codec = binarization; // always adaptive
+            }
+            m_posTOC = bstream.GetSize();
+            m_toc.Save(bstream, m_streamType); // offsets and sizes filled by Encode()
+        }
+        else
+        {
+            m_toc.Clear();
+        }
         return O3DGC_OK;
     }
     template <class T>
+    void SC3DMCEncoder<T>::UpdateTableOfContents(unsigned long section, 
+                                                 unsigned long size,
+                                                 const BinaryStream & bstream)
+    {
+        if (m_toc.GetNumSections() > 0)
+        {
+            m_toc.GetSection(section).m_offset = bstream.GetSize() - size - m_posStart;
+            m_toc.GetSection(section).m_size   = size;
+        }
+    }
+    template <class T>
     O3DGCErrorCode SC3DMCEncoder<T>::QuantizeFloatArray(const Real * const floatArray, 
                                                    unsigned long numFloatArray,
                                                    unsigned long dimFloatArray,
                                                    unsigned long stride,
                                                    const Real * const minFloatArray,
                                                    const Real * const maxFloatArray,
-                                                   unsigned long nQBits)
+                                                   unsigned long nQBits,
+                                                   SC3DMCEncodeScratch & scratch)
     {
         const unsigned long size = numFloatArray * dimFloatArray;
-        Real delta[O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES];
-        Real r;
-        for(unsigned long d = 0; d < dimFloatArray; d++)
+        if (scratch.m_quantFloatArraySize < size)
         {
-            r = maxFloatArray[d] - minFloatArray[d];
-            if (r > 0.0f)
+            delete [] scratch.m_quantFloatArray;
+            scratch.m_quantFloatArraySize = size;
+            scratch.m_quantFloatArray     = new long [size];
+        }                                  
+        QuantizeVectors(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits, 
+                        scratch.m_quantFloatArray, stride, 1);
+        return O3DGC_OK;
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::ComputeCandidateResiduals(const SC3DMCResidualTask & task, long vm, long * const residuals)
+    {
+        const unsigned long dim        = task.m_dimFloatArray;
+        const unsigned long stride     = task.m_stride;
+        const long * const  q          = task.m_quantFloatArray;
+        const unsigned long nPred      = task.m_predictors->GetNumPredictors(vm);
+        const long          v          = task.m_invVMap[vm];
+        const Index * const candidates = task.m_predictors->GetPredictors(vm);
+        for (unsigned long p = 0; p < nPred; ++p)
+        {
+            const long a = candidates[3*p];
+            const long b = candidates[3*p+1];
+            const long c = candidates[3*p+2];
+            for (unsigned long i = 0; i < dim; i++) 
             {
-                delta[d] = (float)((1 << nQBits) - 1) / r;
+                const long pred = (c < 0) ? q[a*stride+i] : q[a*stride+i] + q[b*stride+i] - q[c*stride+i];
+                residuals[p*dim+i] = q[v*stride+i] - pred;
             }
-            else
+        }
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::ComputeResidualsThread(unsigned long threadID, void * data)
+    {
+        const SC3DMCResidualTask & task = *((const SC3DMCResidualTask *) data);
+        const long          numVertices = task.m_end - task.m_start;
+        const long          start       = task.m_start + (long) (numVertices * threadID / task.m_numThreads);
+        const long          end         = task.m_start + (long) (numVertices * (threadID + 1) / task.m_numThreads);
+        for (long vm = start; vm < end; ++vm) 
+        {
+            if (task.m_predictors->GetNumPredictors(vm) < 2)
             {
-                delta[d] = 1.0f;
+                continue; // only the vertices with several candidates choose between them
             }
-        }        
-        if (m_quantFloatArraySize < size)
-        {
-            delete [] m_quantFloatArray;
-            m_quantFloatArraySize = size;
-            m_quantFloatArray     = new long [size];
-        }                                  
-        for(unsigned long v = 0; v < numFloatArray; ++v)
+            ComputeCandidateResiduals(task, vm, 
+                                      task.m_residuals + (vm - task.m_start) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * task.m_dimFloatArray);
+        }
+    }
+    template <class T>
+    unsigned long SC3DMCEncoder<T>::EstimateM(const SC3DMCResidualTask & task, 
+                                              long numVertices,
+                                              O3DGCSC3DMCPredictionMode predMode,
+                                              O3DGCModelDictionary dictionary,
+                                              O3DGCModelDictionaryEntry valuesEntry,
+                                              SC3DMCEncodeScratch & scratch)
+    {
+        const unsigned long dim       = task.m_dimFloatArray;
+        const unsigned long stride    = task.m_stride;
+        const long * const  q         = task.m_quantFloatArray;
+        const long          end       = min(numVertices, O3DGC_SC3DMC_RESIDUAL_BLOCK_SIZE);
+        long residuals[O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES];
+        scratch.m_estimator.Clear();
+        for (long vm = 0; vm < end; ++vm) 
         {
-            for(unsigned long d = 0; d < dimFloatArray; ++d)
+            const long          v     = task.m_invVMap[vm];
+            const unsigned long nPred = (predMode != O3DGC_SC3DMC_NO_PREDICTION) ? task.m_predictors->GetNumPredictors(vm) : 0;
+            if (nPred > 1)
+            {
+                // the candidate with the smallest residuals stands for the one the encoder selects
+                ComputeCandidateResiduals(task, vm, residuals);
+                unsigned long bestPred = 0;
+                unsigned long bestSum  = 0xFFFFFFFF;
+                for (unsigned long p = 0; p < nPred; ++p)
+                {
+                    unsigned long sum = 0;
+                    for (unsigned long i = 0; i < dim; ++i) 
+                    {
+                        sum += IntToUInt(residuals[p*dim+i]);
+                    }
+                    if (sum < bestSum)
+                    {
+                        bestSum  = sum;
+                        bestPred = p;
+                    }
+                }
+                for (unsigned long i = 0; i < dim; ++i) 
+                {
+                    scratch.m_estimator.AddInt(residuals[bestPred*dim+i]);
+                }
+            }
+            else if (vm > 0 && predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            {
+                const long prev = task.m_invVMap[vm-1];
+                for (unsigned long i = 0; i < dim; ++i) 
+                {
+                    scratch.m_estimator.AddInt(q[v*stride+i] - q[prev*stride+i]);
+                }
+            }
+            else
             {
-                m_quantFloatArray[v * stride + d] = (long)((floatArray[v * stride + d]-minFloatArray[d]) * delta[d] + 0.5f);
+                for (unsigned long i = 0; i < dim; ++i) 
+                {
+                    scratch.m_estimator.AddUInt(q[v*stride+i]);
+                }
             }
         }
-        return O3DGC_OK;
+        return scratch.m_estimator.GetBestM(O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS - 1, O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE, 
+                                            dictionary, valuesEntry);
     }
     template <class T>
     O3DGCErrorCode SC3DMCEncoder<T>::EncodeFloatArray(const Real * const floatArray, 
@@ -190,52 +391,83 @@ namespace o3dgc
                                                       unsigned long nQBits,
                                                       const IndexedFaceSet<T> & ifs,
                                                       O3DGCSC3DMCPredictionMode predMode,
+                                                      O3DGCIFSFloatAttributeType attributeType,
+                                                      SC3DMCEncodeScratch & scratch,
+                                                      BinaryStream & bstream)
+    {
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && m_binarization == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec ace;
+            return EncodeFloatArray(ace, floatArray, numFloatArray, dimFloatArray, stride, 
+                                    minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream);
+        }
+        Arithmetic_Codec ace;
+        return EncodeFloatArray(ace, floatArray, numFloatArray, dimFloatArray, stride, 
+                                minFloatArray, maxFloatArray, nQBits, ifs, predMode, attributeType, scratch, bstream);
+    }
+    template <class T>
+    template <class Codec>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeFloatArray(Codec & ace,
+                                                      const Real * const floatArray, 
+                                                      unsigned long numFloatArray,
+                                                      unsigned long dimFloatArray,
+                                                      unsigned long stride,
+                                                      const Real * const minFloatArray,
+                                                      const Real * const maxFloatArray,
+                                                      unsigned long nQBits,
+                                                      const IndexedFaceSet<T> & ifs,
+                                                      O3DGCSC3DMCPredictionMode predMode,
+                                                      O3DGCIFSFloatAttributeType attributeType,
+                                                      SC3DMCEncodeScratch & scratch,
                                                       BinaryStream & bstream)
     {
         assert(dimFloatArray <  O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES);
         long predResidual, v, uPredResidual;
         unsigned long nPred;
-        Arithmetic_Codec ace;
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
 
-        const AdjacencyInfo & v2T         = m_triangleListEncoder.GetVertexToTriangle();
-        const long * const    vmap        = m_triangleListEncoder.GetVMap();
-        const long * const    invVMap     = m_triangleListEncoder.GetInvVMap();
-        const T * const       triangles   = ifs.GetCoordIndex();
+        const Index * const   invVMap     = m_triangleListEncoder.GetInvVMap();
         const long            nvert       = (long) numFloatArray;
         unsigned long         start       = bstream.GetSize();
         unsigned char         mask        = predMode & 7;
-        const unsigned long   M           = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS - 1;
+        unsigned long         M           = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS - 1;
         unsigned long         nSymbols    = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS;
         unsigned long         nPredictors = O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS;
+        const bool            semiStatic  = (m_streamType != O3DGC_STREAM_TYPE_ASCII && 
+                                             m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC);
         
 
         Adaptive_Data_Model mModelValues(M+2);
         Adaptive_Data_Model mModelPreds(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS+1);
+        MultiLaneCodec<Codec> lanes(ace, mModelValues, bModel0, bModel1);
+        Static_Data_Model sModelValues;
+        MultiLaneCodec<Codec, Static_Data_Model> staticLanes(ace, sModelValues, bModel0, bModel1);
+        const O3DGCModelDictionaryEntry valuesEntry = GetModelDictionaryValuesEntry(attributeType);
 
-        memset(m_freqSymbols, 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS);
-        memset(m_freqPreds  , 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS);
+        memset(scratch.m_freqSymbols, 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS);
+        memset(scratch.m_freqPreds  , 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS);
         if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
         {
             mask += (O3DGC_SC3DMC_BINARIZATION_ASCII & 7)<<4;
-            m_predictors.Allocate(nvert);
-            m_predictors.Clear();
+            scratch.m_predictors.Allocate(nvert);
+            scratch.m_predictors.Clear();
+            // at least one symbol per residual and per predictor
+            bstream.Reserve(numFloatArray * (dimFloatArray + 1) + 3 * O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32 + 1);
         }
         else
         {
-            mask += (O3DGC_SC3DMC_BINARIZATION_AC_EGC & 7)<<4;
-            const unsigned int NMAX = numFloatArray * dimFloatArray * 8 + 100;
-            if ( m_sizeBufferAC < NMAX )
+            mask += (m_binarization & 7)<<4;
+            if (m_numLanes > 1)
             {
-                delete [] m_bufferAC;
-                m_sizeBufferAC = NMAX;
-                m_bufferAC     = new unsigned char [m_sizeBufferAC];
+                mask += 0x80; // multi-lane payload
+            }
+            if (semiStatic)
+            {
+                mask += 0x08; // semi-static models
+                scratch.m_residuals.Allocate((nvert + 1) * (dimFloatArray + 1));
+                scratch.m_residuals.Clear();
             }
-            ace.set_buffer(NMAX, m_bufferAC);
-            ace.start_encoder();
-            ace.ExpGolombEncode(0, 0, bModel0, bModel1);
-            ace.ExpGolombEncode(M, 0, bModel0, bModel1);
         }
         bstream.WriteUInt32(0, m_streamType);
         bstream.WriteUChar(mask, m_streamType);
@@ -249,122 +481,140 @@ namespace o3dgc
         {
             const Real minFloatArray[2] = {(Real)(-2.0),(Real)(-2.0)};
             const Real maxFloatArray[2] = {(Real)(2.0),(Real)(2.0)};
+            QuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits+1, scratch);
+        }
+        else if (predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
+        {
+            const Real minOctahedron[2] = {(Real)(-1.0),(Real)(-1.0)};
+            const Real maxOctahedron[2] = {(Real)(1.0),(Real)(1.0)};
+            QuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minOctahedron, maxOctahedron, nQBits+1, scratch);
+        }
+        else
+        {
+            QuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits, scratch);
+        }
+
+        const SC3DMCPredictorTable & predictors = GetPredictorTable(predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION, ifs);
+        SC3DMCResidualTask residualTask;
+        residualTask.m_predictors      = &predictors;
+        residualTask.m_invVMap         = invVMap;
+        residualTask.m_quantFloatArray = scratch.m_quantFloatArray;
+        residualTask.m_dimFloatArray   = dimFloatArray;
+        residualTask.m_stride          = stride;
+        residualTask.m_start           = 0;
+        residualTask.m_end             = 0;
+        residualTask.m_residuals       = 0;
+        // the escape threshold of the adaptive models is picked from the residuals of the first block
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && !semiStatic)
+        {
+            M = EstimateM(residualTask, nvert, predMode, m_modelDictionary, valuesEntry, scratch);
+        }
+
+        // the lanes are encoded in place, after room for the lane count and the lane sizes. Each lane codes every 
+        // m_numLanes-th value, in at most 8 bytes; lane 0 also codes the predictors, the normal orientations and the 
+        // semi-static frequency tables.
+        const unsigned long   laneValues   = (numFloatArray * dimFloatArray + m_numLanes - 1) / m_numLanes;
+        const unsigned long   laneSize     = laneValues * 8 + 100;
+        const unsigned long   lane0Size    = laneSize + numFloatArray * 4 + 
+                                             8 * (O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 2);
+        const unsigned long   sizeHeaderAC = (m_numLanes > 1) ? 1 + 4 * (m_numLanes - 1) : 0;
+        unsigned char *       bufferAC     = 0;
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
+        {
+            bufferAC = bstream.ReserveTail(sizeHeaderAC + lane0Size + laneSize * (m_numLanes - 1)) + sizeHeaderAC;
+            lanes.Init(m_numLanes);
+            staticLanes.Init(m_numLanes);
+            for(unsigned long l = 0; l < m_numLanes; ++l)
+            {
+                Codec & codec = (semiStatic) ? staticLanes.GetCodec(l) : lanes.GetCodec(l);
+                lanes.GetModelValues(l).set_alphabet(M+2);
+                SeedModel(m_modelDictionary, valuesEntry, lanes.GetModelValues(l));
+                if (l == 0)
+                {
+                    codec.set_buffer(lane0Size, bufferAC);
+                }
+                else
+                {
+                    codec.set_buffer(laneSize, bufferAC + lane0Size + (l - 1) * laneSize);
+                }
+                codec.start_encoder();
+            }
+            SeedModel(m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_PREDICTORS, mModelPreds);
+            ace.ExpGolombEncode(0, 0, bModel0, bModel1);
+            ace.ExpGolombEncode(M, 0, bModel0, bModel1);
+        }
+
+        if (predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
+        {
             if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
             {
                 for(unsigned long i = 0; i < numFloatArray; ++i)
                 {
-                    bstream.WriteIntASCII(m_predictors[i]);
+                    bstream.WriteIntASCII(scratch.m_predictors[i]);
                 }
             }
             else
             {
                 Adaptive_Data_Model dModel(12);
+                SeedModel(m_modelDictionary, O3DGC_MODEL_DICTIONARY_ENTRY_NORMAL_ORIENTATIONS, dModel);
                 for(unsigned long i = 0; i < numFloatArray; ++i)
                 {
-                    ace.encode(IntToUInt(m_predictors[i]), dModel);
+                    ace.encode(IntToUInt(scratch.m_predictors[i]), dModel);
                 }
             }
-            QuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits+1);
         }
-        else
+        else if (predMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
         {
-            QuantizeFloatArray(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits);
+            const unsigned long inverted = (scratch.m_invertedNormals) ? 1 : 0;
+            if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
+            {
+                bstream.WriteIntASCII(inverted);
+            }
+            else
+            {
+                ace.ExpGolombEncode(inverted, 0, bModel0, bModel1);
+            }
         }
 
+        // a single thread computes the residuals of each vertex when it selects its predictor, without buffering them
+        const bool concurrentResiduals = (predMode != O3DGC_SC3DMC_NO_PREDICTION && scratch.m_numThreads > 1);
+        long vertexResiduals[O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES];
+        if (concurrentResiduals)
+        {
+            scratch.m_candidateResiduals.Allocate(O3DGC_SC3DMC_RESIDUAL_BLOCK_SIZE * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * dimFloatArray);
+            residualTask.m_residuals = scratch.m_candidateResiduals.GetBuffer();
+        }
         for (long vm=0; vm < nvert; ++vm) 
         {
             nPred = 0;
             v     = invVMap[vm];
             assert( v >= 0 && v < nvert);
-            if ( v2T.GetNumNeighbors(v) > 0 && 
-                 predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            if (predMode != O3DGC_SC3DMC_NO_PREDICTION)
             {
-                int u0 = v2T.Begin(v);
-                int u1 = v2T.End(v);
-                for (long u = u0; u < u1; u++) 
+                if (concurrentResiduals && vm == residualTask.m_end)
                 {
-                    long ta = v2T.GetNeighbor(u);
-                    if ( predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION )
-                    {
-                        long a,b;
-                        if ((long) triangles[ta*3] == v)
-                        {
-                            a = triangles[ta*3 + 1];
-                            b = triangles[ta*3 + 2];
-                        }
-                        else if ((long) triangles[ta*3 + 1] == v)
-                        {
-                            a = triangles[ta*3 + 0];
-                            b = triangles[ta*3 + 2];
-                        }
-                        else
-                        {
-                            a = triangles[ta*3 + 0];
-                            b = triangles[ta*3 + 1];
-                        }
-                        if ( vmap[a] < vm && vmap[b] < vm)
-                        {
-                            int u0 = v2T.Begin(a);
-                            int u1 = v2T.End(a);
-                            for (long u = u0; u < u1; u++) 
-                            {
-                                long tb = v2T.GetNeighbor(u);
-                                long c = -1;
-                                bool foundB = false;
-                                for(long k = 0; k < 3; ++k)
-                                {
-                                    long x = triangles[tb*3 + k];
-                                    if (x == b)
-                                    {
-                                        foundB = true;
-                                    }
-                                    if (vmap[x] < vm && x != a && x != b)
-                                    {
-                                        c = x;
-                                    }
-                                }
-                                if (c != -1 && foundB)
-                                {
-                                    SC3DMCTriplet id = {min(vmap[a], vmap[b]), max(vmap[a], vmap[b]), -vmap[c]-1};
-                                    unsigned long p = Insert(id, nPred, m_neighbors);
-                                    if (p != 0xFFFFFFFF)
-                                    {
-                                        for (unsigned long i = 0; i < dimFloatArray; i++) 
-                                        {
-                                            m_neighbors[p].m_pred[i] = m_quantFloatArray[a*stride+i] + 
-                                                                       m_quantFloatArray[b*stride+i] - 
-                                                                       m_quantFloatArray[c*stride+i];
-                                        } 
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    if ( predMode == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION  ||
-                         predMode == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION ||
-                         predMode == O3DGC_SC3DMC_DIFFERENTIAL_PREDICTION )
-                    {
-                        for(long k = 0; k < 3; ++k)
-                        {
-                            long w = triangles[ta*3 + k];
-                            if ( vmap[w] < vm )
-                            {
-                                SC3DMCTriplet id = {-1, -1, vmap[w]};
-                                unsigned long p = Insert(id, nPred, m_neighbors);
-                                if (p != 0xFFFFFFFF)
-                                {
-                                    for (unsigned long i = 0; i < dimFloatArray; i++) 
-                                    {
-                                        m_neighbors[p].m_pred[i] = m_quantFloatArray[w*stride+i];
-                                    } 
-                                }
-                            }
-                        }
-                    }        
+                    // the residuals do not depend on the statistics gathered below: compute those of the next block
+                    // of vertices concurrently, then select the predictors and code the residuals sequentially
+                    residualTask.m_start      = vm;
+                    residualTask.m_end        = min(vm + O3DGC_SC3DMC_RESIDUAL_BLOCK_SIZE, nvert);
+                    residualTask.m_numThreads = min(scratch.m_numThreads, 
+                                                    (unsigned long) (residualTask.m_end - vm + 1023) / 1024);
+                    scratch.m_threadPool.Run(ComputeResidualsThread, &residualTask, residualTask.m_numThreads);
                 }
+                nPred = predictors.GetNumPredictors(vm);
             }
             if (nPred > 1)
             {
+                const long * residuals = vertexResiduals;
+                if (concurrentResiduals)
+                {
+                    residuals = residualTask.m_residuals + 
+                                (vm - residualTask.m_start) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS * dimFloatArray;
+                }
+                else
+                {
+                    ComputeCandidateResiduals(residualTask, vm, vertexResiduals);
+                }
                 // find best predictor
                 unsigned long bestPred = 0xFFFFFFFF;
                 double bestCost = O3DGC_MAX_DOUBLE;
@@ -377,25 +627,25 @@ namespace o3dgc
                 for (unsigned long p = 0; p < nPred; ++p)
                 {
 #ifdef DEBUG_VERBOSE1
-                    printf("\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
-                    fprintf(g_fileDebugSC3DMCEnc, "\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
+                    printf("\t\t pred a = %i b = %i c = %i \n", predictors.GetPredictors(vm)[3*p], predictors.GetPredictors(vm)[3*p+1], predictors.GetPredictors(vm)[3*p+2]);
+                    fprintf(g_fileDebugSC3DMCEnc, "\t\t pred a = %i b = %i c = %i \n", predictors.GetPredictors(vm)[3*p], predictors.GetPredictors(vm)[3*p+1], predictors.GetPredictors(vm)[3*p+2]);
 #endif //DEBUG_VERBOSE
-                    cost = -log2((m_freqPreds[p]+1.0) / nPredictors );
+                    cost = -log2((scratch.m_freqPreds[p]+1.0) / nPredictors );
                     for (unsigned long i = 0; i < dimFloatArray; ++i) 
                     {
 #ifdef DEBUG_VERBOSE1
-                        printf("\t\t\t %i\n", m_neighbors[p].m_pred[i]);
-                        fprintf(g_fileDebugSC3DMCEnc, "\t\t\t %i\n", m_neighbors[p].m_pred[i]);
+                        printf("\t\t\t %i\n", scratch.m_quantFloatArray[v*stride+i] - residuals[p*dimFloatArray+i]);
+                        fprintf(g_fileDebugSC3DMCEnc, "\t\t\t %i\n", scratch.m_quantFloatArray[v*stride+i] - residuals[p*dimFloatArray+i]);
 #endif //DEBUG_VERBOSE
 
-                        predResidual = (long) IntToUInt(m_quantFloatArray[v*stride+i] - m_neighbors[p].m_pred[i]);
+                        predResidual = (long) IntToUInt(residuals[p*dimFloatArray+i]);
                         if (predResidual < (long) M) 
                         {
-                            cost += -log2((m_freqSymbols[predResidual]+1.0) / nSymbols );
+                            cost += -log2((scratch.m_freqSymbols[predResidual]+1.0) / nSymbols );
                         }
                         else 
                         {
-                            cost += -log2((m_freqSymbols[M] + 1.0) / nSymbols ) + log2((double) (predResidual-M));
+                            cost += -log2((scratch.m_freqSymbols[M] + 1.0) / nSymbols ) + log2((double) (predResidual-M));
                         }
                     }
                     if (cost < bestCost)
@@ -406,38 +656,46 @@ namespace o3dgc
                 }
                 if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                 {
-                    m_predictors.PushBack((unsigned char) bestPred);
+                    scratch.m_predictors.PushBack((unsigned char) bestPred);
+                }
+                else if (semiStatic)
+                {
+                    scratch.m_residuals.PushBack(-1 - (long) bestPred); // predictors are stored as negative symbols
                 }
                 else
                 {
                     ace.encode(bestPred, mModelPreds);
                 }
 #ifdef DEBUG_VERBOSE1
-                    printf("best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
-                    fprintf(g_fileDebugSC3DMCEnc, "best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
+                    printf("best (%i, %i, %i) \t pos %i\n", predictors.GetPredictors(vm)[3*bestPred], predictors.GetPredictors(vm)[3*bestPred+1], predictors.GetPredictors(vm)[3*bestPred+2], bestPred);
+                    fprintf(g_fileDebugSC3DMCEnc, "best (%i, %i, %i) \t pos %i\n", predictors.GetPredictors(vm)[3*bestPred], predictors.GetPredictors(vm)[3*bestPred+1], predictors.GetPredictors(vm)[3*bestPred+2], bestPred);
 #endif //DEBUG_VERBOSE
                 // use best predictor
                 for (unsigned long i = 0; i < dimFloatArray; ++i) 
                 {
-                    predResidual  = m_quantFloatArray[v*stride+i] - m_neighbors[bestPred].m_pred[i];
+                    predResidual  = residuals[bestPred*dimFloatArray+i];
                     uPredResidual = IntToUInt(predResidual);
-                    ++m_freqSymbols[(uPredResidual < (long) M)? uPredResidual : M];
+                    ++scratch.m_freqSymbols[(uPredResidual < (long) M)? uPredResidual : M];
 
 #ifdef DEBUG_VERBOSE
-                    printf("%i \t %i \t [%i]\n", vm*dimFloatArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
-                    fprintf(g_fileDebugSC3DMCEnc, "%i \t %i \t [%i]\n", vm*dimFloatArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
+                    printf("%i \t %i \t [%i]\n", vm*dimFloatArray+i, predResidual, scratch.m_quantFloatArray[v*stride+i] - predResidual);
+                    fprintf(g_fileDebugSC3DMCEnc, "%i \t %i \t [%i]\n", vm*dimFloatArray+i, predResidual, scratch.m_quantFloatArray[v*stride+i] - predResidual);
 #endif //DEBUG_VERBOSE
 
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
                         bstream.WriteIntASCII(predResidual);
                     }
+                    else if (semiStatic)
+                    {
+                        scratch.m_residuals.PushBack(IntToUInt(predResidual));
+                    }
                     else
                     {
-                        EncodeIntACEGC(predResidual, ace, mModelValues, bModel0, bModel1, M);
+                        lanes.EncodeInt(predResidual, M);
                     }
                 }
-                ++m_freqPreds[bestPred];
+                ++scratch.m_freqPreds[bestPred];
                 nSymbols += dimFloatArray;
                 ++nPredictors;
             }
@@ -446,14 +704,18 @@ namespace o3dgc
                 long prev = invVMap[vm-1];
                 for (unsigned long i = 0; i < dimFloatArray; i++) 
                 {
-                    predResidual = m_quantFloatArray[v*stride+i] - m_quantFloatArray[prev*stride+i];
+                    predResidual = scratch.m_quantFloatArray[v*stride+i] - scratch.m_quantFloatArray[prev*stride+i];
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
                         bstream.WriteIntASCII(predResidual);
                     }
+                    else if (semiStatic)
+                    {
+                        scratch.m_residuals.PushBack(IntToUInt(predResidual));
+                    }
                     else
                     {
-                        EncodeIntACEGC(predResidual, ace, mModelValues, bModel0, bModel1, M);
+                        lanes.EncodeInt(predResidual, M);
                     }
 #ifdef DEBUG_VERBOSE
                     printf("%i \t %i\n", vm*dimFloatArray+i, predResidual);
@@ -465,14 +727,18 @@ namespace o3dgc
             {
                 for (unsigned long i = 0; i < dimFloatArray; i++) 
                 {
-                    predResidual = m_quantFloatArray[v*stride+i];
+                    predResidual = scratch.m_quantFloatArray[v*stride+i];
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                     {
                         bstream.WriteUIntASCII(predResidual);
                     }
+                    else if (semiStatic)
+                    {
+                        scratch.m_residuals.PushBack(predResidual);
+                    }
                     else
                     {
-                        EncodeUIntACEGC(predResidual, ace, mModelValues, bModel0, bModel1, M);
+                        lanes.EncodeUInt(predResidual, M);
                     }
 #ifdef DEBUG_VERBOSE
                     printf("%i \t %i\n", vm*dimFloatArray+i, predResidual);
@@ -483,10 +749,36 @@ namespace o3dgc
         }
         if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
         {
-            unsigned long encodedBytes = ace.stop_encoder();
-            for(unsigned long i = 0; i < encodedBytes; ++i)
+            unsigned long encodedBytes[O3DGC_SC3DMC_MAX_NUM_LANES] = {0};
+            if (semiStatic)
+            {
+                const O3DGCErrorCode ret = EncodeSemiStatic(ace, staticLanes, M, bModel0, bModel1, scratch);
+                if (ret != O3DGC_OK)
+                {
+                    return ret;
+                }
+            }
+            for(unsigned long l = 0; l < m_numLanes; ++l)
+            {
+                Codec & codec = (semiStatic) ? staticLanes.GetCodec(l) : lanes.GetCodec(l);
+                encodedBytes[l] = codec.stop_encoder();
+            }
+            unsigned long sizeAC = encodedBytes[0];
+            for(unsigned long l = 1; l < m_numLanes; ++l)
+            {
+                memmove(bufferAC + sizeAC, bufferAC + lane0Size + (l - 1) * laneSize, encodedBytes[l]);
+                sizeAC += encodedBytes[l];
+            }
+            unsigned long pos = bstream.GetSize();
+            bstream.CommitTail(sizeHeaderAC + sizeAC);
+            if (m_numLanes > 1)
             {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
+                bstream.WriteUChar8Bin(pos++, (unsigned char) m_numLanes);
+                for(unsigned long l = 0; l < m_numLanes - 1; ++l)
+                {
+                    bstream.WriteUInt32Bin(pos, encodedBytes[l]);
+                    pos += 4;
+                }
             }
         }
         bstream.WriteUInt32(start, bstream.GetSize() - start, m_streamType);
@@ -495,10 +787,10 @@ namespace o3dgc
         {
             unsigned long start = bstream.GetSize();
             bstream.WriteUInt32ASCII(0);
-            const unsigned long size       = m_predictors.GetSize();
+            const unsigned long size       = scratch.m_predictors.GetSize();
             for(unsigned long i = 0; i < size; ++i)
             {
-                bstream.WriteUCharASCII((unsigned char) m_predictors[i]);
+                bstream.WriteUCharASCII((unsigned char) scratch.m_predictors[i]);
             }
             bstream.WriteUInt32ASCII(start, bstream.GetSize() - start);
         }
@@ -508,6 +800,74 @@ namespace o3dgc
         return O3DGC_OK;
     }
 
+    template <class T>
+    template <class Codec>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeSemiStatic(Codec & ace,
+                                                      MultiLaneCodec<Codec, Static_Data_Model> & lanes,
+                                                      unsigned long M,
+                                                      Static_Bit_Model & bModel0,
+                                                      Adaptive_Bit_Model & bModel1,
+                                                      SC3DMCEncodeScratch & scratch)
+    {
+        assert(M + 2 <= O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + 1);
+        unsigned long     histogramValues[O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + 1];
+        unsigned long     histogramPreds [O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1];
+        unsigned          frequencies    [O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS + 1];
+        Static_Data_Model mModelPreds;
+        const unsigned long size = scratch.m_residuals.GetSize();
+        long symbol;
+
+        // the escape threshold is picked once all the residuals are known
+        scratch.m_estimator.Clear();
+        for(unsigned long i = 0; i < size; ++i)
+        {
+            if (scratch.m_residuals[i] >= 0)
+            {
+                scratch.m_estimator.AddUInt(scratch.m_residuals[i]);
+            }
+        }
+        M = scratch.m_estimator.GetBestM(M, O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC);
+        ace.ExpGolombEncode(M, 0, bModel0, bModel1);
+
+        // first pass: histograms of the symbols recorded by EncodeFloatArray()
+        memset(histogramValues, 0, sizeof(unsigned long) * (M + 2));
+        memset(histogramPreds , 0, sizeof(unsigned long) * (O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1));
+        for(unsigned long i = 0; i < size; ++i)
+        {
+            symbol = scratch.m_residuals[i];
+            if (symbol < 0)
+            {
+                ++histogramPreds[-1 - symbol];
+            }
+            else
+            {
+                ++histogramValues[(symbol < (long) M)? symbol : M];
+            }
+        }
+        ReduceFrequencies(histogramValues, M + 2, frequencies);
+        EncodeFrequencies(ace, frequencies, M + 2, bModel0, bModel1);
+        lanes.GetModelValues(0).set_frequencies(M + 2, frequencies);
+        lanes.ShareModelValues();
+        ReduceFrequencies(histogramPreds, O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1, frequencies);
+        EncodeFrequencies(ace, frequencies, O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1, bModel0, bModel1);
+        mModelPreds.set_frequencies(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS + 1, frequencies);
+
+        // second pass: same symbols order as the adaptive mode
+        for(unsigned long i = 0; i < size; ++i)
+        {
+            symbol = scratch.m_residuals[i];
+            if (symbol < 0)
+            {
+                ace.encode(-1 - symbol, mModelPreds);
+            }
+            else
+            {
+                lanes.EncodeUInt(symbol, M);
+            }
+        }
+        return O3DGC_OK;
+    }
+
     template <class T>
     O3DGCErrorCode SC3DMCEncoder<T>::EncodeIntArray(const long * const intArray, 
                                                     unsigned long numIntArray,
@@ -515,55 +875,84 @@ namespace o3dgc
                                                     unsigned long stride,
                                                     const IndexedFaceSet<T> & ifs,
                                                     O3DGCSC3DMCPredictionMode predMode,
+                                                    SC3DMCEncodeScratch & scratch,
+                                                    BinaryStream & bstream)
+    {
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && m_binarization == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec ace;
+            return EncodeIntArray(ace, intArray, numIntArray, dimIntArray, stride, ifs, predMode, scratch, bstream);
+        }
+        Arithmetic_Codec ace;
+        return EncodeIntArray(ace, intArray, numIntArray, dimIntArray, stride, ifs, predMode, scratch, bstream);
+    }
+    template <class T>
+    template <class Codec>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeIntArray(Codec & ace,
+                                                    const long * const intArray, 
+                                                    unsigned long numIntArray,
+                                                    unsigned long dimIntArray,
+                                                    unsigned long stride,
+                                                    const IndexedFaceSet<T> & ifs,
+                                                    O3DGCSC3DMCPredictionMode predMode,
+                                                    SC3DMCEncodeScratch & scratch,
                                                     BinaryStream & bstream)
     {
         assert(dimIntArray <  O3DGC_SC3DMC_MAX_DIM_ATTRIBUTES);
         long predResidual, v, uPredResidual;
         unsigned long nPred;
-        Arithmetic_Codec ace;
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
 
-        const AdjacencyInfo & v2T         = m_triangleListEncoder.GetVertexToTriangle();
-        const long * const    vmap        = m_triangleListEncoder.GetVMap();
-        const long * const    invVMap     = m_triangleListEncoder.GetInvVMap();
-        const T * const       triangles   = ifs.GetCoordIndex();
+        const Index * const   invVMap     = m_triangleListEncoder.GetInvVMap();
         const long            nvert       = (long) numIntArray;
         unsigned long         start       = bstream.GetSize();
         unsigned char         mask        = predMode & 7;
-        const unsigned long   M           = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS - 1;
         unsigned long         nSymbols    = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS;
         unsigned long         nPredictors = O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS;
-        
+        const SC3DMCPredictorTable & predictors = GetPredictorTable(false, ifs);
+        // the escape threshold of the adaptive model is picked from the residuals of the first block
+        unsigned long         M           = O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS - 1;
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
+        {
+            SC3DMCResidualTask residualTask;
+            residualTask.m_predictors      = &predictors;
+            residualTask.m_invVMap         = invVMap;
+            residualTask.m_quantFloatArray = intArray;
+            residualTask.m_dimFloatArray   = dimIntArray;
+            residualTask.m_stride          = stride;
+            residualTask.m_start           = 0;
+            residualTask.m_end             = 0;
+            residualTask.m_residuals       = 0;
+            M = EstimateM(residualTask, nvert, predMode, O3DGC_MODEL_DICTIONARY_NONE, O3DGC_MODEL_DICTIONARY_ENTRY_NONE, scratch);
+        }
 
         Adaptive_Data_Model mModelValues(M+2);
         Adaptive_Data_Model mModelPreds(O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS+1);
 
-        memset(m_freqSymbols, 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS);
-        memset(m_freqPreds  , 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS);
+        memset(scratch.m_freqSymbols, 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_SYMBOLS);
+        memset(scratch.m_freqPreds  , 0, sizeof(unsigned long) * O3DGC_SC3DMC_MAX_PREDICTION_NEIGHBORS);
         if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
         {
             mask += (O3DGC_SC3DMC_BINARIZATION_ASCII & 7)<<4;
-            m_predictors.Allocate(nvert);
-            m_predictors.Clear();
+            scratch.m_predictors.Allocate(nvert);
+            scratch.m_predictors.Clear();
+            bstream.Reserve(numIntArray * (dimIntArray + 1) + 3 * O3DGC_BINARY_STREAM_NUM_SYMBOLS_UINT32 + 1);
         }
         else
         {
-            mask += (O3DGC_SC3DMC_BINARIZATION_AC_EGC & 7)<<4;
-            const unsigned int NMAX = numIntArray * dimIntArray * 8 + 100;
-            if ( m_sizeBufferAC < NMAX )
-            {
-                delete [] m_bufferAC;
-                m_sizeBufferAC = NMAX;
-                m_bufferAC     = new unsigned char [m_sizeBufferAC];
-            }
-            ace.set_buffer(NMAX, m_bufferAC);
+            mask += (m_binarization & 7)<<4;
+        }
+        bstream.WriteUInt32(0, m_streamType);
+        bstream.WriteUChar(mask, m_streamType);
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
+        {
+            const unsigned long NMAX = numIntArray * dimIntArray * 8 + 100;
+            ace.set_buffer(NMAX, bstream.ReserveTail(NMAX));
             ace.start_encoder();
             ace.ExpGolombEncode(0, 0, bModel0, bModel1);
             ace.ExpGolombEncode(M, 0, bModel0, bModel1);
         }
-        bstream.WriteUInt32(0, m_streamType);
-        bstream.WriteUChar(mask, m_streamType);
 
 #ifdef DEBUG_VERBOSE
         printf("IntArray (%i, %i)\n", numIntArray, dimIntArray);
@@ -575,29 +964,16 @@ namespace o3dgc
             nPred = 0;
             v     = invVMap[vm];
             assert( v >= 0 && v < nvert);
-            if ( v2T.GetNumNeighbors(v) > 0 && 
-                 predMode != O3DGC_SC3DMC_NO_PREDICTION)
+            const Index * const candidates = predictors.GetPredictors(vm);
+            if (predMode != O3DGC_SC3DMC_NO_PREDICTION)
             {
-                int u0 = v2T.Begin(v);
-                int u1 = v2T.End(v);
-                for (long u = u0; u < u1; u++) 
+                nPred = predictors.GetNumPredictors(vm);
+                for (unsigned long p = 0; p < nPred; ++p)
                 {
-                    long ta = v2T.GetNeighbor(u);
-                    for(long k = 0; k < 3; ++k)
+                    const long w = candidates[3*p];
+                    for (unsigned long i = 0; i < dimIntArray; i++) 
                     {
-                        long w = triangles[ta*3 + k];
-                        if ( vmap[w] < vm )
-                        {
-                            SC3DMCTriplet id = {-1, -1, vmap[w]};
-                            unsigned long p = Insert(id, nPred, m_neighbors);
-                            if (p != 0xFFFFFFFF)
-                            {
-                                for (unsigned long i = 0; i < dimIntArray; i++) 
-                                {
-                                    m_neighbors[p].m_pred[i] = intArray[w*stride+i];
-                                } 
-                            }
-                        }
+                        scratch.m_neighbors[p].m_pred[i] = intArray[w*stride+i];
                     }
                 }
             }
@@ -615,25 +991,25 @@ namespace o3dgc
                 for (unsigned long p = 0; p < nPred; ++p)
                 {
 #ifdef DEBUG_VERBOSE1
-                    printf("\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
-                    fprintf(g_fileDebugSC3DMCEnc, "\t\t pred a = %i b = %i c = %i \n", m_neighbors[p].m_id.m_a, m_neighbors[p].m_id.m_b, m_neighbors[p].m_id.m_c);
+                    printf("\t\t pred a = %i b = %i c = %i \n", candidates[3*p], candidates[3*p+1], candidates[3*p+2]);
+                    fprintf(g_fileDebugSC3DMCEnc, "\t\t pred a = %i b = %i c = %i \n", candidates[3*p], candidates[3*p+1], candidates[3*p+2]);
 #endif //DEBUG_VERBOSE
-                    cost = -log2((m_freqPreds[p]+1.0) / nPredictors );
+                    cost = -log2((scratch.m_freqPreds[p]+1.0) / nPredictors );
                     for (unsigned long i = 0; i < dimIntArray; ++i) 
                     {
 #ifdef DEBUG_VERBOSE1
-                        printf("\t\t\t %i\n", m_neighbors[p].m_pred[i]);
-                        fprintf(g_fileDebugSC3DMCEnc, "\t\t\t %i\n", m_neighbors[p].m_pred[i]);
+                        printf("\t\t\t %i\n", scratch.m_neighbors[p].m_pred[i]);
+                        fprintf(g_fileDebugSC3DMCEnc, "\t\t\t %i\n", scratch.m_neighbors[p].m_pred[i]);
 #endif //DEBUG_VERBOSE
 
-                        predResidual = (long) IntToUInt(intArray[v*stride+i] - m_neighbors[p].m_pred[i]);
+                        predResidual = (long) IntToUInt(intArray[v*stride+i] - scratch.m_neighbors[p].m_pred[i]);
                         if (predResidual < (long) M) 
                         {
-                            cost += -log2((m_freqSymbols[predResidual]+1.0) / nSymbols );
+                            cost += -log2((scratch.m_freqSymbols[predResidual]+1.0) / nSymbols );
                         }
                         else 
                         {
-                            cost += -log2((m_freqSymbols[M] + 1.0) / nSymbols ) + log2((double) (predResidual-M));
+                            cost += -log2((scratch.m_freqSymbols[M] + 1.0) / nSymbols ) + log2((double) (predResidual-M));
                         }
                     }
                     if (cost < bestCost)
@@ -644,26 +1020,26 @@ namespace o3dgc
                 }
                 if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
                 {
-                    m_predictors.PushBack((unsigned char) bestPred);
+                    scratch.m_predictors.PushBack((unsigned char) bestPred);
                 }
                 else
                 {
                     ace.encode(bestPred, mModelPreds);
                 }
 #ifdef DEBUG_VERBOSE1
-                    printf("best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
-                    fprintf(g_fileDebugSC3DMCEnc, "best (%i, %i, %i) \t pos %i\n", m_neighbors[bestPred].m_id.m_a, m_neighbors[bestPred].m_id.m_b, m_neighbors[bestPred].m_id.m_c, bestPred);
+                    printf("best (%i, %i, %i) \t pos %i\n", candidates[3*bestPred], candidates[3*bestPred+1], candidates[3*bestPred+2], bestPred);
+                    fprintf(g_fileDebugSC3DMCEnc, "best (%i, %i, %i) \t pos %i\n", candidates[3*bestPred], candidates[3*bestPred+1], candidates[3*bestPred+2], bestPred);
 #endif //DEBUG_VERBOSE
                 // use best predictor
                 for (unsigned long i = 0; i < dimIntArray; ++i) 
                 {
-                    predResidual  = intArray[v*stride+i] - m_neighbors[bestPred].m_pred[i];
+                    predResidual  = intArray[v*stride+i] - scratch.m_neighbors[bestPred].m_pred[i];
                     uPredResidual = IntToUInt(predResidual);
-                    ++m_freqSymbols[(uPredResidual < (long) M)? uPredResidual : M];
+                    ++scratch.m_freqSymbols[(uPredResidual < (long) M)? uPredResidual : M];
 
 #ifdef DEBUG_VERBOSE
-                    printf("%i \t %i \t [%i]\n", vm*dimIntArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
-                    fprintf(g_fileDebugSC3DMCEnc, "%i \t %i \t [%i]\n", vm*dimIntArray+i, predResidual, m_neighbors[bestPred].m_pred[i]);
+                    printf("%i \t %i \t [%i]\n", vm*dimIntArray+i, predResidual, scratch.m_neighbors[bestPred].m_pred[i]);
+                    fprintf(g_fileDebugSC3DMCEnc, "%i \t %i \t [%i]\n", vm*dimIntArray+i, predResidual, scratch.m_neighbors[bestPred].m_pred[i]);
 #endif //DEBUG_VERBOSE
 
                     if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
@@ -675,7 +1051,7 @@ namespace o3dgc
                         EncodeIntACEGC(predResidual, ace, mModelValues, bModel0, bModel1, M);
                     }
                 }
-                ++m_freqPreds[bestPred];
+                ++scratch.m_freqPreds[bestPred];
                 nSymbols += dimIntArray;
                 ++nPredictors;
             }
@@ -721,11 +1097,7 @@ namespace o3dgc
         }
         if (m_streamType != O3DGC_STREAM_TYPE_ASCII)
         {
-            unsigned long encodedBytes = ace.stop_encoder();
-            for(unsigned long i = 0; i < encodedBytes; ++i)
-            {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
-            }
+            bstream.CommitTail(ace.stop_encoder());
         }
         bstream.WriteUInt32(start, bstream.GetSize() - start, m_streamType);
 
@@ -733,10 +1105,10 @@ namespace o3dgc
         {
             unsigned long start = bstream.GetSize();
             bstream.WriteUInt32ASCII(0);
-            const unsigned long size       = m_predictors.GetSize();
+            const unsigned long size       = scratch.m_predictors.GetSize();
             for(unsigned long i = 0; i < size; ++i)
             {
-                bstream.WriteUCharASCII((unsigned char) m_predictors[i]);
+                bstream.WriteUCharASCII((unsigned char) scratch.m_predictors[i]);
             }
             bstream.WriteUInt32ASCII(start, bstream.GetSize() - start);
         }
@@ -746,18 +1118,29 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode SC3DMCEncoder<T>::ProcessNormals(const IndexedFaceSet<T> & ifs)
+    const SC3DMCPredictorTable & SC3DMCEncoder<T>::GetPredictorTable(bool parallelogram, const IndexedFaceSet<T> & ifs)
+    {
+        SC3DMCPredictorTable & table = (parallelogram) ? m_parallelogramPredictors : m_differentialPredictors;
+        if (!table.IsValid())
+        {
+            table.Build(m_triangleListEncoder.GetVertexToTriangle(), ifs.GetCoordIndex(),
+                        m_triangleListEncoder.GetVMap(), m_triangleListEncoder.GetInvVMap(), (long) ifs.GetNCoord(), parallelogram);
+        }
+        return table;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::ProcessNormals(const IndexedFaceSet<T> & ifs, SC3DMCEncodeScratch & scratch)
     {
         const long nvert               = (long) ifs.GetNNormal();
         const unsigned long normalSize = ifs.GetNNormal() * 2;
-        if (m_normalsSize < normalSize)
+        if (scratch.m_normalsSize < normalSize)
         {
-            delete [] m_normals;
-            m_normalsSize = normalSize;
-            m_normals     = new Real [normalSize];
+            delete [] scratch.m_normals;
+            scratch.m_normalsSize = normalSize;
+            scratch.m_normals     = new Real [normalSize];
         }                                  
         const AdjacencyInfo & v2T          = m_triangleListEncoder.GetVertexToTriangle();
-        const long * const    invVMap      = m_triangleListEncoder.GetInvVMap();
+        const Index * const   invVMap      = m_triangleListEncoder.GetInvVMap();
         const T * const       triangles    = ifs.GetCoordIndex();
         const Real * const originalNormals = ifs.GetNormal();
         Vec3<long> p1, p2, p3, n0, nt;
@@ -766,7 +1149,7 @@ namespace o3dgc
         Real rna0, rnb0, na1, nb1, norm0, norm1;
         char ni0 = 0, ni1 = 0;
         long a, b, c, v;
-        m_predictors.Clear();
+        scratch.m_predictors.Clear();
         for (long i=0; i < nvert; ++i) 
         {
             v = invVMap[i];
@@ -781,15 +1164,15 @@ namespace o3dgc
                 a = triangles[ta*3 + 0];
                 b = triangles[ta*3 + 1];
                 c = triangles[ta*3 + 2];
-                p1.X() = m_quantFloatArray[3*a];
-                p1.Y() = m_quantFloatArray[3*a+1];
-                p1.Z() = m_quantFloatArray[3*a+2];
-                p2.X() = m_quantFloatArray[3*b];
-                p2.Y() = m_quantFloatArray[3*b+1];
-                p2.Z() = m_quantFloatArray[3*b+2];
-                p3.X() = m_quantFloatArray[3*c];
-                p3.Y() = m_quantFloatArray[3*c+1];
-                p3.Z() = m_quantFloatArray[3*c+2];
+                p1.X() = scratch.m_quantFloatArray[3*a];
+                p1.Y() = scratch.m_quantFloatArray[3*a+1];
+                p1.Z() = scratch.m_quantFloatArray[3*a+2];
+                p2.X() = scratch.m_quantFloatArray[3*b];
+                p2.Y() = scratch.m_quantFloatArray[3*b+1];
+                p2.Z() = scratch.m_quantFloatArray[3*b+2];
+                p3.X() = scratch.m_quantFloatArray[3*c];
+                p3.Y() = scratch.m_quantFloatArray[3*c+1];
+                p3.Z() = scratch.m_quantFloatArray[3*c+2];
                 nt  = (p2-p1)^(p3-p1);
                 n0 += nt;
             }
@@ -813,14 +1196,14 @@ namespace o3dgc
                 n1.Z() /= norm1;
             }
             SphereToCube(n1.X(), n1.Y(), n1.Z(), na1, nb1, ni1);
-            m_predictors.PushBack(ni1 - ni0);
+            scratch.m_predictors.PushBack(ni1 - ni0);
             if ( (ni1 >> 1) != (ni0 >> 1) )
             {
                 rna0 = (Real)0.0;
                 rnb0 = (Real)0.0;
             }
-            m_normals[2*v]   = na1 - rna0;
-            m_normals[2*v+1] = nb1 - rnb0;
+            scratch.m_normals[2*v]   = na1 - rna0;
+            scratch.m_normals[2*v+1] = nb1 - rnb0;
 
 #ifdef DEBUG_VERBOSE1
             printf("n0 \t %i \t %i \t %i \t %i (%f, %f)\n", i, n0.X(), n0.Y(), n0.Z(), rna0, rnb0);
@@ -835,92 +1218,1040 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-
     template <class T>
-    O3DGCErrorCode SC3DMCEncoder<T>::EncodePayload(const SC3DMCEncodeParams & params, 
-                                                   const IndexedFaceSet<T> & ifs, 
-                                                   BinaryStream & bstream)
+    O3DGCErrorCode SC3DMCEncoder<T>::ProcessOctahedralNormals(const IndexedFaceSet<T> & ifs, SC3DMCEncodeScratch & scratch)
     {
-#ifdef DEBUG_VERBOSE
-        g_fileDebugSC3DMCEnc = fopen("tfans_enc_main.txt", "w");
-#endif //DEBUG_VERBOSE
-
-        // encode triangle list        
-        m_triangleListEncoder.SetStreamType(params.GetStreamType());
-        m_stats.m_streamSizeCoordIndex = bstream.GetSize();
-        Timer timer;
-        timer.Tic();
-        m_triangleListEncoder.Encode(ifs.GetCoordIndex(), ifs.GetIndexBufferID(), ifs.GetNCoordIndex(), ifs.GetNCoord(), bstream);
+        const long nvert               = (long) ifs.GetNNormal();
+        const unsigned long normalSize = ifs.GetNNormal() * 3;
+        if (scratch.m_normalsSize < normalSize)
+        {
+            delete [] scratch.m_normals;
+            scratch.m_normalsSize = normalSize;
+            scratch.m_normals     = new Real [normalSize];
+        }                                  
+        const AdjacencyInfo & v2T          = m_triangleListEncoder.GetVertexToTriangle();
+        const T * const       triangles    = ifs.GetCoordIndex();
+        const Real * const originalNormals = ifs.GetNormal();
+        Vec3<long> p1, p2, p3, n0;
+        Real n[3], t[3], s[3];
+        Real norm0;
+        double agreement = 0.0;
+        long a, b, c;
+        for (long v=0; v < nvert; ++v) 
+        {
+            n0.X() = 0;
+            n0.Y() = 0;
+            n0.Z() = 0;
+            int u0 = v2T.Begin(v);
+            int u1 = v2T.End(v);
+            for (long u = u0; u < u1; u++) 
+            {
+                long ta = v2T.GetNeighbor(u);
+                a = triangles[ta*3 + 0];
+                b = triangles[ta*3 + 1];
+                c = triangles[ta*3 + 2];
+                p1.X() = scratch.m_quantFloatArray[3*a];
+                p1.Y() = scratch.m_quantFloatArray[3*a+1];
+                p1.Z() = scratch.m_quantFloatArray[3*a+2];
+                p2.X() = scratch.m_quantFloatArray[3*b];
+                p2.Y() = scratch.m_quantFloatArray[3*b+1];
+                p2.Z() = scratch.m_quantFloatArray[3*b+2];
+                p3.X() = scratch.m_quantFloatArray[3*c];
+                p3.Y() = scratch.m_quantFloatArray[3*c+1];
+                p3.Z() = scratch.m_quantFloatArray[3*c+2];
+                n0 += (p2-p1)^(p3-p1);
+            }
+            norm0 = (Real) n0.GetNorm();
+            if (norm0 == 0.0)
+            {
+                n0.Z() = 1;
+                norm0  = 1.0;
+            }
+            n[0] = scratch.m_normals[3*v]   = n0.X() / norm0;
+            n[1] = scratch.m_normals[3*v+1] = n0.Y() / norm0;
+            n[2] = scratch.m_normals[3*v+2] = n0.Z() / norm0;
+            const Real * const n1 = originalNormals + 3*v;
+            agreement += n1[0] * n[0] + n1[1] * n[1] + n1[2] * n[2];
+        }
+        // the orientation of the triangles may oppose that of the normals
+        scratch.m_invertedNormals = (agreement < 0.0);
+        const Real sign           = (scratch.m_invertedNormals) ? (Real)(-1.0) : (Real)(1.0);
+        for (long v=0; v < nvert; ++v) 
+        {
+            // the octahedral coordinates of v overwrite the normals of the surface of the vertices before v only
+            n[0] = sign * scratch.m_normals[3*v];
+            n[1] = sign * scratch.m_normals[3*v+1];
+            n[2] = sign * scratch.m_normals[3*v+2];
+            ComputeOrthonormalBasis(n, t, s);
+            // the normal in the frame of the normal of the surface, close to its pole when well predicted
+            const Real * const n1 = originalNormals + 3*v;
+            SphereToOctahedron(n1[0] * t[0] + n1[1] * t[1] + n1[2] * t[2], 
+                               n1[0] * s[0] + n1[1] * s[1] + n1[2] * s[2], 
+                               n1[0] * n[0] + n1[1] * n[1] + n1[2] * n[2], 
+                               scratch.m_normals[2*v], scratch.m_normals[2*v+1]);
+        }
+        return O3DGC_OK;
+    }
+
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodePayload(const SC3DMCEncodeParams & params, 
+                                                   const IndexedFaceSet<T> & ifs, 
+                                                   BinaryStream & bstream)
+    {
+#ifdef DEBUG_VERBOSE
+        g_fileDebugSC3DMCEnc = fopen("tfans_enc_main.txt", "w");
+#endif //DEBUG_VERBOSE
+
+        // encode triangle list        
+        m_triangleListEncoder.SetStreamType(params.GetStreamType());
+        m_triangleListEncoder.SetBinarization(params.GetBinarization());
+        m_triangleListEncoder.SetModelDictionary(m_modelDictionary);
+        m_triangleListEncoder.SetEntropyModel(m_entropyModel);
+        m_triangleListEncoder.SetNumThreads(params.GetNumThreads());
+        m_stats.m_streamSizeCoordIndex = bstream.GetSize();
+        Timer timer;
+        timer.Tic();
+        O3DGCErrorCode ret = m_triangleListEncoder.Encode(ifs.GetCoordIndex(), ifs.GetIndexBufferID(), 
+                                                          ifs.GetNCoordIndex(), ifs.GetNCoord(), bstream);
+        m_parallelogramPredictors.Clear();
+        m_differentialPredictors.Clear();
         timer.Toc();
         m_stats.m_timeCoordIndex       = timer.GetElapsedTime();
         m_stats.m_streamSizeCoordIndex = bstream.GetSize() - m_stats.m_streamSizeCoordIndex;
+        UpdateTableOfContents(O3DGC_SC3DMC_SECTION_CONNECTIVITY, m_stats.m_streamSizeCoordIndex, bstream);
+        bstream.Flush(); // sections are complete once encoded: hand them to the sink, if any
 
-        // encode coord
-        m_stats.m_streamSizeCoord = bstream.GetSize();
+        if (ret == O3DGC_OK)
+        {
+            ret = EncodeAttributes(params, ifs, bstream);
+        }
+#ifdef DEBUG_VERBOSE
+        fclose(g_fileDebugSC3DMCEnc);
+#endif //DEBUG_VERBOSE
+        return ret;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeAttribute(unsigned long section,
+                                                     const SC3DMCEncodeParams & params, 
+                                                     const IndexedFaceSet<T> & ifs, 
+                                                     SC3DMCEncodeScratch & scratch,
+                                                     BinaryStream & bstream)
+    {
+        const unsigned long numFloatAttributes = ifs.GetNumFloatAttributes();
+        O3DGCErrorCode ret = O3DGC_OK;
+        Timer timer;
         timer.Tic();
-        if (ifs.GetNCoord() > 0)
+        if (section == O3DGC_SC3DMC_SECTION_COORD)
+        {
+            if (ifs.GetNCoord() > 0)
+            {
+                ret = EncodeFloatArray(ifs.GetCoord(), ifs.GetNCoord(), 3, 3, ifs.GetCoordMin(), ifs.GetCoordMax(), 
+                                       params.GetCoordQuantBits(), ifs, params.GetCoordPredMode(), 
+                                       O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_POSITION, scratch, bstream);
+            }
+        }
+        else if (section == O3DGC_SC3DMC_SECTION_NORMAL)
+        {
+            if (ifs.GetNNormal() > 0)
+            {
+                if (params.GetNormalPredMode() == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
+                {
+                    // scratch holds the quantized coordinates
+                    ProcessNormals(ifs, scratch);
+                    ret = EncodeFloatArray(scratch.m_normals, ifs.GetNNormal(), 2, 2, ifs.GetNormalMin(), ifs.GetNormalMax(), 
+                                           params.GetNormalQuantBits(), ifs, params.GetNormalPredMode(), 
+                                           O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_NORMAL, scratch, bstream);
+                }
+                else if (params.GetNormalPredMode() == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)
+                {
+                    // scratch holds the quantized coordinates
+                    ProcessOctahedralNormals(ifs, scratch);
+                    ret = EncodeFloatArray(scratch.m_normals, ifs.GetNNormal(), 2, 2, ifs.GetNormalMin(), ifs.GetNormalMax(), 
+                                           params.GetNormalQuantBits(), ifs, params.GetNormalPredMode(), 
+                                           O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_NORMAL, scratch, bstream);
+                }
+                else
+                {
+                    ret = EncodeFloatArray(ifs.GetNormal(), ifs.GetNNormal(), 3, 3, ifs.GetNormalMin(), ifs.GetNormalMax(), 
+                                           params.GetNormalQuantBits(), ifs, params.GetNormalPredMode(), 
+                                           O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_NORMAL, scratch, bstream);
+                }
+            }
+        }
+        else if (section < O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes)
+        {
+            const unsigned long a = section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0;
+            ret = EncodeFloatArray(ifs.GetFloatAttribute(a), ifs.GetNFloatAttribute(a), 
+                                   ifs.GetFloatAttributeDim(a), ifs.GetFloatAttributeDim(a),
+                                   ifs.GetFloatAttributeMin(a), ifs.GetFloatAttributeMax(a), 
+                                   params.GetFloatAttributeQuantBits(a), ifs, 
+                                   params.GetFloatAttributePredMode(a), ifs.GetFloatAttributeType(a), scratch, bstream);
+        }
+        else
         {
-            EncodeFloatArray(ifs.GetCoord(), ifs.GetNCoord(), 3, 3, ifs.GetCoordMin(), ifs.GetCoordMax(), 
-                                params.GetCoordQuantBits(), ifs, params.GetCoordPredMode(), bstream);
+            const unsigned long a = section - O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 - numFloatAttributes;
+            ret = EncodeIntArray(ifs.GetIntAttribute(a), ifs.GetNIntAttribute(a), ifs.GetIntAttributeDim(a), 
+                                 ifs.GetIntAttributeDim(a), ifs, params.GetIntAttributePredMode(a), scratch, bstream);
         }
         timer.Toc();
-        m_stats.m_timeCoord       = timer.GetElapsedTime();
-        m_stats.m_streamSizeCoord = bstream.GetSize() - m_stats.m_streamSizeCoord;
-
+        GetSectionTime(m_stats, section, numFloatAttributes) = timer.GetElapsedTime();
+        return ret;
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::EncodeAttributesThread(unsigned long threadID, void * data)
+    {
+        SC3DMCAttributeEncodeTask<T> & task = *((SC3DMCAttributeEncodeTask<T> *) data);
+        const bool surfNormals = (task.m_ifs->GetNNormal() > 0 && 
+                                  IsSurfaceNormalsPrediction(task.m_params->GetNormalPredMode()));
+        for(unsigned long i = threadID; i < task.m_numSections; i += task.m_numThreads)
+        {
+            const unsigned long section = task.m_sections[i];
+            task.m_errors[section] = task.m_encoder->EncodeAttribute(section, *task.m_params, *task.m_ifs, 
+                                                                     task.m_scratch[threadID], task.m_streams[section]);
+            if (section == O3DGC_SC3DMC_SECTION_COORD && surfNormals)
+            {
+                // the normals are predicted from the coordinates quantized in the same scratch
+                task.m_errors[O3DGC_SC3DMC_SECTION_NORMAL] = 
+                    task.m_encoder->EncodeAttribute(O3DGC_SC3DMC_SECTION_NORMAL, *task.m_params, *task.m_ifs, 
+                                                    task.m_scratch[threadID], task.m_streams[O3DGC_SC3DMC_SECTION_NORMAL]);
+            }
+        }
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeAttributes(const SC3DMCEncodeParams & params, 
+                                                      const IndexedFaceSet<T> & ifs, 
+                                                      BinaryStream & bstream)
+    {
+        const unsigned long numFloatAttributes = ifs.GetNumFloatAttributes();
+        const unsigned long numSections        = O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + numFloatAttributes + 
+                                                 ifs.GetNumIntAttributes();
+        const bool          surfNormals        = (ifs.GetNNormal() > 0 && 
+                                                  IsSurfaceNormalsPrediction(params.GetNormalPredMode()));
+        // the normals predicted from the coordinates are encoded right after them, by the same thread
+        unsigned long sections[O3DGC_SC3DMC_SECTION_FLOAT_ATTRIBUTE0 + O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES + 
+                               O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES];
+        unsigned long numTasks = 0;
+        for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+        {
+            if (s != O3DGC_SC3DMC_SECTION_NORMAL || !surfNormals)
+            {
+                sections[numTasks++] = s;
+            }
+        }
+        const unsigned long maxNumThreads = GetNumThreads(params.GetNumThreads());
+        const unsigned long numThreads    = min(maxNumThreads, numTasks);
+        if (numThreads <= 1)
+        {
+            m_scratch.m_numThreads = maxNumThreads;
+            for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+            {
+                unsigned long & size = GetSectionStreamSize(m_stats, s, numFloatAttributes);
+                size = bstream.GetSize();
+                const O3DGCErrorCode ret = EncodeAttribute(s, params, ifs, m_scratch, bstream);
+                if (ret != O3DGC_OK)
+                {
+                    return ret;
+                }
+                size = bstream.GetSize() - size;
+                UpdateTableOfContents(s, size, bstream);
+                bstream.Flush();
+            }
+            return O3DGC_OK;
+        }
 
-        // encode Normal
-        m_stats.m_streamSizeNormal = bstream.GetSize();
-        timer.Tic();
+        // the prediction candidates are built on first use: build the ones the threads share beforehand
+        GetPredictorTable(params.GetCoordPredMode() == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION, ifs);
         if (ifs.GetNNormal() > 0)
         {
-            if (params.GetNormalPredMode() == O3DGC_SC3DMC_SURF_NORMALS_PREDICTION)
+            GetPredictorTable(params.GetNormalPredMode() == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION, ifs);
+        }
+        for(unsigned long a = 0; a < numFloatAttributes; ++a)
+        {
+            GetPredictorTable(params.GetFloatAttributePredMode(a) == O3DGC_SC3DMC_PARALLELOGRAM_PREDICTION, ifs);
+        }
+        if (ifs.GetNumIntAttributes() > 0)
+        {
+            GetPredictorTable(false, ifs);
+        }
+        SC3DMCAttributeEncodeTask<T> task;
+        task.m_encoder     = this;
+        task.m_params      = &params;
+        task.m_ifs         = &ifs;
+        task.m_sections    = sections;
+        task.m_numSections = numTasks;
+        task.m_streams     = new BinaryStream       [numSections];
+        task.m_scratch     = new SC3DMCEncodeScratch[numThreads];
+        task.m_errors      = new O3DGCErrorCode     [numSections];
+        task.m_numThreads  = numThreads;
+        for(unsigned long s = 0; s < numSections; ++s)
+        {
+            task.m_errors[s] = O3DGC_OK;
+        }
+        for(unsigned long i = 0; i < numThreads; ++i)
+        {
+            // the remaining threads are shared by the residual computations of the sections
+            task.m_scratch[i].m_numThreads = maxNumThreads / numThreads;
+        }
+        m_threadPool.Run(EncodeAttributesThread, &task, numThreads);
+
+        // the sections are appended in stream order, up to the first that failed
+        O3DGCErrorCode ret = O3DGC_OK;
+        for(unsigned long s = O3DGC_SC3DMC_SECTION_COORD; s < numSections; ++s)
+        {
+            ret = task.m_errors[s];
+            if (ret != O3DGC_OK)
+            {
+                break;
+            }
+            const unsigned long size = task.m_streams[s].GetSize();
+            bstream.WriteBytes(task.m_streams[s].GetBuffer(), size);
+            GetSectionStreamSize(m_stats, s, numFloatAttributes) = size;
+            UpdateTableOfContents(s, size, bstream);
+            bstream.Flush();
+        }
+        delete [] task.m_streams;
+        delete [] task.m_scratch;
+        delete [] task.m_errors;
+        return ret;
+    }
+    //! Root of the union-find tree of v, with path halving.
+    inline long FindSegmentRoot(long * const parent, long v)
+    {
+        while (parent[v] != v)
+        {
+            parent[v] = parent[parent[v]];
+            v         = parent[v];
+        }
+        return v;
+    }
+    //! Reorders the n triangles of ids so that the k-th one is at position k, the ones before it having a smaller
+    //! centroid coordinate along axis and the ones after it a larger one.
+    inline void SelectSegmentSplit(long * const ids, long n, long k, const Real * const centroids, long axis)
+    {
+        long lo = 0;
+        long hi = n - 1;
+        while (lo < hi)
+        {
+            const Real pivot = centroids[3 * ids[(lo + hi) / 2] + axis];
+            long i = lo;
+            long j = hi;
+            do
             {
-                ProcessNormals(ifs);
-                EncodeFloatArray(m_normals, ifs.GetNNormal(), 2, 2, ifs.GetNormalMin(), ifs.GetNormalMax(), 
-                params.GetNormalQuantBits(), ifs, params.GetNormalPredMode(), bstream);
+                while (centroids[3 * ids[i] + axis] < pivot) ++i;
+                while (pivot < centroids[3 * ids[j] + axis]) --j;
+                if (i <= j)
+                {
+                    const long tmp = ids[i];
+                    ids[i] = ids[j];
+                    ids[j] = tmp;
+                    ++i;
+                    --j;
+                }
+            } while (i <= j);
+            if (k <= j)
+            {
+                hi = j;
+            }
+            else if (k >= i)
+            {
+                lo = i;
             }
             else
             {
-                EncodeFloatArray(ifs.GetNormal(), ifs.GetNNormal(), 3, 3, ifs.GetNormalMin(), ifs.GetNormalMax(), 
-                params.GetNormalQuantBits(), ifs, params.GetNormalPredMode(), bstream);
+                break;
             }
         }
-        timer.Toc();
-        m_stats.m_timeNormal       = timer.GetElapsedTime();
-        m_stats.m_streamSizeNormal = bstream.GetSize() - m_stats.m_streamSizeNormal;
+    }
+    //! Copies the dim components of the numVertices listed vertices to dest, in list order.
+    template <class A>
+    inline void GatherSegmentAttribute(const A * const src, 
+                                       unsigned long dim,
+                                       const long * const vertices,
+                                       unsigned long numVertices,
+                                       A * const dest)
+    {
+        for(unsigned long v = 0; v < numVertices; ++v)
+        {
+            memcpy(dest + v * dim, src + vertices[v] * dim, sizeof(A) * dim);
+        }
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::ComputeSegments(const SC3DMCEncodeParams & params, 
+                                           const IndexedFaceSet<T> & ifs)
+    {
+        m_segments.Clear();
+        const long numVertices  = (long) ifs.GetNCoord();
+        const long numTriangles = (long) ifs.GetNCoordIndex();
+        // the segments split the vertices, which requires per vertex attributes
+        bool perVertex = (ifs.GetNNormal() == 0 || (long) ifs.GetNNormal() == numVertices);
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            perVertex = perVertex && (ifs.GetNFloatAttribute(a) == 0 || (long) ifs.GetNFloatAttribute(a) == numVertices);
+        }
+        for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            perVertex = perVertex && (ifs.GetNIntAttribute(a) == 0 || (long) ifs.GetNIntAttribute(a) == numVertices);
+        }
+        if (numTriangles == 0 || ifs.GetIndexBufferID() || !perVertex)
+        {
+            return;
+        }
+        Vector<unsigned long> triangleSegments;
+        triangleSegments.Allocate(numTriangles);
+        triangleSegments.SetSize(numTriangles);
+        if (params.GetClusterSize() > 0)
+        {
+            if ((unsigned long) numTriangles > params.GetClusterSize())
+            {
+                const unsigned long numSegments = ComputeClusters(params.GetClusterSize(), ifs, triangleSegments);
+                BuildSegments(numSegments, triangleSegments, 0, ifs);
+            }
+            return;
+        }
+        if (params.GetNumSegments() < 2)
+        {
+            return;
+        }
+        // label the connected components: the root of each tree is its smallest vertex, so that the 
+        // components are numbered in the order of their first vertex
+        const T * const triangles = ifs.GetCoordIndex();
+        m_localVertices.Allocate(numVertices);
+        m_localVertices.SetSize(numVertices);
+        long * const parent = m_localVertices.GetBuffer();
+        for(long v = 0; v < numVertices; ++v)
+        {
+            parent[v] = v;
+        }
+        for(long t = 0; t < 3 * numTriangles; t += 3)
+        {
+            long r0 = FindSegmentRoot(parent, (long) triangles[t]);
+            for(long k = 1; k < 3; ++k)
+            {
+                const long r = FindSegmentRoot(parent, (long) triangles[t + k]);
+                if (r < r0)
+                {
+                    parent[r0] = r;
+                    r0         = r;
+                }
+                else if (r > r0)
+                {
+                    parent[r] = r0;
+                }
+            }
+        }
+        Vector<unsigned long> vertexSegments;
+        vertexSegments.Allocate(numVertices);
+        vertexSegments.SetSize(numVertices);
+        unsigned long numComponents = 0;
+        for(long v = 0; v < numVertices; ++v)
+        {
+            const long r      = FindSegmentRoot(parent, v);
+            vertexSegments[v] = (r == v) ? numComponents++ : vertexSegments[r];
+        }
+        if (numComponents < 2)
+        {
+            return;
+        }
+        // consecutive components are grouped into segments of about numTriangles / numSegments triangles, 
+        // each segment starting with a component that has triangles
+        Vector<unsigned long> componentSegments;
+        componentSegments.Allocate(numComponents);
+        componentSegments.SetSize(numComponents);
+        memset(componentSegments.GetBuffer(), 0, sizeof(unsigned long) * numComponents);
+        for(long t = 0; t < 3 * numTriangles; t += 3)
+        {
+            ++componentSegments[vertexSegments[(long) triangles[t]]];
+        }
+        const unsigned long maxNumSegments = min(params.GetNumSegments(), numComponents);
+        const unsigned long target         = (numTriangles + maxNumSegments - 1) / maxNumSegments;
+        unsigned long segment              = 0;
+        unsigned long count                = 0;
+        for(unsigned long c = 0; c < numComponents; ++c)
+        {
+            if (componentSegments[c] > 0 && count >= target * (segment + 1) && segment + 1 < maxNumSegments)
+            {
+                ++segment;
+            }
+            count               += componentSegments[c];
+            componentSegments[c] = segment;
+        }
+        const unsigned long numSegments = componentSegments[numComponents - 1] + 1;
+        if (numSegments < 2)
+        {
+            return;
+        }
+        for(long v = 0; v < numVertices; ++v)
+        {
+            vertexSegments[v] = componentSegments[vertexSegments[v]];
+        }
+        for(long t = 0; t < numTriangles; ++t)
+        {
+            triangleSegments[t] = vertexSegments[(long) triangles[3 * t]];
+        }
+        BuildSegments(numSegments, triangleSegments, vertexSegments.GetBuffer(), ifs);
+    }
+    template <class T>
+    unsigned long SC3DMCEncoder<T>::ComputeClusters(unsigned long clusterSize,
+                                                    const IndexedFaceSet<T> & ifs,
+                                                    Vector<unsigned long> & triangleSegments)
+    {
+        const long numTriangles   = (long) ifs.GetNCoordIndex();
+        const T * const triangles = ifs.GetCoordIndex();
+        const Real * const coord  = ifs.GetCoord();
+        Vector<Real> centroids;
+        Vector<long> ids;
+        centroids.Allocate(3 * numTriangles);
+        centroids.SetSize(3 * numTriangles);
+        ids.Allocate(numTriangles);
+        ids.SetSize(numTriangles);
+        for(long t = 0; t < numTriangles; ++t)
+        {
+            for(long j = 0; j < 3; ++j)
+            {
+                centroids[3 * t + j] = (coord[3 * (long) triangles[3 * t    ] + j] + 
+                                        coord[3 * (long) triangles[3 * t + 1] + j] + 
+                                        coord[3 * (long) triangles[3 * t + 2] + j]) / (Real) 3.0;
+            }
+            ids[t] = t;
+        }
+        // k-d tree: the ranges are split at the median centroid along the longest side of their bounding box,
+        // and the leaves are numbered from left to right so that consecutive clusters are close to each other
+        Vector<long> ranges;
+        ranges.PushBack(0);
+        ranges.PushBack(numTriangles);
+        unsigned long numClusters = 0;
+        while (ranges.GetSize() > 0)
+        {
+            const long end   = ranges[ranges.GetSize() - 1];
+            const long begin = ranges[ranges.GetSize() - 2];
+            ranges.SetSize(ranges.GetSize() - 2);
+            if ((unsigned long) (end - begin) <= clusterSize)
+            {
+                for(long i = begin; i < end; ++i)
+                {
+                    triangleSegments[ids[i]] = numClusters;
+                }
+                ++numClusters;
+                continue;
+            }
+            Real min[3];
+            Real max[3];
+            for(long j = 0; j < 3; ++j)
+            {
+                min[j] = max[j] = centroids[3 * ids[begin] + j];
+            }
+            for(long i = begin + 1; i < end; ++i)
+            {
+                for(long j = 0; j < 3; ++j)
+                {
+                    const Real c = centroids[3 * ids[i] + j];
+                    min[j] = (c < min[j]) ? c : min[j];
+                    max[j] = (c > max[j]) ? c : max[j];
+                }
+            }
+            long axis = 0;
+            for(long j = 1; j < 3; ++j)
+            {
+                if (max[j] - min[j] > max[axis] - min[axis])
+                {
+                    axis = j;
+                }
+            }
+            const long middle = begin + (end - begin) / 2;
+            SelectSegmentSplit(ids.GetBuffer() + begin, end - begin, middle - begin, centroids.GetBuffer(), axis);
+            ranges.PushBack(middle);
+            ranges.PushBack(end);
+            ranges.PushBack(begin);
+            ranges.PushBack(middle);
+        }
+        return numClusters;
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::BuildSegments(unsigned long numSegments,
+                                         const Vector<unsigned long> & triangleSegments,
+                                         const unsigned long * const vertexSegments,
+                                         const IndexedFaceSet<T> & ifs)
+    {
+        const long numVertices    = (long) ifs.GetNCoord();
+        const long numTriangles   = (long) ifs.GetNCoordIndex();
+        const T * const triangles = ifs.GetCoordIndex();
+        const Real * const coord  = ifs.GetCoord();
+        m_segments.Init(numSegments);
+        // within a segment, the triangles keep their relative order
+        for(long t = 0; t < numTriangles; ++t)
+        {
+            ++m_segments.GetSegment(triangleSegments[t]).m_numTriangles;
+        }
+        for(unsigned long s = 1; s < numSegments; ++s)
+        {
+            m_segments.GetSegment(s).m_firstTriangle = m_segments.GetSegment(s - 1).m_firstTriangle + 
+                                                       m_segments.GetSegment(s - 1).m_numTriangles;
+        }
+        Vector<unsigned long> cursors;
+        cursors.Allocate(numSegments);
+        cursors.SetSize(numSegments);
+        for(unsigned long s = 0; s < numSegments; ++s)
+        {
+            cursors[s] = m_segments.GetSegment(s).m_firstTriangle;
+        }
+        Vector<long> segmentTriangles;
+        segmentTriangles.Allocate(numTriangles);
+        segmentTriangles.SetSize(numTriangles);
+        for(long t = 0; t < numTriangles; ++t)
+        {
+            segmentTriangles[cursors[triangleSegments[t]]++] = t;
+        }
+        // the vertices not referenced by any triangle go to the segment of their component, or to the last one
+        Vector<unsigned long> marks;
+        marks.Allocate(numVertices);
+        marks.SetSize(numVertices);
+        memset(marks.GetBuffer(), 0, sizeof(unsigned long) * numVertices);
+        for(long i = 0; i < 3 * numTriangles; ++i)
+        {
+            marks[(long) triangles[i]] = 1;
+        }
+        Vector<long> unreferenced;
+        for(unsigned long s = 0; s < numSegments; ++s)
+        {
+            cursors[s] = 0;
+        }
+        for(long v = 0; v < numVertices; ++v)
+        {
+            if (!marks[v])
+            {
+                ++cursors[vertexSegments ? vertexSegments[v] : numSegments - 1];
+                unreferenced.PushBack(v);
+            }
+        }
+        if (unreferenced.GetSize() > 0)
+        {
+            // stable counting sort by segment
+            Vector<long> sorted;
+            sorted.Allocate(unreferenced.GetSize());
+            sorted.SetSize(unreferenced.GetSize());
+            unsigned long sum = 0;
+            for(unsigned long s = 0; s < numSegments; ++s)
+            {
+                const unsigned long count = cursors[s];
+                cursors[s] = sum;
+                sum       += count;
+            }
+            for(unsigned long i = 0; i < unreferenced.GetSize(); ++i)
+            {
+                const long v = unreferenced[i];
+                sorted[cursors[vertexSegments ? vertexSegments[v] : numSegments - 1]++] = v;
+            }
+            for(unsigned long i = 0; i < unreferenced.GetSize(); ++i)
+            {
+                unreferenced[i] = sorted[i];
+            }
+        }
+        // the vertices of a segment are numbered in order of first reference; a vertex referenced by several
+        // segments is duplicated in each of them
+        memset(marks.GetBuffer(), 0, sizeof(unsigned long) * numVertices);
+        m_localVertices.Allocate(numVertices);
+        m_localVertices.SetSize(numVertices);
+        m_segmentCoordIndex.Allocate(3 * numTriangles);
+        m_segmentCoordIndex.SetSize(3 * numTriangles);
+        m_segmentVertices.Allocate(numVertices);
+        m_segmentVertices.Clear();
+        unsigned long u = 0;
+        for(unsigned long s = 0; s < numSegments; ++s)
+        {
+            SC3DMCSegment & segment = m_segments.GetSegment(s);
+            segment.m_firstVertex   = m_segmentVertices.GetSize();
+            for(unsigned long t = segment.m_firstTriangle; t < segment.m_firstTriangle + segment.m_numTriangles; ++t)
+            {
+                for(long k = 0; k < 3; ++k)
+                {
+                    const long v = (long) triangles[3 * segmentTriangles[t] + k];
+                    if (marks[v] != s + 1)
+                    {
+                        marks[v]           = s + 1;
+                        m_localVertices[v] = m_segmentVertices.GetSize() - segment.m_firstVertex;
+                        m_segmentVertices.PushBack(v);
+                    }
+                    m_segmentCoordIndex[3 * t + k] = m_localVertices[v];
+                }
+            }
+            while (u < unreferenced.GetSize() && 
+                   (vertexSegments ? vertexSegments[unreferenced[u]] : numSegments - 1) == s)
+            {
+                m_segmentVertices.PushBack(unreferenced[u++]);
+            }
+            segment.m_numVertices = m_segmentVertices.GetSize() - segment.m_firstVertex;
+            for(long j = 0; j < 3; ++j)
+            {
+                segment.m_min[j] = segment.m_max[j] = coord[3 * m_segmentVertices[segment.m_firstVertex] + j];
+            }
+            for(unsigned long i = segment.m_firstVertex; i < m_segmentVertices.GetSize(); ++i)
+            {
+                for(long j = 0; j < 3; ++j)
+                {
+                    const Real c = coord[3 * m_segmentVertices[i] + j];
+                    segment.m_min[j] = (c < segment.m_min[j]) ? c : segment.m_min[j];
+                    segment.m_max[j] = (c > segment.m_max[j]) ? c : segment.m_max[j];
+                }
+            }
+        }
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::EncodeSegmentsThread(unsigned long threadID, void * data)
+    {
+        SC3DMCSegmentEncodeTask<T> & task = *((SC3DMCSegmentEncodeTask<T> *) data);
+        const unsigned long numSegments = task.m_encoder->m_segments.GetNumSegments();
+        for(unsigned long s = threadID; s < numSegments; s += task.m_numThreads)
+        {
+            task.m_errors[s] = task.m_encoder->EncodeSegment(s, *task.m_params, *task.m_ifs, task.m_streams[s], task.m_stats[s]);
+        }
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeSegments(const SC3DMCEncodeParams & params, 
+                                                    const IndexedFaceSet<T> & ifs, 
+                                                    BinaryStream & bstream)
+    {
+        const unsigned long numSegments = m_segments.GetNumSegments();
+        SC3DMCSegmentEncodeTask<T> task;
+        task.m_encoder    = this;
+        task.m_params     = &params;
+        task.m_ifs        = &ifs;
+        task.m_streams    = new BinaryStream  [numSegments];
+        task.m_stats      = new SC3DMCStats   [numSegments];
+        task.m_errors     = new O3DGCErrorCode[numSegments];
+        task.m_numThreads = min(GetNumThreads(params.GetNumThreads()), numSegments);
+        m_threadPool.Run(EncodeSegmentsThread, &task, task.m_numThreads);
+
+        O3DGCErrorCode ret = O3DGC_OK;
+        unsigned long size = 0;
+        m_stats = SC3DMCStats();
+        for(unsigned long s = 0; s < numSegments; ++s)
+        {
+            if (ret == O3DGC_OK)
+            {
+                ret = task.m_errors[s];
+            }
+            m_segments.GetSegment(s).m_size = task.m_streams[s].GetSize();
+            size += task.m_streams[s].GetSize();
+            m_stats.Accumulate(task.m_stats[s]);
+        }
+        if (ret == O3DGC_OK)
+        {
+            m_segments.Save(bstream, m_streamType);
+            bstream.Reserve(size);
+            for(unsigned long s = 0; s < numSegments; ++s)
+            {
+                bstream.WriteBytes(task.m_streams[s].GetBuffer(), task.m_streams[s].GetSize());
+            }
+        }
+        delete [] task.m_streams;
+        delete [] task.m_stats;
+        delete [] task.m_errors;
+        return ret;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::EncodeSegment(unsigned long s,
+                                                   const SC3DMCEncodeParams & params, 
+                                                   const IndexedFaceSet<T> & ifs, 
+                                                   BinaryStream & bstream,
+                                                   SC3DMCStats & stats) const
+    {
+        const SC3DMCSegment & segment      = m_segments.GetSegment(s);
+        const unsigned long numVertices    = segment.m_numVertices;
+        const unsigned long numTriangles   = segment.m_numTriangles;
+        const long * const vertices        = m_segmentVertices.GetBuffer()   + segment.m_firstVertex;
+        const long * const localCoordIndex = m_segmentCoordIndex.GetBuffer() + 3 * segment.m_firstTriangle;
 
+        // the segment keeps the header of the mesh, so that all the segments share the same quantization
+        IndexedFaceSet<T> segmentIFS(ifs);
+        Vector<T> coordIndex;
+        coordIndex.Allocate(3 * numTriangles);
+        coordIndex.SetSize(3 * numTriangles);
+        for(unsigned long i = 0; i < 3 * numTriangles; ++i)
+        {
+            coordIndex[i] = (T) localCoordIndex[i];
+        }
+        segmentIFS.SetNCoordIndex(numTriangles);
+        segmentIFS.SetCoordIndex(coordIndex.GetBuffer());
 
-        // encode FloatAttribute
+        unsigned long numReals = 3 * numVertices + ((ifs.GetNNormal() > 0) ? 3 * numVertices : 0);
+        unsigned long numLongs = 0;
         for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
         {
-            m_stats.m_streamSizeFloatAttribute[a] = bstream.GetSize();
-            timer.Tic();
-            EncodeFloatArray(ifs.GetFloatAttribute(a), ifs.GetNFloatAttribute(a), 
-                             ifs.GetFloatAttributeDim(a), ifs.GetFloatAttributeDim(a),
-                             ifs.GetFloatAttributeMin(a), ifs.GetFloatAttributeMax(a), 
-                             params.GetFloatAttributeQuantBits(a), ifs, 
-                             params.GetFloatAttributePredMode(a), bstream);
-            timer.Toc();
-            m_stats.m_timeFloatAttribute[a]       = timer.GetElapsedTime();
-            m_stats.m_streamSizeFloatAttribute[a] = bstream.GetSize() - m_stats.m_streamSizeFloatAttribute[a];
+            numReals += (ifs.GetNFloatAttribute(a) > 0) ? ifs.GetFloatAttributeDim(a) * numVertices : 0;
         }
-
-        // encode IntAttribute
         for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
         {
-            m_stats.m_streamSizeIntAttribute[a] = bstream.GetSize();
-            timer.Tic();
-            EncodeIntArray(ifs.GetIntAttribute(a), ifs.GetNIntAttribute(a), ifs.GetIntAttributeDim(a), 
-                           ifs.GetIntAttributeDim(a), ifs, params.GetIntAttributePredMode(a), bstream);
-            timer.Toc();
-            m_stats.m_timeIntAttribute[a]       = timer.GetElapsedTime();
-            m_stats.m_streamSizeIntAttribute[a] = bstream.GetSize() - m_stats.m_streamSizeIntAttribute[a];
+            numLongs += (ifs.GetNIntAttribute(a) > 0) ? ifs.GetIntAttributeDim(a) * numVertices : 0;
+        }
+        Vector<Real> reals;
+        Vector<long> longs;
+        reals.Allocate(numReals);
+        longs.Allocate(numLongs);
+        Real * real = reals.GetBuffer();
+        long * lng  = longs.GetBuffer();
+        GatherSegmentAttribute(ifs.GetCoord(), 3, vertices, numVertices, real);
+        segmentIFS.SetNCoord(numVertices);
+        segmentIFS.SetCoord(real);
+        real += 3 * numVertices;
+        if (ifs.GetNNormal() > 0)
+        {
+            GatherSegmentAttribute(ifs.GetNormal(), 3, vertices, numVertices, real);
+            segmentIFS.SetNNormal(numVertices);
+            segmentIFS.SetNormal(real);
+            real += 3 * numVertices;
+        }
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            if (ifs.GetNFloatAttribute(a) > 0)
+            {
+                GatherSegmentAttribute(ifs.GetFloatAttribute(a), ifs.GetFloatAttributeDim(a), vertices, numVertices, real);
+                segmentIFS.SetNFloatAttribute(a, numVertices);
+                segmentIFS.SetFloatAttribute(a, real);
+                real += ifs.GetFloatAttributeDim(a) * numVertices;
+            }
+        }
+        for(unsigned long a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            if (ifs.GetNIntAttribute(a) > 0)
+            {
+                GatherSegmentAttribute(ifs.GetIntAttribute(a), ifs.GetIntAttributeDim(a), vertices, numVertices, lng);
+                segmentIFS.SetNIntAttribute(a, numVertices);
+                segmentIFS.SetIntAttribute(a, lng);
+                lng += ifs.GetIntAttributeDim(a) * numVertices;
+            }
+        }
+
+        // the segments are already encoded concurrently
+        SC3DMCEncodeParams segmentParams(params);
+        segmentParams.SetNumSegments(1);
+        segmentParams.SetNumThreads(1);
+        SC3DMCEncoder<T> encoder;
+        const O3DGCErrorCode ret = encoder.EncodeStream(segmentParams, segmentIFS, bstream);
+        stats = encoder.GetStats();
+        return ret;
+    }
+    //! Diagonal of the bounding box of the coordinates of ifs.
+    template <class T>
+    inline Real ComputeCoordDiagonal(const IndexedFaceSet<T> & ifs)
+    {
+        Real minCoord[3];
+        Real maxCoord[3];
+        ComputeVectorBounds(ifs.GetCoord(), ifs.GetNCoord(), 3, 3, minCoord, maxCoord);
+        const Real dx = maxCoord[0] - minCoord[0];
+        const Real dy = maxCoord[1] - minCoord[1];
+        const Real dz = maxCoord[2] - minCoord[2];
+        return (Real) sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    inline unsigned long LowerQuantBits(unsigned long nQBits, unsigned long numBits)
+    {
+        if (nQBits > O3DGC_SC3DMC_MIN_QUANT_BITS + numBits)
+        {
+            return nQBits - numBits;
+        }
+        return (nQBits < O3DGC_SC3DMC_MIN_QUANT_BITS) ? nQBits : O3DGC_SC3DMC_MIN_QUANT_BITS;
+    }
+    //! Copies params into lowered with the quantization bits of the float attributes of ifs lowered by numBits, down 
+    //! to O3DGC_SC3DMC_MIN_QUANT_BITS.
+    template <class T>
+    inline void LowerQuantBits(const SC3DMCEncodeParams & params, 
+                               unsigned long numBits,
+                               const IndexedFaceSet<T> & ifs,
+                               SC3DMCEncodeParams & lowered)
+    {
+        lowered = params;
+        lowered.SetCoordQuantBits(LowerQuantBits(params.GetCoordQuantBits(), numBits));
+        lowered.SetNormalQuantBits(LowerQuantBits(params.GetNormalQuantBits(), numBits));
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            lowered.SetFloatAttributeQuantBits(a, LowerQuantBits(params.GetFloatAttributeQuantBits(a), numBits));
+        }
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::ComputeQuantBits(const SC3DMCEncodeParams & params, 
+                                            const IndexedFaceSet<T> & ifs,
+                                            SC3DMCEncodeParams & quantParams)
+    {
+        // the errors decrease with the bits: the first bits meeting a bound are the fewest
+        if (params.GetCoordMaxError() > 0.0 && ifs.GetNCoord() > 0)
+        {
+            // relative to the bounding box, which the quantization box of ComputeMinMax() may exceed
+            const Real maxError = params.GetCoordMaxError() * ComputeCoordDiagonal(ifs);
+            unsigned long nQBits = O3DGC_SC3DMC_MIN_QUANT_BITS;
+            while (nQBits < O3DGC_SC3DMC_MAX_QUANT_BITS && 
+                   ComputeQuantizationError(ifs.GetCoordMin(), ifs.GetCoordMax(), 3, nQBits) > maxError)
+            {
+                ++nQBits;
+            }
+            quantParams.SetCoordQuantBits(nQBits);
+        }
+        if (params.GetNormalMaxError() > 0.0 && ifs.GetNNormal() > 0)
+        {
+            unsigned long nQBits = O3DGC_SC3DMC_MIN_QUANT_BITS;
+            while (nQBits < O3DGC_SC3DMC_MAX_QUANT_BITS && 
+                   ComputeNormalQuantizationError(params.GetNormalPredMode(), ifs.GetNormalMin(), ifs.GetNormalMax(), 
+                                                  nQBits) > params.GetNormalMaxError())
+            {
+                ++nQBits;
+            }
+            quantParams.SetNormalQuantBits(nQBits);
+        }
+        if (params.GetTexCoordMaxError() > 0.0)
+        {
+            const Real maxError = params.GetTexCoordMaxError() / params.GetTextureSize();
+            for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+            {
+                if (ifs.GetFloatAttributeType(a) != O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_TEXCOORD || 
+                    ifs.GetNFloatAttribute(a) == 0)
+                {
+                    continue;
+                }
+                unsigned long nQBits = O3DGC_SC3DMC_MIN_QUANT_BITS;
+                while (nQBits < O3DGC_SC3DMC_MAX_QUANT_BITS && 
+                       ComputeQuantizationError(ifs.GetFloatAttributeMin(a), ifs.GetFloatAttributeMax(a), 
+                                                ifs.GetFloatAttributeDim(a), nQBits) > maxError)
+                {
+                    ++nQBits;
+                }
+                quantParams.SetFloatAttributeQuantBits(a, nQBits);
+            }
+        }
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::ComputeStreamSize(const SC3DMCEncodeParams & params, 
+                                                       const IndexedFaceSet<T> & ifs,
+                                                       unsigned long & size)
+    {
+        SC3DMCEncoder<T> encoder;
+        BinaryStream bstream(ifs.GetNCoord() * 8);
+        const O3DGCErrorCode ret = encoder.EncodeStream(params, ifs, bstream);
+        size = bstream.GetSize();
+        return ret;
+    }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::ChooseModelDictionary(const IndexedFaceSet<T> & ifs, 
+                                                           SC3DMCEncodeParams & quantParams)
+    {
+        if (quantParams.GetStreamType() == O3DGC_STREAM_TYPE_ASCII || 
+            ifs.GetNCoord() > O3DGC_SC3DMC_MODEL_DICTIONARY_MAX_VERTICES)
+        {
+            return O3DGC_OK; // not seeded anyway
+        }
+        SC3DMCEncodeParams noneParams(quantParams);
+        noneParams.SetModelDictionary(O3DGC_MODEL_DICTIONARY_NONE);
+        unsigned long sizeDictionary = 0;
+        unsigned long sizeNone       = 0;
+        O3DGCErrorCode ret = ComputeStreamSize(quantParams, ifs, sizeDictionary);
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        ret = ComputeStreamSize(noneParams, ifs, sizeNone);
+        if (ret != O3DGC_OK)
+        {
+            return ret;
+        }
+        if (sizeNone <= sizeDictionary)
+        {
+            quantParams.SetModelDictionary(O3DGC_MODEL_DICTIONARY_NONE);
         }
-#ifdef DEBUG_VERBOSE
-        fclose(g_fileDebugSC3DMCEnc);
-#endif //DEBUG_VERBOSE
         return O3DGC_OK;
     }
+    template <class T>
+    O3DGCErrorCode SC3DMCEncoder<T>::FitStreamSize(const IndexedFaceSet<T> & ifs, 
+                                                   SC3DMCEncodeParams & quantParams,
+                                                   bool & fits)
+    {
+        // the bits of all the float attributes are lowered by the same numBits in [0, maxNumBits], binary-searched
+        // for the fewest fitting. The size does not always decrease with the bits (coarse coordinates predict the 
+        // normals poorly): if none of the measured sizes fits, the smallest measured is kept.
+        const unsigned long maxStreamSize = quantParams.GetMaxStreamSize();
+        unsigned long maxNumBits = 0;
+        if (ifs.GetNCoord() > 0 && quantParams.GetCoordQuantBits() > O3DGC_SC3DMC_MIN_QUANT_BITS)
+        {
+            maxNumBits = quantParams.GetCoordQuantBits() - O3DGC_SC3DMC_MIN_QUANT_BITS;
+        }
+        if (ifs.GetNNormal() > 0 && quantParams.GetNormalQuantBits() > O3DGC_SC3DMC_MIN_QUANT_BITS + maxNumBits)
+        {
+            maxNumBits = quantParams.GetNormalQuantBits() - O3DGC_SC3DMC_MIN_QUANT_BITS;
+        }
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            if (ifs.GetNFloatAttribute(a) > 0 && 
+                quantParams.GetFloatAttributeQuantBits(a) > O3DGC_SC3DMC_MIN_QUANT_BITS + maxNumBits)
+            {
+                maxNumBits = quantParams.GetFloatAttributeQuantBits(a) - O3DGC_SC3DMC_MIN_QUANT_BITS;
+            }
+        }
+        unsigned long size = 0;
+        O3DGCErrorCode ret = ComputeStreamSize(quantParams, ifs, size);
+        fits = (size <= maxStreamSize);
+        if (ret != O3DGC_OK || fits || maxNumBits == 0)
+        {
+            return ret;
+        }
+        unsigned long minSize     = size;
+        unsigned long minNumBits  = 0;
+        // size(numBits0) > maxStreamSize and numBits1 fits, or is maxNumBits + 1 if none was found to
+        unsigned long numBits0    = 0;
+        unsigned long numBits1    = maxNumBits + 1;
+        SC3DMCEncodeParams lowered;
+        while (numBits1 - numBits0 > 1)
+        {
+            const unsigned long numBits = (numBits0 + numBits1) / 2;
+            LowerQuantBits(quantParams, numBits, ifs, lowered);
+            ret = ComputeStreamSize(lowered, ifs, size);
+            if (ret != O3DGC_OK)
+            {
+                return ret;
+            }
+            if (size <= maxStreamSize)
+            {
+                numBits1 = numBits;
+                fits     = true;
+            }
+            else
+            {
+                numBits0 = numBits;
+            }
+            if (size < minSize)
+            {
+                minSize    = size;
+                minNumBits = numBits;
+            }
+        }
+        LowerQuantBits(SC3DMCEncodeParams(quantParams), (fits) ? numBits1 : minNumBits, ifs, quantParams);
+        return O3DGC_OK;
+    }
+    template <class T>
+    void SC3DMCEncoder<T>::ComputeQuantErrors(const SC3DMCEncodeParams & params, 
+                                              const IndexedFaceSet<T> & ifs)
+    {
+        m_stats.m_quantBitsCoord  = params.GetCoordQuantBits();
+        m_stats.m_quantBitsNormal = params.GetNormalQuantBits();
+        if (ifs.GetNCoord() > 0)
+        {
+            const Real diag = ComputeCoordDiagonal(ifs);
+            m_stats.m_quantErrorCoord = (diag > 0.0) ? 
+                                        ComputeQuantizationError(ifs.GetCoordMin(), ifs.GetCoordMax(), 3, 
+                                                                 params.GetCoordQuantBits()) / diag : 0.0;
+        }
+        if (ifs.GetNNormal() > 0)
+        {
+            m_stats.m_quantErrorNormal = ComputeNormalQuantizationError(params.GetNormalPredMode(), ifs.GetNormalMin(), 
+                                                                        ifs.GetNormalMax(), params.GetNormalQuantBits());
+        }
+        for(unsigned long a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            m_stats.m_quantBitsFloatAttribute[a] = params.GetFloatAttributeQuantBits(a);
+            if (ifs.GetNFloatAttribute(a) > 0)
+            {
+                m_stats.m_quantErrorFloatAttribute[a] = ComputeQuantizationError(ifs.GetFloatAttributeMin(a), 
+                                                                                 ifs.GetFloatAttributeMax(a), 
+                                                                                 ifs.GetFloatAttributeDim(a), 
+                                                                                 params.GetFloatAttributeQuantBits(a));
+            }
+        }
+    }
 }
 #endif // O3DGC_SC3DMC_ENCODER_INL
 
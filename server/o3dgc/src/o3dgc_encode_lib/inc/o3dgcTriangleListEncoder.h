@@ -33,6 +33,9 @@ THE SOFTWARE.
 
 namespace o3dgc
 {
+    //! Vertices with more incident triangles are processed with hash tables instead of quadratic scans.
+    const Index O3DGC_TFAN_HASH_MIN_VALENCE = 32;
+
     //! 
     template <class T>
     class TriangleListEncoder
@@ -45,55 +48,83 @@ namespace o3dgc
         //! 
         O3DGCErrorCode              Encode(const T * const triangles,
                                            const unsigned long * const indexBufferIDs,
-                                           const long numTriangles,
-                                           const long numVertices,
+                                           const Index numTriangles,
+                                           const Index numVertices,
                                            BinaryStream & bstream);
         O3DGCStreamType       GetStreamType() const { return m_streamType; }
         void                        SetStreamType(O3DGCStreamType streamType) { m_streamType = streamType; }
-        const long * const          GetInvVMap() const { return m_invVMap;}
-        const long * const          GetInvTMap() const { return m_invTMap;}        
-        const long * const          GetVMap()    const { return m_vmap;}
-        const long * const          GetTMap()    const { return m_tmap;}
+        O3DGCSC3DMCBinarization     GetBinarization() const { return m_binarization; }
+        void                        SetBinarization(O3DGCSC3DMCBinarization binarization) { m_binarization = binarization; }
+        O3DGCModelDictionary        GetModelDictionary() const { return m_modelDictionary; }
+        void                        SetModelDictionary(O3DGCModelDictionary modelDictionary) { m_modelDictionary = modelDictionary; }
+        O3DGCSC3DMCEntropyModel     GetEntropyModel() const { return m_entropyModel; }
+        void                        SetEntropyModel(O3DGCSC3DMCEntropyModel entropyModel) { m_entropyModel = entropyModel; }
+        unsigned long               GetNumThreads() const { return m_numThreads; }
+        void                        SetNumThreads(unsigned long numThreads) { m_numThreads = numThreads; }
+        const Index * const         GetInvVMap() const { return m_invVMap;}
+        const Index * const         GetInvTMap() const { return m_invTMap;}        
+        const Index * const         GetVMap()    const { return m_vmap;}
+        const Index * const         GetTMap()    const { return m_tmap;}
         const AdjacencyInfo &       GetVertexToTriangle() const { return m_vertexToTriangle;}
 
         private:
         O3DGCErrorCode              Init(const T * const triangles, 
-                                         long numTriangles, 
-                                         long numVertices);
-        O3DGCErrorCode              CompueLocalConnectivityInfo(const long focusVertex);
-        O3DGCErrorCode              ProcessVertex( long focusVertex);
-        O3DGCErrorCode              ComputeTFANDecomposition(const long focusVertex);
-        O3DGCErrorCode              CompressTFAN(const long focusVertex);
+                                         Index numTriangles, 
+                                         Index numVertices);
+        O3DGCErrorCode              CompueLocalConnectivityInfo(const Index focusVertex);
+        O3DGCErrorCode              ProcessVertex( Index focusVertex);
+        O3DGCErrorCode              ComputeTFANDecomposition(const Index focusVertex);
+        O3DGCErrorCode              CompressTFAN(const Index focusVertex);
+        O3DGCErrorCode              ComputeTriangleToTriangleHashed();
+        O3DGCErrorCode              SortVisitedVerticesHashed();
 
-        long                        m_vertexCount;
-        long                        m_triangleCount;
-        long                        m_maxNumVertices;
-        long                        m_maxNumTriangles;
-        long                        m_numNonConqueredTriangles;
-        long                        m_numConqueredTriangles;
-        long                        m_numVisitedVertices;
-        long                        m_numTriangles;
-        long                        m_numVertices;
-        long                        m_maxSizeVertexToTriangle;
+        Index                       m_vertexCount;
+        Index                       m_triangleCount;
+        Index                       m_maxNumVertices;
+        Index                       m_maxNumTriangles;
+        Index                       m_numNonConqueredTriangles;
+        Index                       m_numConqueredTriangles;
+        Index                       m_numVisitedVertices;
+        Index                       m_numTriangles;
+        Index                       m_numVertices;
+        Index                       m_maxSizeVertexToTriangle;
         T const *                   m_triangles;
-        long *                      m_vtags;
-        long *                      m_ttags;
-        long *                      m_vmap;
-        long *                      m_invVMap;
-        long *                      m_tmap;
-        long *                      m_invTMap;
-        long *                      m_count;
-        long *                      m_nonConqueredTriangles;
-        long *                      m_nonConqueredEdges;
-        long *                      m_visitedVertices;
-        long *                      m_visitedVerticesValence;
-        FIFO<long>                  m_vfifo;
+        Index *                     m_vtags;
+        Index *                     m_ttags;
+        Index *                     m_vmap;
+        Index *                     m_invVMap;
+        Index *                     m_tmap;
+        Index *                     m_invTMap;
+        Index *                     m_count;
+        Index *                     m_nonConqueredTriangles;
+        Index *                     m_nonConqueredEdges;
+        Index *                     m_visitedVertices;
+        Index *                     m_visitedVerticesValence;
+        Index *                     m_visitedPositions;     // 1 + index in m_visitedVertices of each vmap value, 0 if absent
+        Index *                     m_fanHashKeys;          // open-addressing table of the vertices of the opposite edges
+        Index *                     m_fanHashHeads;         // per key: first edge starting (2*i) and ending (2*i+1) at it
+        Index *                     m_fanHashCounts;        // per key: number of edges starting (2*i) and ending (2*i+1) at it
+        Index *                     m_fanNext;              // per edge: next edge with the same start (2*i) and end (2*i+1)
+        Index *                     m_fanSeeds;             // non-conquered triangles by increasing number of input edges
+        Index *                     m_fanBuckets;           // number of non-conquered triangles per number of input edges
+        Index *                     m_fanVisited;           // (vmap value, valence) pairs being sorted
+        Index *                     m_tfanOps;
+        Index *                     m_tfanIndices;
+        Index                       m_tfanBufferSize;
+        Index                       m_fanHashSize;
+        Index                       m_fanBufferSize;
+        bool                        m_hashedFan;
+        FIFO<Index>                 m_vfifo;
         AdjacencyInfo               m_vertexToTriangle;
         AdjacencyInfo               m_triangleToTriangle;
         AdjacencyInfo               m_triangleToTriangleInv;
         TriangleFans                m_tfans;
         CompressedTriangleFans      m_ctfans;
         O3DGCStreamType       m_streamType;
+        O3DGCSC3DMCBinarization     m_binarization;
+        O3DGCModelDictionary        m_modelDictionary;
+        O3DGCSC3DMCEntropyModel     m_entropyModel;
+        unsigned long               m_numThreads;
     };
 }
 #include "o3dgcTriangleListEncoder.inl"    // template implementation
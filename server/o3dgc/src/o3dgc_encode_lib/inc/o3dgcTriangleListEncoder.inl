@@ -28,27 +28,78 @@ namespace o3dgc
 {
     // extract opposite edge
     template <class T>
-    inline void CompueOppositeEdge(const long focusVertex, 
+    inline void CompueOppositeEdge(const Index focusVertex, 
                                    const T * triangle,
-                                   long & a, long & b)
+                                   Index & a, Index & b)
     {                
-        if ((long) triangle[0] == focusVertex)
+        if ((Index) triangle[0] == focusVertex)
         {
-            a = triangle[1];
-            b = triangle[2];
+            a = (Index) triangle[1];
+            b = (Index) triangle[2];
         }
-        else if ((long) triangle[1] == focusVertex)
+        else if ((Index) triangle[1] == focusVertex)
         {
-            a = triangle[2];
-            b = triangle[0];
+            a = (Index) triangle[2];
+            b = (Index) triangle[0];
         }
         else
         {
-            a = triangle[0];
-            b = triangle[1];
+            a = (Index) triangle[0];
+            b = (Index) triangle[1];
         }
     }
-    inline bool IsCase0(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline Index FindFanHashEntry(const Index * const keys, Index hashSize, Index key)
+    {
+        unsigned long h = ((unsigned long) key * 2654435761UL) & (hashSize - 1);
+        while (keys[h] != -1 && keys[h] != key)
+        {
+            h = (h + 1) & (hashSize - 1);
+        }
+        return (Index) h;
+    }
+    // lists the edges connected to edge x in the order in which the quadratic scan of
+    // CompueLocalConnectivityInfo() calls AddNeighbor(), i.e. the edges y < x first (only
+    // reached for x > 0), then those of the row of x (y > 0, x itself twice) and the edges y > x
+    inline Index FillFanNeighbors(Index x, Index head, const Index * const next, Index * const neighbors, Index p, Index end)
+    {
+        Index y;
+        if (x > 0)
+        {
+            for(y = head; y >= 0 && y < x && p < end; y = next[2*y])
+            {
+                neighbors[p++] = y;
+            }
+        }
+        for(y = head; y >= 0 && p < end; y = next[2*y])
+        {
+            if (y > 0)
+            {
+                neighbors[p++] = y;
+                if (y == x && p < end)
+                {
+                    neighbors[p++] = y;
+                }
+            }
+        }
+        if (x > 0)
+        {
+            for(y = head; y >= 0 && p < end; y = next[2*y])
+            {
+                if (y > x)
+                {
+                    neighbors[p++] = y;
+                }
+            }
+        }
+        return p;
+    }
+    inline int CompareVisitedVertices(const void * a, const void * b)
+    {
+        const Index va = *((const Index *) a);
+        const Index vb = *((const Index *) b);
+        return (va < vb) ? -1 : ((va > vb) ? 1 : 0);
+    }
+    inline bool IsCase0(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 1000001 vertices: -1 -2
         if ((numIndices != 2) || (degree < 2)) {
@@ -56,12 +107,12 @@ namespace o3dgc
         }
         if ((indices[0] != -1) ||(indices[1] != -2) || 
             (ops[0] != 1)       ||(ops[degree-1] != 1)  ) return false;
-        for (long u = 1; u < degree-1; u++) {
+        for (Index u = 1; u < degree-1; u++) {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase1(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase1(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 1xxxxxx1 indices: -1 x x x x x -2
         if ((degree < 2) || (numIndices < 1))
@@ -72,7 +123,7 @@ namespace o3dgc
             (ops[0] != 1)       ||(ops[degree-1] != 1)  ) return false;
         return true;
     }
-    inline bool IsCase2(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase2(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 00000001 indices: -1
         if ((degree < 2) || (numIndices!= 1))
@@ -80,12 +131,12 @@ namespace o3dgc
             return false;
         }
         if ((indices[0] != -1) || (ops[degree-1] != 1)  ) return false;
-        for (long u = 0; u < degree-1; u++) {
+        for (Index u = 0; u < degree-1; u++) {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase3(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase3(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 00000001 indices: -2
         if ((degree < 2) || (numIndices!= 1))
@@ -93,12 +144,12 @@ namespace o3dgc
             return false;
         }
         if ((indices[0] != -2) || (ops[degree-1] != 1)  ) return false;
-        for (long u = 0; u < degree-1; u++) {
+        for (Index u = 0; u < degree-1; u++) {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase4(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase4(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 10000000 indices: -1
         if ((degree < 2) || (numIndices!= 1)) 
@@ -106,13 +157,13 @@ namespace o3dgc
             return false;
         }
         if ((indices[0] != -1) || (ops[0] != 1)  ) return false;
-        for (long u = 1; u < degree; u++) 
+        for (Index u = 1; u < degree; u++) 
         {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase5(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase5(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 10000000 indices: -2
         if ((degree < 2) || (numIndices!= 1)) 
@@ -120,25 +171,25 @@ namespace o3dgc
             return false;
         }
         if ((indices[0] != -2) || (ops[0] != 1)  ) return false;
-        for (long u = 1; u < degree; u++) {
+        for (Index u = 1; u < degree; u++) {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase6(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase6(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 0000000 indices: 
         if (numIndices!= 0) 
         {
             return false;
         }
-        for (long u = 0; u < degree; u++) 
+        for (Index u = 0; u < degree; u++) 
         {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase7(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase7(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 1000001 indices: -2 -1
         if ((numIndices!= 2) || (degree < 2)) 
@@ -147,13 +198,13 @@ namespace o3dgc
         }
         if ((indices[0] != -2) ||(indices[1] != -1) || 
             (ops[0] != 1)      ||(ops[degree-1] != 1)  ) return false;
-        for (long u = 1; u < degree-1; u++) 
+        for (Index u = 1; u < degree-1; u++) 
         {
             if (ops[u] != 0) return false;
         }
         return true;
     }
-    inline bool IsCase8(long degree, long numIndices, const long * const ops, const long * const indices)
+    inline bool IsCase8(Index degree, Index numIndices, const Index * const ops, const Index * const indices)
     {
         // ops: 1xxxxxx1 indices: -1 x x x x x -2
         if ((degree < 2) || (numIndices < 1)) 
@@ -178,6 +229,20 @@ namespace o3dgc
         m_nonConqueredEdges       = 0;
         m_visitedVertices         = 0;
         m_visitedVerticesValence  = 0;
+        m_visitedPositions        = 0;
+        m_fanHashKeys             = 0;
+        m_fanHashHeads            = 0;
+        m_fanHashCounts           = 0;
+        m_fanNext                 = 0;
+        m_fanSeeds                = 0;
+        m_fanBuckets              = 0;
+        m_fanVisited              = 0;
+        m_tfanOps                 = 0;
+        m_tfanIndices             = 0;
+        m_tfanBufferSize          = 0;
+        m_fanHashSize             = 0;
+        m_fanBufferSize           = 0;
+        m_hashedFan               = false;
         m_vertexCount             = 0;
         m_triangleCount           = 0;
         m_maxNumVertices          = 0;
@@ -187,6 +252,10 @@ namespace o3dgc
         m_triangles               = 0;
         m_maxSizeVertexToTriangle = 0;
         m_streamType              = O3DGC_STREAM_TYPE_UNKOWN;
+        m_binarization            = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+        m_modelDictionary         = O3DGC_MODEL_DICTIONARY_NONE;
+        m_entropyModel            = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE;
+        m_numThreads              = 1;
     }
     template <class T>
     TriangleListEncoder<T>::~TriangleListEncoder()
@@ -197,6 +266,16 @@ namespace o3dgc
         delete [] m_invTMap;
         delete [] m_visitedVerticesValence;
         delete [] m_visitedVertices;
+        delete [] m_visitedPositions;
+        delete [] m_fanHashKeys;
+        delete [] m_fanHashHeads;
+        delete [] m_fanHashCounts;
+        delete [] m_fanNext;
+        delete [] m_fanSeeds;
+        delete [] m_fanBuckets;
+        delete [] m_fanVisited;
+        delete [] m_tfanOps;
+        delete [] m_tfanIndices;
         delete [] m_ttags;
         delete [] m_tmap;
         delete [] m_count;
@@ -205,8 +284,8 @@ namespace o3dgc
     }
     template <class T>
     O3DGCErrorCode TriangleListEncoder<T>::Init(const T * const triangles, 
-                                             long numTriangles, 
-                                             long numVertices)
+                                             Index numTriangles, 
+                                             Index numVertices)
     {
         assert(numVertices  > 0);
         assert(numTriangles > 0);
@@ -224,12 +303,14 @@ namespace o3dgc
             delete [] m_invVMap;
             delete [] m_visitedVerticesValence;
             delete [] m_visitedVertices;
+            delete [] m_visitedPositions;
             m_maxNumVertices         = m_numVertices;
-            m_vtags                  = new long [m_numVertices];
-            m_vmap                   = new long [m_numVertices];
-            m_invVMap                = new long [m_numVertices];
-            m_visitedVerticesValence = new long [m_numVertices];
-            m_visitedVertices        = new long [m_numVertices];
+            m_vtags                  = new Index [m_numVertices];
+            m_vmap                   = new Index [m_numVertices];
+            m_invVMap                = new Index [m_numVertices];
+            m_visitedVerticesValence = new Index [m_numVertices];
+            m_visitedVertices        = new Index [m_numVertices];
+            m_visitedPositions       = new Index [m_numVertices];
         }
         
         if  (m_numTriangles > m_maxNumTriangles)
@@ -241,59 +322,79 @@ namespace o3dgc
             delete [] m_nonConqueredEdges;
             delete [] m_count;
             m_maxNumTriangles       = m_numTriangles;
-            m_ttags                 = new long [m_numTriangles];
-            m_tmap                  = new long [m_numTriangles];
-            m_invTMap               = new long [m_numTriangles];
-            m_count                 = new long [m_numTriangles+1];
-            m_nonConqueredTriangles = new long [m_numTriangles];
-            m_nonConqueredEdges     = new long [2*m_numTriangles];
+            m_ttags                 = new Index [m_numTriangles];
+            m_tmap                  = new Index [m_numTriangles];
+            m_invTMap               = new Index [m_numTriangles];
+            m_count                 = new Index [m_numTriangles+1];
+            m_nonConqueredTriangles = new Index [m_numTriangles];
+            m_nonConqueredEdges     = new Index [2*m_numTriangles];
         }
 
-        memset(m_vtags  , 0x00, sizeof(long) * m_numVertices );
-        memset(m_vmap   , 0xFF, sizeof(long) * m_numVertices );
-        memset(m_invVMap, 0xFF, sizeof(long) * m_numVertices );
-        memset(m_ttags  , 0x00, sizeof(long) * m_numTriangles);
-        memset(m_tmap   , 0xFF, sizeof(long) * m_numTriangles);
-        memset(m_invTMap, 0xFF, sizeof(long) * m_numTriangles);
-        memset(m_count  , 0x00, sizeof(long) * (m_numTriangles+1));
+        memset(m_vtags  , 0x00, sizeof(Index) * m_numVertices );
+        memset(m_visitedPositions, 0x00, sizeof(Index) * m_numVertices);
+        memset(m_vmap   , 0xFF, sizeof(Index) * m_numVertices );
+        memset(m_invVMap, 0xFF, sizeof(Index) * m_numVertices );
+        memset(m_ttags  , 0x00, sizeof(Index) * m_numTriangles);
+        memset(m_tmap   , 0xFF, sizeof(Index) * m_numTriangles);
+        memset(m_invTMap, 0xFF, sizeof(Index) * m_numTriangles);
+        memset(m_count  , 0x00, sizeof(Index) * (m_numTriangles+1));
 
         m_vfifo.Allocate(m_numVertices);
         m_ctfans.SetStreamType(m_streamType);
+        m_ctfans.SetBinarization(m_binarization);
+        m_ctfans.SetModelDictionary(m_modelDictionary);
+        m_ctfans.SetEntropyModel(m_entropyModel);
         m_ctfans.Allocate(m_numVertices, m_numTriangles);
 
         // compute vertex-to-triangle adjacency information
-        m_vertexToTriangle.AllocateNumNeighborsArray(numVertices);
-        m_vertexToTriangle.ClearNumNeighborsArray();
-        long * numNeighbors = m_vertexToTriangle.GetNumNeighborsBuffer();
-        for(long i = 0, t = 0; i < m_numTriangles; ++i, t+=3)
-        {
-            ++numNeighbors[ triangles[t  ] ];
-            ++numNeighbors[ triangles[t+1] ];
-            ++numNeighbors[ triangles[t+2] ];
-        }
+        m_vertexToTriangle.ComputeVertexToTriangle(triangles, m_numTriangles, numVertices, m_numThreads);
         m_maxSizeVertexToTriangle = 0;
-        for(long i = 0; i < numVertices; ++i)
+        for(Index i = 0; i < numVertices; ++i)
         {
-            if (m_maxSizeVertexToTriangle < numNeighbors[i])
+            if (m_maxSizeVertexToTriangle < m_vertexToTriangle.GetNumNeighbors(i))
             {
-                m_maxSizeVertexToTriangle = numNeighbors[i];
+                m_maxSizeVertexToTriangle = m_vertexToTriangle.GetNumNeighbors(i);
             }
         }
-        m_vertexToTriangle.AllocateNeighborsArray();
-        m_vertexToTriangle.ClearNeighborsArray();
-        for(long i = 0, t = 0; i < m_numTriangles; ++i, t+=3)
+        // a fan has at most m_maxSizeVertexToTriangle triangles
+        if (m_tfanBufferSize < O3DGC_MAX_TFAN_SIZE || m_tfanBufferSize < m_maxSizeVertexToTriangle + 2)
         {
-            m_vertexToTriangle.AddNeighbor(triangles[t  ], i);
-            m_vertexToTriangle.AddNeighbor(triangles[t+1], i);
-            m_vertexToTriangle.AddNeighbor(triangles[t+2], i);
+            delete [] m_tfanOps;
+            delete [] m_tfanIndices;
+            m_tfanBufferSize = (m_maxSizeVertexToTriangle + 2 > O3DGC_MAX_TFAN_SIZE) ? m_maxSizeVertexToTriangle + 2 : O3DGC_MAX_TFAN_SIZE;
+            m_tfanOps        = new Index [m_tfanBufferSize];
+            m_tfanIndices    = new Index [m_tfanBufferSize];
+        }
+        if (m_maxSizeVertexToTriangle > O3DGC_TFAN_HASH_MIN_VALENCE && m_maxSizeVertexToTriangle > m_fanBufferSize)
+        {
+            delete [] m_fanHashKeys;
+            delete [] m_fanHashHeads;
+            delete [] m_fanHashCounts;
+            delete [] m_fanNext;
+            delete [] m_fanSeeds;
+            delete [] m_fanBuckets;
+            delete [] m_fanVisited;
+            m_fanBufferSize = m_maxSizeVertexToTriangle;
+            m_fanHashSize   = 1;
+            while (m_fanHashSize < 4 * m_fanBufferSize) // two keys per edge, half-full at most
+            {
+                m_fanHashSize <<= 1;
+            }
+            m_fanHashKeys   = new Index [m_fanHashSize];
+            m_fanHashHeads  = new Index [2 * m_fanHashSize];
+            m_fanHashCounts = new Index [2 * m_fanHashSize];
+            m_fanNext       = new Index [2 * m_fanBufferSize];
+            m_fanSeeds      = new Index [m_fanBufferSize];
+            m_fanBuckets    = new Index [m_fanBufferSize + 1];
+            m_fanVisited    = new Index [4 * m_fanBufferSize];
         }
         return O3DGC_OK;
     }
     template <class T>
     O3DGCErrorCode TriangleListEncoder<T>::Encode(const T * const triangles, 
                                                   const unsigned long * const indexBufferIDs,
-                                                  const long numTriangles,
-                                                  const long numVertices, 
+                                                  const Index numTriangles,
+                                                  const Index numVertices, 
                                                   BinaryStream & bstream)
     {
         assert(numVertices > 0);
@@ -306,27 +407,35 @@ namespace o3dgc
         
         if (encodeTrianglesOrder)
         {
-            long numBufferIDs = 0;
-            for (long t = 0; t < numTriangles; t++)
+            Index numBufferIDs = 0;
+            for (Index t = 0; t < numTriangles; t++)
             {
-                if (numBufferIDs <= (long) indexBufferIDs[t])
+                if (numBufferIDs <= (Index) indexBufferIDs[t])
                 {
                     ++numBufferIDs;
                     assert(numBufferIDs <= numTriangles);
                 }
                 ++m_count[indexBufferIDs[t]+1];
             }
-            for (long i = 2; i <= numBufferIDs; i++)
+            for (Index i = 2; i <= numBufferIDs; i++)
             {
                 m_count[i] += m_count[i-1];
             }
             mask += 2; // preserved triangles order
         }
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && m_binarization == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            mask += (O3DGC_SC3DMC_BINARIZATION_RANS & 7) << 4; // entropy coder (0 = arithmetic coding)
+        }
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && m_entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)
+        {
+            mask += 8; // semi-static models
+        }
         bstream.WriteUChar(mask, m_streamType); 
         bstream.WriteUInt32(m_maxSizeVertexToTriangle, m_streamType);
 
-        long v0;
-        for (long v = 0; v < m_numVertices; v++)
+        Index v0;
+        for (Index v = 0; v < m_numVertices; v++)
         {
             if (!m_vtags[v]) 
             {
@@ -343,9 +452,9 @@ namespace o3dgc
         }
         if (encodeTrianglesOrder)
         {
-            long t, prev = 0;
-            long pred;
-            for (long i = 0; i < numTriangles; ++i)
+            Index t, prev = 0;
+            Index pred;
+            for (Index i = 0; i < numTriangles; ++i)
             {
                 t = m_invTMap[i];
                 m_tmap[t] = m_count[ indexBufferIDs[t] ]++;
@@ -353,7 +462,7 @@ namespace o3dgc
                 m_ctfans.PushTriangleIndex(pred);
                 prev = m_tmap[t] + 1;
             }
-            for (long t = 0; t < numTriangles; ++t)
+            for (Index t = 0; t < numTriangles; ++t)
             {
                 m_invTMap[m_tmap[t]] = t;
             }
@@ -362,13 +471,13 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode TriangleListEncoder<T>::CompueLocalConnectivityInfo(const long focusVertex)
+    O3DGCErrorCode TriangleListEncoder<T>::CompueLocalConnectivityInfo(const Index focusVertex)
     {
-        long t, v, p;
+        Index t, v, p;
         m_numNonConqueredTriangles = 0;
         m_numConqueredTriangles    = 0;
         m_numVisitedVertices       = 0;
-        for(long i = m_vertexToTriangle.Begin(focusVertex); i < m_vertexToTriangle.End(focusVertex); ++i)
+        for(Index i = m_vertexToTriangle.Begin(focusVertex); i < m_vertexToTriangle.End(focusVertex); ++i)
         {
             t = m_vertexToTriangle.GetNeighbor(i);
 
@@ -386,13 +495,27 @@ namespace o3dgc
                 m_numConqueredTriangles++;
                 p = 3*t;
                 // extract visited vertices
-                for(long k = 0; k < 3; ++k)
+                for(Index k = 0; k < 3; ++k)
                 {
                     v = m_triangles[p+k];
-                    if (m_vmap[v] > m_vmap[focusVertex]) // vertices are insertices by increasing traversal order
+                    if (m_hashedFan && m_vmap[v] > m_vmap[focusVertex])
+                    {
+                        Index & position = m_visitedPositions[m_vmap[v]];
+                        if (position == 0)
+                        {
+                            m_visitedVertices[m_numVisitedVertices]        = m_vmap[v];
+                            m_visitedVerticesValence[m_numVisitedVertices] = 1;
+                            position = ++m_numVisitedVertices;
+                        }
+                        else
+                        {
+                            m_visitedVerticesValence[position-1]++;
+                        }
+                    }
+                    else if (m_vmap[v] > m_vmap[focusVertex]) // vertices are insertices by increasing traversal order
                     {
                         bool foundOrInserted = false;
-                        for (long j = 0; j < m_numVisitedVertices; ++j)
+                        for (Index j = 0; j < m_numVisitedVertices; ++j)
                         {
 
                             if (m_vmap[v] == m_visitedVertices[j])
@@ -404,7 +527,7 @@ namespace o3dgc
                             else if (m_vmap[v] < m_visitedVertices[j])
                             {
                                 ++m_numVisitedVertices;
-                                for (long h = m_numVisitedVertices-1; h > j; --h)
+                                for (Index h = m_numVisitedVertices-1; h > j; --h)
                                 {
                                     m_visitedVertices[h]        = m_visitedVertices[h-1];
                                     m_visitedVerticesValence[h] = m_visitedVerticesValence[h-1];
@@ -425,12 +548,16 @@ namespace o3dgc
                 }
             }            
         }
+        if (m_hashedFan)
+        {
+            SortVisitedVerticesHashed();
+        }
         // re-order visited vertices by taking into account their valence (i.e., # of conquered triangles incident to each vertex)
         // in order to avoid config. 9
-        if (m_numVisitedVertices > 2)
+        else if (m_numVisitedVertices > 2)
         {
-            long y;
-            for(long x = 1; x < m_numVisitedVertices; ++x)
+            Index y;
+            for(Index x = 1; x < m_numVisitedVertices; ++x)
             {
 
                 if (m_visitedVerticesValence[x] == 1)
@@ -445,18 +572,22 @@ namespace o3dgc
                 }
             }
         }
-        if (m_numNonConqueredTriangles > 0)
+        if (m_hashedFan && m_numNonConqueredTriangles > 0)
+        {
+            ComputeTriangleToTriangleHashed();
+        }
+        else if (m_numNonConqueredTriangles > 0)
         {
             // compute triangle-to-triangle adjacency information
             m_triangleToTriangle.AllocateNumNeighborsArray(m_numNonConqueredTriangles);
             m_triangleToTriangle.ClearNumNeighborsArray();
             m_triangleToTriangleInv.AllocateNumNeighborsArray(m_numNonConqueredTriangles);
             m_triangleToTriangleInv.ClearNumNeighborsArray();
-            long * const numNeighbors    = m_triangleToTriangle.GetNumNeighborsBuffer();
-            long * const invNumNeighbors = m_triangleToTriangleInv.GetNumNeighborsBuffer();
-            for(long i = 0; i < m_numNonConqueredTriangles; ++i)
+            Index * const numNeighbors    = m_triangleToTriangle.GetNumNeighborsBuffer();
+            Index * const invNumNeighbors = m_triangleToTriangleInv.GetNumNeighborsBuffer();
+            for(Index i = 0; i < m_numNonConqueredTriangles; ++i)
             {
-                for(long j = i+1; j < m_numNonConqueredTriangles; ++j)
+                for(Index j = i+1; j < m_numNonConqueredTriangles; ++j)
                 {
                     if (m_nonConqueredEdges[2*i+1] == m_nonConqueredEdges[2*j]) // edge i is connected to edge j
                     {
@@ -474,9 +605,9 @@ namespace o3dgc
             m_triangleToTriangle.ClearNeighborsArray();
             m_triangleToTriangleInv.AllocateNeighborsArray();
             m_triangleToTriangleInv.ClearNeighborsArray();
-            for(long i = 0; i < m_numNonConqueredTriangles; ++i)
+            for(Index i = 0; i < m_numNonConqueredTriangles; ++i)
             {
-                for(long j = 1; j < m_numNonConqueredTriangles; ++j)
+                for(Index j = 1; j < m_numNonConqueredTriangles; ++j)
                 {
                     if (m_nonConqueredEdges[2*i+1] == m_nonConqueredEdges[2*j]) // edge i is connected to edge j
                     {
@@ -494,16 +625,17 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode TriangleListEncoder<T>::ComputeTFANDecomposition(const long focusVertex)
+    O3DGCErrorCode TriangleListEncoder<T>::ComputeTFANDecomposition(const Index focusVertex)
     {
-        long processedTriangles = 0;
-        long minNumInputEdges;
-        long numInputEdges;
-        long indexSeedTriangle;
-        long seedTriangle;
-        long currentIndex;
-        long currentTriangle;
-        long i0, i1, index;
+        Index processedTriangles = 0;
+        Index minNumInputEdges;
+        Index numInputEdges;
+        Index indexSeedTriangle;
+        Index seedTriangle;
+        Index currentIndex;
+        Index currentTriangle;
+        Index i0, i1, index;
+        Index nextSeed = 0;
 
         m_tfans.Clear();
         while (processedTriangles != m_numNonConqueredTriangles)
@@ -511,7 +643,16 @@ namespace o3dgc
             // find non processed triangle with lowest number of inputs
             minNumInputEdges   = m_numTriangles;
             indexSeedTriangle = -1;
-            for(long i = 0; i < m_numNonConqueredTriangles; ++i)
+            if (m_hashedFan)
+            {
+                // the seeds are sorted and processed triangles stay processed
+                while (m_ttags[m_nonConqueredTriangles[m_fanSeeds[nextSeed]]])
+                {
+                    ++nextSeed;
+                }
+                indexSeedTriangle = m_fanSeeds[nextSeed];
+            }
+            for(Index i = 0; !m_hashedFan && i < m_numNonConqueredTriangles; ++i)
             {
                 numInputEdges = m_triangleToTriangleInv.GetNumNeighbors(i);
                 if ( !m_ttags[m_nonConqueredTriangles[i]] && 
@@ -543,7 +684,7 @@ namespace o3dgc
                 i0 = m_triangleToTriangle.Begin(currentIndex);
                 i1 = m_triangleToTriangle.End(currentIndex);
                 currentIndex = -1;
-                for(long i = i0; i < i1; ++i)
+                for(Index i = i0; i < i1; ++i)
                 {
                     index           = m_triangleToTriangle.GetNeighbor(i);
                     currentTriangle = m_nonConqueredTriangles[index];
@@ -564,25 +705,25 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode TriangleListEncoder<T>::CompressTFAN(const long focusVertex)
+    O3DGCErrorCode TriangleListEncoder<T>::CompressTFAN(const Index focusVertex)
     {
         m_ctfans.PushNumTFans(m_tfans.GetNumTFANs());    
 
-        const long ntfans = m_tfans.GetNumTFANs();
-        long degree;
-        long k0, k1;
-        long v0;
-        long ops[O3DGC_MAX_TFAN_SIZE];
-        long indices[O3DGC_MAX_TFAN_SIZE];
+        const Index ntfans = m_tfans.GetNumTFANs();
+        Index degree;
+        Index k0, k1;
+        Index v0;
+        Index * const ops     = m_tfanOps;
+        Index * const indices = m_tfanIndices;
 
-        long numOps;
-        long numIndices;
-        long pos;
-        long found;
+        Index numOps;
+        Index numIndices;
+        Index pos;
+        Index found;
 
         if (m_tfans.GetNumTFANs() > 0) 
         {
-            for(long f = 0; f != ntfans; f++) 
+            for(Index f = 0; f != ntfans; f++) 
             {
                 degree = m_tfans.GetTFANSize(f) - 1;
                 m_ctfans.PushDegree(degree-2+ m_numConqueredTriangles);
@@ -590,7 +731,7 @@ namespace o3dgc
                 numIndices = 0;
                 k0 = 1 + m_tfans.Begin(f);
                 k1 = m_tfans.End(f);
-                for(long k = k0; k < k1; k++) 
+                for(Index k = k0; k < k1; k++) 
                 {
                     v0 = m_tfans.GetVertex(k);
                     if (m_vtags[v0] == 0)
@@ -601,13 +742,17 @@ namespace o3dgc
                         m_invVMap[m_vmap[v0]] = v0;
                         m_vfifo.PushBack(v0);
                         m_visitedVertices[m_numVisitedVertices++] = m_vmap[v0];
+                        if (m_hashedFan)
+                        {
+                            m_visitedPositions[m_vmap[v0]] = m_numVisitedVertices;
+                        }
                     }
                     else 
                     {
                         ops[numOps++] = 1;
-                        pos = 0;
-                        found = 0;
-                        for(long u=0; u < m_numVisitedVertices; ++u)
+                        pos = (m_hashedFan) ? m_visitedPositions[m_vmap[v0]] : 0;
+                        found = (pos > 0) ? 1 : 0;
+                        for(Index u=0; !m_hashedFan && u < m_numVisitedVertices; ++u)
                         {
                             pos++;
                             if (m_visitedVertices[u] == m_vmap[v0]) 
@@ -635,7 +780,7 @@ namespace o3dgc
                 else if (IsCase1(degree, numIndices, ops, indices))
                 {
                     // ops: 1xxxxxx1 vertices: -1 x x x x x -2
-                    long u = 1;
+                    Index u = 1;
                     for(u = 1; u < degree-1; u++)
                     {
                         m_ctfans.PushOperation(ops[u]);
@@ -679,7 +824,7 @@ namespace o3dgc
                 else if (IsCase8(degree, numIndices, ops, indices))
                 {
                     // ops: 1xxxxxx1 vertices: -2 x x x x x -1
-                    long u = 1;
+                    Index u = 1;
                     for(u =1; u < degree-1; u++)
                     {
                         m_ctfans.PushOperation(ops[u]);
@@ -692,7 +837,7 @@ namespace o3dgc
                 }
                 else 
                 {
-                    long u = 0;
+                    Index u = 0;
                     for(u =0; u < degree; u++)
                     {
                         m_ctfans.PushOperation(ops[u]);
@@ -708,11 +853,121 @@ namespace o3dgc
         return O3DGC_OK;
     }
     template <class T>
-    O3DGCErrorCode TriangleListEncoder<T>::ProcessVertex(const long focusVertex)
+    O3DGCErrorCode TriangleListEncoder<T>::ProcessVertex(const Index focusVertex)
     {
+        m_hashedFan = (m_vertexToTriangle.GetNumNeighbors(focusVertex) > O3DGC_TFAN_HASH_MIN_VALENCE);
         CompueLocalConnectivityInfo(focusVertex);
         ComputeTFANDecomposition(focusVertex);
         CompressTFAN(focusVertex);
+        if (m_hashedFan)
+        {
+            for(Index u = 0; u < m_numVisitedVertices; ++u)
+            {
+                m_visitedPositions[m_visitedVertices[u]] = 0;
+            }
+        }
+        return O3DGC_OK;
+    }
+    template <class T>
+    O3DGCErrorCode TriangleListEncoder<T>::SortVisitedVerticesHashed()
+    {
+        // same order as the insertion sort of CompueLocalConnectivityInfo(): by increasing vmap value, then, with more
+        // than two vertices, those with a valence of 1 first
+        Index * const pairs = m_fanVisited;
+        for(Index u = 0; u < m_numVisitedVertices; ++u)
+        {
+            pairs[2*u  ] = m_visitedVertices[u];
+            pairs[2*u+1] = m_visitedVerticesValence[u];
+        }
+        qsort(pairs, m_numVisitedVertices, 2 * sizeof(Index), CompareVisitedVertices);
+        Index n = 0;
+        for(Index pass = 0; pass < 2; ++pass)
+        {
+            for(Index u = 0; u < m_numVisitedVertices; ++u)
+            {
+                const bool first = (m_numVisitedVertices <= 2) || (pairs[2*u+1] == 1);
+                if (first == (pass == 0))
+                {
+                    m_visitedVertices[n]               = pairs[2*u];
+                    m_visitedVerticesValence[n]        = pairs[2*u+1];
+                    m_visitedPositions[pairs[2*u]]     = ++n;
+                }
+            }
+        }
+        return O3DGC_OK;
+    }
+    template <class T>
+    O3DGCErrorCode TriangleListEncoder<T>::ComputeTriangleToTriangleHashed()
+    {
+        // edge i goes from m_nonConqueredEdges[2*i] to m_nonConqueredEdges[2*i+1] and is connected to the edges j
+        // starting where it ends: both are found through a hash table on the edge vertices instead of testing all pairs
+        const Index numEdges = m_numNonConqueredTriangles;
+        Index hashSize = 1;
+        while (hashSize < 4 * numEdges)
+        {
+            hashSize <<= 1;
+        }
+        memset(m_fanHashKeys, 0xFF, sizeof(Index) * hashSize);
+        for(Index i = numEdges-1; i >= 0; --i) // chains sorted by increasing edge index
+        {
+            for(Index k = 0; k < 2; ++k)
+            {
+                const Index key = m_nonConqueredEdges[2*i+k];
+                const Index h   = FindFanHashEntry(m_fanHashKeys, hashSize, key);
+                if (m_fanHashKeys[h] == -1)
+                {
+                    m_fanHashKeys[h]       = key;
+                    m_fanHashHeads[2*h  ]  = -1;
+                    m_fanHashHeads[2*h+1]  = -1;
+                    m_fanHashCounts[2*h  ] = 0;
+                    m_fanHashCounts[2*h+1] = 0;
+                }
+                m_fanNext[2*i+k]      = m_fanHashHeads[2*h+k];
+                m_fanHashHeads[2*h+k] = i;
+                ++m_fanHashCounts[2*h+k];
+            }
+        }
+        m_triangleToTriangle.AllocateNumNeighborsArray(numEdges);
+        m_triangleToTriangleInv.AllocateNumNeighborsArray(numEdges);
+        Index * const numNeighbors    = m_triangleToTriangle.GetNumNeighborsBuffer();
+        Index * const invNumNeighbors = m_triangleToTriangleInv.GetNumNeighborsBuffer();
+        memset(m_fanBuckets, 0x00, sizeof(Index) * (numEdges + 1));
+        for(Index i = 0; i < numEdges; ++i)
+        {
+            const Index a    = m_nonConqueredEdges[2*i];
+            const Index b    = m_nonConqueredEdges[2*i+1];
+            const Index self = (a == b) ? 1 : 0;
+            const Index hb   = FindFanHashEntry(m_fanHashKeys, hashSize, b);
+            const Index ha   = FindFanHashEntry(m_fanHashKeys, hashSize, a);
+            numNeighbors[i]    = m_fanHashCounts[2*hb  ] - self; // edges starting at b
+            invNumNeighbors[i] = m_fanHashCounts[2*ha+1] - self; // edges ending at a
+            ++m_fanBuckets[invNumNeighbors[i]];
+        }
+        // bucket the triangles by number of input edges, by increasing index within a bucket
+        Index position = 0;
+        for(Index c = 0; c <= numEdges; ++c)
+        {
+            const Index n = m_fanBuckets[c];
+            m_fanBuckets[c] = position;
+            position += n;
+        }
+        for(Index i = 0; i < numEdges; ++i)
+        {
+            m_fanSeeds[ m_fanBuckets[ invNumNeighbors[i] ]++ ] = i;
+        }
+        m_triangleToTriangle.AllocateNeighborsArray();
+        m_triangleToTriangleInv.AllocateNeighborsArray();
+        Index * const neighbors    = m_triangleToTriangle.GetNeighborsBuffer();
+        Index * const invNeighbors = m_triangleToTriangleInv.GetNeighborsBuffer();
+        for(Index i = 0; i < numEdges; ++i)
+        {
+            const Index hb = FindFanHashEntry(m_fanHashKeys, hashSize, m_nonConqueredEdges[2*i+1]);
+            const Index ha = FindFanHashEntry(m_fanHashKeys, hashSize, m_nonConqueredEdges[2*i]);
+            FillFanNeighbors(i, m_fanHashHeads[2*hb  ], m_fanNext    , neighbors   ,
+                             m_triangleToTriangle.Begin(i)   , m_triangleToTriangle.End(i));
+            FillFanNeighbors(i, m_fanHashHeads[2*ha+1], m_fanNext + 1, invNeighbors,
+                             m_triangleToTriangleInv.Begin(i), m_triangleToTriangleInv.End(i));
+        }
         return O3DGC_OK;
     }
 }
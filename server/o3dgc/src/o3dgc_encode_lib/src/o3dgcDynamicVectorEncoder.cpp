@@ -22,7 +22,9 @@ THE SOFTWARE.
 #include "o3dgcDVEncodeParams.h"
 #include "o3dgcDynamicVectorEncoder.h"
 #include "o3dgcArithmeticCodec.h"
+#include "o3dgcRANSCodec.h"
 #include "o3dgcBinaryStream.h"
+#include "o3dgcSIMD.h"
 
 //#define DEBUG_VERBOSE
 
@@ -99,15 +101,12 @@ namespace o3dgc
         m_numVectors    = 0;
         m_dimVectors    = 0;
         m_quantVectors  = 0;
-        m_sizeBufferAC  = 0;
-        m_bufferAC      = 0;
         m_posSize       = 0;
         m_streamType    = O3DGC_STREAM_TYPE_UNKOWN;
     }
     DynamicVectorEncoder::~DynamicVectorEncoder()
     {
         delete [] m_quantVectors;
-        delete [] m_bufferAC;
     }
     O3DGCErrorCode DynamicVectorEncoder::Encode(const DVEncodeParams & params,
                                                 const DynamicVector & dynamicVector,
@@ -136,7 +135,12 @@ namespace o3dgc
         bstream.WriteUInt32(O3DGC_DV_START_CODE, m_streamType);
         m_posSize = bstream.GetSize();
         bstream.WriteUInt32(0, m_streamType); // to be filled later
-        bstream.WriteUChar((unsigned char) params.GetEncodeMode(), m_streamType);
+        unsigned char mode = (unsigned char) params.GetEncodeMode();
+        if (m_streamType != O3DGC_STREAM_TYPE_ASCII && params.GetBinarization() == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            mode += (O3DGC_SC3DMC_BINARIZATION_RANS & 7) << 4; // entropy coder (0 = arithmetic coding)
+        }
+        bstream.WriteUChar(mode, m_streamType);
         bstream.WriteUInt32(dynamicVector.GetNVector() , m_streamType);
         if (dynamicVector.GetNVector() > 0)
         {
@@ -145,23 +149,19 @@ namespace o3dgc
         }
         return O3DGC_OK;
     }
-    O3DGCErrorCode DynamicVectorEncoder::EncodeAC(unsigned long num, 
+    template <class Codec>
+    O3DGCErrorCode DynamicVectorEncoder::EncodeAC(Codec & ace,
+                                                  unsigned long num, 
                                                   unsigned long dim, 
                                                   unsigned long M, 
-                                                  unsigned long & encodedBytes)
+                                                  unsigned long & encodedBytes,
+                                                  BinaryStream & bstream)
     {
-        Arithmetic_Codec ace;
         Static_Bit_Model bModel0;
         Adaptive_Bit_Model bModel1;
         Adaptive_Data_Model mModelValues(M+2);
         const unsigned int NMAX = num * dim * 8 + 100;
-        if ( m_sizeBufferAC < NMAX )
-        {
-            delete [] m_bufferAC;
-            m_sizeBufferAC = NMAX;
-            m_bufferAC     = new unsigned char [m_sizeBufferAC];
-        }
-        ace.set_buffer(NMAX, m_bufferAC);
+        ace.set_buffer(NMAX, bstream.ReserveTail(NMAX));
         ace.start_encoder();
         ace.ExpGolombEncode(0, 0, bModel0, bModel1);
         ace.ExpGolombEncode(M, 0, bModel0, bModel1);
@@ -221,6 +221,7 @@ namespace o3dgc
 
         if (m_streamType == O3DGC_STREAM_TYPE_ASCII)
         {
+            bstream.Reserve(num * dim); // at least one symbol per value
             for(unsigned long v = 0; v < num; ++v)
             {
                 for(unsigned long d = 0; d < dim; ++d)
@@ -229,28 +230,15 @@ namespace o3dgc
                 }
             }
         }
+        else if (params.GetBinarization() == O3DGC_SC3DMC_BINARIZATION_RANS)
+        {
+            RANS_Codec ace;
+            EncodeBestM(ace, num, dim, bstream);
+        }
         else
         {
-            unsigned long encodedBytes = 0;
-            unsigned long bestEncodedBytes = O3DGC_MAX_ULONG;
-            unsigned long M = 1;
-            unsigned long bestM = 1;
-            while (M < 1024)
-            {
-                EncodeAC(num, dim, M, encodedBytes);
-                if (encodedBytes > bestEncodedBytes)
-                {
-                    break;
-                }
-                bestM = M;
-                bestEncodedBytes = encodedBytes;
-                M *= 2;
-            }
-            EncodeAC(num, dim, bestM, encodedBytes);
-            for(unsigned long i = 0; i < encodedBytes; ++i)
-            {
-                bstream.WriteUChar8Bin(m_bufferAC[i]);
-            }
+            Arithmetic_Codec ace;
+            EncodeBestM(ace, num, dim, bstream);
         }
         bstream.WriteUInt32(start, bstream.GetSize() - start, m_streamType);
 #ifdef DEBUG_VERBOSE
@@ -258,6 +246,22 @@ namespace o3dgc
 #endif //DEBUG_VERBOSE
         return O3DGC_OK;
     }
+    template <class Codec>
+    O3DGCErrorCode DynamicVectorEncoder::EncodeBestM(Codec & ace,
+                                                     unsigned long num, 
+                                                     unsigned long dim, 
+                                                     BinaryStream & bstream)
+    {
+        unsigned long encodedBytes = 0;
+        m_estimator.Clear();
+        for(unsigned long i = 0; i < num * dim; ++i)
+        {
+            m_estimator.AddInt(m_quantVectors[i]);
+        }
+        EncodeAC(ace, num, dim, m_estimator.GetBestM(O3DGC_DV_MAX_M), encodedBytes, bstream);
+        bstream.CommitTail(encodedBytes);
+        return O3DGC_OK;
+    }
     O3DGCErrorCode DynamicVectorEncoder::Quantize(const Real * const floatArray, 
                                                   unsigned long numFloatArray,
                                                   unsigned long dimFloatArray,
@@ -267,30 +271,14 @@ namespace o3dgc
                                                   unsigned long nQBits)
     {
         const unsigned long size = numFloatArray * dimFloatArray;
-        Real r;
         if (m_maxNumVectors < size)
         {
             delete [] m_quantVectors;
             m_maxNumVectors = size;
             m_quantVectors = new long [m_maxNumVectors];
         }
-        Real delta;
-        for(unsigned long d = 0; d < dimFloatArray; ++d)
-        {
-            r = maxFloatArray[d] - minFloatArray[d];
-            if (r > 0.0f)
-            {
-                delta = (float)((1 << nQBits) - 1) / r;
-            }
-            else
-            {
-                delta = 1.0f;
-            }
-            for(unsigned long v = 0; v < numFloatArray; ++v)
-            {
-                m_quantVectors[v + d * numFloatArray] = (long)((floatArray[v * stride + d]-minFloatArray[d]) * delta + 0.5f);
-            }
-        }
+        QuantizeVectors(floatArray, numFloatArray, dimFloatArray, stride, minFloatArray, maxFloatArray, nQBits, 
+                        m_quantVectors, 1, numFloatArray);
         return O3DGC_OK;
     }
 }
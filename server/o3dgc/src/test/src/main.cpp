@@ -39,6 +39,8 @@ THE SOFTWARE.
 #include "o3dgcDVEncodeParams.h"
 #include "o3dgcDynamicVectorEncoder.h"
 #include "o3dgcDynamicVectorDecoder.h"
+#include "o3dgcMappedFile.h"
+#include "o3dgcSIMD.h"
 
 //#define ADD_FAKE_ANIMATION_WEIGHTS
 //#define TEST_DYNAMIC_VECTOR_ENCODING
@@ -48,14 +50,17 @@ THE SOFTWARE.
 #define PATH_SEP "\\"
 #else
 #define PATH_SEP "/"
+#include <sys/resource.h>
 #endif
 
 using namespace o3dgc;
 
+const double PI = 3.14159265358979323846;
+
 class IVec3Cmp 
 {
    public:
-      bool operator()(const Vec3<unsigned long> a,const Vec3<unsigned long> b) 
+      bool operator()(const Vec3<unsigned long> a,const Vec3<unsigned long> b) const
       { 
           if (a.X() != b.X())
           {
@@ -88,27 +93,30 @@ public:
     std::string     m_name;
 };
 
+template <class T>
 bool LoadOBJ(const std::string & fileName, 
              std::vector< Vec3<Real> > & upoints,
              std::vector< Vec2<Real> > & utexCoords,
              std::vector< Vec3<Real> > & unormals,
-             std::vector< Vec3<unsigned long> > & triangles,
+             std::vector< Vec3<T> > & triangles,
              std::vector< unsigned long > & indexBufferIDs,
              std::vector< Material > & materials,
              std::string & materialLib);
 
+template <class T>
 bool LoadIFS(const std::string & fileName, 
              std::vector< Vec3<Real> > & points,
              std::vector< Vec2<Real> > & texCoords,
              std::vector< Vec3<Real> > & normals,
-             std::vector< Vec3<unsigned long> > & triangles,
+             std::vector< Vec3<T> > & triangles,
              std::vector< unsigned long > & indexBufferIDs);
 
+template <class T>
 bool SaveOBJ(const std::string & fileName, 
              const std::vector< Vec3<Real> > & points,
              const std::vector< Vec2<Real> > & texCoords,
              const std::vector< Vec3<Real> > & normals,
-             const std::vector< Vec3<unsigned long> > & triangles,
+             const std::vector< Vec3<T> > & triangles,
              const std::vector< Material > & materials,
              const std::vector< unsigned long > indexBufferIDs,
              const std::string & materialLib);
@@ -120,11 +128,14 @@ bool LoadMaterials(const std::string & fileName,
 bool SaveMaterials(const std::string & fileName, 
                    const std::vector< Material > & materials, 
                    const std::string & materialLib);
+template <class T>
 bool SaveIFS(const std::string & fileName, 
-             const IndexedFaceSet<unsigned long> & ifs);
-bool Check(const IndexedFaceSet<unsigned long> & ifs);
+             const IndexedFaceSet<T> & ifs);
+template <class T>
+bool Check(const IndexedFaceSet<T> & ifs);
 
-int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnormal, O3DGCStreamType streamType)
+template <class T>
+int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnormal, O3DGCStreamType streamType, O3DGCSC3DMCBinarization binarization, unsigned long numLanes, O3DGCModelDictionary modelDictionary, O3DGCSC3DMCEntropyModel entropyModel, bool tableOfContents, unsigned long numThreads, unsigned long numSegments, unsigned long clusterSize, O3DGCSC3DMCPredictionMode normalPredMode, Real coordMaxError, Real normalMaxError, Real texCoordMaxError, unsigned long textureSize, unsigned long maxStreamSize)
 {
     std::string folder;
     long found = (long) fileName.find_last_of(PATH_SEP);
@@ -141,7 +152,7 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
     std::vector< Vec3<Real> > points;
     std::vector< Vec3<Real> > normals;
     std::vector< Vec2<Real> > texCoords;
-    std::vector< Vec3<unsigned long> > triangles;
+    std::vector< Vec3<T> > triangles;
     std::vector< unsigned long > indexBufferIDs;
     std::vector< Material > materials;
 
@@ -171,6 +182,11 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
         std::cout <<  "Error: points.size() == 0 || triangles.size() == 0 \n" << std::endl;
         return -1;
     }
+    if (points.size() - 1 > GetMaxIndex<T>())
+    {
+        std::cout <<  "Error: " << points.size() << " vertices do not fit in " << 8 * sizeof(T) << "-bit indices\n" << std::endl;
+        return -1;
+    }
     std::cout << "Done." << std::endl;
 
     if (materials.size() > 0)
@@ -217,10 +233,23 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
     
     SC3DMCEncodeParams params;
     params.SetStreamType(streamType);
-    IndexedFaceSet<unsigned long> ifs;
+    params.SetBinarization(binarization);
+    params.SetNumLanes(numLanes);
+    params.SetModelDictionary(modelDictionary);
+    params.SetEntropyModel(entropyModel);
+    params.SetTableOfContents(tableOfContents);
+    params.SetNumThreads(numThreads);
+    params.SetNumSegments(numSegments);
+    params.SetClusterSize(clusterSize);
+    params.SetCoordMaxError(coordMaxError);
+    params.SetNormalMaxError(normalMaxError);
+    params.SetTexCoordMaxError(texCoordMaxError);
+    params.SetTextureSize(textureSize);
+    params.SetMaxStreamSize(maxStreamSize);
+    IndexedFaceSet<T> ifs;
 
     ifs.SetNCoordIndex((unsigned long)triangles.size());
-    ifs.SetCoordIndex((unsigned long * const ) &(triangles[0]));
+    ifs.SetCoordIndex((T * const ) &(triangles[0]));
     if (materials.size() > 1)
     {
         ifs.SetIndexBufferID((unsigned long * const ) &(indexBufferIDs[0]));
@@ -236,7 +265,7 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
     if (normals.size() > 0)
     {
         ifs.SetNormal((Real * const) & (normals[0]));
-        params.SetNormalPredMode(O3DGC_SC3DMC_SURF_NORMALS_PREDICTION);
+        params.SetNormalPredMode(normalPredMode);
     }
 
     unsigned int nIntAttributes   = 0;
@@ -302,20 +331,27 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
     BinaryStream bstream((unsigned long)points.size()*8);
 
     SaveIFS("debug_enc.txt", ifs);
-    SC3DMCEncoder<unsigned long> encoder;
-    Timer timer;
-    timer.Tic();
-    encoder.Encode(params, ifs, bstream);
-    timer.Toc();
-    std::cout << "Encode time (ms) " << timer.GetElapsedTime() << std::endl;
-
     FILE * fout = fopen(outFileName.c_str(), "wb");
     if (!fout)
     {
         return -1;
     }
-    fwrite(bstream.GetBuffer(), 1, bstream.GetSize(), fout);
+    // each encoded section is written to the file as soon as it is complete
+    FileStreamSink sink(fout);
+    bstream.SetSink(&sink);
+
+    SC3DMCEncoder<T> encoder;
+    Timer timer;
+    timer.Tic();
+    O3DGCErrorCode errorCode = encoder.Encode(params, ifs, bstream);
+    timer.Toc();
     fclose(fout);
+    if (errorCode != O3DGC_OK)
+    {
+        return -1;
+    }
+    std::cout << "Encode time (ms) " << timer.GetElapsedTime() << std::endl;
+
     std::cout << "Bitstream size (bytes) " << bstream.GetSize() << std::endl;
 
     std::cout << "Details" << std::endl;
@@ -331,10 +367,34 @@ int testEncode(const std::string & fileName, int qcoord, int qtexCoord, int qnor
     {
         std::cout << "\t# IntAttribute[" << a << "] " << stats.m_timeIntAttribute[a] << " ms, " << stats.m_streamSizeIntAttribute[a] <<" bytes (" << 8.0 * stats.m_streamSizeIntAttribute[a] / ifs.GetNCoord() <<" bpv)" <<std::endl;
     }
+    std::cout << "Quantization (max. error)" << std::endl;
+    std::cout << "\t Coord              " << stats.m_quantBitsCoord << " bits, " << stats.m_quantErrorCoord << " x bbox diagonal" << std::endl;
+    if (ifs.GetNNormal() > 0)
+    {
+        std::cout << "\t Normal             " << stats.m_quantBitsNormal << " bits, " << stats.m_quantErrorNormal * 180.0 / PI << " degrees" << std::endl;
+    }
+    for(unsigned int a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+    {
+        std::cout << "\t# FloatAttribute[" << a << "] " << stats.m_quantBitsFloatAttribute[a] << " bits, ";
+        if (ifs.GetFloatAttributeType(a) == O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_TEXCOORD)
+        {
+            std::cout << stats.m_quantErrorFloatAttribute[a] * textureSize << " texels of " << textureSize << std::endl;
+        }
+        else
+        {
+            std::cout << stats.m_quantErrorFloatAttribute[a] << std::endl;
+        }
+    }
+    if (stats.m_maxStreamSizeExceeded)
+    {
+        std::cout << "Error: the stream exceeds the size budget of " << maxStreamSize << " bytes\n" << std::endl;
+        return -1;
+    }
 
     return 0;
 }
-int testDecode(std::string & fileName)
+template <class T>
+int testDecode(std::string & fileName, bool geometryOnly, unsigned long numThreads, const Real * const regionOfInterest, O3DGCVertexCacheOptimization vertexCacheOptimization, bool batches)
 {
     std::string folder;
     long found = (long)fileName.find_last_of(PATH_SEP);
@@ -353,7 +413,7 @@ int testDecode(std::string & fileName)
     std::vector< Vec3<Real> > points;
     std::vector< Vec3<Real> > normals;
     std::vector< Vec2<Real> > texCoords;
-    std::vector< Vec3<unsigned long> > triangles;
+    std::vector< Vec3<T> > triangles;
     std::vector< unsigned long > indexBufferIDs;
     std::vector< Material > materials;
     std::string materialLib;
@@ -376,48 +436,66 @@ int testDecode(std::string & fileName)
     
 
     BinaryStream bstream;
-    IndexedFaceSet<unsigned long> ifs;
+    IndexedFaceSet<T> ifs;
 
 
-    FILE * fin = fopen(fileName.c_str(), "rb");
-    if (!fin)
-    {
-        return -1;
-    }
-    fseek(fin, 0, SEEK_END);
-    unsigned long size = ftell(fin);
-    bstream.Allocate(size);
-    rewind(fin);
-    unsigned long nread = (unsigned long)fread((void *) bstream.GetBuffer(), 1, size, fin);
-    bstream.SetSize(size);
-    if (nread != size)
+    MappedFile mappedFile;
+    if (mappedFile.Open(fileName.c_str()) != O3DGC_OK)
     {
         return -1;
     }
-    fclose(fin);
+    mappedFile.Attach(bstream); // decoded in place, no copy
     std::cout << "Bitstream size (bytes) " << bstream.GetSize() << std::endl;
 
-    SC3DMCDecoder<unsigned long> decoder;
+    SC3DMCDecoder<T> decoder;
+    decoder.SetNumThreads(numThreads);
+    decoder.SetVertexCacheOptimization(vertexCacheOptimization);
+    if (batches)
+    {
+        decoder.SetMaxBatchVertices(O3DGC_MAX_BATCH_VERTICES);
+    }
+    if (regionOfInterest)
+    {
+        decoder.SetRegionOfInterest(regionOfInterest, regionOfInterest + 3);
+    }
     // load header
     Timer timer;
     timer.Tic();
-    decoder.DecodeHeader(ifs, bstream);
+    O3DGCErrorCode errorCode = decoder.DecodeHeader(ifs, bstream);
     timer.Toc();
+    if (errorCode == O3DGC_ERROR_NON_SUPPORTED_FEATURE && ifs.GetNCoord() - 1 > GetMaxIndex<T>())
+    {
+        std::cout << "Error: " << ifs.GetNCoord() << " vertices do not fit in " << 8 * sizeof(T) << "-bit indices, use -it 32 -batch\n" << std::endl;
+        return -1;
+    }
+    if (errorCode != O3DGC_OK)
+    {
+        return -1;
+    }
     std::cout << "DecodeHeader time (ms) " << timer.GetElapsedTime() << std::endl;
+    if (decoder.GetSegmentIndex().GetNumSegments() > 0)
+    {
+        std::cout << "Segments " << decoder.GetSegmentIndex().GetNumSegments() << std::endl;
+    }
 
     // allocate memory
     triangles.resize(ifs.GetNCoordIndex());
-    ifs.SetCoordIndex((unsigned long * const ) &(triangles[0]));
+    ifs.SetCoordIndex((T * const ) &(triangles[0]));
 
     points.resize(ifs.GetNCoord());
     ifs.SetCoord((Real * const ) &(points[0]));
 
-    if (ifs.GetNNormal() > 0)
+    // geometry only: the other sections are neither decoded nor allocated
+    SC3DMCSectionSelection selection(!geometryOnly);
+    selection.SetConnectivity(true);
+    selection.SetCoord(true);
+
+    if (ifs.GetNNormal() > 0 && !geometryOnly)
     {
         normals.resize(ifs.GetNNormal());
         ifs.SetNormal((Real * const ) &(normals[0]));  
     }
-    unsigned int nFloatAttributes = ifs.GetNumFloatAttributes();
+    unsigned int nFloatAttributes = (geometryOnly) ? 0 : ifs.GetNumFloatAttributes();
     for(unsigned int a  = 0; a < nFloatAttributes; ++a)
     {
         if (ifs.GetFloatAttributeType(a) == O3DGC_IFS_FLOAT_ATTRIBUTE_TYPE_TEXCOORD)
@@ -431,7 +509,7 @@ int testDecode(std::string & fileName)
             ifs.SetFloatAttribute(a, (Real * const ) &(weights[0]));
         }
     }
-    unsigned int nIntAttributes = ifs.GetNumIntAttributes();
+    unsigned int nIntAttributes = (geometryOnly) ? 0 : ifs.GetNumIntAttributes();
     for(unsigned int a  = 0; a < nIntAttributes; ++a)
     {
         if (ifs.GetIntAttributeType(a) == O3DGC_IFS_INT_ATTRIBUTE_TYPE_JOINT_ID)
@@ -456,8 +534,12 @@ int testDecode(std::string & fileName)
 
     // decode mesh
     timer.Tic();
-    decoder.DecodePlayload(ifs, bstream);
+    errorCode = decoder.DecodePlayload(ifs, bstream, selection);
     timer.Toc();
+    if (errorCode != O3DGC_OK)
+    {
+        return -1;
+    }
     std::cout << "DecodePlayload time (ms) " << timer.GetElapsedTime() << std::endl;
 
     std::cout << "Details" << std::endl;
@@ -473,12 +555,54 @@ int testDecode(std::string & fileName)
     {
         std::cout << "\t# IntAttribute[" << a << "] " << stats.m_timeIntAttribute[a] << " ms, " << stats.m_streamSizeIntAttribute[a] <<" bytes (" << 8.0 * stats.m_streamSizeIntAttribute[a] / ifs.GetNCoord() <<" bpv)" <<std::endl;
     }
+    std::cout << "\t Entropy decoding   " << stats.m_timeEntropyDecoding << " ms" <<std::endl;
+    std::cout << "\t Reconstruction     " << stats.m_timeReconstruction  << " ms" <<std::endl;
     std::cout << "\t Reorder            " << stats.m_timeReorder        << " ms,  " << 0 <<" bytes (" << 0.0 <<" bpv)" <<std::endl;
+    if (stats.m_numCacheTriangles > 0)
+    {
+        std::cout << "\t Vertex cache       " << stats.m_timeVertexCache    << " ms, ACMR " << stats.m_acmrBefore << " -> " << stats.m_acmrAfter << std::endl;
+    }
 
     std::cout << "Saving " << outFileName << " ..." << std::endl;
 
     SaveIFS("debug_dec.txt", ifs);
-    ret = SaveOBJ(outFileName.c_str(), points, texCoords, normals, triangles, materials, indexBufferIDs, materialLib);
+    if (batches)
+    {
+        // each batch has its own vertices and 16-bit indices, the shared vertices are written once per batch
+        const TriangleBatches & triangleBatches = decoder.GetBatches();
+        const unsigned long numBatchVertices = triangleBatches.GetNumVertices();
+        std::vector< Vec3<Real> > batchPoints(numBatchVertices);
+        std::vector< Vec3<Real> > batchNormals((normals.size() > 0) ? numBatchVertices : 0);
+        std::vector< Vec2<Real> > batchTexCoords((texCoords.size() > 0) ? numBatchVertices : 0);
+        std::vector< Vec3<unsigned long> > batchTriangles(triangles.size());
+        const unsigned short * const indices = triangleBatches.GetIndices();
+        for(unsigned long b = 0; b < triangleBatches.GetNumBatches(); ++b)
+        {
+            const TriangleBatch & batch = triangleBatches.GetBatch(b);
+            triangleBatches.GatherVertexAttribute(b, (const Real * const) &(points[0]), 3, (Real * const) &(batchPoints[batch.m_firstVertex]));
+            if (batchNormals.size() > 0)
+            {
+                triangleBatches.GatherVertexAttribute(b, (const Real * const) &(normals[0]), 3, (Real * const) &(batchNormals[batch.m_firstVertex]));
+            }
+            if (batchTexCoords.size() > 0)
+            {
+                triangleBatches.GatherVertexAttribute(b, (const Real * const) &(texCoords[0]), 2, (Real * const) &(batchTexCoords[batch.m_firstVertex]));
+            }
+            for(unsigned long t = batch.m_firstTriangle; t < batch.m_firstTriangle + batch.m_numTriangles; ++t)
+            {
+                for(int k = 0; k < 3; ++k)
+                {
+                    batchTriangles[t][k] = batch.m_firstVertex + indices[3 * t + k];
+                }
+            }
+        }
+        std::cout << "Batches " << triangleBatches.GetNumBatches() << " (" << numBatchVertices << " vertices)" << std::endl;
+        ret = SaveOBJ(outFileName.c_str(), batchPoints, batchTexCoords, batchNormals, batchTriangles, materials, indexBufferIDs, materialLib);
+    }
+    else
+    {
+        ret = SaveOBJ(outFileName.c_str(), points, texCoords, normals, triangles, materials, indexBufferIDs, materialLib);
+    }
     if (!ret)
     {
         std::cout << "Error: SaveOBJ()\n" << std::endl;
@@ -495,11 +619,336 @@ int testDecode(std::string & fileName)
     return 0;
 }
 
+int testDecodeTimes(const std::string & fileName, int numIterations, SC3DMCStats & stats)
+{
+    BinaryStream bstream;
+    FILE * fin = fopen(fileName.c_str(), "rb");
+    if (!fin)
+    {
+        return -1;
+    }
+    fseek(fin, 0, SEEK_END);
+    unsigned long size = ftell(fin);
+    bstream.Allocate(size);
+    rewind(fin);
+    unsigned long nread = (unsigned long)fread((void *) bstream.GetBuffer(), 1, size, fin);
+    bstream.SetSize(size);
+    fclose(fin);
+    if (nread != size)
+    {
+        return -1;
+    }
+
+    stats = SC3DMCStats();
+    std::vector< Vec3<unsigned long> > triangles;
+    std::vector< Real > coords;
+    std::vector< Real > normals;
+    std::vector< Real > floatAttributes[O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES];
+    std::vector< long > intAttributes[O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES];
+    for(int it = 0; it < numIterations; ++it)
+    {
+        IndexedFaceSet<unsigned long> ifs;
+        SC3DMCDecoder<unsigned long> decoder;
+        decoder.DecodeHeader(ifs, bstream);
+        triangles.resize(ifs.GetNCoordIndex());
+        ifs.SetCoordIndex((unsigned long * const ) &(triangles[0]));
+        coords.resize(3 * ifs.GetNCoord());
+        ifs.SetCoord((Real * const ) &(coords[0]));
+        if (ifs.GetNNormal() > 0)
+        {
+            normals.resize(3 * ifs.GetNNormal());
+            ifs.SetNormal((Real * const ) &(normals[0]));
+        }
+        for(unsigned int a  = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            floatAttributes[a].resize(ifs.GetNFloatAttribute(a) * ifs.GetFloatAttributeDim(a));
+            ifs.SetFloatAttribute(a, (Real * const ) &(floatAttributes[a][0]));
+        }
+        for(unsigned int a  = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            intAttributes[a].resize(ifs.GetNIntAttribute(a) * ifs.GetIntAttributeDim(a));
+            ifs.SetIntAttribute(a, (long * const ) &(intAttributes[a][0]));
+        }
+        decoder.DecodePlayload(ifs, bstream);
+
+        const SC3DMCStats & s = decoder.GetStats();
+        stats.m_timeCoordIndex       += s.m_timeCoordIndex / numIterations;
+        stats.m_timeCoord            += s.m_timeCoord      / numIterations;
+        stats.m_timeNormal           += s.m_timeNormal     / numIterations;
+        stats.m_streamSizeCoordIndex  = s.m_streamSizeCoordIndex;
+        stats.m_streamSizeCoord       = s.m_streamSizeCoord;
+        stats.m_streamSizeNormal      = s.m_streamSizeNormal;
+        for(unsigned int a = 0; a < ifs.GetNumFloatAttributes(); ++a)
+        {
+            stats.m_timeFloatAttribute[a]      += s.m_timeFloatAttribute[a] / numIterations;
+            stats.m_streamSizeFloatAttribute[a] = s.m_streamSizeFloatAttribute[a];
+        }
+        for(unsigned int a = 0; a < ifs.GetNumIntAttributes(); ++a)
+        {
+            stats.m_timeIntAttribute[a]      += s.m_timeIntAttribute[a] / numIterations;
+            stats.m_streamSizeIntAttribute[a] = s.m_streamSizeIntAttribute[a];
+        }
+    }
+    return 0;
+}
+void PrintEntropyCoderStats(const char * name, unsigned long sizeAC, unsigned long sizeRANS, double timeAC, double timeRANS)
+{
+    if (sizeAC == 0 && sizeRANS == 0)
+    {
+        return;
+    }
+    printf("\t %-20s %10lu %10lu %8.2f%% %10.3f %10.3f %8.2fx\n", name, sizeAC, sizeRANS, 
+           (sizeAC > 0) ? 100.0 * ((double) sizeRANS - (double) sizeAC) / sizeAC : 0.0,
+           timeAC, timeRANS, (timeRANS > 0.0) ? timeAC / timeRANS : 0.0);
+}
+int testEntropyCoders(const std::string & fileName, int qcoord, int qtexCoord, int qnormal, int numIterations, unsigned long numLanes, O3DGCModelDictionary modelDictionary, O3DGCSC3DMCEntropyModel entropyModel)
+{
+    std::string folder;
+    long found = (long) fileName.find_last_of(PATH_SEP);
+    if (found != -1)
+    {
+        folder = fileName.substr(0,found);
+    }
+    if (folder == "")
+    {
+        folder = ".";
+    }
+    std::string file(fileName.substr(found+1));
+    std::string outFileName = folder + PATH_SEP + file.substr(0, file.find_last_of(".")) + ".s3d";
+
+    const O3DGCSC3DMCBinarization binarizations[2] = {O3DGC_SC3DMC_BINARIZATION_AC_EGC, O3DGC_SC3DMC_BINARIZATION_RANS};
+    SC3DMCStats stats[2];
+    for(int b = 0; b < 2; ++b)
+    {
+        int ret = testEncode<unsigned long>(fileName, qcoord, qtexCoord, qnormal, O3DGC_STREAM_TYPE_BINARY, binarizations[b], numLanes, modelDictionary, entropyModel, false, 1, 1, 0, O3DGC_SC3DMC_SURF_NORMALS_PREDICTION, 0, 0, 0, 1024, 0);
+        if (!ret)
+        {
+            ret = testDecodeTimes(outFileName, numIterations, stats[b]);
+        }
+        if (ret)
+        {
+            return ret;
+        }
+    }
+    std::cout << "Decoding: arithmetic coding vs. interleaved rANS (" << numIterations << " iterations)" << std::endl;
+    printf("\t %-20s %10s %10s %9s %10s %10s %9s\n", "", "AC bytes", "rANS bytes", "size", "AC ms", "rANS ms", "speedup");
+    PrintEntropyCoderStats("CoordIndex", stats[0].m_streamSizeCoordIndex, stats[1].m_streamSizeCoordIndex, stats[0].m_timeCoordIndex, stats[1].m_timeCoordIndex);
+    PrintEntropyCoderStats("Coord"     , stats[0].m_streamSizeCoord     , stats[1].m_streamSizeCoord     , stats[0].m_timeCoord     , stats[1].m_timeCoord);
+    PrintEntropyCoderStats("Normal"    , stats[0].m_streamSizeNormal    , stats[1].m_streamSizeNormal    , stats[0].m_timeNormal    , stats[1].m_timeNormal);
+    char name[64];
+    for(unsigned int a = 0; a < O3DGC_SC3DMC_MAX_NUM_FLOAT_ATTRIBUTES; ++a)
+    {
+        sprintf(name, "FloatAttribute[%u]", a);
+        PrintEntropyCoderStats(name, stats[0].m_streamSizeFloatAttribute[a], stats[1].m_streamSizeFloatAttribute[a], stats[0].m_timeFloatAttribute[a], stats[1].m_timeFloatAttribute[a]);
+    }
+    for(unsigned int a = 0; a < O3DGC_SC3DMC_MAX_NUM_INT_ATTRIBUTES; ++a)
+    {
+        sprintf(name, "IntAttribute[%u]", a);
+        PrintEntropyCoderStats(name, stats[0].m_streamSizeIntAttribute[a], stats[1].m_streamSizeIntAttribute[a], stats[0].m_timeIntAttribute[a], stats[1].m_timeIntAttribute[a]);
+    }
+    return 0;
+}
+
+//! Peak resident set size of the process in KB (0 if not available).
+unsigned long GetPeakMemoryKB()
+{
+#ifdef WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (unsigned long) usage.ru_maxrss / 1024;
+#else
+    return (unsigned long) usage.ru_maxrss;
+#endif
+#endif
+}
+int testConnectivity(const std::string & fileName, int numIterations)
+{
+    std::vector< Vec3<Real> > points;
+    std::vector< Vec3<Real> > normals;
+    std::vector< Vec2<Real> > texCoords;
+    std::vector< Vec3<unsigned int> > triangles;
+    std::vector< unsigned long > indexBufferIDs;
+    std::vector< Material > materials;
+    std::string materialLib;
+    bool ret;
+    if (fileName.find(".obj") != std::string::npos )
+    {
+        ret = LoadOBJ(fileName, points, texCoords, normals, triangles, indexBufferIDs, materials, materialLib);
+    }
+    else
+    {
+        ret = LoadIFS(fileName, points, texCoords, normals, triangles, indexBufferIDs);
+    }
+    if (!ret || points.size() == 0 || triangles.size() == 0)
+    {
+        std::cout << "Error: no mesh loaded from " << fileName << std::endl;
+        return -1;
+    }
+    const long numTriangles = (long) triangles.size();
+    const long numVertices  = (long) points.size();
+    std::vector< Vec3<unsigned int> > decodedTriangles(numTriangles);
+    const unsigned long memory0 = GetPeakMemoryKB();
+    double timeEncode = 0.0;
+    double timeDecode = 0.0;
+    unsigned long size = 0;
+    Timer timer;
+    for(int it = 0; it < numIterations; ++it)
+    {
+        BinaryStream bstream;
+        TriangleListEncoder<unsigned int> encoder;
+        encoder.SetStreamType(O3DGC_STREAM_TYPE_BINARY);
+        timer.Tic();
+        if (encoder.Encode((const unsigned int * const) &(triangles[0]), 0, numTriangles, numVertices, bstream) != O3DGC_OK)
+        {
+            return -1;
+        }
+        timer.Toc();
+        timeEncode += timer.GetElapsedTime();
+        size = bstream.GetSize();
+
+        unsigned long iterator = 0;
+        TriangleListDecoder<unsigned int> decoder;
+        decoder.SetStreamType(O3DGC_STREAM_TYPE_BINARY);
+        timer.Tic();
+        if (decoder.Decode((unsigned int * const) &(decodedTriangles[0]), numTriangles, numVertices, bstream, iterator) != O3DGC_OK)
+        {
+            return -1;
+        }
+        decoder.Reorder();
+        timer.Toc();
+        timeDecode += timer.GetElapsedTime();
+    }
+    const unsigned long memory1 = GetPeakMemoryKB();
+    std::cout << "Connectivity: " << numTriangles << " triangles, " << numVertices << " vertices, " 
+              << 8 * sizeof(Index) << "-bit internal indices (" << numIterations << " iterations)" << std::endl;
+    std::cout << "\t Stream size        " << size << " bytes (" << 8.0 * size / numVertices << " bpv)" << std::endl;
+    std::cout << "\t Encode             " << timeEncode / numIterations << " ms" << std::endl;
+    std::cout << "\t Decode             " << timeDecode / numIterations << " ms" << std::endl;
+    std::cout << "\t Peak memory        " << memory1 - memory0 << " KB above the loaded mesh (" << memory1 << " KB)" << std::endl;
+    return 0;
+}
+
+int testQuantization(const std::string & fileName, int qcoord, int qtexCoord, int qnormal, int numIterations)
+{
+    std::vector< Vec3<Real> > points;
+    std::vector< Vec3<Real> > normals;
+    std::vector< Vec2<Real> > texCoords;
+    std::vector< Vec3<unsigned int> > triangles;
+    std::vector< unsigned long > indexBufferIDs;
+    std::vector< Material > materials;
+    std::string materialLib;
+    bool ret;
+    if (fileName.find(".obj") != std::string::npos )
+    {
+        ret = LoadOBJ(fileName, points, texCoords, normals, triangles, indexBufferIDs, materials, materialLib);
+    }
+    else
+    {
+        ret = LoadIFS(fileName, points, texCoords, normals, triangles, indexBufferIDs);
+    }
+    if (!ret || points.size() == 0)
+    {
+        std::cout << "Error: no mesh loaded from " << fileName << std::endl;
+        return -1;
+    }
+    const char * const levelNames[] = {"scalar", "SSE2", "AVX2"};
+    const char * const attributeNames[] = {"Coord", "Normal", "TexCoord"};
+    const Real * const attributes[] = {(points.size())    ? &(points[0].X())    : 0, 
+                                       (normals.size())   ? &(normals[0].X())   : 0, 
+                                       (texCoords.size()) ? &(texCoords[0].X()) : 0};
+    const unsigned long nums[] = {points.size(), normals.size(), texCoords.size()};
+    const unsigned long dims[] = {3, 3, 2};
+    const unsigned long nQBits[] = {(unsigned long) qcoord, (unsigned long) qnormal, (unsigned long) qtexCoord};
+    const O3DGCSIMDLevel supportedLevel = GetSupportedSIMDLevel();
+    std::cout << "Quantization kernels: " << levelNames[supportedLevel] << " supported (" << numIterations << " iterations)" << std::endl;
+    Timer timer;
+    for(int a = 0; a < 3; ++a)
+    {
+        const unsigned long num = nums[a];
+        const unsigned long dim = dims[a];
+        if (num == 0)
+        {
+            continue;
+        }
+        std::cout << "\t " << attributeNames[a] << ": " << num << " vectors of dimension " << dim << std::endl;
+        std::vector< long > quant(num * dim);
+        std::vector< long > refQuant(num * dim);
+        std::vector< long > planarQuant(num * dim);
+        std::vector< long > refPlanarQuant(num * dim);
+        std::vector< Real > values(num * dim);
+        std::vector< Real > refValues(num * dim);
+        Real min[3], max[3], refMin[3], refMax[3];
+        for(int level = O3DGC_SIMD_NONE; level <= supportedLevel; ++level)
+        {
+            SetSIMDLevel((O3DGCSIMDLevel) level);
+            double timeMinMax     = 0.0;
+            double timeQuantize   = 0.0;
+            double timePlanar     = 0.0;
+            double timeIQuantize  = 0.0;
+            for(int it = 0; it < numIterations; ++it)
+            {
+                timer.Tic();
+                ComputeVectorMinMax(attributes[a], num, dim, dim, min, max, O3DGC_SC3DMC_MAX_ALL_DIMS);
+                timer.Toc();
+                timeMinMax += timer.GetElapsedTime();
+                timer.Tic();
+                QuantizeVectors(attributes[a], num, dim, dim, min, max, nQBits[a], &(quant[0]), dim, 1);
+                timer.Toc();
+                timeQuantize += timer.GetElapsedTime();
+                timer.Tic();
+                QuantizeVectors(attributes[a], num, dim, dim, min, max, nQBits[a], &(planarQuant[0]), 1, num);
+                timer.Toc();
+                timePlanar += timer.GetElapsedTime();
+                timer.Tic();
+                IQuantizeVectors(&(quant[0]), dim, 1, num, dim, min, max, nQBits[a], &(values[0]), dim);
+                timer.Toc();
+                timeIQuantize += timer.GetElapsedTime();
+            }
+            bool identical = true;
+            if (level == O3DGC_SIMD_NONE)
+            {
+                memcpy(refMin, min, sizeof(min));
+                memcpy(refMax, max, sizeof(max));
+                refQuant       = quant;
+                refPlanarQuant = planarQuant;
+                refValues      = values;
+            }
+            else
+            {
+                identical = !memcmp(refMin, min, dim * sizeof(Real)) && !memcmp(refMax, max, dim * sizeof(Real)) &&
+                            refQuant == quant && refPlanarQuant == planarQuant &&
+                            !memcmp(&(refValues[0]), &(values[0]), num * dim * sizeof(Real));
+            }
+            std::cout << "\t\t " << levelNames[level] << "\t min/max " << timeMinMax / numIterations 
+                      << " ms, quantize " << timeQuantize / numIterations 
+                      << " ms, planar " << timePlanar / numIterations
+                      << " ms, dequantize " << timeIQuantize / numIterations << " ms" 
+                      << ((identical) ? "" : " MISMATCH") << std::endl;
+            if (!identical)
+            {
+                SetSIMDLevel(supportedLevel);
+                return -1;
+            }
+        }
+    }
+    SetSIMDLevel(supportedLevel);
+    return 0;
+}
+
 enum Mode
 {
     UNKNOWN = 0,
     ENCODE  = 1,
-    DECODE  = 2
+    DECODE  = 2,
+    BENCHMARK = 3,
+    BENCHMARK_CONNECTIVITY = 4,
+    BENCHMARK_QUANTIZATION = 5
 };
 
 int testDynamicVectorCompression()
@@ -582,7 +1031,28 @@ int testIFSCompression(int argc, char * argv[])
     int qcoord    = 12;
     int qtexCoord = 10;
     int qnormal   = 8;
+    int numIterations = 10;
     O3DGCStreamType streamType = O3DGC_STREAM_TYPE_BINARY;
+    O3DGCSC3DMCBinarization binarization = O3DGC_SC3DMC_BINARIZATION_AC_EGC;
+    int numLanes  = 1;
+    O3DGCModelDictionary modelDictionary = O3DGC_MODEL_DICTIONARY_NONE;
+    O3DGCSC3DMCEntropyModel entropyModel = O3DGC_SC3DMC_ENTROPY_MODEL_ADAPTIVE;
+    bool tableOfContents = false;
+    bool geometryOnly    = false;
+    int numThreads       = 1;
+    int numSegments      = 1;
+    int clusterSize      = 0;
+    O3DGCSC3DMCPredictionMode normalPredMode = O3DGC_SC3DMC_SURF_NORMALS_PREDICTION;
+    double coordMaxError    = 0.0;
+    double normalMaxError   = 0.0;
+    double texCoordMaxError = 0.0;
+    int textureSize      = 1024;
+    int maxStreamSize    = 0;
+    Real regionOfInterest[6];
+    bool useRegionOfInterest = false;
+    O3DGCVertexCacheOptimization vertexCacheOptimization = O3DGC_VERTEX_CACHE_OPTIMIZATION_NONE;
+    int indexBits        = 32;
+    bool batches         = false;
     for(int i = 1; i < argc; ++i)
     {
         if ( !strcmp(argv[i], "-c"))
@@ -593,6 +1063,159 @@ int testIFSCompression(int argc, char * argv[])
         {
             mode = DECODE;
         }
+        else if ( !strcmp(argv[i], "-b"))
+        {
+            mode = BENCHMARK;
+            if (i + 1 < argc && argv[i+1][0] != '-')
+            {
+                ++i;
+                numIterations = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-bc"))
+        {
+            mode = BENCHMARK_CONNECTIVITY;
+            if (i + 1 < argc && argv[i+1][0] != '-')
+            {
+                ++i;
+                numIterations = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-bq"))
+        {
+            mode = BENCHMARK_QUANTIZATION;
+            if (i + 1 < argc && argv[i+1][0] != '-')
+            {
+                ++i;
+                numIterations = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-ec"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                if (!strcmp(argv[i], "rans"))
+                {
+                    binarization = O3DGC_SC3DMC_BINARIZATION_RANS;
+                }
+            }
+        }
+        else if ( !strcmp(argv[i], "-md"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                if (!strcmp(argv[i], "small"))
+                {
+                    modelDictionary = O3DGC_MODEL_DICTIONARY_SMALL_MESHES;
+                }
+            }
+        }
+        else if ( !strcmp(argv[i], "-it"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                indexBits = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-batch"))
+        {
+            batches = true;
+        }
+        else if ( !strcmp(argv[i], "-vc"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                if (!strcmp(argv[i], "tri"))
+                {
+                    vertexCacheOptimization = O3DGC_VERTEX_CACHE_OPTIMIZATION_TRIANGLES;
+                }
+                else if (!strcmp(argv[i], "vert"))
+                {
+                    vertexCacheOptimization = O3DGC_VERTEX_CACHE_OPTIMIZATION_VERTICES;
+                }
+            }
+        }
+        else if ( !strcmp(argv[i], "-np"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                if (!strcmp(argv[i], "oct"))
+                {
+                    normalPredMode = O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION;
+                }
+                else if (!strcmp(argv[i], "surf"))
+                {
+                    normalPredMode = O3DGC_SC3DMC_SURF_NORMALS_PREDICTION;
+                }
+            }
+        }
+        else if ( !strcmp(argv[i], "-em"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                if (!strcmp(argv[i], "static"))
+                {
+                    entropyModel = O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC;
+                }
+            }
+        }
+        else if ( !strcmp(argv[i], "-toc"))
+        {
+            tableOfContents = true;
+        }
+        else if ( !strcmp(argv[i], "-go"))
+        {
+            geometryOnly = true;
+        }
+        else if ( !strcmp(argv[i], "-nt"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                numThreads = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-seg"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                numSegments = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-cs"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                clusterSize = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-roi"))
+        {
+            if (i + 6 < argc)
+            {
+                for(int j = 0; j < 6; ++j)
+                {
+                    regionOfInterest[j] = (Real) atof(argv[++i]);
+                }
+                useRegionOfInterest = true;
+            }
+        }
+        else if ( !strcmp(argv[i], "-nl"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                numLanes = atoi(argv[i]);
+            }
+        }
         else if ( !strcmp(argv[i], "-i"))
         {
             ++i;
@@ -625,6 +1248,46 @@ int testIFSCompression(int argc, char * argv[])
                 qtexCoord = atoi(argv[i]);
             }
         }
+        else if ( !strcmp(argv[i], "-ep"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                coordMaxError = atof(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-en"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                normalMaxError = atof(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-et"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                texCoordMaxError = atof(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-ts"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                textureSize = atoi(argv[i]);
+            }
+        }
+        else if ( !strcmp(argv[i], "-mb"))
+        {
+            ++i;
+            if (i < argc)
+            {
+                maxStreamSize = atoi(argv[i]);
+            }
+        }
         else if ( !strcmp(argv[i], "-st"))
         {
             ++i;
@@ -638,19 +1301,45 @@ int testIFSCompression(int argc, char * argv[])
         }
     }
 
-    if (inputFileName.size() == 0 || mode == UNKNOWN)
+    if (inputFileName.size() == 0 || mode == UNKNOWN || numIterations <= 0 || numLanes < 1 || numLanes > (int) O3DGC_SC3DMC_MAX_NUM_LANES || numThreads < 0 || numThreads > (int) O3DGC_MAX_NUM_THREADS || numSegments < 1 || clusterSize < 0 || coordMaxError < 0.0 || normalMaxError < 0.0 || texCoordMaxError < 0.0 || textureSize < 1 || maxStreamSize < 0 || (indexBits != 16 && indexBits != 32 && indexBits != 64))
     {
-        std::cout << "Usage: ./test_o3dgc [-c|d] [-qc QuantBits] [-qt QuantBits] [-qn QuantBits] -i fileName.obj "<< std::endl;
+        std::cout << "Usage: ./test_o3dgc [-c|d|b|bc|bq] [-qc QuantBits] [-qt QuantBits] [-qn QuantBits] [-ep MaxError] [-en MaxDegrees] [-et MaxTexels] [-ts TextureSize] [-mb MaxBytes] [-np surf|oct] [-ec ac|rans] [-nl NumLanes] [-md none|small] [-em adaptive|static] [-toc] [-go] [-nt NumThreads] [-seg NumSegments] [-cs ClusterSize] [-roi xmin ymin zmin xmax ymax zmax] [-vc none|tri|vert] [-it 16|32|64] [-batch] -i fileName.obj "<< std::endl;
         std::cout << "\t -c \t Encode"<< std::endl;
         std::cout << "\t -d \t Decode"<< std::endl;
+        std::cout << "\t -b \t Compare arithmetic coding and rANS decoding times (optional: number of iterations, default=10)"<< std::endl;
+        std::cout << "\t -bc \t Time the connectivity coder and measure its peak memory (optional: number of iterations, default=10)"<< std::endl;
+        std::cout << "\t -bq \t Time the quantization kernels at each SIMD level and check their outputs match (optional: number of iterations, default=10)"<< std::endl;
         std::cout << "\t -qc \t Quantization bits for positions (default=11, range = {8,...,15})"<< std::endl;
         std::cout << "\t -qn \t Quantization bits for normals (default=10, range = {8,...,15})"<< std::endl;
         std::cout << "\t -qt \t Quantization bits for texture coordinates (default=10, range = {8,...,15})"<< std::endl;
+        std::cout << "\t -ep \t Maximum position error relative to the bounding box diagonal, overrides -qc (default=0, fixed bits)"<< std::endl;
+        std::cout << "\t -en \t Maximum normal error in degrees, overrides -qn (default=0, fixed bits)"<< std::endl;
+        std::cout << "\t -et \t Maximum texture coordinate error in texels, overrides -qt (default=0, fixed bits)"<< std::endl;
+        std::cout << "\t -ts \t Texture size in texels of -et (default=1024)"<< std::endl;
+        std::cout << "\t -mb \t Maximum stream size in bytes, met by lowering all the quantization bits (default=0, no budget)"<< std::endl;
+        std::cout << "\t -np \t Normal prediction from the surface, oct = octahedral coordinates (default=surf, range = {surf, oct})"<< std::endl;
         std::cout << "\t -st \t Stream type (default=Bin, range = {binary, ascii})"<< std::endl;
+        std::cout << "\t -ec \t Entropy coder of binary streams (default=ac, range = {ac, rans})"<< std::endl;
+        std::cout << "\t -nl \t Number of entropy coding lanes for attributes (default=1, range = {1,...,8})"<< std::endl;
+        std::cout << "\t -md \t Pre-trained models for meshes with at most 2048 vertices (default=none, range = {none, small})"<< std::endl;
+        std::cout << "\t -em \t Entropy models, static = two-pass encoding for faster decoding (default=adaptive, range = {adaptive, static})"<< std::endl;
+        std::cout << "\t -toc \t Write a table of contents for random access to the sections"<< std::endl;
+        std::cout << "\t -go \t Decode the connectivity and the positions only"<< std::endl;
+        std::cout << "\t -nt \t Number of threads (default=1, 0 = one per processor)"<< std::endl;
+        std::cout << "\t -seg \t Maximum number of independently decodable segments of connected components (default=1)"<< std::endl;
+        std::cout << "\t -cs \t Maximum number of triangles of the spatial clusters (default=0, no clusters)"<< std::endl;
+        std::cout << "\t -roi \t Decode the segments or clusters intersecting the box only"<< std::endl;
+        std::cout << "\t -vc \t Vertex cache optimization of the decoded triangles, and vertices (default=none, range = {none, tri, vert})"<< std::endl;
+        std::cout << "\t -it \t Bits of the index type, 64 = unsigned long (default=32, range = {16, 32, 64})"<< std::endl;
+        std::cout << "\t -batch \t Decode into batches of at most 65535 vertices with 16-bit indices"<< std::endl;
         std::cout << "Examples:"<< std::endl;
         std::cout << "\t Encode binary: test_o3dgc -c -i fileName.obj -st binary"<< std::endl;
         std::cout << "\t Encode ascii:  test_o3dgc -c -i fileName.obj -st ascii "<< std::endl;
         std::cout << "\t Decode:        test_o3dgc -d -i fileName.s3d"<< std::endl;
+        std::cout << "\t Benchmark:     test_o3dgc -b 20 -i fileName.obj"<< std::endl;
+        std::cout << "\t Connectivity:  test_o3dgc -bc 20 -i fileName.obj"<< std::endl;
+        std::cout << "\t Quantization:  test_o3dgc -bq 20 -i fileName.obj"<< std::endl;
+        std::cout << "\t Error bounds:  test_o3dgc -c -i fileName.obj -ep 0.0001 -en 1 -et 0.5 -ts 2048"<< std::endl;
         return -1;
     }
 
@@ -664,12 +1353,73 @@ int testIFSCompression(int argc, char * argv[])
         std::cout << "   Coord Quant.    \t "<< qcoord << std::endl;
         std::cout << "   Normal Quant.   \t "<< qnormal << std::endl;
         std::cout << "   TexCoord Quant. \t "<< qtexCoord << std::endl;
+        if (coordMaxError > 0.0)
+        {
+            std::cout << "   Coord Max. Err. \t "<< coordMaxError << std::endl;
+        }
+        if (normalMaxError > 0.0)
+        {
+            std::cout << "   Normal Max. Err.\t "<< normalMaxError << " degrees" << std::endl;
+        }
+        if (texCoordMaxError > 0.0)
+        {
+            std::cout << "   TexC. Max. Err. \t "<< texCoordMaxError << " texels of " << textureSize << std::endl;
+        }
+        if (maxStreamSize > 0)
+        {
+            std::cout << "   Max. Stream Size\t "<< maxStreamSize << std::endl;
+        }
         std::cout << "   Stream Type     \t "<< ((streamType == O3DGC_STREAM_TYPE_ASCII)? "ASCII" : "Binary") << std::endl;
-        ret = testEncode(inputFileName, qcoord, qtexCoord, qnormal, streamType);
+        std::cout << "   Entropy Coder   \t "<< ((binarization == O3DGC_SC3DMC_BINARIZATION_RANS)? "rANS" : "AC") << std::endl;
+        std::cout << "   Lanes           \t "<< numLanes << std::endl;
+        std::cout << "   Model Dictionary\t "<< ((modelDictionary == O3DGC_MODEL_DICTIONARY_SMALL_MESHES)? "small" : "none") << std::endl;
+        std::cout << "   Entropy Models  \t "<< ((entropyModel == O3DGC_SC3DMC_ENTROPY_MODEL_SEMI_STATIC)? "static" : "adaptive") << std::endl;
+        std::cout << "   Table of Cont.  \t "<< ((tableOfContents)? "yes" : "no") << std::endl;
+        std::cout << "   Threads         \t "<< numThreads << std::endl;
+        std::cout << "   Segments        \t "<< numSegments << std::endl;
+        std::cout << "   Cluster Size    \t "<< clusterSize << std::endl;
+        std::cout << "   Normal Pred.    \t "<< ((normalPredMode == O3DGC_SC3DMC_OCTAHEDRAL_NORMALS_PREDICTION)? "octahedral" : "surface") << std::endl;
+        std::cout << "   Index Bits      \t "<< indexBits << std::endl;
+        if (indexBits == 16)
+        {
+            ret = testEncode<unsigned short>(inputFileName, qcoord, qtexCoord, qnormal, streamType, binarization, numLanes, modelDictionary, entropyModel, tableOfContents, numThreads, numSegments, clusterSize, normalPredMode, (Real) coordMaxError, (Real) (normalMaxError * PI / 180.0), (Real) texCoordMaxError, textureSize, maxStreamSize);
+        }
+        else if (indexBits == 32)
+        {
+            ret = testEncode<unsigned int>(inputFileName, qcoord, qtexCoord, qnormal, streamType, binarization, numLanes, modelDictionary, entropyModel, tableOfContents, numThreads, numSegments, clusterSize, normalPredMode, (Real) coordMaxError, (Real) (normalMaxError * PI / 180.0), (Real) texCoordMaxError, textureSize, maxStreamSize);
+        }
+        else
+        {
+            ret = testEncode<unsigned long>(inputFileName, qcoord, qtexCoord, qnormal, streamType, binarization, numLanes, modelDictionary, entropyModel, tableOfContents, numThreads, numSegments, clusterSize, normalPredMode, (Real) coordMaxError, (Real) (normalMaxError * PI / 180.0), (Real) texCoordMaxError, textureSize, maxStreamSize);
+        }
+    }
+    else if (mode == BENCHMARK_QUANTIZATION)
+    {
+        ret = testQuantization(inputFileName, qcoord, qtexCoord, qnormal, numIterations);
+    }
+    else if (mode == BENCHMARK_CONNECTIVITY)
+    {
+        ret = testConnectivity(inputFileName, numIterations);
+    }
+    else if (mode == BENCHMARK)
+    {
+        ret = testEntropyCoders(inputFileName, qcoord, qtexCoord, qnormal, numIterations, numLanes, modelDictionary, entropyModel);
     }
     else
     {
-        ret = testDecode(inputFileName);
+        const Real * const roi = (useRegionOfInterest) ? regionOfInterest : 0;
+        if (indexBits == 16)
+        {
+            ret = testDecode<unsigned short>(inputFileName, geometryOnly, numThreads, roi, vertexCacheOptimization, batches);
+        }
+        else if (indexBits == 32)
+        {
+            ret = testDecode<unsigned int>(inputFileName, geometryOnly, numThreads, roi, vertexCacheOptimization, batches);
+        }
+        else
+        {
+            ret = testDecode<unsigned long>(inputFileName, geometryOnly, numThreads, roi, vertexCacheOptimization, batches);
+        }
     }
     if (ret)
     {
@@ -687,11 +1437,12 @@ int main(int argc, char * argv[])
     return testIFSCompression(argc, argv);
 #endif
 }
+template <class T>
 bool LoadOBJ(const std::string & fileName, 
              std::vector< Vec3<Real> > & upoints,
              std::vector< Vec2<Real> > & utexCoords,
              std::vector< Vec3<Real> > & unormals,
-             std::vector< Vec3<unsigned long> > & triangles,
+             std::vector< Vec3<T> > & triangles,
              std::vector< unsigned long > & indexBufferIDs,
              std::vector< Material > & materials,
              std::string & materialLib) 
@@ -713,7 +1464,7 @@ bool LoadOBJ(const std::string & fileName,
         char * str;
         unsigned long nv = 0;
         Vec3<unsigned long> vertex;
-        Vec3<unsigned long> triangle;
+        Vec3<T> triangle;
         std::vector< Vec3<Real> > points;
         std::vector< Vec2<Real> > texCoords;
         std::vector< Vec3<Real> > normals;
@@ -847,12 +1598,12 @@ bool LoadOBJ(const std::string & fileName,
                     if ( it == vertices.end() )
                     {
                         vertices[vertex] = nv;
-                        triangle[k]      = nv;
+                        triangle[k]      = (T) nv;
                         ++nv;
                     }
                     else
                     {
-                        triangle[k]         =  it->second;
+                        triangle[k]         =  (T) it->second;
                     }
                 }                
                 triangles.push_back(triangle);
@@ -899,11 +1650,12 @@ bool LoadOBJ(const std::string & fileName,
     }
     return true;
 }
+template <class T>
 bool SaveOBJ(const std::string & fileName, 
              const std::vector< Vec3<Real> > & points,
              const std::vector< Vec2<Real> > & texCoords,
              const std::vector< Vec3<Real> > & normals,
-             const std::vector< Vec3<unsigned long> > & triangles,
+             const std::vector< Vec3<T> > & triangles,
              const std::vector< Material > & materials,
              const std::vector< unsigned long > indexBufferIDs,
              const std::string & materialLib)
@@ -1107,7 +1859,8 @@ void SaveIFSArray(std::ofstream & fout,
         fout << std::endl;
     }
 }
-bool SaveIFS(const std::string & fileName, const IndexedFaceSet<unsigned long> & ifs)
+template <class T>
+bool SaveIFS(const std::string & fileName, const IndexedFaceSet<T> & ifs)
 {
     std::ofstream fout;
     fout.open(fileName.c_str());
@@ -1134,11 +1887,12 @@ bool SaveIFS(const std::string & fileName, const IndexedFaceSet<unsigned long> &
     }
     return true;
 }
+template <class T>
 bool LoadIFS(const std::string & fileName, 
              std::vector< Vec3<Real> > & points,
              std::vector< Vec2<Real> > & texCoords,
              std::vector< Vec3<Real> > & normals,
-             std::vector< Vec3<unsigned long> > & triangles,
+             std::vector< Vec3<T> > & triangles,
              std::vector< unsigned long > & indexBufferIDs)
 {
     std::ifstream fin;
@@ -1226,14 +1980,15 @@ bool LoadIFS(const std::string & fileName,
         return false;
     }
 }
-bool Check(const IndexedFaceSet<unsigned long> & ifs)
+template <class T>
+bool Check(const IndexedFaceSet<T> & ifs)
 {
     unsigned int nt = ifs.GetNCoordIndex() * 3;
     unsigned int nv = ifs.GetNCoord();
-    const unsigned long * const triangles = ifs.GetCoordIndex();
+    const T * const triangles = ifs.GetCoordIndex();
     for(unsigned int i = 0; i < nt; ++i)
     {
-        if ( triangles[i] < 0 || triangles[i] >= nv )
+        if ( triangles[i] >= nv )
         {
             std::cout << "CoordIndex[" << i << "] = " << triangles[i] << " out of range" << std::endl;
             return false;